@@ -13,9 +13,27 @@ namespace octopus {
 
 // AlignedRead::Segment public
 
+AlignedRead::Segment::Segment(const GenomicRegion::ContigName& contig_name, GenomicRegion::Position begin,
+                              GenomicRegion::Size inferred_template_length, Flags data)
+: Segment {intern_contig(contig_name), begin, inferred_template_length, data}
+{}
+
+AlignedRead::Segment::Segment(GenomicRegion::ContigId contig_id, GenomicRegion::Position begin,
+                              GenomicRegion::Size inferred_template_length, Flags data)
+: contig_id_ {contig_id}
+, begin_ {begin}
+, inferred_template_length_ {inferred_template_length}
+, flags_ {compress(data)}
+{}
+
 const GenomicRegion::ContigName& AlignedRead::Segment::contig_name() const
 {
-    return contig_name_;
+    return lookup_contig_name(contig_id_);
+}
+
+GenomicRegion::ContigId AlignedRead::Segment::contig_id() const noexcept
+{
+    return contig_id_;
 }
 
 GenomicRegion::Position AlignedRead::Segment::begin() const noexcept
@@ -251,7 +269,7 @@ AlignedRead::NucleotideSequence::size_type sequence_size(const AlignedRead& read
 
 AlignedRead::NucleotideSequence::size_type sequence_size(const AlignedRead& read, const GenomicRegion& region)
 {
-    if (contig_name(region) != contig_name(read)) return 0;
+    if (!is_same_contig(region, read)) return 0;
     if (contains(region, read)) return sequence_size(read);
     const auto copy_region = *overlapped_region(read, region);
     const auto reference_offset = static_cast<CigarOperation::Size>(begin_distance(read, copy_region));
@@ -440,7 +458,7 @@ bool IsDuplicate::operator()(const AlignedRead& lhs, const AlignedRead& rhs) con
 
 bool operator==(const AlignedRead::Segment& lhs, const AlignedRead::Segment& rhs) noexcept
 {
-    return lhs.contig_name() == rhs.contig_name()
+    return lhs.contig_id() == rhs.contig_id()
         && lhs.begin() == rhs.begin()
         && lhs.inferred_template_length() == rhs.inferred_template_length();
 }
@@ -43,8 +43,10 @@ public:
         
         Segment() = default;
         
-        template <typename S>
-        Segment(S&& contig_name, GenomicRegion::Position begin,
+        Segment(const GenomicRegion::ContigName& contig_name, GenomicRegion::Position begin,
+                GenomicRegion::Size inferred_template_length,
+                Flags data);
+        Segment(GenomicRegion::ContigId contig_id, GenomicRegion::Position begin,
                 GenomicRegion::Size inferred_template_length,
                 Flags data);
         
@@ -56,6 +58,7 @@ public:
         ~Segment() = default;
         
         const GenomicRegion::ContigName& contig_name() const;
+        GenomicRegion::ContigId contig_id() const noexcept;
         
         GenomicRegion::Position begin() const noexcept;
         
@@ -69,7 +72,7 @@ public:
     private:
         using FlagBits = std::bitset<2>;
         
-        GenomicRegion::ContigName contig_name_;
+        GenomicRegion::ContigId contig_id_ = 0;
         GenomicRegion::Position begin_;
         GenomicRegion::Size inferred_template_length_;
         FlagBits flags_;
@@ -200,14 +203,6 @@ AlignedRead::AlignedRead(String1_&& name, GenomicRegion_&& reference_region, Seq
 , mapping_quality_ {mapping_quality}
 {}
 
-template <typename String_>
-AlignedRead::Segment::Segment(String_&& contig_name, GenomicRegion::Position begin,
-                              GenomicRegion::Size inferred_template_length, Flags data)
-: contig_name_ {std::forward<String_>(contig_name)}
-, begin_ {begin}
-, inferred_template_length_ {inferred_template_length}
-, flags_ {compress(data)}
-{}
 
 // Non-member methods
 
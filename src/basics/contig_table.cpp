@@ -0,0 +1,148 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "contig_table.hpp"
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+/*
+ Names are stored in blocks that double in size, so the table can grow without moving any name
+ (which would invalidate returned references) and without making readers take a lock. Block b
+ holds 2^(b + firstBlockBits) names, so the blocks cover every ContigId.
+ */
+class ContigTable
+{
+public:
+    ContigTable();
+
+    ContigTable(const ContigTable&)            = delete;
+    ContigTable& operator=(const ContigTable&) = delete;
+    ContigTable(ContigTable&&)                 = delete;
+    ContigTable& operator=(ContigTable&&)      = delete;
+
+    ~ContigTable() noexcept;
+
+    ContigId intern(const std::string& name);
+    const std::string& name(ContigId id) const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    static constexpr unsigned firstBlockBits {6};
+    static constexpr unsigned numBlocks {33 - firstBlockBits};
+
+    std::array<std::atomic<std::string*>, numBlocks> blocks_;
+    std::unordered_map<std::string, ContigId> ids_;
+    std::atomic<std::size_t> size_;
+    mutable std::shared_timed_mutex mutex_;
+
+    static unsigned block_index(std::uint64_t slot) noexcept;
+    static std::uint64_t block_size(unsigned block) noexcept;
+};
+
+ContigTable::ContigTable()
+: ids_ {}
+, size_ {0}
+, mutex_ {}
+{
+    for (auto& block : blocks_) block = nullptr;
+    intern("");
+}
+
+ContigTable::~ContigTable() noexcept
+{
+    for (auto& block : blocks_) delete[] block.load();
+}
+
+ContigId ContigTable::intern(const std::string& name)
+{
+    {
+        std::shared_lock<std::shared_timed_mutex> lock {mutex_};
+        const auto itr = ids_.find(name);
+        if (itr != std::cend(ids_)) return itr->second;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock {mutex_};
+    const auto itr = ids_.find(name);
+    if (itr != std::cend(ids_)) return itr->second;
+    const auto id = size_.load(std::memory_order_relaxed);
+    if (id > std::numeric_limits<ContigId>::max()) {
+        throw std::length_error {"ContigTable: too many contigs"};
+    }
+    const std::uint64_t slot {id + (std::uint64_t {1} << firstBlockBits)};
+    const auto block = block_index(slot);
+    auto names = blocks_[block].load(std::memory_order_relaxed);
+    if (!names) {
+        names = new std::string[block_size(block)];
+        blocks_[block].store(names, std::memory_order_release);
+    }
+    names[slot - block_size(block)] = name;
+    ids_.emplace(name, static_cast<ContigId>(id));
+    size_.store(id + 1, std::memory_order_release);
+    return static_cast<ContigId>(id);
+}
+
+const std::string& ContigTable::name(const ContigId id) const noexcept
+{
+    assert(id < size());
+    const std::uint64_t slot {id + (std::uint64_t {1} << firstBlockBits)};
+    const auto block = block_index(slot);
+    return blocks_[block].load(std::memory_order_acquire)[slot - block_size(block)];
+}
+
+std::size_t ContigTable::size() const noexcept
+{
+    return size_.load(std::memory_order_acquire);
+}
+
+unsigned ContigTable::block_index(std::uint64_t slot) noexcept
+{
+    unsigned result {0};
+    for (slot >>= firstBlockBits + 1; slot > 0; slot >>= 1) ++result;
+    return result;
+}
+
+std::uint64_t ContigTable::block_size(const unsigned block) noexcept
+{
+    return std::uint64_t {1} << (block + firstBlockBits);
+}
+
+ContigTable& get_contig_table()
+{
+    static ContigTable result {};
+    return result;
+}
+
+} // namespace
+
+ContigId intern_contig(const std::string& name)
+{
+    return get_contig_table().intern(name);
+}
+
+void intern_contigs(const std::vector<std::string>& names)
+{
+    auto& table = get_contig_table();
+    for (const auto& name : names) table.intern(name);
+}
+
+const std::string& lookup_contig_name(const ContigId id) noexcept
+{
+    return get_contig_table().name(id);
+}
+
+std::size_t num_interned_contigs() noexcept
+{
+    return get_contig_table().size();
+}
+
+} // namespace octopus
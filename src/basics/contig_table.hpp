@@ -0,0 +1,38 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef contig_table_hpp
+#define contig_table_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace octopus {
+
+/**
+ The process-wide contig table maps each contig name to a small integer ID so regions can store
+ and compare contigs without carrying a copy of the name. IDs are never reused or removed, and
+ names are stored at stable addresses, so references returned by lookup_contig_name stay valid
+ for the life of the program.
+
+ ID 0 is always the empty name, which default constructed regions use. Registering the reference
+ contigs up front (see ReferenceGenome) gives them consecutive IDs in reference order; any other
+ name is added the first time it is seen.
+
+ Interning takes a lock, but looking up the name of an ID does not.
+ */
+using ContigId = std::uint32_t;
+
+ContigId intern_contig(const std::string& name);
+
+void intern_contigs(const std::vector<std::string>& names);
+
+const std::string& lookup_contig_name(ContigId id) noexcept;
+
+std::size_t num_interned_contigs() noexcept;
+
+} // namespace octopus
+
+#endif
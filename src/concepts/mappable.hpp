@@ -158,6 +158,12 @@ decltype(auto) contig_name(const Mappable<T>& mappable) noexcept
     return contig_name(static_cast<const T&>(mappable).mapped_region());
 }
 
+template <typename T>
+auto contig_id(const Mappable<T>& mappable) noexcept
+{
+    return contig_id(static_cast<const T&>(mappable).mapped_region());
+}
+
 template <typename T>
 auto is_same_contig(const GenomicRegion& lhs, const Mappable<T>& rhs) noexcept
 {
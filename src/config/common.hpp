@@ -12,6 +12,7 @@
 
 #include "basics/genomic_region.hpp"
 #include "basics/aligned_read.hpp"
+#include "basics/mappable_reference_wrapper.hpp"
 #include "io/read/read_manager.hpp"
 #include "containers/mappable_flat_set.hpp"
 #include "containers/mappable_flat_multi_set.hpp"
@@ -32,6 +33,10 @@ using InputRegionMap = MappableSetMap<ContigName, GenomicRegion>;
 using ReadContainer = MappableFlatMultiSet<AlignedRead>;
 using ReadMap       = MappableMap<SampleName, AlignedRead>;
 
+// Non-owning views of reads; the viewed ReadContainer or ReadMap must outlive the view
+using ReadViewContainer = MappableFlatMultiSet<MappableReferenceWrapper<const AlignedRead>>;
+using ReadViewMap       = MappableMap<SampleName, MappableReferenceWrapper<const AlignedRead>>;
+
 enum class ExecutionPolicy { seq, par, par_vec }; // To match Parallelism TS
 
 namespace logging {
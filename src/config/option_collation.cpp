@@ -15,6 +15,7 @@
 #include <utility>
 #include <thread>
 #include <sstream>
+#include <set>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -27,6 +28,7 @@
 #include "utils/repeat_finder.hpp"
 #include "utils/append.hpp"
 #include "utils/maths.hpp"
+#include "utils/map_utils.hpp"
 #include "basics/phred.hpp"
 #include "basics/genomic_region.hpp"
 #include "basics/aligned_read.hpp"
@@ -256,6 +258,15 @@ MemoryFootprint get_target_read_buffer_size(const OptionMap& options)
     return options.at("target-read-buffer-footprint").as<MemoryFootprint>();
 }
 
+std::shared_ptr<MemoryGovernor> make_memory_governor(const OptionMap& options)
+{
+    if (is_set("target-working-memory", options)) {
+        return std::make_shared<MemoryGovernor>(options.at("target-working-memory").as<MemoryFootprint>());
+    } else {
+        return std::make_shared<MemoryGovernor>();
+    }
+}
+
 boost::optional<fs::path> get_debug_log_file_name(const OptionMap& options)
 {
     if (is_debug_mode(options)) {
@@ -838,11 +849,15 @@ ReadPipe make_read_pipe(ReadManager& read_manager, std::vector<SampleName> sampl
 {
     auto transformers = make_read_transformers(options);
     if (transformers.second.num_transforms() > 0) {
-        return ReadPipe {read_manager, std::move(transformers.first), make_read_filterer(options),
+        ReadPipe result {read_manager, std::move(transformers.first), make_read_filterer(options),
                          std::move(transformers.second), make_downsampler(options), std::move(samples)};
+        result.set_max_threads(get_num_threads(options));
+        return result;
     } else {
-        return ReadPipe {read_manager, std::move(transformers.first), make_read_filterer(options),
+        ReadPipe result {read_manager, std::move(transformers.first), make_read_filterer(options),
                          make_downsampler(options), std::move(samples)};
+        result.set_max_threads(get_num_threads(options));
+        return result;
     }
 }
 
@@ -1320,19 +1335,37 @@ auto get_min_flank_pad() noexcept
     return 2 * (2 * HaplotypeLikelihoodModel{}.pad_requirement() - 1);
 }
 
-auto make_haplotype_generator_builder(const OptionMap& options, const boost::optional<ReadSetProfile>& input_reads_profile)
+boost::optional<HaplotypeCostModel>
+make_haplotype_cost_model(const OptionMap& options, const std::vector<SampleName>& samples, const InputRegionMap& regions)
+{
+    if (!is_set("region-time-budget", options)) return boost::none;
+    const HaplotypeCostModel::Seconds region_budget {as_unsigned("region-time-budget", options)};
+    const auto max_ploidy = get_max_ploidy(samples, extract_keys(regions), get_ploidy_map(options));
+    auto result = make_calibrated_cost_model(region_budget, max_ploidy);
+    auto debug_log = logging::get_debug_log();
+    if (debug_log) {
+        stream(*debug_log) << "Calibrated haplotype cost model at " << result.unit_cost().count()
+                           << " seconds per read-haplotype base";
+    }
+    return result;
+}
+
+auto make_haplotype_generator_builder(const OptionMap& options, const boost::optional<ReadSetProfile>& input_reads_profile,
+                                      const boost::optional<HaplotypeCostModel>& cost_model)
 {
     const auto lagging_policy    = get_lagging_policy(options);
     const auto max_haplotypes    = get_max_haplotypes(options);
     const auto holdout_limit     = as_unsigned("haplotype-holdout-threshold", options);
     const auto overflow_limit    = as_unsigned("haplotype-overflow", options);
     const auto max_holdout_depth = as_unsigned("max-holdout-depth", options);
-    return HaplotypeGenerator::Builder().set_extension_policy(get_extension_policy(options))
+    auto result = HaplotypeGenerator::Builder().set_extension_policy(get_extension_policy(options))
     .set_target_limit(max_haplotypes).set_holdout_limit(holdout_limit).set_overflow_limit(overflow_limit)
     .set_lagging_policy(lagging_policy).set_max_holdout_depth(max_holdout_depth)
     .set_max_indicator_join_distance(get_max_indicator_join_distance())
     .set_dense_variation_detector(get_dense_variation_detector(options, input_reads_profile))
     .set_min_flank_pad(get_min_flank_pad());
+    if (cost_model) result.set_cost_model(*cost_model);
+    return result;
 }
 
 boost::optional<Pedigree> read_ped_file(const OptionMap& options)
@@ -1663,11 +1696,13 @@ auto get_target_working_memory(const OptionMap& options)
 
 CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                                   const InputRegionMap& regions, const OptionMap& options,
-                                  const boost::optional<ReadSetProfile> read_profile)
+                                  const boost::optional<ReadSetProfile> read_profile,
+                                  std::shared_ptr<MemoryGovernor> memory_governor)
 {
+    const auto cost_model = make_haplotype_cost_model(options, read_pipe.samples(), regions);
     CallerBuilder vc_builder {reference, read_pipe,
                               make_variant_generator_builder(options),
-                              make_haplotype_generator_builder(options, read_profile)};
+                              make_haplotype_generator_builder(options, read_profile, cost_model)};
 	const auto pedigree = read_ped_file(options);
     const auto caller = get_caller_type(options, read_pipe.samples(), pedigree);
     check_caller(caller, read_pipe.samples(), options);
@@ -1750,6 +1785,12 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
     vc_builder.set_likelihood_model(make_likelihood_model(options, read_profile));
     const auto target_working_memory = get_target_working_memory(options);
     if (target_working_memory) vc_builder.set_target_memory_footprint(*target_working_memory);
+    if (memory_governor) vc_builder.set_memory_governor(std::move(memory_governor));
+    vc_builder.set_active_region_pipelining(options.at("pipeline-active-regions").as<bool>());
+    if (is_set("isolated-snv-distance", options)) {
+        vc_builder.set_isolated_snv_distance(as_unsigned("isolated-snv-distance", options));
+    }
+    if (cost_model) vc_builder.set_haplotype_cost_model(*cost_model);
     return CallerFactory {std::move(vc_builder)};
 }
 
@@ -1810,8 +1851,7 @@ auto get_caller_type(const OptionMap& options, const std::vector<SampleName>& sa
 }
 
 std::unique_ptr<VariantCallFilterFactory>
-make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe, const OptionMap& options,
-                         boost::optional<fs::path> temp_directory)
+make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe, const OptionMap& options)
 {
     if (is_call_filtering_requested(options)) {
         const auto caller = get_caller_type(options, read_pipe.samples());
@@ -1820,16 +1860,15 @@ make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
             if (!fs::exists(forest_file)) {
                 throw MissingForestFile {forest_file, "forest-file"};
             }
-            if (!temp_directory) temp_directory = "/tmp";
             if (caller == "cancer") {
                 if (is_set("somatic-forest-file", options)) {
                     auto somatic_forest_file = resolve_path(options.at("somatic-forest-file").as<fs::path>(), options);
                     if (!fs::exists(somatic_forest_file)) {
                         throw MissingForestFile {somatic_forest_file, "somatic-forest-file"};
                     }
-                    return std::make_unique<RandomForestFilterFactory>(forest_file, somatic_forest_file, *temp_directory);
+                    return std::make_unique<RandomForestFilterFactory>(forest_file, somatic_forest_file);
                 } else if (options.at("somatics-only").as<bool>()) {
-                    return std::make_unique<RandomForestFilterFactory>(forest_file, *temp_directory,
+                    return std::make_unique<RandomForestFilterFactory>(forest_file,
                                                                        RandomForestFilterFactory::ForestType::somatic);
                 } else {
                     logging::WarningLogger log {};
@@ -1838,13 +1877,13 @@ make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                 }
             } else if (caller == "trio") {
                 if (options.at("denovos-only").as<bool>()) {
-                    return std::make_unique<RandomForestFilterFactory>(forest_file, *temp_directory,
+                    return std::make_unique<RandomForestFilterFactory>(forest_file,
                                                                        RandomForestFilterFactory::ForestType::denovo);
                 } else {
-                    return std::make_unique<RandomForestFilterFactory>(forest_file, *temp_directory);
+                    return std::make_unique<RandomForestFilterFactory>(forest_file);
                 }
             } else {
-                return std::make_unique<RandomForestFilterFactory>(forest_file, *temp_directory);
+                return std::make_unique<RandomForestFilterFactory>(forest_file);
             }
         } else if (is_set("somatic-forest-file", options)) {
             if (options.at("somatics-only").as<bool>()) {
@@ -1852,7 +1891,7 @@ make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                 if (!fs::exists(somatic_forest_file)) {
                     throw MissingForestFile {somatic_forest_file, "somatic-forest-file"};
                 }
-                return std::make_unique<RandomForestFilterFactory>(somatic_forest_file, *temp_directory,
+                return std::make_unique<RandomForestFilterFactory>(somatic_forest_file,
                                                                    RandomForestFilterFactory::ForestType::somatic);
             } else {
                 logging::WarningLogger log {};
@@ -1923,7 +1962,9 @@ ReadPipe make_call_filter_read_pipe(ReadManager& read_manager, std::vector<Sampl
     if (use_calling_read_pipe_for_call_filtering(options)) {
         return make_read_pipe(read_manager, std::move(samples), options);
     } else {
-        return make_default_filter_read_pipe(read_manager, std::move(samples));
+        auto result = make_default_filter_read_pipe(read_manager, std::move(samples));
+        result.set_max_threads(get_num_threads(options));
+        return result;
     }
 }
 
@@ -1935,6 +1976,31 @@ boost::optional<fs::path> get_output_path(const OptionMap& options)
     return boost::none;
 }
 
+class ExistingCheckpoint : public UserError
+{
+    std::string do_where() const override
+    {
+        return "get_checkpoint_directory";
+    }
+
+    std::string do_why() const override
+    {
+        std::ostringstream ss {};
+        ss << "The working directory already contains a checkpoint ";
+        ss << path_;
+        return ss.str();
+    }
+
+    std::string do_help() const override
+    {
+        return "add --resume to continue the checkpointed run, or delete the checkpoint directory";
+    }
+
+    fs::path path_;
+public:
+    ExistingCheckpoint(fs::path p) : path_ {std::move(p)} {}
+};
+
 boost::optional<fs::path> create_temp_file_directory(const OptionMap& options)
 {
     const auto working_directory = get_working_directory(options);
@@ -1970,6 +2036,98 @@ boost::optional<fs::path> create_temp_file_directory(const OptionMap& options)
     return result;
 }
 
+bool is_checkpointing_requested(const OptionMap& options) noexcept
+{
+    return options.at("checkpoint").as<bool>() || is_resume_requested(options);
+}
+
+bool is_resume_requested(const OptionMap& options) noexcept
+{
+    return options.at("resume").as<bool>();
+}
+
+boost::optional<fs::path> get_checkpoint_directory(const OptionMap& options)
+{
+    if (!is_checkpointing_requested(options)) return boost::none;
+    auto result = get_working_directory(options);
+    result /= "octopus-checkpoint";
+    if (!is_resume_requested(options) && fs::exists(result) && !fs::is_empty(result)) {
+        throw ExistingCheckpoint {result};
+    }
+    return result;
+}
+
+namespace {
+
+template <typename T>
+bool write_value(const boost::any& value, std::ostream& os)
+{
+    if (const auto typed_value = boost::any_cast<T>(&value)) {
+        os << *typed_value;
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+bool write_values(const boost::any& value, std::ostream& os)
+{
+    if (const auto typed_values = boost::any_cast<std::vector<T>>(&value)) {
+        for (const auto& typed_value : *typed_values) os << typed_value << ';';
+        return true;
+    }
+    return false;
+}
+
+void write_option_value(const boost::any& value, std::ostream& os)
+{
+    write_value<bool>(value, os) || write_value<int>(value, os) || write_value<float>(value, os)
+    || write_value<double>(value, os) || write_value<std::string>(value, os) || write_value<fs::path>(value, os)
+    || write_value<Phred<double>>(value, os) || write_value<MemoryFootprint>(value, os)
+    || write_value<ShardRequest>(value, os) || write_value<RefCallType>(value, os)
+    || write_value<PhasingLevel>(value, os) || write_value<NormalContaminationRisk>(value, os)
+    || write_value<ExtensionLevel>(value, os) || write_value<ContigOutputOrder>(value, os)
+    || write_values<int>(value, os) || write_values<std::string>(value, os) || write_values<fs::path>(value, os)
+    || write_values<ContigPloidy>(value, os);
+}
+
+} // namespace
+
+std::string describe_calling_options(const OptionMap& options)
+{
+    static const std::set<std::string> nonCallingOptions {
+        "help", "version", "config", "debug", "trace", "working-directory", "threads",
+        "max-reference-cache-footprint", "target-read-buffer-footprint", "max-open-read-files",
+        "target-working-memory", "pipeline-active-regions", "checkpoint", "resume", "output",
+        "bamout", "split-bamout", "data-profile", "legacy"
+    };
+    std::ostringstream result {};
+    for (const auto& p : options) {
+        if (p.second.empty() || nonCallingOptions.count(p.first) == 1) continue;
+        result << p.first << '=';
+        write_option_value(p.second.value(), result);
+        result << ',';
+    }
+    return result.str();
+}
+
+boost::optional<ShardRequest> get_shard_request(const OptionMap& options)
+{
+    if (is_set("shard", options)) {
+        return options.at("shard").as<ShardRequest>();
+    }
+    return boost::none;
+}
+
+std::vector<fs::path> get_merge_shard_paths(const OptionMap& options)
+{
+    auto result = options.at("shards").as<std::vector<fs::path>>();
+    for (auto& path : result) {
+        path = resolve_path(path, options);
+    }
+    return result;
+}
+
 bool is_legacy_vcf_requested(const OptionMap& options)
 {
     return options.at("legacy").as<bool>();
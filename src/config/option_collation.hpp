@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -22,6 +23,7 @@
 #include "readpipe/read_pipe.hpp"
 #include "utils/input_reads_profiler.hpp"
 #include "utils/memory_footprint.hpp"
+#include "utils/memory_governor.hpp"
 
 namespace fs = boost::filesystem;
 
@@ -39,6 +41,9 @@ boost::optional<unsigned> get_num_threads(const OptionMap& options);
 
 MemoryFootprint get_target_read_buffer_size(const OptionMap& options);
 
+// The governor's budget is the total target working memory for all threads
+std::shared_ptr<MemoryGovernor> make_memory_governor(const OptionMap& options);
+
 ReferenceGenome make_reference(const OptionMap& options);
 
 InputRegionMap get_search_regions(const OptionMap& options, const ReferenceGenome& reference);
@@ -61,13 +66,13 @@ boost::optional<Pedigree> get_pedigree(const OptionMap& options, const std::vect
 
 CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& read_pipe,
                                   const InputRegionMap& regions, const OptionMap& options,
-                                  boost::optional<ReadSetProfile> input_reads_profile = boost::none);
+                                  boost::optional<ReadSetProfile> input_reads_profile = boost::none,
+                                  std::shared_ptr<MemoryGovernor> memory_governor = nullptr);
 
 bool is_call_filtering_requested(const OptionMap& options) noexcept;
 
 std::unique_ptr<VariantCallFilterFactory>
-make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe, const OptionMap& options,
-                         boost::optional<fs::path> temp_directory = boost::none);
+make_call_filter_factory(const ReferenceGenome& reference, ReadPipe& read_pipe, const OptionMap& options);
 
 bool use_calling_read_pipe_for_call_filtering(const OptionMap& options) noexcept;
 
@@ -79,6 +84,19 @@ boost::optional<fs::path> get_output_path(const OptionMap& options);
 
 boost::optional<fs::path> create_temp_file_directory(const OptionMap& options);
 
+bool is_checkpointing_requested(const OptionMap& options) noexcept;
+bool is_resume_requested(const OptionMap& options) noexcept;
+boost::optional<fs::path> get_checkpoint_directory(const OptionMap& options);
+
+// Lists the value of every option that can change the calls a run makes, i.e. everything but
+// resource, logging and output options. Runs with the same description make the same calls.
+std::string describe_calling_options(const OptionMap& options);
+
+boost::optional<ShardRequest> get_shard_request(const OptionMap& options);
+
+// The shard files given to the merge command
+std::vector<fs::path> get_merge_shard_paths(const OptionMap& options);
+
 bool is_legacy_vcf_requested(const OptionMap& options);
 
 bool is_filter_training_mode(const OptionMap& options);
@@ -97,7 +97,28 @@ OptionMap parse_options(const int argc, const char** argv)
     
      ("target-working-memory",
      po::value<MemoryFootprint>(),
-     "Target working memory footprint for analysis not including read or reference footprint")
+     "Target working memory footprint for analysis not including reference footprint; new tasks are"
+     " held back or made smaller when the reads, haplotypes and likelihoods of running tasks near this target")
+    
+    ("pipeline-active-regions",
+     po::bool_switch()->default_value(false),
+     "Computes haplotype likelihoods for the next active region on a second thread while the current"
+     " active region is being called")
+    
+    ("checkpoint",
+     po::bool_switch()->default_value(false),
+     "Periodically records the calls of completed tasks in the working directory so an interrupted"
+     " multithreaded run can be continued with --resume")
+    
+    ("resume",
+     po::bool_switch()->default_value(false),
+     "Continues an interrupted run from the checkpoint in the working directory; the run must use the"
+     " same options as the interrupted run")
+    
+    ("shard",
+     po::value<ShardRequest>(),
+     "Calls only shard i of N (given as i/N, 1-based) of the search regions; shards are balanced by"
+     " mapped read counts and the outputs of all N runs are combined with 'octopus merge'")
     ;
     
     po::options_description input("I/O");
@@ -425,6 +446,17 @@ OptionMap parse_options(const int argc, const char** argv)
     ("protect-reference-haplotype",
      po::value<bool>()->default_value(true),
      "Protect the reference haplotype from filtering")
+    
+    ("isolated-snv-distance",
+     po::value<int>(),
+     "SNV candidates with no other candidate within this many bases, and not in a short tandem repeat,"
+     " are genotyped directly from base qualities without haplotype generation. Ignored when reference"
+     " calls are requested")
+    
+    ("region-time-budget",
+     po::value<int>(),
+     "Target maximum time (seconds) to spend calling each active region. Haplotype limits are reduced in"
+     " regions that a calibrated cost model predicts will exceed this")
     ;
     
     po::options_description caller("Calling (general)");
@@ -458,7 +490,7 @@ OptionMap parse_options(const int argc, const char** argv)
     ("refcall",
      po::value<RefCallType>()->implicit_value(RefCallType::blocked),
      "Caller will report reference confidence calls for each position (positional),"
-     " or in automatically sized blocks (blocked)")
+     " or in blocks of positions with similar genotype quality (blocked)")
     
     ("min-refcall-posterior",
      po::value<Phred<double>>()->default_value(Phred<double> {2.0}),
@@ -1041,7 +1073,8 @@ void validate(const OptionMap& vm)
         "max-region-to-assemble", "fallback-kmer-gap", "organism-ploidy",
         "max-haplotypes", "haplotype-holdout-threshold", "haplotype-overflow",
         "max-genotypes", "max-joint-genotypes", "max-somatic-haplotypes", "max-clones",
-        "max-vb-seeds"
+        "max-vb-seeds", "isolated-snv-distance",
+        "region-time-budget"
     };
     const std::vector<std::string> probability_options {
         "snp-heterozygosity", "snp-heterozygosity-stdev", "indel-heterozygosity",
@@ -1065,6 +1098,50 @@ void validate(const OptionMap& vm)
     validate_caller(vm);
 }
 
+OptionMap parse_merge_options(const int argc, const char** argv)
+{
+    po::options_description general("octopus merge options");
+    general.add_options()
+    ("help,h", "Produce help message")
+    
+    ("working-directory,w",
+     po::value<fs::path>(),
+     "Sets the working directory")
+    
+    ("output,o",
+     po::value<fs::path>(),
+     "File to write the merged calls to, or stdout if not given")
+    ;
+    
+    po::options_description hidden("hidden");
+    hidden.add_options()
+    ("shards",
+     po::value<std::vector<fs::path>>()->multitoken(),
+     "The VCF outputs of all shards of a run called with --shard")
+    ;
+    
+    po::positional_options_description positional {};
+    positional.add("shards", -1);
+    
+    po::options_description all("octopus merge options");
+    all.add(general).add(hidden);
+    
+    // argv[1] is the command name, which is skipped like a program name
+    OptionMap vm;
+    po::store(run(po::command_line_parser(argc - 1, argv + 1).options(all).positional(positional)), vm);
+    
+    if (vm.count("help") == 1) {
+        std::cout << "Usage: octopus merge [options] shard1.vcf shard2.vcf ...\n\n" << general << std::endl;
+        return vm;
+    }
+    if (vm.count("shards") == 0) {
+        throw MissingRequiredCommandLineArguement {"shards"};
+    }
+    po::notify(vm);
+    
+    return vm;
+}
+
 std::istream& operator>>(std::istream& in, ContigPloidy& result)
 {
     static const std::regex re {"(?:([^:]*):)?([^=]+)=(\\d+)"};
@@ -1094,6 +1171,36 @@ std::ostream& operator<<(std::ostream& out, const ContigPloidy& cp)
     return out;
 }
 
+std::istream& operator>>(std::istream& in, ShardRequest& result)
+{
+    static const std::regex re {"(\\d+)/(\\d+)"};
+    
+    std::string token;
+    in >> token;
+    std::smatch match;
+    
+    if (std::regex_match(token, match, re) && match.size() == 3) {
+        const auto index = boost::lexical_cast<unsigned>(match.str(1));
+        result.count = boost::lexical_cast<unsigned>(match.str(2));
+        if (index == 0 || index > result.count) {
+            using Error = po::validation_error;
+            throw Error {Error::kind_t::invalid_option_value, token, "shard"};
+        }
+        result.index = index - 1;
+    } else {
+        using Error = po::validation_error;
+        throw Error {Error::kind_t::invalid_option_value, token, "shard"};
+    }
+    
+    return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const ShardRequest& shard)
+{
+    out << (shard.index + 1) << '/' << shard.count;
+    return out;
+}
+
 std::istream& operator>>(std::istream& in, RefCallType& result)
 {
     std::string token;
@@ -16,6 +16,9 @@ using OptionMap = boost::program_options::variables_map;
 
 OptionMap parse_options(int argc, const char** argv);
 
+// Parses the options of the 'merge' command, argv[1] must be "merge"
+OptionMap parse_merge_options(int argc, const char** argv);
+
 enum class ContigOutputOrder
 {
     lexicographicalAscending, lexicographicalDescending,
@@ -31,6 +34,11 @@ struct ContigPloidy
     int ploidy;
 };
 
+struct ShardRequest
+{
+    unsigned index, count; // index is zero-based
+};
+
 enum class RefCallType { positional, blocked };
 enum class ExtensionLevel { conservative, normal, optimistic, aggressive };
 enum class PhasingLevel { minimal, conservative, moderate, normal, aggressive };
@@ -40,6 +48,8 @@ std::istream& operator>>(std::istream& in, ContigOutputOrder& coo);
 std::ostream& operator<<(std::ostream& os, const ContigOutputOrder& coo);
 std::istream& operator>>(std::istream& in, ContigPloidy& cp);
 std::ostream& operator<<(std::ostream& os, const ContigPloidy& cp);
+std::istream& operator>>(std::istream& in, ShardRequest& shard);
+std::ostream& operator<<(std::ostream& os, const ShardRequest& shard);
 std::istream& operator>>(std::istream& in, RefCallType& rct);
 std::ostream& operator<<(std::ostream& os, const RefCallType& rct);
 std::istream& operator>>(std::istream& in, ExtensionLevel& el);
@@ -12,9 +12,11 @@
 #include <cstddef>
 #include <functional>
 #include <utility>
+#include <tuple>
 
 #include "mappable_flat_set.hpp"
 #include "mappable_flat_multi_set.hpp"
+#include "basics/mappable_reference_wrapper.hpp"
 #include "utils/mappable_algorithms.hpp"
 
 namespace octopus {
@@ -314,6 +316,26 @@ copy_overlapped(const MappableMap<KeyType, typename Container::value_type, Conta
     return result;
 }
 
+/**
+ Like copy_overlapped but the result only references the overlapped elements of mappables,
+ which must therefore outlive it.
+ */
+template <typename KeyType, typename Container, typename MappableType2>
+auto
+view_overlapped(const MappableMap<KeyType, typename Container::value_type, Container>& mappables,
+                const MappableType2& mappable)
+{
+    using ReferenceType = MappableReferenceWrapper<const typename Container::value_type>;
+    MappableMap<KeyType, ReferenceType> result {mappables.size()};
+    for (const auto& p : mappables) {
+        const auto overlapped = overlap_range(p.second, mappable);
+        result.emplace(std::piecewise_construct,
+                       std::forward_as_tuple(p.first),
+                       std::forward_as_tuple(std::cbegin(overlapped), std::cend(overlapped)));
+    }
+    return result;
+}
+
 template <typename KeyType, typename Container, typename MappableType2>
 auto
 copy_contained(const MappableMap<KeyType, typename Container::value_type, Container>& mappables,
@@ -10,6 +10,7 @@
 #include <stdexcept>
 #include <cassert>
 #include <iostream>
+#include <numeric>
 
 #include "concepts/mappable.hpp"
 #include "core/types/calls/call.hpp"
@@ -18,12 +19,15 @@
 #include "core/types/calls/reference_call.hpp"
 #include "core/models/haplotype_likelihood_model.hpp"
 #include "core/tools/haplotype_filter.hpp"
+#include "core/tools/isolated_snv_screener.hpp"
 #include "core/tools/read_assigner.hpp"
 #include "core/tools/read_realigner.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/maths.hpp"
 #include "utils/append.hpp"
+#include "utils/input_reads_profiler.hpp"
+#include "utils/parallel_algorithms.hpp"
 
 namespace octopus {
 
@@ -138,14 +142,39 @@ auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& fac
     return result;
 }
 
+MemoryFootprint estimate_footprint(const ReadMap& reads) noexcept
+{
+    std::size_t result {0};
+    for (const auto& p : reads) {
+        for (const auto& read : p.second) result += estimate_read_size(read);
+    }
+    return result;
+}
+
+MemoryFootprint estimate_footprint(const std::vector<Haplotype>& haplotypes) noexcept
+{
+    return std::accumulate(std::cbegin(haplotypes), std::cend(haplotypes), std::size_t {0},
+                           [] (auto curr, const auto& haplotype) noexcept {
+                               return curr + sizeof(Haplotype) + sequence_size(haplotype);
+                           });
+}
+
+MemoryFootprint estimate_likelihoods_footprint(const std::vector<Haplotype>& haplotypes, const ReadViewMap& reads)
+{
+    using Likelihood = HaplotypeLikelihoodArray::LikelihoodVector::value_type;
+    return haplotypes.size() * count_reads(reads) * sizeof(Likelihood);
+}
+
 } // namespace
 
 std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
 {
     ReadPipe::Report reads_report {};
     ReadMap reads;
+    MemoryGovernor::Reservation reads_memory {};
     if (candidate_generator_.requires_reads()) {
         reads = read_pipe_.get().fetch_reads(expand(call_region, 100), reads_report);
+        reads_memory = reserve_memory(MemoryGovernor::Component::reads, estimate_footprint(reads));
         add_reads(reads, candidate_generator_);
         if (!refcalls_requested() && all_empty(reads)) {
             if (debug_log_) stream(*debug_log_) << "Stopping early as no reads found in call region " << call_region;
@@ -163,8 +192,17 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
     if (!candidate_generator_.requires_reads()) {
         // as we didn't fetch them earlier
         reads = read_pipe_.get().fetch_reads(call_region, reads_report);
+        reads_memory = reserve_memory(MemoryGovernor::Component::reads, estimate_footprint(reads));
+    }
+    std::deque<CallWrapper> isolated_snv_calls {};
+    if (parameters_.isolated_snv_distance && !refcalls_requested()) {
+        isolated_snv_calls = call_isolated_snvs(candidates, call_region, reads);
     }
     auto calls = call_variants(call_region, candidates, reads, reads_report, progress_meter);
+    if (!isolated_snv_calls.empty()) {
+        const auto itr = utils::append(std::move(isolated_snv_calls), calls);
+        std::inplace_merge(std::begin(calls), itr, std::end(calls));
+    }
     candidates.clear();
     candidates.shrink_to_fit();
     progress_meter.log_completed(call_region);
@@ -178,13 +216,6 @@ std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants,
     return {}; // TODO
 }
 
-auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype)
-{
-    auto result = compute_haplotype_support(genotype, reads, {AssignmentConfig::AmbiguousAction::first});
-    for (auto& p : result) realign_to_reference(p.second, p.first);
-    return result;
-}
-
 // private methods
 
 namespace debug {
@@ -314,7 +345,17 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
     boost::optional<GenomicRegion> next_active_region {}, prev_called_region {}, backtrack_region {};
     auto completed_region = head_region(call_region);
     std::deque<Haplotype> protected_haplotypes {};
+    boost::optional<GenomicRegion> speculated_region {};
+    boost::optional<HaplotypeLikelihoodArray> speculation_result {};
+    MemoryGovernor::Reservation haplotype_memory {}, likelihood_memory {}, speculation_memory {};
+    // Declared after everything the speculative task uses, so it is finished before they are destroyed
+    TaskGroup speculation {};
     while (true) {
+        // Must finish before next_haplotypes is moved from
+        speculation.wait();
+        auto speculated_likelihoods = std::move(speculation_result);
+        speculation_result = boost::none;
+        auto speculated_memory = std::move(speculation_memory);
         status = generate_active_haplotypes(call_region, haplotype_generator, active_region,
                                             next_active_region, haplotypes, next_haplotypes);
         if (status == GeneratorStatus::done) {
@@ -334,17 +375,26 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
             progress_meter.log_completed(active_region);
             continue;
         }
-        const auto active_reads = copy_overlapped(reads, active_region);
+        const auto active_reads = view_overlapped(reads, active_region);
         if (!refcalls_requested() && !has_coverage(active_reads)) {
             if (debug_log_) stream(*debug_log_) << "Skipping active region " << active_region << " as there are no active reads";
             continue;
         }
         if (debug_log_) stream(*debug_log_) << "There are " << count_reads(active_reads) << " active reads in " << active_region;
-        if (!populate(haplotype_likelihoods, active_region, haplotypes, candidates, active_reads)) {
+        if (speculated_likelihoods && speculated_region == active_region
+            && std::all_of(std::cbegin(haplotypes), std::cend(haplotypes),
+                           [&] (const auto& haplotype) { return speculated_likelihoods->contains(haplotype); })) {
+            haplotype_likelihoods = std::move(*speculated_likelihoods);
+        } else if (!populate(haplotype_likelihoods, active_region, haplotypes, candidates, active_reads)) {
             haplotype_generator.clear_progress();
             haplotype_likelihoods.clear();
             continue;
         }
+        haplotype_memory = reserve_memory(MemoryGovernor::Component::haplotypes, estimate_footprint(haplotypes));
+        likelihood_memory = reserve_memory(MemoryGovernor::Component::likelihoods,
+                                           estimate_likelihoods_footprint(haplotypes, active_reads));
+        speculated_likelihoods = boost::none;
+        speculated_memory.release();
         if (!protected_haplotypes.empty()) {
             assert(!haplotypes.empty());
             std::sort(std::begin(haplotypes), std::end(haplotypes));
@@ -375,6 +425,13 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
             haplotype_generator.clear_progress();
         }
         status = generate_next_active_haplotypes(next_haplotypes, next_active_region, backtrack_region, haplotype_generator);
+        if (status == GeneratorStatus::good && next_active_region && !next_haplotypes.empty()
+            && !is_after(*next_active_region, call_region) && can_pipeline_active_regions()) {
+            remove_duplicates(next_haplotypes);
+            speculated_region = next_active_region;
+            speculation_memory = speculate_likelihoods(*next_active_region, next_haplotypes, candidates, reads,
+                                                       speculation_result, speculation);
+        }
         if (backtrack_region) {
             // Only protect haplotypes in backtrack - or holdout - regions as these are more likely
             // to suffer from window artifacts.
@@ -388,11 +445,43 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
                           result, prev_called_region, completed_region);
         }
         haplotype_likelihoods.clear();
+        likelihood_memory.release();
         progress_meter.log_completed(completed_region);
     }
     return result;
 }
 
+std::deque<CallWrapper>
+Caller::call_isolated_snvs(MappableFlatSet<Variant>& candidates, const GenomicRegion& call_region,
+                           const ReadMap& reads) const
+{
+    std::deque<CallWrapper> result {};
+    auto snvs = find_isolated_snvs(candidates, reference_.get(), *parameters_.isolated_snv_distance);
+    snvs.erase(std::remove_if(std::begin(snvs), std::end(snvs),
+                              [&] (const Variant& snv) { return !contains(call_region, snv); }),
+               std::end(snvs));
+    if (snvs.empty()) return result;
+    if (debug_log_) stream(*debug_log_) << "Calling " << snvs.size() << " isolated SNVs in " << call_region << " without haplotype generation";
+    auto haplotype_likelihoods = make_haplotype_likelihood_cache();
+    for (const auto& snv : snvs) {
+        const auto snv_reads = view_overlapped(reads, snv);
+        if (!has_coverage(snv_reads)) continue;
+        const auto haplotypes = populate_isolated_snv_likelihoods(snv, snv_reads, samples_, reference_.get(),
+                                                                  haplotype_likelihoods);
+        const auto latents = infer_latents(haplotypes, haplotype_likelihoods);
+        auto calls = wrap(call_variants(std::vector<Variant> {snv}, *latents));
+        if (!calls.empty()) {
+            set_model_posteriors(calls, *latents, haplotypes, haplotype_likelihoods);
+            set_phasing(calls, *latents, haplotypes, call_region);
+            utils::append(std::move(calls), result);
+        }
+        haplotype_likelihoods.clear();
+    }
+    // The main path would skip uncovered SNVs too
+    candidates.erase_all(std::cbegin(snvs), std::cend(snvs));
+    return result;
+}
+
 std::size_t Caller::do_remove_duplicates(std::vector<Haplotype>& haplotypes) const
 {
     return octopus::remove_duplicates(haplotypes, Haplotype {haplotype_region(haplotypes), reference_.get()});
@@ -673,7 +762,7 @@ void Caller::call_variants(const GenomicRegion& active_region,
                            const MappableFlatSet<Variant>& candidates,
                            const std::vector<Haplotype>& haplotypes,
                            const HaplotypeLikelihoodArray& haplotype_likelihoods,
-                           const ReadMap& reads,
+                           const ReadViewMap& reads,
                            const Latents& latents,
                            std::deque<CallWrapper>& result,
                            boost::optional<GenomicRegion>& prev_called_region,
@@ -695,9 +784,7 @@ void Caller::call_variants(const GenomicRegion& active_region,
         }
         if (refcalls_requested()) {
             const auto refcall_region = right_overhang_region(uncalled_region, completed_region);
-            const auto pileups = make_pileups(reads, latents, refcall_region);
-            auto alleles = generate_reference_alleles(refcall_region, active_candidates, calls);
-            auto reference_calls = wrap(call_reference(alleles, latents, pileups));
+            auto reference_calls = call_reference(refcall_region, active_candidates, calls, reads);
             const auto itr = utils::append(std::move(reference_calls), calls);
             std::inplace_merge(std::begin(calls), itr, std::end(calls));
         }
@@ -895,7 +982,7 @@ bool Caller::populate(HaplotypeLikelihoodArray& haplotype_likelihoods,
                       const GenomicRegion& active_region,
                       const std::vector<Haplotype>& haplotypes,
                       const MappableFlatSet<Variant>& candidates,
-                      const ReadMap& active_reads) const
+                      const ReadViewMap& active_reads) const
 {
     assert(haplotype_likelihoods.is_empty());
     boost::optional<HaplotypeLikelihoodArray::FlankState> flank_state {};
@@ -927,13 +1014,76 @@ bool Caller::populate(HaplotypeLikelihoodArray& haplotype_likelihoods,
     return true;
 }
 
+MemoryGovernor::Reservation Caller::reserve_memory(MemoryGovernor::Component component, MemoryFootprint footprint) const
+{
+    if (parameters_.memory_governor) {
+        return parameters_.memory_governor->reserve(component, footprint);
+    }
+    return {};
+}
+
+bool Caller::can_pipeline_active_regions() const noexcept
+{
+    // Speculative population would interleave the debug and trace logs, and without pool workers it
+    // would just run ahead serially
+    return parameters_.pipeline_active_regions && !debug_log_ && !trace_log_ && !shared_thread_pool().empty();
+}
+
+// Populates result for the next active region on the shared pool, and returns the reservation for
+// the likelihoods. Nothing is speculated if the likelihoods do not fit in the memory budget.
+// next_haplotypes must not be modified until speculation has finished.
+MemoryGovernor::Reservation
+Caller::speculate_likelihoods(const GenomicRegion& next_active_region,
+                              const std::vector<Haplotype>& next_haplotypes,
+                              const MappableFlatSet<Variant>& candidates,
+                              const ReadMap& reads,
+                              boost::optional<HaplotypeLikelihoodArray>& result,
+                              TaskGroup& speculation) const
+{
+    auto next_active_reads = view_overlapped(reads, next_active_region);
+    auto memory = reserve_memory(MemoryGovernor::Component::likelihoods,
+                                 estimate_likelihoods_footprint(next_haplotypes, next_active_reads));
+    if (parameters_.memory_governor && parameters_.memory_governor->headroom() == 0) {
+        return {};
+    }
+    speculation.run([this, next_active_region, next_active_reads = std::move(next_active_reads),
+                     &next_haplotypes, &candidates, &result] () {
+        result = make_haplotype_likelihood_cache();
+        if (!populate(*result, next_active_region, next_haplotypes, candidates, next_active_reads)) {
+            result = boost::none;
+        }
+    });
+    return memory;
+}
+
+unsigned Caller::max_filtered_haplotypes(const std::vector<Haplotype>& haplotypes,
+                                         const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    if (!parameters_.haplotype_cost_model || haplotypes.empty()) return parameters_.max_haplotypes;
+    std::size_t num_reads {0};
+    for (const auto& sample : samples_) {
+        num_reads += haplotype_likelihoods(sample, haplotypes.front()).size();
+    }
+    const auto haplotype_length = region_size(haplotypes.front());
+    const auto max_haplotypes = parameters_.haplotype_cost_model->max_haplotypes(num_reads, haplotype_length);
+    if (max_haplotypes >= parameters_.max_haplotypes) return parameters_.max_haplotypes;
+    const auto result = std::max(static_cast<unsigned>(max_haplotypes), 2u);
+    if (debug_log_) {
+        stream(*debug_log_) << "Region time budget reduced the haplotype filter limit in " << mapped_region(haplotypes.front())
+                            << " (" << num_reads << " reads, haplotype length " << haplotype_length << ") to " << result;
+    }
+    report_budget_reduction(mapped_region(haplotypes.front()), result);
+    return result;
+}
+
 std::vector<Haplotype>
 Caller::filter(std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArray& haplotype_likelihoods,
                const std::deque<Haplotype>& protected_haplotypes) const
 {
     std::vector<Haplotype> removed_haplotypes {};
+    const auto max_haplotypes = max_filtered_haplotypes(haplotypes, haplotype_likelihoods);
     if (protected_haplotypes.empty()) {
-        removed_haplotypes = filter_to_n(haplotypes, samples_, haplotype_likelihoods, parameters_.max_haplotypes);
+        removed_haplotypes = filter_to_n(haplotypes, samples_, haplotype_likelihoods, max_haplotypes);
     } else {
         if (debug_log_) {
             stream(*debug_log_) << "Protecting " << protected_haplotypes.size() << " haplotypes from filtering";
@@ -949,7 +1099,7 @@ Caller::filter(std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArra
         std::set_intersection(std::cbegin(haplotypes), std::cend(haplotypes),
                               std::cbegin(protected_haplotypes), std::cend(protected_haplotypes),
                               std::back_inserter(protected_copies));
-        removed_haplotypes = filter_to_n(removable_haplotypes, samples_, haplotype_likelihoods, parameters_.max_haplotypes);
+        removed_haplotypes = filter_to_n(removable_haplotypes, samples_, haplotype_likelihoods, max_haplotypes);
         haplotypes = std::move(removable_haplotypes);
         std::sort(std::begin(haplotypes), std::end(haplotypes));
         merge_unique(std::move(protected_copies), haplotypes);
@@ -1026,23 +1176,28 @@ bool Caller::done_calling(const GenomicRegion& region) const noexcept
     return is_empty(region);
 }
 
+const ReferenceConfidenceEngine* Caller::reference_confidence_engine() const
+{
+    std::call_once(reference_confidence_engine_flag_, [this] () {
+        const auto ploidy = do_reference_call_ploidy();
+        if (!ploidy) return;
+        ReferenceConfidenceEngine::Parameters parameters {};
+        if (parameters_.refcall_type == RefCallType::positional) {
+            parameters.resolution = ReferenceConfidenceEngine::Resolution::positional;
+        } else {
+            parameters.resolution = ReferenceConfidenceEngine::Resolution::blocked;
+        }
+        parameters.min_call_posterior = parameters_.min_refcall_posterior;
+        reference_confidence_engine_ = ReferenceConfidenceEngine {reference_, samples_, *ploidy, std::move(parameters)};
+    });
+    return reference_confidence_engine_ ? std::addressof(*reference_confidence_engine_) : nullptr;
+}
+
 std::vector<CallWrapper> Caller::call_reference(const GenomicRegion& region, const ReadMap& reads) const
 {
-    const auto active_reads = copy_overlapped(reads, region);
-    auto haplotype_likelihoods = make_haplotype_likelihood_cache();
-    std::vector<Haplotype> haplotypes;
-    if (has_coverage(active_reads)) {
-        const auto active_reads_region = encompassing_region(active_reads);
-        const auto haplotype_region = expand(active_reads_region, HaplotypeLikelihoodModel{}.pad_requirement());
-        haplotypes.emplace_back(haplotype_region, reference_);
-    } else {
-        haplotypes.emplace_back(region, reference_);
-    }
-    haplotype_likelihoods.populate(active_reads, haplotypes);
-    const auto latents = infer_latents(haplotypes, haplotype_likelihoods);
-    const auto pileups = make_pileups(active_reads, *latents, region);
-    const auto alleles = generate_reference_alleles(region);
-    return wrap(call_reference(alleles, *latents, pileups));
+    const auto engine = reference_confidence_engine();
+    if (!engine) return {};
+    return wrap(engine->call(region, reads));
 }
 
 namespace {
@@ -1099,78 +1254,16 @@ auto extract_uncalled_reference_regions(const GenomicRegion& region,
     return result;
 }
 
-auto make_positional_reference_alleles(const std::vector<GenomicRegion>& regions, const ReferenceGenome& reference)
-{
-    std::vector<Allele> result {};
-    result.reserve(sum_region_sizes(regions));
-    for (const auto& region : regions) {
-        utils::append(make_positional_reference_alleles(region, reference), result);
-    }
-    return result;
-}
-
-} // namespace
-
-std::vector<Allele>
-Caller::generate_reference_alleles(const GenomicRegion& region,
-                                   const std::vector<Variant>& candidates,
-                                   const std::vector<CallWrapper>& calls) const
-{
-    auto refcall_regions = extract_uncalled_reference_regions(region, candidates, calls);
-    if (parameters_.refcall_type == RefCallType::positional) {
-        return make_positional_reference_alleles(std::move(refcall_regions), reference_);
-    } else {
-        return make_reference_alleles(std::move(refcall_regions), reference_);
-    }
-}
-
-std::vector<Allele> Caller::generate_reference_alleles(const GenomicRegion& region) const
-{
-    return generate_reference_alleles(region, {}, {});
-}
-
-namespace {
-
-auto overlap_range(std::vector<ReadPileup>& pileups, const AlignedRead& read)
-{
-    return overlap_range(std::begin(pileups), std::end(pileups), contig_region(read), BidirectionallySortedTag {});
-}
-
 } // namespace
 
-auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+std::vector<CallWrapper>
+Caller::call_reference(const GenomicRegion& region, const std::vector<Variant>& candidates,
+                       const std::vector<CallWrapper>& calls, const ReadViewMap& reads) const
 {
-    const auto realignments = assign_and_realign(reads, genotype);
-    ReadPileups result {};
-    result.reserve(size(region));
-    for (auto position = region.begin(); position < region.end(); ++position) {
-        result.emplace_back(position);
-    }
-    for (const auto& p : realignments) {
-        for (const auto& read : p.second) {
-            for (ReadPileup& pileup : overlap_range(result, read)) {
-                pileup.add(read);
-            }
-        }
-    }
-    return result;
-}
-
-auto make_pileups(const ReadContainer& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
-{
-    const std::vector<AlignedRead> copy {std::cbegin(reads), std::cend(reads)};
-    return make_pileups(copy, genotype, region);
-}
-
-Caller::ReadPileupMap Caller::make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const
-{
-    ReadPileupMap result {};
-    result.reserve(samples_.size());
-    for (const auto& sample : samples_) {
-        const auto called_genotype = call_genotype(latents, sample);
-        result.emplace(sample, octopus::make_pileups(reads.at(sample), called_genotype, region));
-    }
-    return result;
+    const auto engine = reference_confidence_engine();
+    if (!engine) return {};
+    const auto refcall_regions = extract_uncalled_reference_regions(region, candidates, calls);
+    return wrap(engine->call(refcall_regions, reads));
 }
 
 namespace debug {
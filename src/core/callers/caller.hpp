@@ -11,6 +11,7 @@
 #include <deque>
 #include <typeindex>
 #include <set>
+#include <mutex>
 
 #include <boost/optional.hpp>
 
@@ -28,13 +29,15 @@
 #include "logging/logging.hpp"
 #include "io/variant/vcf_record.hpp"
 #include "core/tools/vcf_record_factory.hpp"
-#include "basics/read_pileup.hpp"
+#include "core/tools/reference_confidence_engine.hpp"
 #include "utils/memory_footprint.hpp"
+#include "utils/memory_governor.hpp"
 
 namespace octopus {
 
 class Call;
 struct CallWrapper;
+class TaskGroup;
 class VariantCall;
 class ReferenceCall;
 
@@ -110,12 +113,17 @@ public:
     struct Parameters
     {
         RefCallType refcall_type;
+        Phred<double> min_refcall_posterior;
         bool call_sites_only;
         unsigned max_haplotypes;
         Phred<double> haplotype_extension_threshold, saturation_limit;
         bool allow_model_filtering;
         bool protect_reference_haplotype;
         boost::optional<MemoryFootprint> target_max_memory;
+        bool pipeline_active_regions;
+        boost::optional<GenomicRegion::Size> isolated_snv_distance;
+        boost::optional<HaplotypeCostModel> haplotype_cost_model;
+        std::shared_ptr<MemoryGovernor> memory_governor;
     };
     
 private:
@@ -129,6 +137,8 @@ private:
     HaplotypeLikelihoodModel likelihood_model_;
     Phaser phaser_;
     Parameters parameters_;
+    mutable std::once_flag reference_confidence_engine_flag_;
+    mutable boost::optional<ReferenceConfidenceEngine> reference_confidence_engine_;
     
     // virtual methods
     
@@ -136,12 +146,12 @@ private:
     virtual CallTypeSet do_call_types() const = 0;
     virtual unsigned do_min_callable_ploidy() const { return 1; }
     virtual unsigned do_max_callable_ploidy() const { return min_callable_ploidy(); };
+    // Callers that can make reference calls return the ploidy to make them with; the default is no refcalls
+    virtual boost::optional<unsigned> do_reference_call_ploidy() const { return boost::none; }
 
 protected:
     virtual std::size_t do_remove_duplicates(std::vector<Haplotype>& haplotypes) const;
     
-    using ReadPileupMap = std::unordered_map<SampleName, ReadPileups>;
-    
     boost::optional<MemoryFootprint> target_max_memory() const noexcept;
 
 private:
@@ -159,27 +169,34 @@ private:
     virtual std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const = 0;
     
-    virtual std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Latents& latents,
-                   const ReadPileupMap& pileups) const = 0;
-    
     // helper methods
     
     std::deque<CallWrapper>
     call_variants(const GenomicRegion& call_region,  const MappableFlatSet<Variant>& candidates,
                   const ReadMap& reads, const ReadPipe::Report& read_report, ProgressMeter& progress_meter) const;
+    std::deque<CallWrapper>
+    call_isolated_snvs(MappableFlatSet<Variant>& candidates, const GenomicRegion& call_region,
+                       const ReadMap& reads) const;
     bool refcalls_requested() const noexcept;
     MappableFlatSet<Variant> generate_candidate_variants(const GenomicRegion& region) const;
     HaplotypeGenerator make_haplotype_generator(const MappableFlatSet<Variant>& candidates, const ReadMap& reads,
                                                 const ReadPipe::Report& read_report) const;
     HaplotypeLikelihoodArray make_haplotype_likelihood_cache() const;
     VcfRecordFactory make_record_factory(const ReadMap& reads) const;
+    unsigned max_filtered_haplotypes(const std::vector<Haplotype>& haplotypes,
+                                     const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     std::vector<Haplotype>
     filter(std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArray& haplotype_likelihoods,
            const std::deque<Haplotype>& protected_haplotypes) const;
     bool populate(HaplotypeLikelihoodArray& haplotype_likelihoods, const GenomicRegion& active_region,
                   const std::vector<Haplotype>& haplotypes, const MappableFlatSet<Variant>& candidates,
-                  const ReadMap& active_reads) const;
+                  const ReadViewMap& active_reads) const;
+    MemoryGovernor::Reservation reserve_memory(MemoryGovernor::Component component, MemoryFootprint footprint) const;
+    bool can_pipeline_active_regions() const noexcept;
+    MemoryGovernor::Reservation
+    speculate_likelihoods(const GenomicRegion& next_active_region, const std::vector<Haplotype>& next_haplotypes,
+                          const MappableFlatSet<Variant>& candidates, const ReadMap& reads,
+                          boost::optional<HaplotypeLikelihoodArray>& result, TaskGroup& speculation) const;
     std::vector<std::reference_wrapper<const Haplotype>>
     get_removable_haplotypes(const std::vector<Haplotype>& haplotypes, const HaplotypeLikelihoodArray& haplotype_likelihoods,
                              const Latents::HaplotypeProbabilityMap& haplotype_posteriors,
@@ -206,7 +223,7 @@ private:
                        const boost::optional<GenomicRegion>& next_active_region,
                        const boost::optional<GenomicRegion>& backtrack_region,
                        const MappableFlatSet<Variant>& candidates, const std::vector<Haplotype>& haplotypes,
-                       const HaplotypeLikelihoodArray& haplotype_likelihoods, const ReadMap& reads,
+                       const HaplotypeLikelihoodArray& haplotype_likelihoods, const ReadViewMap& reads,
                        const Latents& latents, std::deque<CallWrapper>& result,
                        boost::optional<GenomicRegion>& prev_called_region, GenomicRegion& completed_region) const;
     GenotypeCallMap get_genotype_calls(const Latents& latents) const;
@@ -217,13 +234,11 @@ private:
     void set_phasing(std::vector<CallWrapper>& calls, const Latents& latents,
                      const std::vector<Haplotype>& haplotypes, const GenomicRegion& call_region) const;
     bool done_calling(const GenomicRegion& region) const noexcept;
+    const ReferenceConfidenceEngine* reference_confidence_engine() const;
     std::vector<CallWrapper> call_reference(const GenomicRegion& region, const ReadMap& reads) const;
-    std::vector<Allele>
-    generate_reference_alleles(const GenomicRegion& region,
-                               const std::vector<Variant>& candidates,
-                               const std::vector<CallWrapper>& calls) const;
-    std::vector<Allele> generate_reference_alleles(const GenomicRegion& region) const;
-    ReadPileupMap make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const;
+    std::vector<CallWrapper>
+    call_reference(const GenomicRegion& region, const std::vector<Variant>& candidates,
+                   const std::vector<CallWrapper>& calls, const ReadViewMap& reads) const;
 };
 
 } // namespace octopus
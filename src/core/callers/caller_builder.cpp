@@ -20,11 +20,13 @@ CallerBuilder::CallerBuilder(const ReferenceGenome& reference, const ReadPipe& r
 , factory_ {}
 {
     params_.general.refcall_type = Caller::RefCallType::none;
+    params_.general.min_refcall_posterior = Phred<> {2.0};
     params_.general.call_sites_only = false;
     params_.general.allow_model_filtering = false;
     params_.general.haplotype_extension_threshold = Phred<> {150.0};
     params_.general.saturation_limit = Phred<> {10.0};
     params_.general.max_haplotypes = 200;
+    params_.general.pipeline_active_regions = false;
     factory_ = generate_factory();
 }
 
@@ -115,6 +117,30 @@ CallerBuilder& CallerBuilder::set_target_memory_footprint(MemoryFootprint memory
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_memory_governor(std::shared_ptr<MemoryGovernor> governor) noexcept
+{
+    params_.general.memory_governor = std::move(governor);
+    return *this;
+}
+
+CallerBuilder& CallerBuilder::set_active_region_pipelining(bool b) noexcept
+{
+    params_.general.pipeline_active_regions = b;
+    return *this;
+}
+
+CallerBuilder& CallerBuilder::set_isolated_snv_distance(unsigned distance) noexcept
+{
+    params_.general.isolated_snv_distance = distance;
+    return *this;
+}
+
+CallerBuilder& CallerBuilder::set_haplotype_cost_model(HaplotypeCostModel model) noexcept
+{
+    params_.general.haplotype_cost_model = std::move(model);
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_min_variant_posterior(Phred<double> posterior) noexcept
 {
     params_.min_variant_posterior = posterior;
@@ -123,7 +149,7 @@ CallerBuilder& CallerBuilder::set_min_variant_posterior(Phred<double> posterior)
 
 CallerBuilder& CallerBuilder::set_min_refcall_posterior(Phred<double> posterior) noexcept
 {
-    params_.min_refcall_posterior = posterior;
+    params_.general.min_refcall_posterior = posterior;
     return *this;
 }
 
@@ -369,7 +395,6 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
                                                           params_.ploidies.of(samples.front(), *requested_contig_),
                                                           make_individual_prior_model(params_.snp_heterozygosity, params_.indel_heterozygosity),
                                                           params_.min_variant_posterior,
-                                                          params_.min_refcall_posterior,
                                                           params_.deduplicate_haplotypes_with_caller_model
                                                       });
         }},
@@ -378,7 +403,6 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
                                                       params_.general,
                                                       PopulationCaller::Parameters {
                                                           params_.min_variant_posterior,
-                                                          params_.min_refcall_posterior,
                                                           get_ploidies(samples, *requested_contig_, params_.ploidies),
                                                           make_population_prior_model(params_.snp_heterozygosity, params_.indel_heterozygosity),
                                                           params_.max_joint_genotypes,
@@ -390,7 +414,6 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
             CancerCaller::Parameters cancer_params {
                 params_.min_variant_posterior,
                 params_.min_somatic_posterior,
-                params_.min_refcall_posterior,
                 params_.ploidies.of(samples.front(), *requested_contig_),
                 params_.normal_sample,
                 make_cancer_prior_model(params_.snp_heterozygosity, params_.indel_heterozygosity),
@@ -419,7 +442,6 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
                                                     {*params_.snv_denovo_mutation_rate, *params_.indel_denovo_mutation_rate},
                                                     params_.min_variant_posterior,
                                                     params_.min_denovo_posterior,
-                                                    params_.min_refcall_posterior,
                                                     params_.max_joint_genotypes,
                                                     params_.deduplicate_haplotypes_with_caller_model
                                                 });
@@ -430,7 +452,6 @@ CallerBuilder::CallerFactoryMap CallerBuilder::generate_factory() const
                                                      PolycloneCaller::Parameters {
                                                          make_individual_prior_model(params_.snp_heterozygosity, params_.indel_heterozygosity),
                                                          params_.min_variant_posterior,
-                                                         params_.min_refcall_posterior,
                                                          params_.deduplicate_haplotypes_with_caller_model,
                                                          params_.max_clones,
                                                          params_.max_genotypes
@@ -52,6 +52,10 @@ public:
     CallerBuilder& set_sites_only() noexcept;
     CallerBuilder& set_reference_haplotype_protection(bool b) noexcept;
     CallerBuilder& set_target_memory_footprint(MemoryFootprint memory) noexcept;
+    CallerBuilder& set_memory_governor(std::shared_ptr<MemoryGovernor> governor) noexcept;
+    CallerBuilder& set_active_region_pipelining(bool b) noexcept;
+    CallerBuilder& set_isolated_snv_distance(unsigned distance) noexcept;
+    CallerBuilder& set_haplotype_cost_model(HaplotypeCostModel model) noexcept;
     
     CallerBuilder& set_min_variant_posterior(Phred<double> posterior) noexcept;
     CallerBuilder& set_min_refcall_posterior(Phred<double> posterior) noexcept;
@@ -110,7 +114,7 @@ private:
         // common
         Caller::Parameters general;
         PloidyMap ploidies;
-        Phred<double> min_variant_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior;
         boost::optional<double> snp_heterozygosity, indel_heterozygosity;
         Phred<double> min_phase_score;
         unsigned max_genotypes, max_joint_genotypes;
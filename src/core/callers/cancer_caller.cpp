@@ -1474,12 +1474,6 @@ double CancerCaller::calculate_somatic_mass(const CancerCaller::Latents& latents
                                          parameters_.min_expected_somatic_frequency);
 }
 
-std::vector<std::unique_ptr<ReferenceCall>>
-CancerCaller::call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents, const ReadPileupMap& pileups) const
-{
-    return {};
-}
-
 std::unique_ptr<GenotypePriorModel> CancerCaller::make_germline_prior_model(const std::vector<Haplotype>& haplotypes) const
 {
     if (parameters_.germline_prior_model_params) {
@@ -55,7 +55,7 @@ public:
             SomaticModelConcentrations somatic;
         };
         
-        Phred<double> min_variant_posterior, min_somatic_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior, min_somatic_posterior;
         unsigned ploidy;
         boost::optional<SampleName> normal_sample;
         boost::optional<CoalescentModel::Parameters> germline_prior_model_params;
@@ -129,10 +129,6 @@ private:
     std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const;
     
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                   const ReadPileupMap& pileups) const override;
-    
     bool has_normal_sample() const noexcept;
     const SampleName& normal_sample() const;
     
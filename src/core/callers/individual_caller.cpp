@@ -55,6 +55,11 @@ unsigned IndividualCaller::do_min_callable_ploidy() const
     return parameters_.ploidy;
 }
 
+boost::optional<unsigned> IndividualCaller::do_reference_call_ploidy() const
+{
+    return parameters_.ploidy;
+}
+
 std::size_t IndividualCaller::do_remove_duplicates(std::vector<Haplotype>& haplotypes) const
 {
     if (parameters_.deduplicate_haplotypes_with_germline_model) {
@@ -124,15 +129,15 @@ std::unique_ptr<IndividualCaller::Caller::Latents>
 IndividualCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
                                 const HaplotypeLikelihoodArray& haplotype_likelihoods) const
 {
-    std::vector<GenotypeIndex> genotype_indices {};
-    auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidy, genotype_indices);
+    auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidy);
     if (debug_log_) stream(*debug_log_) << "There are " << genotypes.size() << " candidate genotypes";
     auto prior_model = make_prior_model(haplotypes);
     prior_model->prime(haplotypes);
     model::IndividualModel model {*prior_model, debug_log_};
     model.prime(haplotypes);
     haplotype_likelihoods.prime(sample());
-    auto inferences = model.evaluate(genotypes, genotype_indices, haplotype_likelihoods);
+    const GenotypeIndexRange genotype_indices {static_cast<unsigned>(haplotypes.size()), parameters_.ploidy};
+    auto inferences = model.evaluate(genotype_indices, haplotype_likelihoods);
     return std::make_unique<Latents>(sample(), haplotypes, std::move(genotypes), std::move(inferences));
 }
 
@@ -160,9 +165,11 @@ IndividualCaller::calculate_model_posterior(const std::vector<Haplotype>& haplot
                                             const HaplotypeLikelihoodArray& haplotype_likelihoods,
                                             const Latents& latents) const
 {
-    const auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidy + 1);
+    const GenotypeIndexRange genotypes {static_cast<unsigned>(haplotypes.size()), parameters_.ploidy + 1};
     const auto prior_model = make_prior_model(haplotypes);
-    const model::IndividualModel model {*prior_model, debug_log_};
+    prior_model->prime(haplotypes);
+    model::IndividualModel model {*prior_model, debug_log_};
+    model.prime(haplotypes);
     haplotype_likelihoods.prime(sample());
     const auto inferences = model.evaluate(genotypes, haplotype_likelihoods);
     return octopus::calculate_model_posterior(latents.model_log_evidence_, inferences.log_evidence);
@@ -385,108 +392,6 @@ IndividualCaller::call_variants(const std::vector<Variant>& candidates,
     return transform_calls(sample(), std::move(variant_calls), std::move(genotype_calls));
 }
 
-namespace {
-
-// reference genotype calling
-
-struct RefCall
-{
-    Allele reference_allele;
-    Phred<double> posterior;
-};
-
-const GenomicRegion& mapped_region(const GenotypeProbabilityMap& genotype_posteriors)
-{
-    return mapped_region(std::cbegin(genotype_posteriors)->first);
-}
-
-bool has_variation(const Allele& allele, const GenotypeProbabilityMap& genotype_posteriors)
-{
-    if (!genotype_posteriors.empty() && !contains(mapped_region(genotype_posteriors), allele)) {
-        return false;
-    }
-    return std::any_of(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors),
-                       [&allele] (const auto& p) {
-                           return !is_homozygous(p.first, allele);
-                       });
-}
-
-auto marginalise_homozygous(const Allele& allele, const GenotypeProbabilityMap& genotype_posteriors)
-{
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors), 0.0,
-                             [&] (const auto curr, const auto& p) {
-                                 return curr + (is_homozygous(p.first, allele) ? 0.0 : p.second);
-                             });
-    return probability_to_phred(p);
-}
-
-auto mean_depth(const ReadPileups& pileups, const GenomicRegion& region)
-{
-    const auto overlapped = overlap_range(pileups, region.contig_region());
-    return maths::mean(overlapped, [] (const auto& pileup) { return pileup.depth(); });
-}
-
-auto compute_homozygous_posterior(const Allele& allele,
-                                  const GenotypeProbabilityMap& genotype_posteriors,
-                                  const ReadPileups& pileups)
-{
-    if (has_variation(allele, genotype_posteriors)) {
-        return marginalise_homozygous(allele, genotype_posteriors);
-    } else {
-        const auto coverage = mean_depth(pileups, mapped_region(allele));
-        return Phred<double> {2 * static_cast<double>(coverage)};
-    }
-}
-
-auto call_reference(const std::vector<Allele>& reference_alleles,
-                    const GenotypeProbabilityMap& genotype_posteriors,
-                    const ReadPileups& pileups,
-                    const Phred<double> min_call_posterior)
-{
-    std::vector<RefCall> result {};
-    for (const auto& allele : reference_alleles) {
-        const auto posterior = compute_homozygous_posterior(allele, genotype_posteriors, pileups);
-        if (posterior >= min_call_posterior) {
-            result.push_back({allele, posterior});
-        }
-    }
-    return result;
-}
-
-auto transform_calls(std::vector<RefCall>&& calls, const SampleName& sample, const unsigned ploidy)
-{
-    std::vector<std::unique_ptr<ReferenceCall>> result {};
-    result.reserve(calls.size());
-    std::transform(std::make_move_iterator(std::begin(calls)), std::make_move_iterator(std::end(calls)),
-                   std::back_inserter(result),
-                   [&] (auto&& call) {
-                       std::map<SampleName, ReferenceCall::GenotypeCall> genotype {{sample, {ploidy, call.posterior}}};
-                       return std::make_unique<ReferenceCall>(std::move(call.reference_allele), call.posterior, std::move(genotype));
-                   });
-    return result;
-}
-
-} // namespace
-
-std::vector<std::unique_ptr<ReferenceCall>>
-IndividualCaller::call_reference(const std::vector<Allele>& alleles,
-                                 const Caller::Latents& latents,
-                                 const ReadPileupMap& pileups) const
-{
-    return call_reference(alleles, dynamic_cast<const Latents&>(latents), pileups);
-}
-
-std::vector<std::unique_ptr<ReferenceCall>>
-IndividualCaller::call_reference(const std::vector<Allele>& alleles,
-                                 const Latents& latents,
-                                 const ReadPileupMap& pileups) const
-{
-    const auto& genotype_posteriors = (*latents.genotype_posteriors_)[sample()];
-    auto calls = octopus::call_reference(alleles, genotype_posteriors, pileups.at(sample()),
-                                         parameters_.min_refcall_posterior);
-    return transform_calls(std::move(calls), sample(), parameters_.ploidy);
-}
-
 const SampleName& IndividualCaller::sample() const noexcept
 {
     return samples_.front();
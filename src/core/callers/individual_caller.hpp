@@ -36,7 +36,7 @@ public:
     {
         unsigned ploidy;
         boost::optional<CoalescentModel::Parameters> prior_model_params;
-        Phred<double> min_variant_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior;
         bool deduplicate_haplotypes_with_germline_model = false;
     };
     
@@ -61,6 +61,7 @@ private:
     std::string do_name() const override;
     CallTypeSet do_call_types() const override;
     unsigned do_min_callable_ploidy() const override;
+    boost::optional<unsigned> do_reference_call_ploidy() const override;
     
     std::size_t do_remove_duplicates(std::vector<Haplotype>& haplotypes) const override;
     
@@ -84,14 +85,6 @@ private:
     std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const;
     
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                   const ReadPileupMap& pileups) const override;
-    
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Latents& latents,
-                   const ReadPileupMap& pileups) const;
-    
     const SampleName& sample() const noexcept;
     
     std::unique_ptr<GenotypePriorModel> make_prior_model(const std::vector<Haplotype>& haplotypes) const;
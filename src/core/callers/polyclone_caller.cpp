@@ -463,18 +463,6 @@ PolycloneCaller::call_variants(const std::vector<Variant>& candidates, const Lat
     return transform_calls(sample(), std::move(variant_calls), std::move(genotype_calls));
 }
 
-std::vector<std::unique_ptr<ReferenceCall>>
-PolycloneCaller::call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents, const ReadPileupMap& pileup) const
-{
-    return call_reference(alleles, dynamic_cast<const Latents&>(latents), pileup);
-}
-
-std::vector<std::unique_ptr<ReferenceCall>>
-PolycloneCaller::call_reference(const std::vector<Allele>& alleles, const Latents& latents, const ReadPileupMap& pileup) const
-{
-    return {};
-}
-
 const SampleName& PolycloneCaller::sample() const noexcept
 {
     return samples_.front();
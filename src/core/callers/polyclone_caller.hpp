@@ -38,7 +38,7 @@ public:
     struct Parameters
     {
         boost::optional<CoalescentModel::Parameters> prior_model_params;
-        Phred<double> min_variant_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior;
         bool deduplicate_haplotypes_with_germline_model = false;
         unsigned max_clones = 3, max_genotypes = 10'000;
         std::function<double(unsigned)> clonality_prior = [] (unsigned clonality) { return maths::geometric_pdf(clonality, 0.5); };
@@ -95,14 +95,6 @@ private:
     std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const;
     
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                   const ReadPileupMap& pileup) const override;
-    
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Latents& latents,
-                   const ReadPileupMap& pileup) const;
-    
     const SampleName& sample() const noexcept;
     
     std::unique_ptr<GenotypePriorModel> make_prior_model(const std::vector<Haplotype>& haplotypes) const;
@@ -727,14 +727,6 @@ using RefCalls = std::vector<RefCall>;
 //    }
 } // namespace
 
-std::vector<std::unique_ptr<ReferenceCall>>
-PopulationCaller::call_reference(const std::vector<Allele>& alleles,
-                                 const Caller::Latents& latents,
-                                 const ReadPileupMap& pileups) const
-{
-    return {};
-}
-
 bool PopulationCaller::use_independence_model() const noexcept
 {
     return parameters_.use_independent_genotype_priors || !parameters_.prior_model_params;
@@ -748,10 +740,10 @@ PopulationCaller::infer_latents_with_joint_model(const std::vector<Haplotype>& h
     prior_model->prime(haplotypes);
     const model::PopulationModel model {*prior_model, {parameters_.max_joint_genotypes}, debug_log_};
     if (parameters_.ploidies.size() == 1) {
-        std::vector<GenotypeIndex> genotype_indices;
-        auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidies.front(), genotype_indices);
-        if (debug_log_) stream(*debug_log_) << "There are " << genotypes.size() << " candidate genotypes";
-        auto inferences = model.evaluate(samples_, genotypes, genotype_indices, haplotypes, haplotype_likelihoods);
+        const GenotypeIndexRange genotype_indices {static_cast<unsigned>(haplotypes.size()), parameters_.ploidies.front()};
+        if (debug_log_) stream(*debug_log_) << "There are " << genotype_indices.size() << " candidate genotypes";
+        auto inferences = model.evaluate(samples_, genotype_indices, haplotypes, haplotype_likelihoods);
+        auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidies.front());
         return std::make_unique<Latents>(samples_, haplotypes, std::move(genotypes), std::move(inferences));
     } else {
         auto unique_genotypes = generate_unique_genotypes(haplotypes, parameters_.ploidies);
@@ -34,7 +34,7 @@ public:
     
     struct Parameters
     {
-        Phred<double> min_variant_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior;
         std::vector<unsigned> ploidies;
         boost::optional<CoalescentModel::Parameters> prior_model_params;
         std::size_t max_joint_genotypes;
@@ -77,10 +77,6 @@ private:
     std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const;
     
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                   const ReadPileupMap& pileups) const override;
-    
     bool use_independence_model() const noexcept;
     std::unique_ptr<Caller::Latents>
     infer_latents_with_joint_model(const std::vector<Haplotype>& haplotypes,
@@ -406,11 +406,11 @@ TrioCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
         TrioModel::Options {parameters_.max_joint_genotypes},
         debug_log_
     };
-    std::vector<std::vector<unsigned>> genotype_indices {};
-    auto maternal_genotypes = generate_all_genotypes(haplotypes, parameters_.maternal_ploidy, genotype_indices);
+    auto maternal_genotypes = generate_all_genotypes(haplotypes, parameters_.maternal_ploidy);
     if (parameters_.maternal_ploidy == parameters_.paternal_ploidy) {
         germline_prior_model->prime(haplotypes);
         denovo_model.prime(haplotypes);
+        const GenotypeIndexRange genotype_indices {static_cast<unsigned>(haplotypes.size()), parameters_.maternal_ploidy};
         auto latents = model.evaluate(maternal_genotypes, genotype_indices, haplotype_likelihoods);
         return std::make_unique<Latents>(haplotypes, std::move(maternal_genotypes),
                                          std::move(latents), parameters_.trio);
@@ -460,8 +460,8 @@ TrioCaller::calculate_model_posterior(const std::vector<Haplotype>& haplotypes,
 {
     const auto max_ploidy = std::max({parameters_.maternal_ploidy, parameters_.paternal_ploidy, parameters_.child_ploidy});
     if (max_ploidy + 1 <= model::TrioModel::max_ploidy()) {
-        std::vector<std::vector<unsigned>> genotype_indices {};
-        const auto genotypes = generate_all_genotypes(haplotypes, max_ploidy + 1, genotype_indices);
+        const auto genotypes = generate_all_genotypes(haplotypes, max_ploidy + 1);
+        const GenotypeIndexRange genotype_indices {static_cast<unsigned>(haplotypes.size()), max_ploidy + 1};
         const auto germline_prior_model = make_prior_model(haplotypes);
         DeNovoModel denovo_model {parameters_.denovo_model_params};
         germline_prior_model->prime(haplotypes);
@@ -1045,20 +1045,6 @@ TrioCaller::call_variants(const std::vector<Variant>& candidates, const Latents&
                       parameters_.trio, candidates);
 }
 
-std::vector<std::unique_ptr<ReferenceCall>>
-TrioCaller::call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                           const ReadPileupMap& pileups) const
-{
-    return call_reference(alleles, dynamic_cast<const Latents&>(latents), pileups);
-}
-
-std::vector<std::unique_ptr<ReferenceCall>>
-TrioCaller::call_reference(const std::vector<Allele>& alleles, const Latents& latents,
-                           const ReadPileupMap& pileups) const
-{
-    return {};
-}
-
 std::unique_ptr<PopulationPriorModel> TrioCaller::make_prior_model(const std::vector<Haplotype>& haplotypes) const
 {
     if (parameters_.germline_prior_model_params) {
@@ -33,7 +33,7 @@ public:
         unsigned maternal_ploidy, paternal_ploidy, child_ploidy;
         boost::optional<CoalescentModel::Parameters> germline_prior_model_params;
         DeNovoModel::Parameters denovo_model_params;
-        Phred<double> min_variant_posterior, min_denovo_posterior, min_refcall_posterior;
+        Phred<double> min_variant_posterior, min_denovo_posterior;
         unsigned max_joint_genotypes;
         bool deduplicate_haplotypes_with_germline_model = true;
     };
@@ -83,14 +83,6 @@ private:
     std::vector<std::unique_ptr<VariantCall>>
     call_variants(const std::vector<Variant>& candidates, const Latents& latents) const;
     
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Caller::Latents& latents,
-                   const ReadPileupMap& pileups) const override;
-    
-    std::vector<std::unique_ptr<ReferenceCall>>
-    call_reference(const std::vector<Allele>& alleles, const Latents& latents,
-                   const ReadPileupMap& pileups) const;
-    
     std::unique_ptr<PopulationPriorModel> make_prior_model(const std::vector<Haplotype>& haplotypes) const;
     std::unique_ptr<GenotypePriorModel> make_single_sample_prior_model(const std::vector<Haplotype>& haplotypes) const;
 };
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <functional>
 #include <exception>
+#include <numeric>
 
 #include "config/config.hpp"
 #include "config/option_collation.hpp"
@@ -148,6 +149,16 @@ ProgressMeter& GenomeCallingComponents::progress_meter() noexcept
     return components_.progress_meter;
 }
 
+MemoryGovernor& GenomeCallingComponents::memory_governor() noexcept
+{
+    return *components_.memory_governor;
+}
+
+const MemoryGovernor& GenomeCallingComponents::memory_governor() const noexcept
+{
+    return *components_.memory_governor;
+}
+
 boost::optional<GenomeCallingComponents::Path> GenomeCallingComponents::legacy() const
 {
     return components_.legacy;
@@ -173,6 +184,26 @@ boost::optional<GenomeCallingComponents::Path> GenomeCallingComponents::data_pro
     return components_.data_profile;
 }
 
+boost::optional<GenomeCallingComponents::Path> GenomeCallingComponents::checkpoint_directory() const
+{
+    return components_.checkpoint_directory;
+}
+
+bool GenomeCallingComponents::resume() const noexcept
+{
+    return components_.resume;
+}
+
+const std::string& GenomeCallingComponents::calling_options() const noexcept
+{
+    return components_.calling_options;
+}
+
+const boost::optional<GenomeShard>& GenomeCallingComponents::shard() const noexcept
+{
+    return components_.shard;
+}
+
 bool GenomeCallingComponents::sites_only() const noexcept
 {
     return components_.sites_only;
@@ -212,7 +243,56 @@ std::vector<ContigName> get_unmapped_contigs(const ReadManager& rm, const Refere
     return copy_unmapped_contigs(rm, reference, reference.contig_names());
 }
 
-auto get_search_regions(const options::OptionMap& options, const ReferenceGenome& reference, const ReadManager& rm)
+class EmptyShard : public UserError
+{
+    std::string do_where() const override
+    {
+        return "make_shard";
+    }
+    
+    std::string do_why() const override
+    {
+        return "Shard " + std::to_string(index_ + 1) + "/" + std::to_string(count_) + " has no search regions";
+    }
+    
+    std::string do_help() const override
+    {
+        return "use fewer shards";
+    }
+    
+    unsigned index_, count_;
+public:
+    EmptyShard(unsigned index, unsigned count) : index_ {index}, count_ {count} {}
+};
+
+// Calls that span a shard split point are called by both shards with at least this much context
+constexpr GenomicRegion::Size shardMargin {1000};
+
+auto get_contigs(const InputRegionMap& regions, const ReferenceGenome& reference,
+                 options::ContigOutputOrder order) -> std::vector<ContigName>;
+
+GenomeShard make_shard(const options::ShardRequest& request, const InputRegionMap& regions,
+                       const ReferenceGenome& reference, const ReadManager& rm,
+                       const options::ContigOutputOrder contig_order)
+{
+    // Shards follow the output contig order so the merged shards are in output order
+    const auto contigs = get_contigs(regions, reference, contig_order);
+    const auto reads = estimate_read_distributions(rm, reference, contigs);
+    auto shards = make_genome_shards(regions, contigs, request.count, reads, shardMargin);
+    auto& result = shards[request.index];
+    if (result.regions.empty()) {
+        throw EmptyShard {request.index, request.count};
+    }
+    logging::InfoLogger log {};
+    const auto num_bases = std::accumulate(std::cbegin(result.regions), std::cend(result.regions), GenomicRegion::Size {0},
+                                           [] (auto curr, const auto& region) { return curr + size(region); });
+    stream(log) << "Calling shard " << request << " (" << result.regions.size() << " regions, "
+                << num_bases << "bp, from " << result.regions.front() << " to " << result.regions.back() << ")";
+    return std::move(result);
+}
+
+auto get_search_regions(const options::OptionMap& options, const ReferenceGenome& reference, const ReadManager& rm,
+                        boost::optional<GenomeShard>& shard)
 {
     auto result = options::get_search_regions(options, reference);
     if (options::ignore_unmapped_contigs(options)) {
@@ -225,6 +305,11 @@ auto get_search_regions(const options::OptionMap& options, const ReferenceGenome
             }
         }
     }
+    const auto shard_request = options::get_shard_request(options);
+    if (shard_request) {
+        shard = make_shard(*shard_request, result, reference, rm, options::get_contig_output_order(options));
+        return get_shard_search_regions(*shard, result);
+    }
     return result;
 }
 
@@ -282,7 +367,7 @@ auto get_sorter(const options::ContigOutputOrder order, const ReferenceGenome& r
 }
 
 auto get_contigs(const InputRegionMap& regions, const ReferenceGenome& reference,
-                 const options::ContigOutputOrder order)
+                 const options::ContigOutputOrder order) -> std::vector<ContigName>
 {
     auto result = extract_keys(regions);
     const auto cmp = get_sorter(order, reference);
@@ -380,6 +465,23 @@ boost::optional<fs::path> get_temp_directory(const options::OptionMap& options)
     }
 }
 
+boost::optional<std::unordered_map<ContigName, CoverageEstimate>>
+estimate_coverage(const InputRegionMap& regions, const std::vector<SampleName>& samples, const ReadManager& read_manager)
+{
+    // Coarse bins are enough to weight progress and keep the index queries cheap
+    static constexpr GenomicRegion::Size binSize {1'000'000};
+    std::unordered_map<ContigName, CoverageEstimate> result {};
+    result.reserve(regions.size());
+    for (const auto& p : regions) {
+        if (p.second.empty()) continue;
+        const auto contig_region = encompassing_region(p.second.front(), p.second.back());
+        auto estimate = read_manager.estimate_coverage(samples, contig_region, binSize);
+        if (!estimate) return boost::none;
+        result.emplace(p.first, std::move(*estimate));
+    }
+    return result;
+}
+
 auto estimate_read_size(const boost::optional<ReadSetProfile>& profile) noexcept
 {
     double result;
@@ -483,11 +585,14 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
 : reference {std::move(reference)}
 , read_manager {std::move(read_manager)}
 , samples {extract_samples(options, this->read_manager)}
-, regions {get_search_regions(options, this->reference, this->read_manager)}
+, shard {}
+, regions {get_search_regions(options, this->reference, this->read_manager, this->shard)}
 , contigs {get_contigs(this->regions, this->reference, options::get_contig_output_order(options))}
 , reads_profile {profile_reads(this->samples, this->regions, this->read_manager)}
 , read_pipe {options::make_read_pipe(this->read_manager, this->samples, options)}
-, caller_factory {options::make_caller_factory(this->reference, this->read_pipe, this->regions, options, this->reads_profile)}
+, memory_governor {options::make_memory_governor(options)}
+, caller_factory {options::make_caller_factory(this->reference, this->read_pipe, this->regions, options,
+                                               this->reads_profile, this->memory_governor)}
 , filter_read_pipe {}
 , output {std::move(output)}
 , filtered_output {}
@@ -502,6 +607,9 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
 , bamout {options::bamout_request(options)}
 , split_bamout {options::split_bamout_request(options)}
 , data_profile {options::data_profile_request(options)}
+, checkpoint_directory {options::get_checkpoint_directory(options)}
+, resume {options::is_resume_requested(options)}
+, calling_options {options::describe_calling_options(options)}
 {
     drop_unused_samples(this->samples, this->read_manager);
     setup_progress_meter(options);
@@ -513,7 +621,7 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
     }
     temp_directory = get_temp_directory(options);
     try {
-        call_filter_factory = options::make_call_filter_factory(this->reference, this->read_pipe, options, this->temp_directory);
+        call_filter_factory = options::make_call_filter_factory(this->reference, this->read_pipe, options);
         setup_writers(options);
     } catch (...) {
         if (temp_directory) fs::remove_all(*temp_directory);
@@ -531,6 +639,10 @@ void GenomeCallingComponents::Components::setup_progress_meter(const options::Op
     } else {
         progress_meter.set_max_tick_size(0.1);
     }
+    if (!samples.empty() && read_manager.good()) {
+        auto coverage_estimates = estimate_coverage(regions, samples, read_manager);
+        if (coverage_estimates) progress_meter.set_coverage_estimates(std::move(*coverage_estimates));
+    }
 }
 
 void GenomeCallingComponents::Components::set_read_buffer_size(const options::OptionMap& options)
@@ -691,6 +803,7 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , read_buffer_size {genome_components.read_buffer_size()}
 , output {genome_components.output()}
 , progress_meter {genome_components.progress_meter()}
+, memory_governor {genome_components.memory_governor()}
 {}
 
 ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName& contig, VcfWriter& output,
@@ -703,6 +816,7 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , read_buffer_size {genome_components.read_buffer_size()}
 , output {output}
 , progress_meter {genome_components.progress_meter()}
+, memory_governor {genome_components.memory_governor()}
 {}
 
 } // namespace octopus
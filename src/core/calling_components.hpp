@@ -5,6 +5,7 @@
 #define calling_components_hpp
 
 #include <vector>
+#include <string>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -23,7 +24,9 @@
 #include "readpipe/read_pipe_fwd.hpp"
 #include "core/callers/caller_factory.hpp"
 #include "core/csr/filters/variant_call_filter_factory.hpp"
+#include "core/tools/genome_sharding.hpp"
 #include "utils/input_reads_profiler.hpp"
+#include "utils/memory_governor.hpp"
 #include "logging/progress_meter.hpp"
 
 namespace octopus {
@@ -65,6 +68,8 @@ public:
     ReadPipe& filter_read_pipe() noexcept;
     const ReadPipe& filter_read_pipe() const noexcept;
     ProgressMeter& progress_meter() noexcept;
+    MemoryGovernor& memory_governor() noexcept;
+    const MemoryGovernor& memory_governor() const noexcept;
     bool sites_only() const noexcept;
     const PloidyMap& ploidies() const noexcept;
     boost::optional<Pedigree> pedigree() const;
@@ -73,6 +78,10 @@ public:
     boost::optional<Path> bamout() const;
     boost::optional<Path> split_bamout() const;
     boost::optional<Path> data_profile() const;
+    boost::optional<Path> checkpoint_directory() const;
+    bool resume() const noexcept;
+    const std::string& calling_options() const noexcept;
+    const boost::optional<GenomeShard>& shard() const noexcept;
     
 private:
     struct Components
@@ -92,10 +101,12 @@ private:
         ReferenceGenome reference;
         ReadManager read_manager;
         std::vector<SampleName> samples;
+        boost::optional<GenomeShard> shard;
         InputRegionMap regions;
         std::vector<GenomicRegion::ContigName> contigs;
         boost::optional<ReadSetProfile> reads_profile;
         ReadPipe read_pipe;
+        std::shared_ptr<MemoryGovernor> memory_governor;
         CallerFactory caller_factory;
         boost::optional<ReadPipe> filter_read_pipe;
         VcfWriter output;
@@ -109,6 +120,9 @@ private:
         boost::optional<Path> legacy;
         boost::optional<Path> filter_request;
         boost::optional<Path> bamout, split_bamout, data_profile;
+        boost::optional<Path> checkpoint_directory;
+        bool resume;
+        std::string calling_options;
         // Components that require temporary directory during construction appear last to make
         // exception handling easier.
         boost::optional<Path> temp_directory;
@@ -141,6 +155,7 @@ struct ContigCallingComponents
     std::size_t read_buffer_size;
     std::reference_wrapper<VcfWriter> output;
     std::reference_wrapper<ProgressMeter> progress_meter;
+    std::reference_wrapper<MemoryGovernor> memory_governor;
     
     ContigCallingComponents() = delete;
     
@@ -0,0 +1,255 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "checkpoint_journal.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const std::string journalFileName {"checkpoint.journal"};
+const std::string journalHeader {"##octopus-checkpoint-journal=1"};
+const std::string fingerprintKey {"##fingerprint="};
+const std::string nextFileKey {"##next-file="};
+
+class MalformedJournal : public MalformedFileError
+{
+    std::string do_where() const override { return "CheckpointJournal"; }
+    std::string do_help() const override
+    {
+        return "the checkpoint is unusable - delete the checkpoint directory and run without --resume";
+    }
+public:
+    MalformedJournal(fs::path file, std::string reason) : MalformedFileError {std::move(file), "checkpoint journal"}
+    {
+        set_reason(std::move(reason));
+    }
+};
+
+class UnwritableJournal : public UnwritableFileError
+{
+    std::string do_where() const override { return "CheckpointJournal"; }
+public:
+    UnwritableJournal(fs::path file) : UnwritableFileError {std::move(file), "checkpoint journal"} {}
+};
+
+std::vector<std::string> split_fields(const std::string& line)
+{
+    std::vector<std::string> result {};
+    std::istringstream ss {line};
+    std::string field {};
+    while (std::getline(ss, field, '\t')) {
+        result.push_back(std::move(field));
+    }
+    return result;
+}
+
+bool starts_with(const std::string& str, const std::string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+GenomicRegion parse_region(const std::string& contig, const std::string& begin, const std::string& end)
+{
+    return GenomicRegion {contig, boost::lexical_cast<GenomicRegion::Position>(begin),
+                          boost::lexical_cast<GenomicRegion::Position>(end)};
+}
+
+void write_region(const GenomicRegion& region, std::ostream& os)
+{
+    os << region.contig_name() << '\t' << region.begin() << '\t' << region.end();
+}
+
+// Flushes the file or directory to disk, so it survives a crash of the machine and not just the process
+void sync_to_disk(const fs::path& path, const bool is_directory = false)
+{
+    const auto fd = ::open(path.c_str(), is_directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if (fd == -1) {
+        throw UnwritableJournal {path};
+    }
+    const auto status = ::fsync(fd);
+    ::close(fd);
+    if (status != 0) {
+        throw UnwritableJournal {path};
+    }
+}
+
+} // namespace
+
+CheckpointJournal::CheckpointJournal(Path directory)
+: directory_ {std::move(directory)}
+, fingerprint_ {}
+, next_file_id_ {0}
+, contigs_ {}
+{
+    if (fs::exists(journal_path())) read();
+}
+
+const CheckpointJournal::Path& CheckpointJournal::directory() const noexcept
+{
+    return directory_;
+}
+
+CheckpointJournal::Path CheckpointJournal::journal_path() const
+{
+    return directory_ / journalFileName;
+}
+
+bool CheckpointJournal::empty() const noexcept
+{
+    return contigs_.empty();
+}
+
+const std::string& CheckpointJournal::fingerprint() const noexcept
+{
+    return fingerprint_;
+}
+
+void CheckpointJournal::set_fingerprint(std::string fingerprint)
+{
+    fingerprint_ = std::move(fingerprint);
+}
+
+bool CheckpointJournal::contains(const ContigName& contig) const noexcept
+{
+    return contigs_.count(contig) == 1;
+}
+
+const CheckpointJournal::ContigEntry& CheckpointJournal::at(const ContigName& contig) const
+{
+    return contigs_.at(contig);
+}
+
+std::vector<CheckpointJournal::Path> CheckpointJournal::chunks() const
+{
+    std::vector<Path> result {};
+    for (const auto& p : contigs_) {
+        result.insert(std::cend(result), std::cbegin(p.second.chunks), std::cend(p.second.chunks));
+    }
+    return result;
+}
+
+std::vector<CheckpointJournal::Path> CheckpointJournal::files() const
+{
+    auto result = chunks();
+    for (const auto& p : contigs_) {
+        if (p.second.boundary) result.push_back(p.second.boundary->calls);
+    }
+    return result;
+}
+
+CheckpointJournal::Path CheckpointJournal::make_unique_file_name(const ContigName& contig, const std::string& type)
+{
+    return contig + "_" + std::to_string(next_file_id_++) + "_" + type + ".bcf";
+}
+
+void CheckpointJournal::add_chunk(const ContigName& contig, Path chunk)
+{
+    contigs_[contig].chunks.push_back(std::move(chunk));
+}
+
+void CheckpointJournal::set_completed(GenomicRegion region)
+{
+    contigs_[region.contig_name()].completed = std::move(region);
+}
+
+void CheckpointJournal::set_boundary(GenomicRegion region, Path calls)
+{
+    auto& entry = contigs_[region.contig_name()];
+    entry.boundary = Boundary {std::move(region), std::move(calls)};
+}
+
+void CheckpointJournal::commit() const
+{
+    // The journal must not be renamed into place before the files it refers to are on disk
+    for (const auto& file : files()) {
+        sync_to_disk(directory_ / file);
+    }
+    auto tmp_path = journal_path();
+    tmp_path += ".tmp";
+    {
+        std::ofstream file {tmp_path.string(), std::ios::trunc};
+        if (!file) {
+            throw UnwritableJournal {tmp_path};
+        }
+        file << journalHeader << '\n';
+        file << fingerprintKey << fingerprint_ << '\n';
+        file << nextFileKey << next_file_id_ << '\n';
+        for (const auto& p : contigs_) {
+            for (const auto& chunk : p.second.chunks) {
+                file << "chunk\t" << p.first << '\t' << chunk.string() << '\n';
+            }
+            if (p.second.completed) {
+                file << "completed\t";
+                write_region(*p.second.completed, file);
+                file << '\n';
+            }
+            if (p.second.boundary) {
+                file << "boundary\t";
+                write_region(p.second.boundary->region, file);
+                file << '\t' << p.second.boundary->calls.string() << '\n';
+            }
+        }
+        file.close();
+        if (!file) {
+            throw UnwritableJournal {tmp_path};
+        }
+    }
+    sync_to_disk(tmp_path);
+    fs::rename(tmp_path, journal_path());
+    sync_to_disk(directory_, true);
+}
+
+void CheckpointJournal::read()
+{
+    const auto path = journal_path();
+    std::ifstream file {path.string()};
+    std::string line {};
+    if (!std::getline(file, line) || line != journalHeader) {
+        throw MalformedJournal {path, "the journal header is missing"};
+    }
+    try {
+        while (std::getline(file, line)) {
+            if (line.empty()) continue;
+            if (starts_with(line, fingerprintKey)) {
+                fingerprint_ = line.substr(fingerprintKey.size());
+                continue;
+            }
+            if (starts_with(line, nextFileKey)) {
+                next_file_id_ = boost::lexical_cast<unsigned>(line.substr(nextFileKey.size()));
+                continue;
+            }
+            const auto fields = split_fields(line);
+            if (fields.front() == "chunk" && fields.size() == 3) {
+                add_chunk(fields[1], fields[2]);
+            } else if (fields.front() == "completed" && fields.size() == 4) {
+                set_completed(parse_region(fields[1], fields[2], fields[3]));
+            } else if (fields.front() == "boundary" && fields.size() == 5) {
+                set_boundary(parse_region(fields[1], fields[2], fields[3]), fields[4]);
+            } else {
+                throw MalformedJournal {path, "unknown record " + line};
+            }
+        }
+    } catch (const boost::bad_lexical_cast&) {
+        throw MalformedJournal {path, "bad number in record " + line};
+    } catch (const ContigRegion::BadRegion&) {
+        throw MalformedJournal {path, "bad region in record " + line};
+    }
+}
+
+} // namespace octopus
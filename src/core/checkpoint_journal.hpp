@@ -0,0 +1,102 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef checkpoint_journal_hpp
+#define checkpoint_journal_hpp
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/**
+ A CheckpointJournal records the progress of a calling run so that it can be resumed if the
+ process is killed.
+
+ Calls are written to chunk files in the checkpoint directory. For each contig the journal lists
+ the chunks that have been closed, the region whose calls are fully written to those chunks, and
+ the boundary task: the last completed task, which is not written until the task to its right has
+ completed so that calls spanning the two can be resolved. The boundary calls are saved to their
+ own file so the boundary task can be rebuilt on resume.
+
+ The journal file is replaced atomically on each commit, so a crash leaves either the old or the
+ new journal, and the files it refers to are always complete. Each commit syncs the journaled files,
+ then the new journal, and then the directory after the rename, so this also holds if the machine
+ goes down.
+ */
+class CheckpointJournal
+{
+public:
+    using Path = boost::filesystem::path;
+
+    struct Boundary
+    {
+        GenomicRegion region;
+        Path calls;
+    };
+
+    struct ContigEntry
+    {
+        std::vector<Path> chunks;
+        boost::optional<GenomicRegion> completed;
+        boost::optional<Boundary> boundary;
+    };
+
+    CheckpointJournal() = delete;
+
+    // Reads the journal in directory if there is one
+    CheckpointJournal(Path directory);
+
+    CheckpointJournal(const CheckpointJournal&)            = default;
+    CheckpointJournal& operator=(const CheckpointJournal&) = default;
+    CheckpointJournal(CheckpointJournal&&)                 = default;
+    CheckpointJournal& operator=(CheckpointJournal&&)      = default;
+
+    ~CheckpointJournal() = default;
+
+    const Path& directory() const noexcept;
+    Path journal_path() const;
+
+    bool empty() const noexcept;
+
+    const std::string& fingerprint() const noexcept;
+    void set_fingerprint(std::string fingerprint);
+
+    bool contains(const ContigName& contig) const noexcept;
+    const ContigEntry& at(const ContigName& contig) const;
+
+    // Returns all chunk paths, relative to the checkpoint directory
+    std::vector<Path> chunks() const;
+    // Returns all chunk and boundary call paths, relative to the checkpoint directory
+    std::vector<Path> files() const;
+
+    // Returns a file name in the checkpoint directory that has not been used by this journal
+    Path make_unique_file_name(const ContigName& contig, const std::string& type);
+
+    void add_chunk(const ContigName& contig, Path chunk);
+    void set_completed(GenomicRegion region);
+    void set_boundary(GenomicRegion region, Path calls);
+
+    // Atomically and durably replaces the journal file with the current state. Throws if any
+    // journaled file does not exist.
+    void commit() const;
+
+private:
+    Path directory_;
+    std::string fingerprint_;
+    unsigned next_file_id_;
+    std::map<ContigName, ContigEntry> contigs_;
+
+    void read();
+};
+
+} // namespace octopus
+
+#endif
@@ -17,6 +17,7 @@
 #include "core/tools/read_assigner.hpp"
 #include "basics/ploidy_map.hpp"
 #include "basics/pedigree.hpp"
+#include "utils/region_read_summary.hpp"
 
 namespace octopus { namespace csr {
 
@@ -34,8 +35,15 @@ public:
         SampleAmbiguityMap ambiguous;
     };
     
+    struct SampleReadSummaries
+    {
+        std::unordered_map<SampleName, RegionReadSummary> samples;
+        RegionReadSummary combined;
+    };
+    
     using ResultType = boost::variant<std::reference_wrapper<const ReadMap>,
                                       std::reference_wrapper<const SupportMaps>,
+                                      std::reference_wrapper<const SampleReadSummaries>,
                                       std::reference_wrapper<const std::string>,
                                       std::reference_wrapper<const std::vector<std::string>>,
                                       std::reference_wrapper<const Haplotype>,
@@ -8,11 +8,12 @@
 #include <algorithm>
 #include <iterator>
 #include <array>
-#include <future>
 #include <cassert>
 
 #include "exceptions/program_error.hpp"
+#include "utils/parallel_algorithms.hpp"
 #include "overlapping_reads.hpp"
+#include "read_summaries.hpp"
 #include "read_assignments.hpp"
 #include "reference_context.hpp"
 #include "samples.hpp"
@@ -133,7 +134,7 @@ bool requires_reference(const std::vector<std::string>& facets) noexcept
 
 bool requires_reads(const std::string& facet) noexcept
 {
-    const static std::array<std::string, 2> read_facets{name<OverlappingReads>(), name<ReadAssignments>()};
+    const static std::array<std::string, 3> read_facets{name<OverlappingReads>(), name<ReadSummaries>(), name<ReadAssignments>()};
     return std::find(std::cbegin(read_facets), std::cend(read_facets), facet) != std::cend(read_facets);
 }
 
@@ -201,32 +202,19 @@ FacetFactory::make(const std::vector<std::string>& names,
     if (blocks.empty()) return {};
     check_requirements(names);
     std::vector<FacetBlock> result {};
-    result.reserve(blocks.size());
     if (blocks.size() > 1 && !workers.empty()) {
-        std::vector<std::future<FacetBlock>> futures {};
-        futures.reserve(blocks.size());
-        const auto fetch_reads = requires_reads(names);
-        const auto fetch_genotypes = requires_genotypes(names);
-        for (const auto& block : blocks) {
+        result.resize(blocks.size());
+        TaskGroup tasks {workers};
+        for (std::size_t i {0}; i < blocks.size(); ++i) {
             // It's faster to fetch reads serially from left to right, so do this outside the thread pool
-            BlockData data {};
-            if (!block.empty()) {
-                data.region = encompassing_region(block);
-                if (fetch_reads) {
-                    data.reads = read_pipe_->fetch_reads(*data.region);
-                }
-            }
-            futures.push_back(workers.push([this, &names, data {std::move(data)}, &block, fetch_genotypes] () mutable {
-                if (fetch_genotypes) {
-                    data.genotypes = extract_genotypes(block, samples_, *reference_);
-                }
-                return this->make(names, data);
-            }));
-        }
-        for (auto& fut : futures) {
-            result.push_back(fut.get());
+            auto data = fetch_serial_data(names, blocks[i]);
+            tasks.run([this, &names, &blocks, &result, i, data {std::move(data)}] () mutable {
+                result[i] = this->make(names, blocks[i], std::move(data));
+            });
         }
+        tasks.wait();
     } else {
+        result.reserve(blocks.size());
         for (const auto& block : blocks) {
             const auto data = make_block_data(names, block);
             result.push_back(make(names, data));
@@ -235,6 +223,29 @@ FacetFactory::make(const std::vector<std::string>& names,
     return result;
 }
 
+FacetFactory::BlockData FacetFactory::fetch_serial_data(const std::vector<std::string>& names, const CallBlock& block) const
+{
+    check_requirements(names);
+    BlockData result {};
+    if (!block.empty()) {
+        result.region = encompassing_region(block);
+        if (requires_reads(names)) {
+            result.reads = read_pipe_->fetch_reads(*result.region);
+        }
+    }
+    return result;
+}
+
+FacetFactory::FacetBlock
+FacetFactory::make(const std::vector<std::string>& names, const CallBlock& block, BlockData serial_data) const
+{
+    if (names.empty()) return {};
+    if (!block.empty() && !serial_data.genotypes && requires_genotypes(names)) {
+        serial_data.genotypes = extract_genotypes(block, samples_, *reference_);
+    }
+    return make(names, serial_data);
+}
+
 // private methods
 
 void FacetFactory::setup_facet_makers()
@@ -244,6 +255,11 @@ void FacetFactory::setup_facet_makers()
         assert(block.reads);
         return {std::make_unique<OverlappingReads>(*block.reads)};
     };
+    facet_makers_[name<ReadSummaries>()] = [] (const BlockData& block) -> FacetWrapper
+    {
+        assert(block.region && block.reads);
+        return {std::make_unique<ReadSummaries>(*block.region, *block.reads)};
+    };
     facet_makers_[name<ReadAssignments>()] = [this] (const BlockData& block) -> FacetWrapper
     {
         assert(block.reads && block.genotypes);
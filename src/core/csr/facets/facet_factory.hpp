@@ -30,6 +30,13 @@ public:
     using CallBlock  = std::vector<VcfRecord>;
     using FacetBlock = std::vector<FacetWrapper>;
     
+    struct BlockData
+    {
+        boost::optional<GenomicRegion> region;
+        boost::optional<ReadMap> reads;
+        boost::optional<GenotypeMap> genotypes;
+    };
+    
     FacetFactory() = delete;
     
     FacetFactory(VcfHeader input_header);
@@ -47,15 +54,13 @@ public:
     FacetWrapper make(const std::string& name, const CallBlock& block) const;
     FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
     std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks, ThreadPool& workers) const;
+    
+    // Reads are fastest fetched serially from left to right, so pipelined callers should fetch
+    // the serial block data in order and complete the facets concurrently.
+    BlockData fetch_serial_data(const std::vector<std::string>& names, const CallBlock& block) const;
+    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block, BlockData serial_data) const;
 
 private:
-    struct BlockData
-    {
-        boost::optional<GenomicRegion> region;
-        boost::optional<ReadMap> reads;
-        boost::optional<GenotypeMap> genotypes;
-    };
-    
     VcfHeader input_header_;
     std::vector<std::string> samples_;
     boost::optional<std::reference_wrapper<const ReferenceGenome>> reference_;
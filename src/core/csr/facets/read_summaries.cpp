@@ -0,0 +1,26 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_summaries.hpp"
+
+namespace octopus { namespace csr {
+
+const std::string ReadSummaries::name_ {"ReadSummaries"};
+
+ReadSummaries::ReadSummaries(const GenomicRegion& region, const ReadMap& reads)
+{
+    summaries_.samples.reserve(reads.size());
+    for (const auto& p : reads) {
+        const auto& sample_summary = summaries_.samples.emplace(p.first, RegionReadSummary {region, p.second}).first->second;
+        summaries_.combined += sample_summary;
+    }
+    if (reads.empty()) summaries_.combined = RegionReadSummary {region, reads};
+}
+
+Facet::ResultType ReadSummaries::do_get() const
+{
+    return std::cref(summaries_);
+}
+
+} // namespace csr
+} // namespace octopus
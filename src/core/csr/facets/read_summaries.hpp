@@ -0,0 +1,38 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_summaries_hpp
+#define read_summaries_hpp
+
+#include <string>
+#include <functional>
+
+#include "facet.hpp"
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus { namespace csr {
+
+// Summarises the block reads once so read statistics for each call are O(1)
+class ReadSummaries : public Facet
+{
+public:
+    using ResultType = std::reference_wrapper<const SampleReadSummaries>;
+    
+    ReadSummaries() = default;
+    
+    ReadSummaries(const GenomicRegion& region, const ReadMap& reads);
+
+private:
+    static const std::string name_;
+    
+    SampleReadSummaries summaries_;
+    
+    const std::string& do_name() const noexcept override { return name_; }
+    Facet::ResultType do_get() const override;
+};
+
+} // namespace csr
+} // namespace octopus
+
+#endif
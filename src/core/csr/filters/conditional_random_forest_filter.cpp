@@ -6,47 +6,20 @@
 #include <utility>
 #include <iterator>
 #include <algorithm>
-#include <numeric>
-#include <iostream>
+#include <type_traits>
 #include <cassert>
 #include <cmath>
-#include <limits>
 
 #include <boost/variant.hpp>
 #include <boost/lexical_cast.hpp>
-#include <boost/filesystem/operations.hpp>
-
-#include "ranger/ForestProbability.h"
 
 #include "basics/phred.hpp"
 #include "utils/concat.hpp"
 #include "utils/maths.hpp"
-#include "exceptions/missing_file_error.hpp"
 #include "exceptions/program_error.hpp"
-#include "exceptions/malformed_file_error.hpp"
 
 namespace octopus { namespace csr {
 
-namespace {
-
-class MissingForestFile : public MissingFileError
-{
-    std::string do_where() const override { return "ConditionalRandomForestFilter"; }
-public:
-    MissingForestFile(boost::filesystem::path p) : MissingFileError {std::move(p), ".forest"} {};
-};
-
-void check_all_exists(const std::vector<ConditionalRandomForestFilter::Path>& forests)
-{
-    for (const auto& forest : forests) {
-        if (!boost::filesystem::exists(forest)) {
-            throw MissingForestFile {forest};
-        }
-    }
-}
-
-} // namespace
-
 ConditionalRandomForestFilter::ConditionalRandomForestFilter(FacetFactory facet_factory,
                                                              std::vector<MeasureWrapper> measures,
                                                              std::vector<MeasureWrapper> chooser_measures,
@@ -54,21 +27,21 @@ ConditionalRandomForestFilter::ConditionalRandomForestFilter(FacetFactory facet_
                                                              std::vector<Path> ranger_forests,
                                                              OutputOptions output_config,
                                                              ConcurrencyPolicy threading,
-                                                             Path temp_directory,
                                                              boost::optional<ProgressMeter&> progress)
 : DoublePassVariantCallFilter {std::move(facet_factory), concat(std::move(measures), chooser_measures),
                                std::move(output_config), threading, progress}
-, forest_paths_ {std::move(ranger_forests)}
-, temp_dir_ {std::move(temp_directory)}
+, forests_ {}
 , chooser_ {std::move(chooser)}
 , num_chooser_measures_ {chooser_measures.size()}
+, row_buffers_ {}
+, buffered_records_ {}
+, predictions_ {}
 , num_records_ {0}
-, data_buffer_ {}
 {
-    check_all_exists(forest_paths_);
-    forests_.reserve(forest_paths_.size());
-    std::generate_n(std::back_inserter(forests_), forest_paths_.size(),
-                    [] () { return std::make_unique<ranger::ForestProbability>(); });
+    forests_.reserve(ranger_forests.size());
+    for (const auto& forest : ranger_forests) {
+        forests_.emplace_back(forest, measures_.size() - num_chooser_measures_);
+    }
 }
 
 const std::string ConditionalRandomForestFilter::call_qual_name_ = "RFQUAL";
@@ -90,35 +63,11 @@ std::int8_t ConditionalRandomForestFilter::choose_forest(const MeasureVector& me
     return chooser_(chooser_measures);
 }
 
-template <typename T>
-static void write_line(const std::vector<T>& data, std::ostream& out)
-{
-    std::copy(std::cbegin(data), std::prev(std::cend(data)), std::ostream_iterator<T> {out, " "});
-    out << data.back() << '\n';
-}
-
 void ConditionalRandomForestFilter::prepare_for_registration(const SampleList& samples) const
 {
-    std::vector<std::string> data_header {};
-    data_header.reserve(measures_.size() - num_chooser_measures_);
-    std::transform(std::cbegin(measures_), std::prev(std::cend(measures_), num_chooser_measures_), std::back_inserter(data_header),
-                   [] (const auto& measure) { return measure.name(); });
-    data_header.push_back("TP");
-    const auto num_forests = forest_paths_.size();
-    data_.resize(num_forests);
-    for (std::size_t forest_idx {0}; forest_idx < num_forests; ++forest_idx) {
-        data_[forest_idx].reserve(samples.size());
-        for (const auto& sample : samples) {
-            auto data_path = temp_dir_;
-            Path fname {"octopus_ranger_temp_forest_data_" + std::to_string(forest_idx) + "_" + sample + ".dat"};
-            data_path /= fname;
-            data_[forest_idx].emplace_back(data_path.string(), data_path);
-            write_line(data_header, data_[forest_idx].back().handle);
-        }
-    }
-    data_buffer_.resize(num_forests);
-    for (auto& buffer : data_buffer_) buffer.resize(samples.size());
-    choices_.resize(samples.size());
+    row_buffers_.assign(forests_.size(), std::vector<std::vector<double>>(samples.size()));
+    buffered_records_.assign(forests_.size(), std::vector<std::vector<std::size_t>>(samples.size()));
+    predictions_.assign(samples.size(), {});
 }
 
 namespace {
@@ -178,132 +127,49 @@ class NanMeasure : public ProgramError
     std::string do_help() const override { return "submit an error report"; }
 };
 
-void check_nan(const std::vector<double>& values)
+template <typename Iterator>
+void check_nan(Iterator first, Iterator last)
 {
-    if (std::any_of(std::cbegin(values), std::cend(values), [] (auto v) { return std::isnan(v); })) {
+    if (std::any_of(first, last, [] (auto v) { return std::isnan(v); })) {
         throw NanMeasure {};
     }
 }
 
-void skip_lines(std::istream& in, int n = 1)
-{
-    for (; n > 0; --n) in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-}
-
 } // namespace
 
 void ConditionalRandomForestFilter::record(const std::size_t call_idx, std::size_t sample_idx, MeasureVector measures) const
 {
     assert(!measures.empty());
     const auto forest_idx = choose_forest(measures);
-    const auto num_forests = static_cast<std::remove_const_t<decltype(forest_idx)>>(data_buffer_.size());
+    const auto num_forests = static_cast<std::remove_const_t<decltype(forest_idx)>>(forests_.size());
     if (forest_idx >= 0 && forest_idx < num_forests) {
-        auto& buffer = data_buffer_[forest_idx][sample_idx];
+        auto& buffer = row_buffers_[forest_idx][sample_idx];
+        const auto row_begin = buffer.size();
         std::transform(std::cbegin(measures), std::prev(std::cend(measures), num_chooser_measures_),
                        std::back_inserter(buffer), cast_to_double);
-        buffer.push_back(0); // dummy TP value
-        check_nan(buffer);
-        write_line(buffer, data_[forest_idx][sample_idx].handle);
-        buffer.clear();
+        check_nan(std::next(std::cbegin(buffer), row_begin), std::cend(buffer));
+        buffered_records_[forest_idx][sample_idx].push_back(call_idx);
+        static constexpr std::size_t max_buffered_rows {4096};
+        if (buffered_records_[forest_idx][sample_idx].size() >= max_buffered_rows) {
+            predict(forest_idx, sample_idx);
+        }
     } else {
         hard_filtered_record_indices_.push_back(call_idx);
     }
     if (call_idx >= num_records_) ++num_records_;
-    choices_[sample_idx].push_back(forest_idx);
 }
 
-void ConditionalRandomForestFilter::close_data_files() const
-{
-    for (auto& forest : data_) {
-        for (auto& sample : forest) {
-            sample.handle.close();
-        }
-    }
-}
-
-namespace {
-
-bool read_header(std::ifstream& prediction_file)
-{
-    skip_lines(prediction_file);
-    std::string order;
-    std::getline(prediction_file, order);
-    skip_lines(prediction_file);
-    return order.front() == '1';
-}
-
-static double get_prob_false(std::string& prediction_line, const bool tp_first)
-{
-    using std::cbegin; using std::cend;
-    if (tp_first) {
-        prediction_line.erase(cbegin(prediction_line), std::next(std::find(cbegin(prediction_line), cend(prediction_line), ' ')));
-        prediction_line.erase(std::find(cbegin(prediction_line), cend(prediction_line), ' '), cend(prediction_line));
-    } else {
-        prediction_line.erase(std::find(cbegin(prediction_line), cend(prediction_line), ' '), cend(prediction_line));
-    }
-    return boost::lexical_cast<double>(prediction_line);
-}
-
-} // namespace
-
-class MalformedForestFile : public MalformedFileError
-{
-    std::string do_where() const override { return "ConditionalRandomForestFilter"; }
-    std::string do_help() const override
-    {
-        return "make sure the forest was trained with the same measures and in the same order as the prediction measures";
-    }
-public:
-    MalformedForestFile(boost::filesystem::path file) : MalformedFileError {std::move(file)} {}
-};
-
 void ConditionalRandomForestFilter::prepare_for_classification(boost::optional<Log>& log) const
 {
-    close_data_files();
-    const Path ranger_prefix {temp_dir_ / "octopus_ranger_temp"};
-    const Path ranger_prediction_fname {ranger_prefix.string() + ".prediction"};
-    data_buffer_.resize(1);
-    auto& predictions = data_buffer_[0];
-    predictions.resize(num_records_);
-    const auto num_samples = choices_.size();
-    for (std::size_t forest_idx {0}; forest_idx < forest_paths_.size(); ++forest_idx) {
-        for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
-            auto forest_choice_itr = std::find(std::cbegin(choices_[sample_idx]), std::cend(choices_[sample_idx]), forest_idx);
-            if (forest_choice_itr != std::cend(choices_[sample_idx])) {
-                const auto& file = data_[forest_idx][sample_idx];
-                std::vector<std::string> tmp {}, cat_vars {};
-                auto& forest = forests_[forest_idx];
-                try {
-                    forest->initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, file.path.string(), 0, ranger_prefix.string(),
-                                    1000, nullptr, 12, 1, forest_paths_[forest_idx].string(), ranger::ImportanceMode::IMP_GINI, 1, "",
-                                    tmp, "", true, cat_vars, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
-                                    ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
-                                    ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
-                } catch (const std::runtime_error& e) {
-                    throw MalformedForestFile {forest_paths_[forest_idx]};
-                }
-                forest->run(false);
-                forest->writePredictionFile();
-                std::ifstream prediction_file {ranger_prediction_fname.string()};
-                const auto tp_first = read_header(prediction_file);
-                std::string line;
-                while (std::getline(prediction_file, line)) {
-                    if (!line.empty()) {
-                        const auto record_idx = std::distance(std::cbegin(choices_[sample_idx]), forest_choice_itr);
-                        predictions[record_idx].push_back(get_prob_false(line, tp_first));
-                        assert(forest_choice_itr != std::cend(choices_[sample_idx]));
-                        forest_choice_itr = std::find(std::next(forest_choice_itr), std::cend(choices_[sample_idx]), forest_idx);
-                    }
-                }
-                boost::filesystem::remove(file.path);
-            }
+    for (std::size_t forest_idx {0}; forest_idx < forests_.size(); ++forest_idx) {
+        for (std::size_t sample_idx {0}; sample_idx < predictions_.size(); ++sample_idx) {
+            predict(forest_idx, sample_idx);
         }
     }
-    boost::filesystem::remove(ranger_prediction_fname);
-    data_.clear();
-    data_.shrink_to_fit();
-    choices_.clear();
-    choices_.shrink_to_fit();
+    row_buffers_.clear();
+    row_buffers_.shrink_to_fit();
+    buffered_records_.clear();
+    buffered_records_.shrink_to_fit();
     if (!hard_filtered_record_indices_.empty()) {
         hard_filtered_.resize(num_records_, false);
         for (auto idx : hard_filtered_record_indices_) {
@@ -314,18 +180,12 @@ void ConditionalRandomForestFilter::prepare_for_classification(boost::optional<L
     }
 }
 
-std::size_t ConditionalRandomForestFilter::get_forest_choice(std::size_t call_idx, std::size_t sample_idx) const
-{
-    return choices_.empty() ? 0 : choices_[sample_idx][call_idx];
-}
-
 VariantCallFilter::Classification ConditionalRandomForestFilter::classify(const std::size_t call_idx, std::size_t sample_idx) const
 {
     Classification result {};
     if (hard_filtered_.empty() || !hard_filtered_[call_idx]) {
-        const auto& predictions = data_buffer_[0];
-        assert(call_idx < predictions.size() && sample_idx < predictions[call_idx].size());
-        const auto prob_false = predictions[call_idx][sample_idx];
+        assert(sample_idx < predictions_.size() && call_idx < predictions_[sample_idx].size());
+        const auto prob_false = predictions_[sample_idx][call_idx];
         if (prob_false < 0.5) {
             result.category = Classification::Category::unfiltered;
         } else {
@@ -339,5 +199,22 @@ VariantCallFilter::Classification ConditionalRandomForestFilter::classify(const
     return result;
 }
 
+void ConditionalRandomForestFilter::predict(const std::size_t forest_idx, const std::size_t sample_idx) const
+{
+    auto& records = buffered_records_[forest_idx][sample_idx];
+    if (records.empty()) return;
+    std::vector<double> forest_predictions {};
+    forest_predictions.reserve(records.size());
+    forests_[forest_idx].predict(row_buffers_[forest_idx][sample_idx], forest_predictions, thread_pool());
+    assert(forest_predictions.size() == records.size());
+    auto& predictions = predictions_[sample_idx];
+    predictions.resize(std::max(predictions.size(), records.back() + 1));
+    for (std::size_t i {0}; i < records.size(); ++i) {
+        predictions[records[i]] = forest_predictions[i];
+    }
+    records.clear();
+    row_buffers_[forest_idx][sample_idx].clear();
+}
+
 } // namespace csr
 } // namespace octopus
@@ -5,18 +5,16 @@
 #define conditional_random_forest_filter_hpp
 
 #include <vector>
+#include <deque>
 #include <cstddef>
-#include <memory>
-#include <fstream>
+#include <cstdint>
 #include <functional>
-#include <cstddef>
 
 #include <boost/optional.hpp>
-#include <boost/filesystem.hpp>
-
-#include "ranger/Forest.h"
+#include <boost/filesystem/path.hpp>
 
 #include "double_pass_variant_call_filter.hpp"
+#include "ranger_forest.hpp"
 
 namespace octopus { namespace csr {
 
@@ -34,7 +32,6 @@ public:
                                   std::vector<Path> ranger_forests,
                                   OutputOptions output_config,
                                   ConcurrencyPolicy threading,
-                                  Path temp_directory = "/tmp",
                                   boost::optional<ProgressMeter&> progress = boost::none);
     
     ConditionalRandomForestFilter(const ConditionalRandomForestFilter&)            = delete;
@@ -45,24 +42,15 @@ public:
     virtual ~ConditionalRandomForestFilter() override = default;
 
 private:
-    struct File
-    {
-        std::ofstream handle;
-        Path path;
-        template <typename F, typename P>
-        File(F&& handle, P&& path) : handle {std::forward<F>(handle)}, path {std::forward<P>(path)} {};
-    };
-    
-    std::vector<Path> forest_paths_;
-    Path temp_dir_;
-    std::vector<std::unique_ptr<ranger::Forest>> forests_;
+    std::vector<RangerForest> forests_;
     std::function<std::int8_t(std::vector<Measure::ResultType>)> chooser_;
     std::size_t num_chooser_measures_;
     
-    mutable std::vector<std::vector<File>> data_;
+    // Measures are buffered per forest and sample, and classified in batches as they are recorded
+    mutable std::vector<std::vector<std::vector<double>>> row_buffers_;
+    mutable std::vector<std::vector<std::vector<std::size_t>>> buffered_records_;
+    mutable std::vector<std::vector<double>> predictions_;
     mutable std::size_t num_records_;
-    mutable std::vector<std::vector<std::vector<double>>> data_buffer_;
-    mutable std::vector<std::deque<std::int8_t>> choices_;
     mutable std::deque<std::size_t> hard_filtered_record_indices_;
     mutable std::vector<bool> hard_filtered_;
     
@@ -73,10 +61,9 @@ private:
     std::int8_t choose_forest(const MeasureVector& measures) const;
     void prepare_for_registration(const SampleList& samples) const override;
     void record(std::size_t call_idx, std::size_t sample_idx, MeasureVector measures) const override;
-    void close_data_files() const;
     void prepare_for_classification(boost::optional<Log>& log) const override;
-    std::size_t get_forest_choice(std::size_t call_idx, std::size_t sample_idx) const;
     Classification classify(std::size_t call_idx, std::size_t sample_idx) const override;
+    void predict(std::size_t forest_idx, std::size_t sample_idx) const;
 };
 
 } // namespace csr
@@ -15,7 +15,6 @@ DeNovoRandomForestVariantCallFilter::DeNovoRandomForestVariantCallFilter(FacetFa
                                                                          Path germline_forest, Path denovo_forest,
                                                                          OutputOptions output_config,
                                                                          ConcurrencyPolicy threading,
-                                                                         Path temp_directory,
                                                                          boost::optional<ProgressMeter&> progress)
 : ConditionalRandomForestFilter {
     std::move(facet_factory),
@@ -25,7 +24,6 @@ DeNovoRandomForestVariantCallFilter::DeNovoRandomForestVariantCallFilter(FacetFa
     {std::move(germline_forest), std::move(denovo_forest)},
     std::move(output_config),
     std::move(threading),
-    std::move(temp_directory),
     progress
 } {}
 
@@ -34,7 +32,6 @@ DeNovoRandomForestVariantCallFilter::DeNovoRandomForestVariantCallFilter(FacetFa
                                                                          Path denovo_forest,
                                                                          OutputOptions output_config,
                                                                          ConcurrencyPolicy threading,
-                                                                         Path temp_directory,
                                                                          boost::optional<ProgressMeter&> progress)
 : ConditionalRandomForestFilter {
     std::move(facet_factory),
@@ -44,7 +41,6 @@ DeNovoRandomForestVariantCallFilter::DeNovoRandomForestVariantCallFilter(FacetFa
     {std::move(denovo_forest)},
     std::move(output_config),
     std::move(threading),
-    std::move(temp_directory),
     progress
 } {}
 
@@ -28,7 +28,6 @@ public:
                                         Path germline_forest, Path denovo_forest,
                                         OutputOptions output_config,
                                         ConcurrencyPolicy threading,
-                                        Path temp_directory = "/tmp",
                                         boost::optional<ProgressMeter&> progress = boost::none);
     // De novo only
     DeNovoRandomForestVariantCallFilter(FacetFactory facet_factory,
@@ -36,7 +35,6 @@ public:
                                         Path denovo_forest,
                                         OutputOptions output_config,
                                         ConcurrencyPolicy threading,
-                                        Path temp_directory = "/tmp",
                                         boost::optional<ProgressMeter&> progress = boost::none);
     
     DeNovoRandomForestVariantCallFilter(const DeNovoRandomForestVariantCallFilter&)            = delete;
@@ -47,11 +47,10 @@ void DoublePassVariantCallFilter::make_registration_pass(const VcfReader& source
     if (progress_) progress_->start();
     std::size_t record_idx {0};
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            const auto blocks = read_next_blocks(p.first, p.second, samples);
-            record(blocks, record_idx, samples);
-            for (const auto& block : blocks) record_idx += block.size();
-        }
+        measure_pipelined(source, samples, [&] (const CallBlock& block, const MeasureBlock& measures) {
+            record(block, measures, record_idx, samples);
+            record_idx += block.size();
+        });
     } else if (can_measure_single_call()) {
         auto p = source.iterate();
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { record(call, record_idx++, samples); });
@@ -75,17 +74,6 @@ void DoublePassVariantCallFilter::record(const CallBlock& block, const std::size
     record(block, measure(block), record_idx, samples);
 }
 
-void DoublePassVariantCallFilter::record(const std::vector<CallBlock>& blocks, std::size_t record_idx, const SampleList& samples) const
-{
-    const auto measures = measure(blocks);
-    assert(measures.size() == blocks.size());
-    for (auto tup : boost::combine(blocks, measures)) {
-        const auto& block = tup.get<0>();
-        record(block, tup.get<1>(), record_idx, samples);
-        record_idx += block.size();
-    }
-}
-
 void DoublePassVariantCallFilter::record(const VcfRecord& call, const MeasureVector& measures,
                                          const std::size_t record_idx, const SampleList& samples) const
 {
@@ -117,9 +105,15 @@ void DoublePassVariantCallFilter::make_filter_pass(const VcfReader& source, cons
         progress_->set_max_tick_size(10);
         progress_->start();
     }
-    auto p = source.iterate();
     std::size_t idx {0};
-    std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, idx++, samples, dest); });
+    if (can_measure_multiple_blocks()) {
+        read_pipelined(source, samples, [&] (const CallBlock& block) {
+            for (const auto& call : block) filter(call, idx++, samples, dest);
+        });
+    } else {
+        auto p = source.iterate();
+        std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, idx++, samples, dest); });
+    }
     if (progress_) progress_->stop();
 }
 
@@ -144,7 +138,7 @@ void DoublePassVariantCallFilter::filter(const VcfRecord& call, const std::size_
 
 static auto expand_lhs_to_zero(const GenomicRegion& region)
 {
-    return GenomicRegion {region.contig_name(), 0, region.end()};
+    return GenomicRegion {region.contig_id(), 0, region.end()};
 }
 
 void DoublePassVariantCallFilter::log_progress(const GenomicRegion& region) const
@@ -6,15 +6,12 @@
 
 #include <vector>
 #include <cstddef>
-#include <memory>
-#include <fstream>
 
 #include <boost/optional.hpp>
-#include <boost/filesystem.hpp>
-
-#include "ranger/Forest.h"
+#include <boost/filesystem/path.hpp>
 
 #include "double_pass_variant_call_filter.hpp"
+#include "ranger_forest.hpp"
 
 namespace octopus { namespace csr {
 
@@ -30,7 +27,6 @@ public:
                        OutputOptions output_config,
                        ConcurrencyPolicy threading,
                        Path ranger_forest,
-                       Path temp_directory = "/tmp",
                        boost::optional<ProgressMeter&> progress = boost::none);
     
     RandomForestFilter(const RandomForestFilter&)            = delete;
@@ -41,20 +37,11 @@ public:
     virtual ~RandomForestFilter() override = default;
 
 private:
-    struct File
-    {
-        std::ofstream handle;
-        Path path;
-        template <typename F, typename P>
-        File(F&& handle, P&& path) : handle {std::forward<F>(handle)}, path {std::forward<P>(path)} {};
-    };
-    
-    std::unique_ptr<ranger::Forest> forest_;
-    Path ranger_forest_, temp_dir_;
+    RangerForest forest_;
     
-    mutable std::vector<File> data_;
-    mutable std::size_t num_records_;
-    mutable std::vector<std::vector<double>> data_buffer_;
+    // Measures are buffered per sample and classified in batches as they are recorded
+    mutable std::vector<std::vector<double>> row_buffers_;
+    mutable std::vector<std::vector<double>> predictions_;
     
     const static std::string call_qual_name_;
     
@@ -64,6 +51,7 @@ private:
     void record(std::size_t call_idx, std::size_t sample_idx, MeasureVector measures) const override;
     void prepare_for_classification(boost::optional<Log>& log) const override;
     Classification classify(std::size_t call_idx, std::size_t sample_idx) const override;
+    void predict(std::size_t sample_idx) const;
 };
 
 } // namespace csr
@@ -27,23 +27,20 @@ static const auto default_measure_names = utils::split("AC AD AF ARF BQ CC CRF D
 RandomForestFilterFactory::RandomForestFilterFactory()
 : ranger_forests_ {}
 , forest_types_ {}
-, temp_directory_ {}
 {
     measures_ = parse_measures(default_measure_names);
 }
 
-RandomForestFilterFactory::RandomForestFilterFactory(Path ranger_forest, Path temp_directory, ForestType type)
+RandomForestFilterFactory::RandomForestFilterFactory(Path ranger_forest, ForestType type)
 : ranger_forests_ {std::move(ranger_forest)}
 , forest_types_ {type}
-, temp_directory_ {std::move(temp_directory)}
 {
     measures_ = parse_measures(default_measure_names);
 }
 
-RandomForestFilterFactory::RandomForestFilterFactory(Path germline_ranger_forest, Path somatic_ranger_forest, Path temp_directory)
+RandomForestFilterFactory::RandomForestFilterFactory(Path germline_ranger_forest, Path somatic_ranger_forest)
 : ranger_forests_ {std::move(germline_ranger_forest), std::move(somatic_ranger_forest)}
 , forest_types_ {ForestType::germline, ForestType::somatic}
-, temp_directory_ {std::move(temp_directory)}
 {
     measures_ = parse_measures(default_measure_names);
 }
@@ -69,20 +66,20 @@ RandomForestFilterFactory::do_make(FacetFactory facet_factory,
         switch (forest_types_.front()) {
             case ForestType::somatic:
                 return std::make_unique<SomaticRandomForestVariantCallFilter>(std::move(facet_factory), measures_, ranger_forests_[0],
-                                                                              output_config, threading, temp_directory_, progress);
+                                                                              output_config, threading, progress);
             case ForestType::denovo:
                 return std::make_unique<DeNovoRandomForestVariantCallFilter>(std::move(facet_factory), measures_, ranger_forests_[0],
-                                                                             output_config, threading, temp_directory_, progress);
+                                                                             output_config, threading, progress);
             case ForestType::germline:
             default:
                 return std::make_unique<RandomForestFilter>(std::move(facet_factory), measures_, output_config, threading,
-                                                            ranger_forests_[0], temp_directory_, progress);
+                                                            ranger_forests_[0], progress);
         }
     } else {
         assert(ranger_forests_.size() == 2);
         return std::make_unique<SomaticRandomForestVariantCallFilter>(std::move(facet_factory), measures_,
                                                                       ranger_forests_[0], ranger_forests_[1],
-                                                                      output_config, threading, temp_directory_, progress);
+                                                                      output_config, threading, progress);
     }
 }
 
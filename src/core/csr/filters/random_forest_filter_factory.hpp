@@ -28,8 +28,8 @@ public:
     enum class ForestType { germline, somatic, denovo };
     
     RandomForestFilterFactory();
-    RandomForestFilterFactory(Path ranger_forest, Path temp_directory, ForestType type = ForestType::germline);
-    RandomForestFilterFactory(Path germline_ranger_forest, Path somatic_ranger_forest, Path temp_directory);
+    RandomForestFilterFactory(Path ranger_forest, ForestType type = ForestType::germline);
+    RandomForestFilterFactory(Path germline_ranger_forest, Path somatic_ranger_forest);
     
     RandomForestFilterFactory(const RandomForestFilterFactory&)            = default;
     RandomForestFilterFactory& operator=(const RandomForestFilterFactory&) = default;
@@ -44,7 +44,6 @@ private:
     std::vector<MeasureWrapper> measures_;
     std::vector<Path> ranger_forests_;
     std::vector<ForestType> forest_types_;
-    Path temp_directory_;
     
     std::unique_ptr<VariantCallFilterFactory> do_clone() const override;
     std::unique_ptr<VariantCallFilter> do_make(FacetFactory facet_factory,
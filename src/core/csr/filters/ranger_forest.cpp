@@ -0,0 +1,232 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "ranger_forest.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <cassert>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "ranger/globals.h"
+#include "ranger/utility.h"
+
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "utils/parallel_algorithms.hpp"
+
+namespace octopus { namespace csr {
+
+namespace {
+
+class MissingForestFile : public MissingFileError
+{
+    std::string do_where() const override { return "RangerForest"; }
+public:
+    MissingForestFile(boost::filesystem::path p) : MissingFileError {std::move(p), ".forest"} {};
+};
+
+class MalformedForestFile : public MalformedFileError
+{
+    std::string do_where() const override { return "RangerForest"; }
+    std::string do_help() const override
+    {
+        return "make sure the forest is a ranger probability forest trained with the same measures and in the same order as the prediction measures";
+    }
+public:
+    MalformedForestFile(boost::filesystem::path file, std::string reason) : MalformedFileError {std::move(file)}
+    {
+        set_reason(std::move(reason));
+    }
+};
+
+struct TreeData
+{
+    std::vector<std::vector<std::size_t>> child_node_ids;
+    std::vector<std::size_t> split_var_ids;
+    std::vector<double> split_values;
+    std::vector<std::vector<double>> terminal_class_frequencies;
+};
+
+} // namespace
+
+constexpr std::uint32_t RangerForest::terminal_;
+
+RangerForest::RangerForest(const Path& forest_file, const std::size_t num_features, const double response_class)
+: nodes_ {}
+, roots_ {}
+, num_features_ {num_features}
+{
+    if (!boost::filesystem::exists(forest_file)) {
+        throw MissingForestFile {forest_file};
+    }
+    std::ifstream in {forest_file.string(), std::ios::binary};
+    in.exceptions(std::ios::failbit | std::ios::badbit);
+    try {
+        // Layout written by ranger::Forest::saveToFile and ranger::ForestProbability::saveToFileInternal
+        std::size_t dependent_var_id, num_trees, num_variables_saved;
+        in.read((char*) &dependent_var_id, sizeof(dependent_var_id));
+        in.read((char*) &num_trees, sizeof(num_trees));
+        // ranger appends the saved variable types to those of the prediction data, so every
+        // prediction variable is treated as ordered; this is kept for compatibility
+        std::vector<bool> is_ordered_variable {};
+        ranger::readVector1D(is_ordered_variable, in);
+        in.read((char*) &num_variables_saved, sizeof(num_variables_saved));
+        ranger::TreeType tree_type;
+        in.read((char*) &tree_type, sizeof(tree_type));
+        if (tree_type != ranger::TREE_PROBABILITY) {
+            throw MalformedForestFile {forest_file, "not a probability forest"};
+        }
+        std::vector<double> class_values {};
+        ranger::readVector1D(class_values, in);
+        const auto response_itr = std::find(std::cbegin(class_values), std::cend(class_values), response_class);
+        if (response_itr == std::cend(class_values)) {
+            throw MalformedForestFile {forest_file, "response class not found"};
+        }
+        const auto response_class_idx = static_cast<std::size_t>(std::distance(std::cbegin(class_values), response_itr));
+        // Prediction data includes a dummy response column after the features
+        const auto num_prediction_variables = num_features_ + 1;
+        roots_.reserve(num_trees);
+        TreeData tree {};
+        std::vector<std::size_t> terminal_nodes {};
+        std::vector<std::vector<double>> terminal_class_frequencies {};
+        constexpr auto no_parent = std::numeric_limits<std::size_t>::max();
+        std::vector<std::pair<std::size_t, std::size_t>> stack {}; // tree node, flat index of the parent of a right child
+        for (std::size_t tree_idx {0}; tree_idx < num_trees; ++tree_idx) {
+            ranger::readVector2D(tree.child_node_ids, in);
+            ranger::readVector1D(tree.split_var_ids, in);
+            ranger::readVector1D(tree.split_values, in);
+            ranger::readVector1D(terminal_nodes, in);
+            ranger::readVector2D(terminal_class_frequencies, in);
+            if (tree.child_node_ids.size() != 2 || tree.child_node_ids[0].empty()
+                || terminal_nodes.size() != terminal_class_frequencies.size()) {
+                throw MalformedForestFile {forest_file, "bad tree"};
+            }
+            const auto num_tree_nodes = tree.child_node_ids[0].size();
+            tree.terminal_class_frequencies.assign(num_tree_nodes, {});
+            for (std::size_t i {0}; i < terminal_nodes.size(); ++i) {
+                tree.terminal_class_frequencies.at(terminal_nodes[i]) = std::move(terminal_class_frequencies[i]);
+            }
+            if (num_variables_saved > num_prediction_variables) {
+                for (auto& var_id : tree.split_var_ids) {
+                    if (var_id >= dependent_var_id) --var_id;
+                }
+            }
+            // Depth-first layout: the left child of each split node immediately follows it
+            roots_.push_back(static_cast<std::uint32_t>(nodes_.size()));
+            stack.assign({{0, no_parent}});
+            while (!stack.empty()) {
+                const auto node_id = stack.back().first;
+                const auto parent_idx = stack.back().second;
+                stack.pop_back();
+                if (node_id >= num_tree_nodes) {
+                    throw MalformedForestFile {forest_file, "bad tree"};
+                }
+                const auto flat_idx = nodes_.size();
+                if (parent_idx != no_parent) nodes_[parent_idx].right = static_cast<std::uint32_t>(flat_idx);
+                const auto left = tree.child_node_ids[0][node_id], right = tree.child_node_ids[1][node_id];
+                if (left == 0 && right == 0) {
+                    const auto& frequencies = tree.terminal_class_frequencies[node_id];
+                    const auto frequency = response_class_idx < frequencies.size() ? frequencies[response_class_idx] : 0.0;
+                    nodes_.push_back({terminal_, 0, frequency});
+                } else {
+                    const auto split_var = tree.split_var_ids.at(node_id);
+                    if (split_var >= num_features_) {
+                        throw MalformedForestFile {forest_file, "split on unknown variable"};
+                    }
+                    nodes_.push_back({static_cast<std::uint32_t>(split_var), 0, tree.split_values.at(node_id)});
+                    stack.emplace_back(right, flat_idx);
+                    stack.emplace_back(left, no_parent); // visited next, so lands at flat_idx + 1
+                }
+            }
+        }
+        if (nodes_.size() >= terminal_) {
+            throw MalformedForestFile {forest_file, "too many nodes"};
+        }
+    } catch (const std::ios::failure& e) {
+        throw MalformedForestFile {forest_file, "unexpected end of file"};
+    } catch (const std::out_of_range& e) {
+        throw MalformedForestFile {forest_file, "bad tree"};
+    }
+    if (roots_.empty()) {
+        throw MalformedForestFile {forest_file, "empty forest"};
+    }
+    nodes_.shrink_to_fit();
+}
+
+std::size_t RangerForest::num_trees() const noexcept
+{
+    return roots_.size();
+}
+
+std::size_t RangerForest::num_features() const noexcept
+{
+    return num_features_;
+}
+
+double RangerForest::predict(const double* row) const noexcept
+{
+    double result;
+    predict(row, 1, &result);
+    return result;
+}
+
+void RangerForest::predict(const std::vector<double>& rows, std::vector<double>& result) const
+{
+    assert(rows.size() % num_features_ == 0);
+    const auto num_rows = rows.size() / num_features_;
+    const auto num_results = result.size();
+    result.resize(num_results + num_rows);
+    predict(rows.data(), num_rows, result.data() + num_results);
+}
+
+void RangerForest::predict(const std::vector<double>& rows, std::vector<double>& result, ThreadPool& workers) const
+{
+    assert(rows.size() % num_features_ == 0);
+    const auto num_rows = rows.size() / num_features_;
+    constexpr std::size_t min_rows_per_task {256};
+    if (workers.empty() || num_rows < 2 * min_rows_per_task) {
+        predict(rows, result);
+        return;
+    }
+    const auto num_results = result.size();
+    result.resize(num_results + num_rows);
+    const auto num_tasks = (num_rows + min_rows_per_task - 1) / min_rows_per_task;
+    parallel_for(std::size_t {0}, num_tasks, [&] (const std::size_t task) {
+        const auto first = task * min_rows_per_task;
+        const auto n = std::min(min_rows_per_task, num_rows - first);
+        predict(rows.data() + first * num_features_, n, result.data() + num_results + first);
+    }, workers);
+}
+
+// private methods
+
+void RangerForest::predict(const double* first_row, const std::size_t num_rows, double* result) const noexcept
+{
+    // Rows are processed in small blocks, tree by tree, so each tree's nodes stay in cache for the block
+    constexpr std::size_t block_size {64};
+    const auto num_trees = static_cast<double>(roots_.size());
+    for (std::size_t block_begin {0}; block_begin < num_rows; block_begin += block_size) {
+        const auto block_end = std::min(block_begin + block_size, num_rows);
+        std::fill(result + block_begin, result + block_end, 0.0);
+        for (const auto root : roots_) {
+            for (auto row_idx = block_begin; row_idx < block_end; ++row_idx) {
+                const double* row {first_row + row_idx * num_features_};
+                auto node = root;
+                while (nodes_[node].feature != terminal_) {
+                    const auto& split = nodes_[node];
+                    node = row[split.feature] <= split.value ? node + 1 : split.right;
+                }
+                result[row_idx] += nodes_[node].value;
+            }
+        }
+        std::for_each(result + block_begin, result + block_end, [=] (double& p) { p /= num_trees; });
+    }
+}
+
+} // namespace csr
+} // namespace octopus
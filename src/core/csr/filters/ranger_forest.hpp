@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef ranger_forest_hpp
+#define ranger_forest_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "utils/thread_pool.hpp"
+
+namespace octopus { namespace csr {
+
+/*
+ An immutable, in-memory probability forest loaded from a ranger .forest file.
+
+ Every tree is laid out depth-first in a single flat node array, so the left child of a split node is
+ always the next node and only the right child index is stored. Prediction returns the forest average
+ of the terminal node frequency for one response class, identical to ranger's probability prediction.
+
+ Rows are dense, row-major feature vectors with num_features() columns, in the same order as the
+ columns of the training data excluding the response.
+ */
+class RangerForest
+{
+public:
+    using Path = boost::filesystem::path;
+
+    RangerForest() = delete;
+
+    RangerForest(const Path& forest_file, std::size_t num_features, double response_class = 0);
+
+    RangerForest(const RangerForest&)            = default;
+    RangerForest& operator=(const RangerForest&) = default;
+    RangerForest(RangerForest&&)                 = default;
+    RangerForest& operator=(RangerForest&&)      = default;
+
+    ~RangerForest() = default;
+
+    std::size_t num_trees() const noexcept;
+    std::size_t num_features() const noexcept;
+
+    double predict(const double* row) const noexcept;
+    // Appends a prediction for each row in rows
+    void predict(const std::vector<double>& rows, std::vector<double>& result) const;
+    void predict(const std::vector<double>& rows, std::vector<double>& result, ThreadPool& workers) const;
+
+private:
+    struct Node
+    {
+        std::uint32_t feature, right;
+        double value; // split value, or response class frequency for terminal nodes
+    };
+
+    static constexpr std::uint32_t terminal_ = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> roots_;
+    std::size_t num_features_;
+
+    void predict(const double* first_row, std::size_t num_rows, double* result) const noexcept;
+};
+
+} // namespace csr
+} // namespace octopus
+
+#endif
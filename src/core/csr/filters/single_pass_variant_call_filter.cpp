@@ -31,9 +31,9 @@ void SinglePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& des
     assert(dest.is_header_written());
     if (progress_) progress_->start();
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            filter(read_next_blocks(p.first, p.second, samples), dest, samples);
-        }
+        measure_pipelined(source, samples, [&] (const CallBlock& block, const MeasureBlock& measures) {
+            filter(block, measures, dest, samples);
+        });
     } else if (can_measure_single_call()) {
         auto p = source.iterate();
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, dest, samples); });
@@ -55,15 +55,6 @@ void SinglePassVariantCallFilter::filter(const CallBlock& block, VcfWriter& dest
     filter(block, measure(block), dest, samples);
 }
 
-void SinglePassVariantCallFilter::filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const SampleList& samples) const
-{
-    const auto measures = measure(blocks);
-    assert(measures.size() == blocks.size());
-    for (auto tup : boost::combine(blocks, measures)) {
-        filter(tup.get<0>(), tup.get<1>(), dest, samples);
-    }
-}
-
 void SinglePassVariantCallFilter::filter(const CallBlock& block, const MeasureBlock& measures, VcfWriter& dest, const SampleList& samples) const
 {
     assert(measures.size() == block.size());
@@ -99,7 +90,7 @@ SinglePassVariantCallFilter::classify(const MeasureVector& call_measures, const
 
 static auto expand_lhs_to_zero(const GenomicRegion& region)
 {
-    return GenomicRegion {region.contig_name(), 0, region.end()};
+    return GenomicRegion {region.contig_id(), 0, region.end()};
 }
 
 void SinglePassVariantCallFilter::log_progress(const GenomicRegion& region) const
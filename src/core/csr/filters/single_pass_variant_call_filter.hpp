@@ -45,7 +45,6 @@ private:
     void filter(const VcfReader& source, VcfWriter& dest, const SampleList& samples) const override;
     void filter(const VcfRecord& call, VcfWriter& dest, const SampleList& samples) const;
     void filter(const CallBlock& block, VcfWriter& dest, const SampleList& samples) const;
-    void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const SampleList& samples) const;
     void filter(const CallBlock& block, const MeasureBlock & measures, VcfWriter& dest, const SampleList& samples) const;
     void filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest, const SampleList& samples) const;
     ClassificationList classify(const MeasureVector& call_measures, const SampleList& samples) const;
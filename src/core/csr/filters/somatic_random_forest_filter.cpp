@@ -15,7 +15,6 @@ SomaticRandomForestVariantCallFilter::SomaticRandomForestVariantCallFilter(Facet
                                                                            Path germline_forest, Path somatic_forest,
                                                                            OutputOptions output_config,
                                                                            ConcurrencyPolicy threading,
-                                                                           Path temp_directory,
                                                                            boost::optional<ProgressMeter&> progress)
 : ConditionalRandomForestFilter {
     std::move(facet_factory),
@@ -33,7 +32,6 @@ SomaticRandomForestVariantCallFilter::SomaticRandomForestVariantCallFilter(Facet
     {std::move(germline_forest), std::move(somatic_forest)},
     std::move(output_config),
     std::move(threading),
-    std::move(temp_directory),
     progress
 } {}
 
@@ -42,7 +40,6 @@ SomaticRandomForestVariantCallFilter::SomaticRandomForestVariantCallFilter(Facet
                                                                            Path somatic_forest,
                                                                            OutputOptions output_config,
                                                                            ConcurrencyPolicy threading,
-                                                                           Path temp_directory,
                                                                            boost::optional<ProgressMeter&> progress)
 : ConditionalRandomForestFilter {
     std::move(facet_factory),
@@ -55,7 +52,6 @@ SomaticRandomForestVariantCallFilter::SomaticRandomForestVariantCallFilter(Facet
     {std::move(somatic_forest)},
     std::move(output_config),
     std::move(threading),
-    std::move(temp_directory),
     progress
 } {}
 
@@ -28,7 +28,6 @@ public:
                                          Path germline_forest, Path somatic_forest,
                                          OutputOptions output_config,
                                          ConcurrencyPolicy threading,
-                                         Path temp_directory = "/tmp",
                                          boost::optional<ProgressMeter&> progress = boost::none);
     // Somatics only
     SomaticRandomForestVariantCallFilter(FacetFactory facet_factory,
@@ -36,7 +35,6 @@ public:
                                          Path somatic_forest,
                                          OutputOptions output_config,
                                          ConcurrencyPolicy threading,
-                                         Path temp_directory = "/tmp",
                                          boost::optional<ProgressMeter&> progress = boost::none);
     
     SomaticRandomForestVariantCallFilter(const SomaticRandomForestVariantCallFilter&)            = delete;
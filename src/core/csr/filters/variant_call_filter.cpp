@@ -12,6 +12,10 @@
 #include <limits>
 #include <cmath>
 #include <thread>
+#include <memory>
+#include <deque>
+#include <exception>
+#include <future>
 
 #include <boost/range/combine.hpp>
 
@@ -26,7 +30,8 @@
 #include "utils/string_utils.hpp"
 #include "utils/genotype_reader.hpp"
 #include "utils/append.hpp"
-#include "utils/parallel_transform.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/bounded_queue.hpp"
 #include "io/variant/vcf_writer.hpp"
 #include "io/variant/vcf_spec.hpp"
 
@@ -34,18 +39,9 @@ namespace octopus { namespace csr {
 
 namespace {
 
-unsigned get_pool_size(VariantCallFilter::ConcurrencyPolicy policy)
+bool allows_multithreading(VariantCallFilter::ConcurrencyPolicy policy) noexcept
 {
-    const auto num_cores = std::thread::hardware_concurrency();
-    if (policy.max_threads) {
-        if (*policy.max_threads > 1) {
-            return num_cores > 0 ? std::min(*policy.max_threads, num_cores) : *policy.max_threads;
-        } else {
-            return 0;
-        }
-    } else {
-        return num_cores > 0 ? num_cores : 8;
-    }
+    return !policy.max_threads || *policy.max_threads > 1;
 }
 
 } // namespace
@@ -62,7 +58,7 @@ VariantCallFilter::VariantCallFilter(FacetFactory facet_factory,
 , facet_names_ {get_all_requirements(measures_)}
 , output_config_ {output_config}
 , duplicate_measures_ {}
-, workers_ {get_pool_size(threading)}
+, multithreaded_ {allows_multithreading(threading)}
 {
     std::unordered_map<MeasureWrapper, int> measure_counts {};
     measure_counts.reserve(measures_.size());
@@ -196,23 +192,6 @@ VariantCallFilter::read_next_block(VcfIterator& first, const VcfIterator& last,
     return copy_each_first(block);
 }
 
-std::vector<VariantCallFilter::CallBlock>
-VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const
-{
-    std::vector<VariantCallFilter::CallBlock> result {};
-    if (can_measure_multiple_blocks()) {
-        const auto max_blocks = max_concurrent_blocks();
-        result.reserve(max_blocks);
-        while (result.size() < max_blocks) {
-            result.push_back(read_next_block(first, last, samples));
-            if (first == last || !is_same_contig(*first, result.back().front())) break;
-        }
-    } else {
-        result.push_back(read_next_block(first, last, samples));
-    }
-    return result;
-}
-
 VariantCallFilter::MeasureVector VariantCallFilter::measure(const VcfRecord& call) const
 {
     MeasureVector result(measures_.size());
@@ -244,25 +223,138 @@ VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& bloc
     return measure(block, facets);
 }
 
-std::vector<VariantCallFilter::MeasureBlock> VariantCallFilter::measure(const std::vector<CallBlock>& blocks) const
+namespace {
+
+auto make_map(const std::vector<std::string>& names, std::vector<FacetWrapper>&& facets)
 {
-    std::vector<MeasureBlock> result {};
-    result.reserve(blocks.size());
-    if (is_multithreaded()) {
-        const auto facets = compute_facets(blocks);
-        if (debug_log_) {
-            stream(*debug_log_) << "Measuring " << blocks.size() << " blocks with " << workers_.size() << " threads";
+    assert(names.size() == facets.size());
+    Measure::FacetMap result {};
+    result.reserve(names.size());
+    for (auto tup : boost::combine(names, std::move(facets))) {
+        result.emplace(tup.get<0>(), std::move(tup.get<1>()));
+    }
+    return result;
+}
+
+template <typename... Queues>
+void close_queues(Queues&... queues) noexcept
+{
+    (void) std::initializer_list<int> {(queues.close(), 0)...};
+}
+
+// Owns the threads running pipeline stages. A stage closes its queues when it finishes, and all queues
+// are closed before the threads are joined, so no stage is left blocked if another stage throws.
+// Stage exceptions are captured and rethrown by join.
+class PipelineStages
+{
+public:
+    PipelineStages() = delete;
+    
+    template <typename... Queues>
+    explicit PipelineStages(Queues&... queues) : close_all_ {[&queues...] () { close_queues(queues...); }} {}
+    
+    PipelineStages(const PipelineStages&)            = delete;
+    PipelineStages& operator=(const PipelineStages&) = delete;
+    PipelineStages(PipelineStages&&)                 = delete;
+    PipelineStages& operator=(PipelineStages&&)      = delete;
+    
+    ~PipelineStages() { close_all_(); wait(); }
+    
+    template <typename F, typename... Queues>
+    void launch(F f, Queues&... queues)
+    {
+        errors_.emplace_back();
+        auto& error = errors_.back();
+        threads_.emplace_back([f = std::move(f), &error, &queues...] () mutable {
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            close_queues(queues...);
+        });
+    }
+    
+    void join()
+    {
+        wait();
+        for (const auto& error : errors_) {
+            if (error) std::rethrow_exception(error);
         }
-        transform(std::cbegin(blocks), std::cend(blocks), std::cbegin(facets), std::back_inserter(result),
-                  [this] (const auto& block, const auto& block_facets) {
-                      return this->measure(block, block_facets);
-                  }, workers_);
-    } else {
-        for (const CallBlock& block : blocks) {
-            result.push_back(measure(block));
+    }
+    
+private:
+    std::function<void()> close_all_;
+    std::deque<std::thread> threads_;
+    std::deque<std::exception_ptr> errors_;
+    
+    void wait() noexcept
+    {
+        for (auto& thread : threads_) {
+            if (thread.joinable()) thread.join();
         }
     }
-    return result;
+};
+
+} // namespace
+
+void VariantCallFilter::measure_pipelined(const VcfReader& source, const SampleList& samples,
+                                          const MeasuredBlockVisitor& visitor) const
+{
+    if (!is_multithreaded()) {
+        read_blocks(source, samples, [&] (const CallBlock& block) { visitor(block, measure(block)); });
+        return;
+    }
+    using SharedCallBlock = std::shared_ptr<const CallBlock>;
+    struct PendingBlock
+    {
+        SharedCallBlock calls;
+        std::future<MeasureBlock> measures;
+    };
+    BoundedQueue<SharedCallBlock> read_queue {max_concurrent_blocks()};
+    BoundedQueue<PendingBlock> pending_queue {max_concurrent_blocks()};
+    PipelineStages stages {read_queue, pending_queue};
+    stages.launch([&] () {
+        for (auto p = source.iterate(); p.first != p.second;) {
+            auto block = std::make_shared<const CallBlock>(read_next_block(p.first, p.second, samples));
+            if (!read_queue.push(std::move(block))) break;
+        }
+    }, read_queue);
+    stages.launch([&] () {
+        while (auto block = read_queue.pop()) {
+            // Reads are fetched in order on this thread; everything else is done in the pool
+            auto data = facet_factory_.fetch_serial_data(facet_names_, **block);
+            auto measures = thread_pool().push([this, block = *block, data = std::move(data)] () mutable {
+                const auto facets = make_map(facet_names_, facet_factory_.make(facet_names_, *block, std::move(data)));
+                return this->measure(*block, facets);
+            });
+            if (!pending_queue.push({std::move(*block), std::move(measures)})) break;
+        }
+    }, read_queue, pending_queue);
+    while (auto block = pending_queue.pop()) {
+        visitor(*block->calls, block->measures.get());
+    }
+    stages.join();
+}
+
+void VariantCallFilter::read_pipelined(const VcfReader& source, const SampleList& samples,
+                                       const BlockVisitor& visitor) const
+{
+    if (!is_multithreaded()) {
+        read_blocks(source, samples, visitor);
+        return;
+    }
+    BoundedQueue<CallBlock> read_queue {max_concurrent_blocks()};
+    PipelineStages stages {read_queue};
+    stages.launch([&] () {
+        for (auto p = source.iterate(); p.first != p.second;) {
+            if (!read_queue.push(read_next_block(p.first, p.second, samples))) break;
+        }
+    }, read_queue);
+    while (auto block = read_queue.pop()) {
+        visitor(*block);
+    }
+    stages.join();
 }
 
 void VariantCallFilter::write(const VcfRecord& call, const Classification& classification, VcfWriter& dest) const
@@ -298,6 +390,12 @@ void VariantCallFilter::annotate(VcfRecord::Builder& call, const MeasureVector&
     }
 }
 
+ThreadPool& VariantCallFilter::thread_pool() const
+{
+    static ThreadPool serial_pool {};
+    return multithreaded_ ? shared_thread_pool() : serial_pool;
+}
+
 // private methods
 
 bool VariantCallFilter::is_soft_filtered(const ClassificationList& sample_classifications, const MeasureVector& measures) const
@@ -401,33 +499,11 @@ void VariantCallFilter::annotate(VcfRecord::Builder& call, const Classification
     }
 }
 
-auto make_map(const std::vector<std::string>& names, std::vector<FacetWrapper>&& facets)
-{
-    assert(names.size() == facets.size());
-    Measure::FacetMap result {};
-    result.reserve(names.size());
-    for (auto tup : boost::combine(names, std::move(facets))) {
-        result.emplace(tup.get<0>(), std::move(tup.get<1>()));
-    }
-    return result;
-}
-
 Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block) const
 {
     return make_map(facet_names_, facet_factory_.make(facet_names_, block));
 }
 
-std::vector<Measure::FacetMap> VariantCallFilter::compute_facets(const std::vector<CallBlock>& blocks) const
-{
-    auto facets = facet_factory_.make(facet_names_, blocks, workers_);
-    std::vector<Measure::FacetMap> result {};
-    result.reserve(blocks.size());
-    for (auto& block : facets) {
-        result.push_back(make_map(facet_names_, std::move(block)));
-    }
-    return result;
-}
-
 VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& block, const Measure::FacetMap& facets) const
 {
     if (debug_log_ && !block.empty()) {
@@ -488,19 +564,26 @@ void VariantCallFilter::fail(VcfRecord::Builder& call, std::vector<std::string>
     }
 }
 
-bool VariantCallFilter::is_multithreaded() const noexcept
+bool VariantCallFilter::is_multithreaded() const
 {
-    return !workers_.empty();
+    return !thread_pool().empty();
 }
 
-unsigned VariantCallFilter::max_concurrent_blocks() const noexcept
+unsigned VariantCallFilter::max_concurrent_blocks() const
 {
     if (is_multithreaded()) {
-        return std::min(100 * workers_.size(), std::size_t {10'000});
+        return std::min(100 * thread_pool().size(), std::size_t {10'000});
     } else {
         return 1;
     }
 }
 
+void VariantCallFilter::read_blocks(const VcfReader& source, const SampleList& samples, const BlockVisitor& visitor) const
+{
+    for (auto p = source.iterate(); p.first != p.second;) {
+        visitor(read_next_block(p.first, p.second, samples));
+    }
+}
+
 } // namespace csr
 } // namespace octopus
@@ -89,15 +89,23 @@ protected:
     bool can_measure_single_call() const noexcept;
     bool can_measure_multiple_blocks() const noexcept;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
-    std::vector<CallBlock> read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
     MeasureVector measure(const VcfRecord& call) const;
     MeasureBlock measure(const CallBlock& block) const;
-    std::vector<MeasureBlock> measure(const std::vector<CallBlock>& blocks) const;
+    
+    using BlockVisitor         = std::function<void(const CallBlock&)>;
+    using MeasuredBlockVisitor = std::function<void(const CallBlock&, const MeasureBlock&)>;
+    
+    // Streams blocks through a bounded pipeline: a reader thread, an in-order read prefetch thread,
+    // facet & measure tasks in the worker pool, and the calling thread, which visits blocks in input order.
+    void measure_pipelined(const VcfReader& source, const SampleList& samples, const MeasuredBlockVisitor& visitor) const;
+    // As above but without measuring, so record decoding overlaps with the visitor.
+    void read_pipelined(const VcfReader& source, const SampleList& samples, const BlockVisitor& visitor) const;
     void write(const VcfRecord& call, const Classification& classification, VcfWriter& dest) const;
     void write(const VcfRecord& call, const Classification& classification,
                const SampleList& samples, const ClassificationList& sample_classifications,
                VcfWriter& dest) const;
     void annotate(VcfRecord::Builder& call, const MeasureVector& measures) const;
+    ThreadPool& thread_pool() const;
     
 private:
     using FacetNameSet = std::vector<std::string>;
@@ -107,7 +115,7 @@ private:
     OutputOptions output_config_;
     std::vector<MeasureWrapper> duplicate_measures_;
     
-    mutable ThreadPool workers_;
+    bool multithreaded_;
     
     virtual void annotate(VcfHeader::Builder& header) const = 0;
     virtual void filter(const VcfReader& source, VcfWriter& dest, const SampleList& samples) const = 0;
@@ -117,7 +125,6 @@ private:
     
     VcfHeader make_header(const VcfReader& source) const;
     Measure::FacetMap compute_facets(const CallBlock& block) const;
-    std::vector<Measure::FacetMap> compute_facets(const std::vector<CallBlock>& blocks) const;
     MeasureBlock measure(const CallBlock& block, const Measure::FacetMap& facets) const;
     MeasureVector measure(const VcfRecord& call, const Measure::FacetMap& facets) const;
     VcfRecord::Builder construct_template(const VcfRecord& call) const;
@@ -129,8 +136,9 @@ private:
     void pass(VcfRecord::Builder& call) const;
     void fail(const SampleName& sample, VcfRecord::Builder& call, std::vector<std::string> reasons) const;
     void fail(VcfRecord::Builder& call, std::vector<std::string> reasons) const;
-    bool is_multithreaded() const noexcept;
-    unsigned max_concurrent_blocks() const noexcept;
+    bool is_multithreaded() const;
+    unsigned max_concurrent_blocks() const;
+    void read_blocks(const VcfReader& source, const SampleList& samples, const BlockVisitor& visitor) const;
 };
 
 } // namespace csr
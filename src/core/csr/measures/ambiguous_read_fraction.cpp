@@ -14,7 +14,7 @@
 #include "io/variant/vcf_spec.hpp"
 #include "utils/genotype_reader.hpp"
 #include "../facets/samples.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/read_summaries.hpp"
 #include "../facets/read_assignments.hpp"
 
 namespace octopus { namespace csr {
@@ -29,13 +29,13 @@ std::unique_ptr<Measure> AmbiguousReadFraction::do_clone() const
 Measure::ResultType AmbiguousReadFraction::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     const auto& samples = get_value<Samples>(facets.at("Samples"));
-    const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
+    const auto& summaries = get_value<ReadSummaries>(facets.at("ReadSummaries")).samples;
     const auto& ambiguous_reads = get_value<ReadAssignments>(facets.at("ReadAssignments")).ambiguous;
     std::vector<boost::optional<double>> result {};
     result.reserve(samples.size());
     for (const auto& sample : samples) {
         boost::optional<double> sample_result {};
-        const auto num_overlapping_reads = count_overlapped(reads.at(sample), call);
+        const auto num_overlapping_reads = summaries.at(sample).count_reads(mapped_region(call));
         if (num_overlapping_reads > 0) {
             if (ambiguous_reads.count(sample) == 1) {
                 const auto num_ambiguous_reads = count_overlapped(ambiguous_reads.at(sample), call);
@@ -66,7 +66,7 @@ std::string AmbiguousReadFraction::do_describe() const
 
 std::vector<std::string> AmbiguousReadFraction::do_requirements() const
 {
-    return {"Samples", "OverlappingReads", "ReadAssignments"};
+    return {"Samples", "ReadSummaries", "ReadAssignments"};
 }
 
 } // namespace csr
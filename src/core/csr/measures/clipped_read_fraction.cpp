@@ -3,14 +3,10 @@
 
 #include "clipped_read_fraction.hpp"
 
-#include <cassert>
-
 #include <boost/variant.hpp>
 
-#include "basics/aligned_read.hpp"
 #include "io/variant/vcf_record.hpp"
-#include "utils/read_stats.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/read_summaries.hpp"
 
 namespace octopus { namespace csr {
 
@@ -23,26 +19,10 @@ std::unique_ptr<Measure> ClippedReadFraction::do_clone() const
 
 namespace {
 
-auto clip_fraction(const AlignedRead& read) noexcept
-{
-    assert(sequence_size(read) > 0);
-    return static_cast<double>(total_clip_size(read)) / sequence_size(read);
-}
-
-bool is_significantly_clipped(const AlignedRead& read) noexcept
+Measure::ResultType clipped_fraction(const RegionReadSummary& reads, const GenomicRegion& region)
 {
-    return is_soft_clipped(read) && clip_fraction(read) > 0.25;
-}
-
-Measure::ResultType clipped_fraction(const ReadMap& reads, const GenomicRegion& region)
-{
-    unsigned num_reads {0}, num_soft_clipped_reads {0};
-    for (const auto& p : reads) {
-        for (const auto& read : overlap_range(p.second, region)) {
-            if (is_significantly_clipped(read)) ++num_soft_clipped_reads;
-            ++num_reads;
-        }
-    }
+    const auto num_reads = reads.count_reads(region);
+    const auto num_soft_clipped_reads = reads.count_heavily_clipped(region);
     boost::optional<double> result {};
     if (num_reads > 0) {
         result = static_cast<double>(num_soft_clipped_reads) / num_reads;
@@ -54,8 +34,8 @@ Measure::ResultType clipped_fraction(const ReadMap& reads, const GenomicRegion&
 
 Measure::ResultType ClippedReadFraction::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
-    const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-    return clipped_fraction(reads, mapped_region(call));
+    const auto& summaries = get_value<ReadSummaries>(facets.at("ReadSummaries"));
+    return clipped_fraction(summaries.combined, mapped_region(call));
 }
 
 Measure::ResultCardinality ClippedReadFraction::do_cardinality() const noexcept
@@ -75,7 +55,7 @@ std::string ClippedReadFraction::do_describe() const
 
 std::vector<std::string> ClippedReadFraction::do_requirements() const
 {
-    return {"OverlappingReads"};
+    return {"ReadSummaries"};
 }
 
 } // namespace csr
@@ -3,14 +3,11 @@
 
 #include "mean_mapping_quality.hpp"
 
-#include <cassert>
-
 #include <boost/variant.hpp>
 
 #include "io/variant/vcf_record.hpp"
-#include "utils/read_stats.hpp"
 #include "io/variant/vcf_spec.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/read_summaries.hpp"
 
 namespace octopus { namespace csr {
 
@@ -26,9 +23,8 @@ std::unique_ptr<Measure> MeanMappingQuality::do_clone() const
 Measure::ResultType MeanMappingQuality::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     if (recalculate_) {
-        const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-        assert(!reads.empty());
-        return rmq_mapping_quality(reads, mapped_region(call));
+        const auto& summaries = get_value<ReadSummaries>(facets.at("ReadSummaries"));
+        return summaries.combined.rmq_mapping_quality(mapped_region(call));
     } else {
         return std::stod(call.info_value(vcfspec::info::rmsMappingQuality).front());
     }
@@ -52,7 +48,7 @@ std::string MeanMappingQuality::do_describe() const
 std::vector<std::string> MeanMappingQuality::do_requirements() const
 {
     if (recalculate_) {
-        return {"OverlappingReads"};
+        return {"ReadSummaries"};
     } else {
         return {};
     }
@@ -8,10 +8,9 @@
 #include "io/variant/vcf_record.hpp"
 #include "io/variant/vcf_spec.hpp"
 #include "basics/aligned_read.hpp"
-#include "utils/read_stats.hpp"
 #include "utils/maths.hpp"
 #include "../facets/samples.hpp"
-#include "../facets/overlapping_reads.hpp"
+#include "../facets/read_summaries.hpp"
 
 namespace octopus { namespace csr {
 
@@ -45,11 +44,11 @@ std::vector<std::string> StrandDisequilibrium::do_parameters() const
 Measure::ResultType StrandDisequilibrium::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     const auto& samples = get_value<Samples>(facets.at("Samples"));
-    const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
+    const auto& summaries = get_value<ReadSummaries>(facets.at("ReadSummaries")).samples;
     std::vector<double> result {};
     result.reserve(samples.size());
     for (const auto& sample : samples) {
-        const auto direction_counts = count_directions(reads.at(sample), mapped_region(call));
+        const auto direction_counts = summaries.at(sample).count_directions(mapped_region(call));
         const auto tail_probability = maths::beta_tail_probability(direction_counts.first + 0.5, direction_counts.second + 0.5, tail_mass_);
         result.push_back(tail_probability);
     }
@@ -73,7 +72,7 @@ std::string StrandDisequilibrium::do_describe() const
 
 std::vector<std::string> StrandDisequilibrium::do_requirements() const
 {
-    return {"Samples", "OverlappingReads"};
+    return {"Samples", "ReadSummaries"};
 }
 
 bool StrandDisequilibrium::is_equal(const Measure& other) const noexcept
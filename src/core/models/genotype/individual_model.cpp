@@ -96,6 +96,20 @@ IndividualModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     return result;
 }
 
+IndividualModel::InferredLatents
+IndividualModel::evaluate(const GenotypeIndexRange& genotypes,
+                          const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    assert(!genotypes.empty());
+    assert(is_primed() && haplotypes_->size() == genotypes.num_elements());
+    const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods, *haplotypes_};
+    InferredLatents result {};
+    result.posteriors.genotype_probabilities = octopus::model::evaluate(genotypes, likelihood_model);
+    octopus::evaluate(genotypes, genotype_prior_model_, result.posteriors.genotype_probabilities, false, true);
+    result.log_evidence = maths::normalise_exp(result.posteriors.genotype_probabilities);
+    return result;
+}
+
 namespace debug {
 
 using octopus::debug::print_variant_alleles;
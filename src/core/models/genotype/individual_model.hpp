@@ -12,6 +12,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index_range.hpp"
 #include "logging/logging.hpp"
 
 namespace octopus { namespace model {
@@ -57,6 +58,10 @@ public:
                              const std::vector<GenotypeIndex>& genotype_indices,
                              const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     
+    // Requires the model to be primed. Posteriors are in the order of genotype ranks.
+    InferredLatents evaluate(const GenotypeIndexRange& genotypes,
+                             const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    
 private:
     const GenotypePriorModel& genotype_prior_model_;
     const std::vector<Haplotype>* haplotypes_;
@@ -167,6 +167,23 @@ compute_genotype_log_likelihoods(const std::vector<SampleName>& samples,
     return result;
 }
 
+GenotypeLogLikelihoodMatrix
+compute_genotype_log_likelihoods(const std::vector<SampleName>& samples,
+                                 const GenotypeIndexRange& genotypes,
+                                 const std::vector<Haplotype>& haplotypes,
+                                 const HaplotypeLikelihoodArray& haplotype_likelihoods)
+{
+    assert(!genotypes.empty());
+    GenotypeLogLikelihoodMatrix result {};
+    result.reserve(samples.size());
+    for (const auto& sample : samples) {
+        haplotype_likelihoods.prime(sample);
+        const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods, haplotypes};
+        result.push_back(evaluate(genotypes, likelihood_model));
+    }
+    return result;
+}
+
 GenotypeLogMarginalVector
 init_genotype_log_marginals(const std::vector<Genotype<Haplotype>>& genotypes,
                             const HardyWeinbergModel& hw_model)
@@ -310,6 +327,83 @@ auto compute_approx_genotype_marginal_posteriors(const std::vector<Haplotype>& h
     return result;
 }
 
+auto make_inverse_genotype_table(const GenotypeIndexRange& genotypes)
+{
+    InverseGenotypeTable result(genotypes.num_elements());
+    for (auto& entry : result) entry.reserve(element_cardinality_in_genotypes(genotypes.num_elements(), genotypes.ploidy()));
+    for (auto itr = std::cbegin(genotypes); itr != std::cend(genotypes); ++itr) {
+        for (auto idx : *itr) {
+            if (result[idx].empty() || result[idx].back() != itr.rank()) {
+                result[idx].push_back(itr.rank());
+            }
+        }
+    }
+    return result;
+}
+
+void evaluate_genotype_log_marginals(const GenotypeIndexRange& genotypes, const HardyWeinbergModel& hw_model,
+                                     std::vector<double>& result)
+{
+    result.resize(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&hw_model] (const auto& genotype) { return hw_model.evaluate(genotype); });
+}
+
+void update_genotype_posteriors(GenotypeMarginalPosteriorMatrix& current_genotype_posteriors,
+                                const std::vector<double>& genotype_log_marginals,
+                                const GenotypeLogLikelihoodMatrix& genotype_log_likilhoods)
+{
+    auto likelihood_itr = std::cbegin(genotype_log_likilhoods);
+    for (auto& sample_genotype_posteriors : current_genotype_posteriors) {
+        sample_genotype_posteriors.resize(genotype_log_marginals.size());
+        std::transform(std::cbegin(genotype_log_marginals), std::cend(genotype_log_marginals),
+                       std::cbegin(*likelihood_itr++), std::begin(sample_genotype_posteriors),
+                       std::plus<> {});
+        maths::normalise_exp(sample_genotype_posteriors);
+    }
+}
+
+double update_haplotype_frequencies(HardyWeinbergModel& hw_model,
+                                    const GenotypeMarginalPosteriorMatrix& genotype_posteriors,
+                                    const InverseGenotypeTable& genotypes_containing_haplotypes,
+                                    const double frequency_update_norm)
+{
+    const auto collaped_posteriors = collapse_genotype_posteriors(genotype_posteriors);
+    double max_frequency_change {0};
+    auto& current_haplotype_frequencies = hw_model.index_frequencies();
+    for (std::size_t i {0}; i < current_haplotype_frequencies.size(); ++i) {
+        double new_frequency {0};
+        for (const auto& genotype_index : genotypes_containing_haplotypes[i]) {
+            new_frequency += collaped_posteriors[genotype_index];
+        }
+        new_frequency /= frequency_update_norm;
+        max_frequency_change = std::max(std::abs(current_haplotype_frequencies[i] - new_frequency), max_frequency_change);
+        current_haplotype_frequencies[i] = new_frequency;
+    }
+    return max_frequency_change;
+}
+
+auto compute_approx_genotype_marginal_posteriors(const GenotypeIndexRange& genotypes,
+                                                 const GenotypeLogLikelihoodMatrix& genotype_likelihoods,
+                                                 const EMOptions options)
+{
+    const auto num_haplotypes = genotypes.num_elements();
+    HardyWeinbergModel hw_model {HardyWeinbergModel::HaplotypeFrequencyVector(num_haplotypes, 1.0 / num_haplotypes)};
+    const auto genotypes_containing_haplotypes = make_inverse_genotype_table(genotypes);
+    const auto frequency_update_norm = calculate_frequency_update_norm(genotype_likelihoods.size(), genotypes.ploidy());
+    std::vector<double> genotype_log_marginals {};
+    evaluate_genotype_log_marginals(genotypes, hw_model, genotype_log_marginals);
+    GenotypeMarginalPosteriorMatrix result(genotype_likelihoods.size());
+    update_genotype_posteriors(result, genotype_log_marginals, genotype_likelihoods);
+    for (unsigned n {1}; n <= options.max_iterations; ++n) {
+        const auto max_change = update_haplotype_frequencies(hw_model, result, genotypes_containing_haplotypes, frequency_update_norm);
+        evaluate_genotype_log_marginals(genotypes, hw_model, genotype_log_marginals);
+        update_genotype_posteriors(result, genotype_log_marginals, genotype_likelihoods);
+        if (max_change <= options.epsilon) break;
+    }
+    return result;
+}
+
 auto compute_approx_genotype_marginal_posteriors(const std::vector<Genotype<Haplotype>>& genotypes,
                                                  const GenotypeLogLikelihoodMatrix& genotype_likelihoods,
                                                  const EMOptions options)
@@ -388,12 +482,12 @@ auto zip_index(const std::vector<T>& v)
 }
 
 std::vector<unsigned>
-select_top_k_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
+select_top_k_genotypes(const std::size_t num_genotypes,
                        const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
                        const std::size_t k)
 {
-    if (genotypes.size() <= k) {
-        std::vector<unsigned> result(genotypes.size());
+    if (num_genotypes <= k) {
+        std::vector<unsigned> result(num_genotypes);
         std::iota(std::begin(result), std::end(result), 0);
         return result;
     } else {
@@ -404,7 +498,7 @@ select_top_k_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
             std::nth_element(std::begin(tmp), std::next(std::begin(tmp), k), std::end(tmp), std::greater<> {});
             indexed_marginals.push_back(std::move(tmp));
         }
-        std::vector<unsigned> result {}, top(genotypes.size(), 0u);
+        std::vector<unsigned> result {}, top(num_genotypes, 0u);
         result.reserve(k);
         for (std::size_t j {0}; j <= k; ++j) {
             for (const auto& marginals : indexed_marginals) {
@@ -426,18 +520,19 @@ select_top_k_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
     }
 }
 
-auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
+auto propose_joint_genotypes(const std::size_t num_genotypes,
                              const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
-                             const std::size_t max_joint_genotypes)
+                             const std::size_t max_joint_genotypes,
+                             const boost::optional<std::size_t> hom_ref_idx)
 {
     const auto num_samples = em_genotype_marginals.size();
-    assert(max_joint_genotypes >= num_samples * genotypes.size());
-    const auto num_joint_genotypes = num_combinations(genotypes.size(), num_samples);
+    assert(max_joint_genotypes >= num_samples * num_genotypes);
+    const auto num_joint_genotypes = num_combinations(num_genotypes, num_samples);
     if (num_joint_genotypes <= max_joint_genotypes) {
-        return generate_all_genotype_combinations(genotypes.size(), num_samples);
+        return generate_all_genotype_combinations(num_genotypes, num_samples);
     }
     auto result = select_top_k_tuples(em_genotype_marginals, max_joint_genotypes);
-    const auto top_k_genotype_indices = select_top_k_genotypes(genotypes, em_genotype_marginals, num_samples / 2);
+    const auto top_k_genotype_indices = select_top_k_genotypes(num_genotypes, em_genotype_marginals, num_samples / 2);
     for (const auto genotype_idx : top_k_genotype_indices) {
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
             if (result.front()[sample_idx] != genotype_idx) {
@@ -449,7 +544,6 @@ auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
             }
         }
     }
-    const auto hom_ref_idx = find_hom_ref_idx(genotypes);
     if (hom_ref_idx) {
         std::vector<std::size_t> ref_indices(num_samples, *hom_ref_idx);
         if (std::find(std::cbegin(result), std::cend(result), ref_indices) == std::cend(result)) {
@@ -459,6 +553,35 @@ auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
     return result;
 }
 
+auto propose_joint_genotypes(const std::vector<Genotype<Haplotype>>& genotypes,
+                             const GenotypeMarginalPosteriorMatrix& em_genotype_marginals,
+                             const std::size_t max_joint_genotypes)
+{
+    return propose_joint_genotypes(genotypes.size(), em_genotype_marginals, max_joint_genotypes, find_hom_ref_idx(genotypes));
+}
+
+boost::optional<std::size_t> find_hom_ref_idx(const GenotypeIndexRange& genotypes, const std::vector<Haplotype>& haplotypes)
+{
+    const auto itr = std::find_if(std::cbegin(haplotypes), std::cend(haplotypes), [] (const auto& h) { return is_reference(h); });
+    if (itr != std::cend(haplotypes)) {
+        return genotypes.homozygous_rank(static_cast<unsigned>(std::distance(std::cbegin(haplotypes), itr)));
+    } else {
+        return boost::none;
+    }
+}
+
+// Only the genotypes that appear in some joint genotype are unranked
+auto materialise_used_indices(const GenotypeIndexRange& genotypes, const GenotypeCombinationMatrix& joint_genotypes)
+{
+    std::vector<GenotypeIndex> result(genotypes.size());
+    for (const auto& joint_genotype : joint_genotypes) {
+        for (const auto rank : joint_genotype) {
+            if (result[rank].empty()) genotypes.unrank(rank, result[rank]);
+        }
+    }
+    return result;
+}
+
 template <typename Container>
 auto sum(const Container& values)
 {
@@ -597,6 +720,31 @@ PopulationModel::evaluate(const SampleVector& samples,
     return result;
 }
 
+PopulationModel::InferredLatents
+PopulationModel::evaluate(const SampleVector& samples,
+                          const GenotypeIndexRange& genotypes,
+                          const std::vector<Haplotype>& haplotypes,
+                          const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    assert(!genotypes.empty());
+    assert(genotypes.num_elements() == haplotypes.size());
+    const auto genotype_log_likelihoods = compute_genotype_log_likelihoods(samples, genotypes, haplotypes, haplotype_likelihoods);
+    const auto num_joint_genotypes = num_combinations(genotypes.size(), samples.size());
+    InferredLatents result;
+    GenotypeCombinationMatrix joint_genotypes {};
+    if (num_joint_genotypes <= options_.max_joint_genotypes) {
+        joint_genotypes = generate_all_genotype_combinations(genotypes.size(), samples.size());
+    } else {
+        const EMOptions em_options {options_.max_em_iterations, options_.em_epsilon};
+        const auto em_genotype_marginals = compute_approx_genotype_marginal_posteriors(genotypes, genotype_log_likelihoods, em_options);
+        joint_genotypes = propose_joint_genotypes(genotypes.size(), em_genotype_marginals, options_.max_joint_genotypes,
+                                                  find_hom_ref_idx(genotypes, haplotypes));
+    }
+    const auto genotype_indices = materialise_used_indices(genotypes, joint_genotypes);
+    calculate_posterior_marginals(genotype_indices, joint_genotypes, genotype_log_likelihoods, prior_model_, result);
+    return result;
+}
+
 PopulationModel::InferredLatents
 PopulationModel::evaluate(const SampleVector& samples,
                           const std::vector<GenotypeVectorReference>& genotypes,
@@ -12,6 +12,7 @@
 #include "config/common.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index_range.hpp"
 #include "population_prior_model.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "containers/probability_matrix.hpp"
@@ -70,6 +71,12 @@ public:
                              const std::vector<GenotypeIndex>& genotype_indices,
                              const std::vector<Haplotype>& haplotypes,
                              const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    // All samples have same ploidy. Genotypes are never materialised; marginals are in the order of genotype ranks.
+    // The prior model must be primed with haplotypes.
+    InferredLatents evaluate(const SampleVector& samples,
+                             const GenotypeIndexRange& genotypes,
+                             const std::vector<Haplotype>& haplotypes,
+                             const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     // Samples have different ploidy
     InferredLatents evaluate(const SampleVector& samples,
                              const std::vector<GenotypeVectorReference>& genotypes,
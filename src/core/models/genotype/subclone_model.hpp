@@ -7,12 +7,14 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
+#include <type_traits>
 
 #include <boost/optional.hpp>
 
 #include "config/common.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index_range.hpp"
 #include "core/types/cancer_genotype.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "exceptions/unimplemented_feature_error.hpp"
@@ -85,6 +87,11 @@ public:
                              const std::vector<GenotypeIndex_>& genotype_indices,
                              const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     
+    // Only available when GenotypeIndex_ is GenotypeIndex
+    InferredLatents evaluate(const std::vector<Genotype_>& genotypes,
+                             const GenotypeIndexRange& genotype_indices,
+                             const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    
 private:
     std::vector<SampleName> samples_;
     Priors priors_;
@@ -378,6 +385,18 @@ SubcloneModelBase<G, GI, GPM>::evaluate(const std::vector<G>& genotypes,
     return detail::run_variational_bayes<G, GI, GPM>(samples_, genotypes, priors_, haplotype_likelihoods, parameters_, index_data);
 }
 
+template <typename G, typename GI, typename GPM>
+typename SubcloneModelBase<G, GI, GPM>::InferredLatents
+SubcloneModelBase<G, GI, GPM>::evaluate(const std::vector<G>& genotypes,
+                                        const GenotypeIndexRange& genotype_indices,
+                                        const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    static_assert(std::is_same<GI, GenotypeIndex>::value, "GenotypeIndexRange only enumerates germline genotypes");
+    assert(genotypes.size() == genotype_indices.size());
+    // The variational model needs per-genotype likelihood references, so the indices are unranked up front
+    return evaluate(genotypes, genotype_indices.materialise(), haplotype_likelihoods);
+}
+
 } // namespace model
 } // namespace octopus
 
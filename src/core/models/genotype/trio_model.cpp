@@ -6,6 +6,8 @@
 #include <iterator>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <memory>
 #include <random>
 #include <utility>
 #include <cassert>
@@ -400,29 +402,86 @@ auto join_size(const ReducedVectorMap<T1>& first, const ReducedVectorMap<T2>& se
     return result;
 }
 
+// Every joint probability is the sum of the two marginal terms plus a conditional log probability, which
+// is never positive, so the sum of the marginals is an upper bound on the joint. A combination can be
+// skipped once its bound falls below the best joint seen so far by more than the allowed relative mass
+// loss divided by the number of combinations, which bounds the total normalised mass lost by pruning.
+struct JoinBound
+{
+    JoinBound(const TrioModel::Options& options, const std::size_t join_size)
+    : best {-std::numeric_limits<double>::infinity()}
+    , log_min_relative_joint {-std::numeric_limits<double>::infinity()}
+    {
+        if (options.prune_joint_search && options.max_joint_mass_loss > 0 && join_size > 1) {
+            log_min_relative_joint = std::log(options.max_joint_mass_loss) - std::log(join_size);
+        }
+    }
+    
+    double cutoff() const noexcept { return best + log_min_relative_joint; }
+    void update(const double joint) noexcept { best = std::max(best, joint); }
+    
+    double best, log_min_relative_joint;
+};
+
+template <typename Iterator>
+auto sort_by_probability(Iterator first, Iterator last)
+{
+    using T = typename std::iterator_traits<Iterator>::value_type;
+    std::vector<const T*> result {};
+    result.reserve(std::distance(first, last));
+    std::transform(first, last, std::back_inserter(result), [] (const auto& x) { return std::addressof(x); });
+    std::sort(std::begin(result), std::end(result), [] (const auto* lhs, const auto* rhs) { return lhs->probability > rhs->probability; });
+    return result;
+}
+
+static constexpr std::size_t joinBlockSize {64};
+
+// Visits lhs x rhs best-first, calling f(lhs, rhs) -> joint for each combination that may still
+// contribute. The rhs probabilities are kept contiguous so each block's bound test is a tight loop.
+template <typename Iterator1, typename Iterator2, typename F>
+void bounded_join(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, JoinBound& bound, F f)
+{
+    if (first1 == last1 || first2 == last2) return;
+    const auto lhs = sort_by_probability(first1, last1);
+    const auto rhs = sort_by_probability(first2, last2);
+    std::vector<double> rhs_probabilities(rhs.size());
+    std::transform(std::cbegin(rhs), std::cend(rhs), std::begin(rhs_probabilities), [] (const auto* x) { return x->probability; });
+    for (const auto* l : lhs) {
+        if (l->probability + rhs_probabilities.front() < bound.cutoff()) break; // all remaining lhs are worse
+        for (std::size_t block_begin {0}; block_begin < rhs.size(); block_begin += joinBlockSize) {
+            const auto min_rhs_probability = bound.cutoff() - l->probability;
+            const auto block_first = std::next(std::cbegin(rhs_probabilities), block_begin);
+            const auto block_last  = std::next(std::cbegin(rhs_probabilities), std::min(block_begin + joinBlockSize, rhs.size()));
+            const auto block_candidates_last = std::partition_point(block_first, block_last, [=] (double p) { return p >= min_rhs_probability; });
+            for (auto i = block_begin, n = block_begin + std::distance(block_first, block_candidates_last); i < n; ++i) {
+                bound.update(f(*l, *rhs[i]));
+            }
+            if (block_candidates_last != block_last) break;
+        }
+    }
+}
+
+template <typename T1, typename T2, typename F>
+void bounded_join(const ReducedVectorMap<T1>& first, const ReducedVectorMap<T2>& second,
+                  const TrioModel::Options& options, F f)
+{
+    JoinBound bound {options, join_size(first, second)};
+    bounded_join(first.first, first.last_to_join, second.first, second.last_to_join, bound, f);
+    bounded_join(first.last_to_join, first.last, second.first, second.last_to_partially_join, bound, f);
+    bounded_join(first.first, first.last_to_partially_join, second.last_to_join, second.last, bound, f);
+}
+
 auto join(const ReducedVectorMap<GenotypeRefProbabilityPair>& maternal,
           const ReducedVectorMap<GenotypeRefProbabilityPair>& paternal,
-          const PopulationPriorModel& model)
+          const PopulationPriorModel& model,
+          const TrioModel::Options& options)
 {
     std::vector<ParentsProbabilityPair> result {};
     result.reserve(join_size(maternal, paternal));
-    std::for_each(maternal.first, maternal.last_to_join, [&] (const auto& m) {
-        std::for_each(paternal.first, paternal.last_to_join, [&] (const auto& p) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
-                              m.probability, m.probability, m.indices, p.indices});
-        });
-    });
-    std::for_each(maternal.last_to_join, maternal.last, [&] (const auto& m) {
-        std::for_each(paternal.first, paternal.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
-                              m.probability, m.probability, m.indices, p.indices});
-        });
-    });
-    std::for_each(paternal.last_to_join, paternal.last, [&] (const auto& p) {
-        std::for_each(maternal.first, maternal.last_to_partially_join, [&] (const auto& m) {
-            result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
-                              m.probability, m.probability, m.indices, p.indices});
-        });
+    bounded_join(maternal, paternal, options, [&] (const auto& m, const auto& p) {
+        result.push_back({m.genotype, p.genotype, joint_probability(m, p, model),
+                          m.probability, m.probability, m.indices, p.indices});
+        return result.back().probability;
     });
     return result;
 }
@@ -638,31 +697,21 @@ auto joint_probability(const ParentsProbabilityPair& parents,
 template <typename F>
 auto join(const ReducedVectorMap<ParentsProbabilityPair>& parents,
           const ReducedVectorMap<GenotypeRefProbabilityPair>& child,
-          F jpdf)
+          F jpdf, const TrioModel::Options& options)
 {
     std::vector<JointProbability> result {};
     result.reserve(join_size(parents, child));
-    std::for_each(parents.first, parents.last_to_join, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_join, [&] (const auto& c) {
-            result.push_back({p.maternal, p.paternal, c.genotype, joint_probability(p, c, jpdf)});
-        });
-    });
-    std::for_each(parents.last_to_join, parents.last, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_partially_join, [&] (const auto& c) {
-            result.push_back({p.maternal, p.paternal, c.genotype, joint_probability(p, c, jpdf)});
-        });
-    });
-    std::for_each(child.last_to_join, child.last, [&] (const auto& c) {
-        std::for_each(parents.first, parents.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({p.maternal, p.paternal, c.genotype, joint_probability(p, c, jpdf)});
-        });
+    bounded_join(parents, child, options, [&] (const auto& p, const auto& c) {
+        result.push_back({p.maternal, p.paternal, c.genotype, joint_probability(p, c, jpdf)});
+        return result.back().probability;
     });
     return result;
 }
 
 auto join(const ReducedVectorMap<ParentsProbabilityPair>& parents,
           const ReducedVectorMap<GenotypeRefProbabilityPair>& child,
-          const DeNovoModel& mutation_model)
+          const DeNovoModel& mutation_model,
+          const TrioModel::Options& options)
 {
     const auto maternal_ploidy = parents.first->maternal.get().ploidy();
     const auto paternal_ploidy = parents.first->paternal.get().ploidy();
@@ -670,26 +719,26 @@ auto join(const ReducedVectorMap<ParentsProbabilityPair>& parents,
     if (child_ploidy == 1) {
         if (paternal_ploidy == 1) {
             if (maternal_ploidy == 0) {
-                return join(parents, child, ProbabilityOfChildGivenParents<1, 0, 1> {mutation_model});
+                return join(parents, child, ProbabilityOfChildGivenParents<1, 0, 1> {mutation_model}, options);
             }
             if (maternal_ploidy == 1) {
-                return join(parents, child, ProbabilityOfChildGivenParents<1, 1, 1> {mutation_model});
+                return join(parents, child, ProbabilityOfChildGivenParents<1, 1, 1> {mutation_model}, options);
             }
             if (maternal_ploidy == 2) {
-                return join(parents, child, ProbabilityOfChildGivenParents<1, 2, 1> {mutation_model});
+                return join(parents, child, ProbabilityOfChildGivenParents<1, 2, 1> {mutation_model}, options);
             }
         }
     } else if (child_ploidy == 2) {
         if (maternal_ploidy == 2) {
             if (paternal_ploidy == 1) {
-                return join(parents, child, ProbabilityOfChildGivenParents<2, 2, 1> {mutation_model});
+                return join(parents, child, ProbabilityOfChildGivenParents<2, 2, 1> {mutation_model}, options);
             }
             if (paternal_ploidy == 2) {
-                return join(parents, child, ProbabilityOfChildGivenParents<2, 2, 2> {mutation_model});
+                return join(parents, child, ProbabilityOfChildGivenParents<2, 2, 2> {mutation_model}, options);
             }
         }
     } else if (child_ploidy == 3 && maternal_ploidy == 3 && paternal_ploidy == 3) {
-        return join(parents, child, ProbabilityOfChildGivenParents<3, 3, 3> {mutation_model});
+        return join(parents, child, ProbabilityOfChildGivenParents<3, 3, 3> {mutation_model}, options);
     }
     throw std::runtime_error {"TrioModel: unimplemented joint probability function"};
 }
@@ -759,10 +808,10 @@ TrioModel::evaluate(const GenotypeVector& maternal_genotypes,
     const auto reduced_maternal_likelihoods = reduce(maternal_likelihoods, prior_model_, options_);
     const auto reduced_paternal_likelihoods = reduce(paternal_likelihoods, prior_model_, options_);
     const auto reduced_child_likelihoods    = reduce(child_likelihoods, prior_model_, options_);
-    auto parental_likelihoods = join(reduced_maternal_likelihoods, reduced_paternal_likelihoods, prior_model_);
+    auto parental_likelihoods = join(reduced_maternal_likelihoods, reduced_paternal_likelihoods, prior_model_, options_);
     if (debug_log_) debug::print(stream(*debug_log_), parental_likelihoods);
     const auto reduced_parental_likelihoods = reduce(parental_likelihoods, options_);
-    auto joint_likelihoods = join(reduced_parental_likelihoods, reduced_child_likelihoods, mutation_model_);
+    auto joint_likelihoods = join(reduced_parental_likelihoods, reduced_child_likelihoods, mutation_model_, options_);
     if (debug_log_) debug::print(stream(*debug_log_), joint_likelihoods);
     const auto evidence = normalise_exp(joint_likelihoods);
     return {std::move(joint_likelihoods), evidence};
@@ -799,15 +848,25 @@ TrioModel::evaluate(const GenotypeVector& genotypes, std::vector<GenotypeIndex>&
     const auto reduced_maternal_likelihoods = reduce(maternal_likelihoods, prior_model_, options_);
     const auto reduced_paternal_likelihoods = reduce(paternal_likelihoods, prior_model_, options_);
     const auto reduced_child_likelihoods    = reduce(child_likelihoods, prior_model_, options_);
-    auto parental_likelihoods = join(reduced_maternal_likelihoods, reduced_paternal_likelihoods, prior_model_);
+    auto parental_likelihoods = join(reduced_maternal_likelihoods, reduced_paternal_likelihoods, prior_model_, options_);
     if (debug_log_) debug::print(stream(*debug_log_), parental_likelihoods);
     const auto reduced_parental_likelihoods = reduce(parental_likelihoods, options_);
-    auto joint_likelihoods = join(reduced_parental_likelihoods, reduced_child_likelihoods, mutation_model_);
+    auto joint_likelihoods = join(reduced_parental_likelihoods, reduced_child_likelihoods, mutation_model_, options_);
     if (debug_log_) debug::print(stream(*debug_log_), joint_likelihoods);
     const auto evidence = normalise_exp(joint_likelihoods);
     return {std::move(joint_likelihoods), evidence};
 }
 
+TrioModel::InferredLatents
+TrioModel::evaluate(const GenotypeVector& genotypes, const GenotypeIndexRange& genotype_indices,
+                    const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    assert(genotypes.size() == genotype_indices.size());
+    // Reduced likelihoods keep pointers to the indices so they must outlive the joint search
+    auto indices = genotype_indices.materialise();
+    return evaluate(genotypes, indices, haplotype_likelihoods);
+}
+
 double probability_of_child_given_parent(const Genotype<Haplotype>& child,
                                          const Genotype<Haplotype>& parent,
                                          const DeNovoModel& mutation_model)
@@ -828,24 +887,14 @@ auto joint_probability(const GenotypeRefProbabilityPair& parent,
 
 auto join(const ReducedVectorMap<GenotypeRefProbabilityPair>& parent,
           const ReducedVectorMap<GenotypeRefProbabilityPair>& child,
-          const DeNovoModel& mutation_model)
+          const DeNovoModel& mutation_model,
+          const TrioModel::Options& options)
 {
     std::vector<JointProbability> result {};
     result.reserve(join_size(parent, child));
-    std::for_each(parent.first, parent.last_to_join, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_join, [&] (const auto& c) {
-            result.push_back({p.genotype, p.genotype, c.genotype, joint_probability(p, c, mutation_model)});
-        });
-    });
-    std::for_each(parent.last_to_join, parent.last, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_partially_join, [&] (const auto& c) {
-            result.push_back({p.genotype, p.genotype, c.genotype, joint_probability(p, c, mutation_model)});
-        });
-    });
-    std::for_each(child.last_to_join, child.last, [&] (const auto& c) {
-        std::for_each(parent.first, parent.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({p.genotype, p.genotype, c.genotype, joint_probability(p, c, mutation_model)});
-        });
+    bounded_join(parent, child, options, [&] (const auto& p, const auto& c) {
+        result.push_back({p.genotype, p.genotype, c.genotype, joint_probability(p, c, mutation_model)});
+        return result.back().probability;
     });
     return result;
 }
@@ -865,7 +914,7 @@ TrioModel::evaluate_allosome(const GenotypeVector& parent_genotypes,
     auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model);
     if (debug_log_) debug::print(stream(*debug_log_), "child", child_likelihoods);
     const auto reduced_child_likelihoods = reduce(child_likelihoods, prior_model_, options_);
-    auto joint_likelihoods = join(reduced_parent_likelihoods, reduced_child_likelihoods, mutation_model_);
+    auto joint_likelihoods = join(reduced_parent_likelihoods, reduced_child_likelihoods, mutation_model_, options_);
     clear(parent_likelihoods);
     clear(child_likelihoods);
     const auto evidence = normalise_exp(joint_likelihoods);
@@ -16,6 +16,7 @@
 #include "core/models/mutation/denovo_model.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index_range.hpp"
 #include "logging/logging.hpp"
 
 namespace octopus { namespace model {
@@ -47,6 +48,8 @@ public:
     {
         std::size_t max_joint_genotypes;
         double max_individual_mass_loss = 1e-80, max_joint_mass_loss = 1e-200;
+        // skip joint combinations whose likelihood upper bound cannot contribute more than max_joint_mass_loss
+        bool prune_joint_search = true;
     };
     
     TrioModel() = delete;
@@ -81,6 +84,10 @@ public:
                              std::vector<GenotypeIndex>& genotype_indices,
                              const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     
+    InferredLatents evaluate(const GenotypeVector& genotypes,
+                             const GenotypeIndexRange& genotype_indices,
+                             const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    
 private:
     const Trio& trio_;
     const PopulationPriorModel& prior_model_;
@@ -3,6 +3,8 @@
 
 #include "haplotype_likelihood_array.hpp"
 
+#include <vector>
+#include <iterator>
 #include <utility>
 #include <cassert>
 
@@ -31,63 +33,18 @@ HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(HaplotypeLikelihoodModel like
     mapping_positions_.resize(maxMappingPositions);
 }
 
-HaplotypeLikelihoodArray::ReadPacket::ReadPacket(Iterator first, Iterator last)
-: first {first}
-, last {last}
-, num_reads {static_cast<std::size_t>(std::distance(first, last))}
-{}
-
 void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
                                         const std::vector<Haplotype>& haplotypes,
                                         boost::optional<FlankState> flank_state)
 {
-    // This code is not very pretty because it is a bottleneck for the entire application.
-    // We want to try a minimise memory allocations for the mapping.
-    cache_.clear();
-    if (cache_.bucket_count() < haplotypes.size()) {
-        cache_.rehash(haplotypes.size());
-    }
-    set_read_iterators_and_sample_indices(reads);
-    assert(reads.size() == read_iterators_.size());
-    const auto num_samples = reads.size();
-    // Precompute all read hashes so we don't have to recompute for each haplotype
-    std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
-    read_hashes.reserve(num_samples);
-    for (const auto& t : read_iterators_) {
-        std::vector<KmerPerfectHashes> sample_read_hashes {};
-        sample_read_hashes.reserve(t.num_reads);
-        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes),
-                       [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
-        read_hashes.emplace_back(std::move(sample_read_hashes));
-    }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
-    const auto first_mapping_position = std::begin(mapping_positions_);
-    for (const auto& haplotype : haplotypes) {
-        populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
-        auto itr = std::begin(cache_.emplace(std::piecewise_construct,
-                                             std::forward_as_tuple(haplotype),
-                                             std::forward_as_tuple(num_samples)).first->second);
-        likelihood_model_.reset(haplotype, flank_state);
-        auto read_hash_itr = std::cbegin(read_hashes);
-        for (const auto& t : read_iterators_) { // for each sample
-            *itr = std::vector<double>(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(*read_hash_itr), std::begin(*itr),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
-            ++read_hash_itr;
-            ++itr;
-        }
-        clear_kmer_hash_table(haplotype_hashes);
-    }
-    likelihood_model_.clear();
-    read_iterators_.clear();
+    populate_helper(reads, haplotypes, std::move(flank_state));
+}
+
+void HaplotypeLikelihoodArray::populate(const ReadViewMap& reads,
+                                        const std::vector<Haplotype>& haplotypes,
+                                        boost::optional<FlankState> flank_state)
+{
+    populate_helper(reads, haplotypes, std::move(flank_state));
 }
 
 std::size_t HaplotypeLikelihoodArray::num_likelihoods(const SampleName& sample) const
@@ -152,20 +109,96 @@ void HaplotypeLikelihoodArray::unprime() const noexcept
 
 // private methods
 
-void HaplotypeLikelihoodArray::set_read_iterators_and_sample_indices(const ReadMap& reads)
+namespace {
+
+template <typename Iterator>
+struct ReadPacket
 {
-    read_iterators_.clear();
-    sample_indices_.clear();
+    ReadPacket(Iterator first, Iterator last)
+    : first {first}
+    , last {last}
+    , num_reads {static_cast<std::size_t>(std::distance(first, last))}
+    {}
+    Iterator first, last;
+    std::size_t num_reads;
+};
+
+template <typename Map>
+auto make_read_packets(const Map& reads)
+{
+    using Iterator = typename Map::mapped_type::const_iterator;
+    std::vector<ReadPacket<Iterator>> result {};
+    result.reserve(reads.size());
+    for (const auto& p : reads) {
+        result.emplace_back(std::cbegin(p.second), std::cend(p.second));
+    }
+    return result;
+}
+
+} // namespace
+
+template <typename Map>
+void HaplotypeLikelihoodArray::populate_helper(const Map& reads,
+                                               const std::vector<Haplotype>& haplotypes,
+                                               boost::optional<FlankState> flank_state)
+{
+    // This code is not very pretty because it is a bottleneck for the entire application.
+    // We want to try a minimise memory allocations for the mapping.
+    cache_.clear();
+    if (cache_.bucket_count() < haplotypes.size()) {
+        cache_.rehash(haplotypes.size());
+    }
+    set_sample_indices(reads);
+    // Packets are in map iteration order, which also defines the sample indices
+    const auto read_iterators = make_read_packets(reads);
     const auto num_samples = reads.size();
-    if (read_iterators_.capacity() < num_samples) {
-        read_iterators_.reserve(num_samples);
+    // Precompute all read hashes so we don't have to recompute for each haplotype
+    std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
+    read_hashes.reserve(num_samples);
+    for (const auto& t : read_iterators) {
+        std::vector<KmerPerfectHashes> sample_read_hashes {};
+        sample_read_hashes.reserve(t.num_reads);
+        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes),
+                       [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
+        read_hashes.emplace_back(std::move(sample_read_hashes));
     }
+    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    MappedIndexCounts haplotype_mapping_counts {};
+    const auto first_mapping_position = std::begin(mapping_positions_);
+    for (const auto& haplotype : haplotypes) {
+        populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
+        auto itr = std::begin(cache_.emplace(std::piecewise_construct,
+                                             std::forward_as_tuple(haplotype),
+                                             std::forward_as_tuple(num_samples)).first->second);
+        likelihood_model_.reset(haplotype, flank_state);
+        auto read_hash_itr = std::cbegin(read_hashes);
+        for (const auto& t : read_iterators) { // for each sample
+            *itr = std::vector<double>(t.num_reads);
+            std::transform(t.first, t.last, std::cbegin(*read_hash_itr), std::begin(*itr),
+                           [&] (const AlignedRead& read, const auto& read_hashes) {
+                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
+                                                                                      haplotype_mapping_counts,
+                                                                                      first_mapping_position,
+                                                                                      maxMappingPositions);
+                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
+                           });
+            ++read_hash_itr;
+            ++itr;
+        }
+    }
+    likelihood_model_.clear();
+}
+
+template <typename Map>
+void HaplotypeLikelihoodArray::set_sample_indices(const Map& reads)
+{
+    sample_indices_.clear();
+    const auto num_samples = reads.size();
     if (sample_indices_.bucket_count() < num_samples) {
         sample_indices_.rehash(num_samples);
     }
     std::size_t i {0};
     for (const auto& p : reads) {
-        read_iterators_.emplace_back(std::cbegin(p.second), std::cend(p.second));
         sample_indices_.emplace(p.first, i++);
     }
 }
@@ -53,6 +53,8 @@ public:
     
     void populate(const ReadMap& reads, const std::vector<Haplotype>& haplotypes,
                   boost::optional<FlankState> flank_state = boost::none);
+    void populate(const ReadViewMap& reads, const std::vector<Haplotype>& haplotypes,
+                  boost::optional<FlankState> flank_state = boost::none);
     
     std::size_t num_likelihoods(const SampleName& sample) const;
     
@@ -82,24 +84,19 @@ private:
     
     HaplotypeLikelihoodModel likelihood_model_;
     
-    struct ReadPacket
-    {
-        using Iterator = ReadMap::mapped_type::const_iterator;
-        ReadPacket(Iterator first, Iterator last);
-        Iterator first, last;
-        std::size_t num_reads;
-    };
-    
     std::unordered_map<Haplotype, std::vector<LikelihoodVector>, HaplotypeHash> cache_;
     std::unordered_map<SampleName, std::size_t> sample_indices_;
     
     mutable boost::optional<std::size_t> primed_sample_;
     
     // Just to optimise population
-    std::vector<ReadPacket> read_iterators_;
     std::vector<std::size_t> mapping_positions_;
     
-    void set_read_iterators_and_sample_indices(const ReadMap& reads);
+    template <typename Map>
+    void populate_helper(const Map& reads, const std::vector<Haplotype>& haplotypes,
+                         boost::optional<FlankState> flank_state);
+    template <typename Map>
+    void set_sample_indices(const Map& reads);
 };
 
 template <typename S, typename Container>
@@ -131,10 +128,10 @@ std::vector<std::reference_wrapper<const Haplotype>>
 rank_haplotypes(const std::vector<Haplotype>& haplotypes, const SampleName& sample,
                 const HaplotypeLikelihoodArray& haplotype_likelihoods);
 
-template <typename S>
+template <typename S, typename Map>
 void print_read_haplotype_likelihoods(S&& stream,
                                      const std::vector<Haplotype>& haplotypes,
-                                     const ReadMap& reads,
+                                     const Map& reads,
                                      const HaplotypeLikelihoodArray& haplotype_likelihoods,
                                      const std::size_t n = 5)
 {
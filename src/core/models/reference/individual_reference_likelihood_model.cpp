@@ -3,7 +3,165 @@
 
 #include "individual_reference_likelihood_model.hpp"
 
-namespace octopus {
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <cassert>
 
+#include "basics/cigar_string.hpp"
+#include "utils/maths.hpp"
 
+namespace octopus { namespace model {
+
+IndividualReferenceLikelihoodModel::IndividualReferenceLikelihoodModel(const unsigned ploidy)
+: IndividualReferenceLikelihoodModel {ploidy, Options {}}
+{}
+
+IndividualReferenceLikelihoodModel::IndividualReferenceLikelihoodModel(const unsigned ploidy, Options options)
+: ploidy_ {ploidy}
+, options_ {options}
+, match_log_likelihoods_ {}
+, mismatch_log_likelihoods_ {}
+, log_likelihoods_ {}
+{
+    if (ploidy_ == 0) return;
+    const auto num_genotypes = ploidy_ + 1;
+    const auto num_qualities = static_cast<std::size_t>(options_.max_base_quality) + 1;
+    match_log_likelihoods_.reserve(num_qualities * num_genotypes);
+    mismatch_log_likelihoods_.reserve(num_qualities * num_genotypes);
+    const double p {static_cast<double>(ploidy_)};
+    for (std::size_t quality {0}; quality < num_qualities; ++quality) {
+        // Error rates above 3/4 would make a matching base evidence against the reference
+        const auto error = std::min(std::pow(10.0, -static_cast<double>(quality) / 10), 0.75);
+        for (unsigned k {0}; k < num_genotypes; ++k) {
+            match_log_likelihoods_.push_back(std::log(((p - k) * (1 - error) + k * error / 3) / p));
+            mismatch_log_likelihoods_.push_back(std::log(((p - k) * error / 3 + k * (1 - error)) / p));
+        }
+    }
+}
+
+unsigned IndividualReferenceLikelihoodModel::ploidy() const noexcept
+{
+    return ploidy_;
+}
+
+void IndividualReferenceLikelihoodModel::evaluate(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                                                  const ReadContainer& reads, std::vector<double>& result) const
+{
+    evaluate_helper(region, reference, reads, result);
+}
+
+void IndividualReferenceLikelihoodModel::evaluate(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                                                  const ReadViewContainer& reads, std::vector<double>& result) const
+{
+    evaluate_helper(region, reference, reads, result);
+}
+
+// private methods
+
+template <typename Container>
+void IndividualReferenceLikelihoodModel::evaluate_helper(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                                                         const Container& reads, std::vector<double>& result) const
+{
+    const auto num_positions = static_cast<std::size_t>(size(region));
+    assert(reference.size() == num_positions);
+    if (ploidy_ == 0) {
+        // the only genotype is the empty one, which is not the reference genotype
+        result.assign(num_positions, 0.0);
+        return;
+    }
+    const auto num_genotypes = ploidy_ + 1;
+    log_likelihoods_.assign(num_positions * num_genotypes, 0.0);
+    for (const AlignedRead& read : overlap_range(reads, region)) {
+        add(read, region, reference);
+    }
+    result.resize(num_positions);
+    static const double ln10 {std::log(10.0)};
+    auto likelihood_itr = std::cbegin(log_likelihoods_);
+    for (std::size_t position {0}; position < num_positions; ++position) {
+        const auto next_likelihood_itr = std::next(likelihood_itr, num_genotypes);
+        const auto norm = maths::log_sum_exp(likelihood_itr, next_likelihood_itr);
+        const auto non_reference = maths::log_sum_exp(std::next(likelihood_itr), next_likelihood_itr);
+        result[position] = std::max(-10 * (non_reference - norm) / ln10, 0.0);
+        likelihood_itr = next_likelihood_itr;
+    }
+}
+
+void IndividualReferenceLikelihoodModel::add(const AlignedRead& read, const GenomicRegion& region,
+                                             const AlignedRead::NucleotideSequence& reference) const
+{
+    const auto mapping_quality = std::min(read.mapping_quality(), options_.max_base_quality);
+    if (mapping_quality < options_.min_base_quality) return;
+    const auto indel_quality = std::min(options_.indel_quality, mapping_quality);
+    const auto& sequence  = read.sequence();
+    const auto& qualities = read.base_qualities();
+    const auto region_begin = region.begin(), region_end = region.end();
+    auto ref_position = mapped_begin(read);
+    std::size_t read_position {0};
+    for (const auto& op : read.cigar()) {
+        if (ref_position > region_end) break;
+        const auto op_size = op.size();
+        using Flag = CigarOperation::Flag;
+        switch (op.flag()) {
+            case Flag::alignmentMatch:
+            case Flag::sequenceMatch:
+            case Flag::substitution:
+            {
+                const auto first = std::max(ref_position, region_begin);
+                const auto last  = std::min<GenomicRegion::Position>(ref_position + op_size, region_end);
+                for (auto position = first; position < last; ++position) {
+                    const auto read_offset = read_position + (position - ref_position);
+                    const auto base = sequence[read_offset];
+                    const auto quality = std::min(qualities[read_offset], mapping_quality);
+                    if (base != 'N' && quality >= options_.min_base_quality) {
+                        const auto offset = static_cast<std::size_t>(position - region_begin);
+                        add(offset, base == reference[offset], quality);
+                    }
+                }
+                ref_position += op_size;
+                read_position += op_size;
+                break;
+            }
+            case Flag::insertion:
+            {
+                if (ref_position > region_begin && ref_position <= region_end) {
+                    add(ref_position - region_begin - 1, false, indel_quality);
+                }
+                read_position += op_size;
+                break;
+            }
+            case Flag::deletion:
+            {
+                const auto first = std::max(ref_position, region_begin);
+                const auto last  = std::min<GenomicRegion::Position>(ref_position + op_size, region_end);
+                for (auto position = first; position < last; ++position) {
+                    add(position - region_begin, false, indel_quality);
+                }
+                ref_position += op_size;
+                break;
+            }
+            case Flag::skipped:
+                ref_position += op_size;
+                break;
+            case Flag::softClipped:
+                read_position += op_size;
+                break;
+            default: // hard clipped or padding
+                break;
+        }
+    }
+}
+
+void IndividualReferenceLikelihoodModel::add(const std::size_t offset, const bool is_reference,
+                                             const BaseQuality quality) const noexcept
+{
+    const auto num_genotypes = ploidy_ + 1;
+    const auto& table = is_reference ? match_log_likelihoods_ : mismatch_log_likelihoods_;
+    const auto first = std::next(std::cbegin(table), quality * num_genotypes);
+    const auto result = std::next(std::begin(log_likelihoods_), offset * num_genotypes);
+    std::transform(first, std::next(first, num_genotypes), result, result, std::plus<> {});
+}
+
+} // namespace model
 } // namespace octopus
@@ -4,9 +4,77 @@
 #ifndef individual_reference_likelihood_model_hpp
 #define individual_reference_likelihood_model_hpp
 
-namespace octopus {
+#include <vector>
 
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
 
+namespace octopus { namespace model {
+
+/*
+ Computes, for every position of a region, the posterior probability that a single sample is
+ homozygous reference, using a single sweep over the sample's reads.
+
+ Genotypes are weighted equally, so a position without informative reads has quality near zero.
+
+ Each aligned base is treated as an independent observation of either the reference or some
+ non-reference base, with error rate given by the lesser of its base and mapping quality. A genotype
+ with k non-reference copies (of ploidy p) explains an observation with probability
+ (p - k)/p p(base | ref) + k/p p(base | non-ref), so the genotype likelihoods at each position are sums
+ of per-quality table lookups accumulated into one contiguous array. Deleted bases and insertions
+ (attributed to the preceding reference position) are non-reference observations.
+
+ No realignment is done, so this is only appropriate for regions without called variation. A sample with
+ zero ploidy has no reference genotype, so every position gets quality zero.
+ */
+class IndividualReferenceLikelihoodModel
+{
+public:
+    using LogProbability = double;
+    using BaseQuality    = AlignedRead::BaseQuality;
+
+    struct Options
+    {
+        BaseQuality min_base_quality = 10, max_base_quality = 60, indel_quality = 40;
+    };
+
+    IndividualReferenceLikelihoodModel() = delete;
+
+    IndividualReferenceLikelihoodModel(unsigned ploidy);
+    IndividualReferenceLikelihoodModel(unsigned ploidy, Options options);
+
+    IndividualReferenceLikelihoodModel(const IndividualReferenceLikelihoodModel&)            = default;
+    IndividualReferenceLikelihoodModel& operator=(const IndividualReferenceLikelihoodModel&) = default;
+    IndividualReferenceLikelihoodModel(IndividualReferenceLikelihoodModel&&)                 = default;
+    IndividualReferenceLikelihoodModel& operator=(IndividualReferenceLikelihoodModel&&)      = default;
+
+    ~IndividualReferenceLikelihoodModel() = default;
+
+    unsigned ploidy() const noexcept;
+
+    // Fills result with the Phred scaled probability that the sample is not homozygous reference at
+    // each position of region, i.e. the reference genotype quality. reference must be the sequence of region.
+    void evaluate(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                  const ReadContainer& reads, std::vector<double>& result) const;
+    void evaluate(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                  const ReadViewContainer& reads, std::vector<double>& result) const;
+
+private:
+    unsigned ploidy_;
+    Options options_;
+    // Indexed [quality * (ploidy + 1) + non-reference copies]
+    std::vector<LogProbability> match_log_likelihoods_, mismatch_log_likelihoods_;
+    mutable std::vector<LogProbability> log_likelihoods_;
+
+    template <typename Container>
+    void evaluate_helper(const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference,
+                         const Container& reads, std::vector<double>& result) const;
+    void add(const AlignedRead& read, const GenomicRegion& region, const AlignedRead::NucleotideSequence& reference) const;
+    void add(std::size_t offset, bool is_reference, BaseQuality quality) const noexcept;
+};
+
+} // namespace model
 } // namespace octopus
 
 #endif
@@ -25,6 +25,7 @@
 #include <cassert>
 
 #include <boost/optional.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "config/common.hpp"
 #include "basics/genomic_region.hpp"
@@ -39,6 +40,8 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/append.hpp"
+#include "utils/memory_governor.hpp"
+#include "utils/thread_pool.hpp"
 #include "config/octopus_vcf.hpp"
 #include "core/callers/caller_factory.hpp"
 #include "core/callers/caller.hpp"
@@ -47,14 +50,18 @@
 #include "logging/logging.hpp"
 #include "logging/error_handler.hpp"
 #include "core/tools/vcf_header_factory.hpp"
+#include "core/tools/connecting_calls.hpp"
 #include "io/variant/vcf.hpp"
 #include "utils/timing.hpp"
 #include "exceptions/program_error.hpp"
+#include "exceptions/user_error.hpp"
 #include "csr/filters/variant_call_filter.hpp"
 #include "csr/filters/variant_call_filter_factory.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
+#include "core/tools/hapgen/haplotype_cost_model.hpp"
+#include "core/checkpoint_journal.hpp"
 
 #include "timers.hpp" // BENCHMARK
 
@@ -148,13 +155,16 @@ auto get_call_types(const GenomeCallingComponents& components, const std::vector
 void write_caller_output_header(GenomeCallingComponents& components, const std::string& command)
 {
     const auto call_types = get_call_types(components, components.contigs());
-    if (components.sites_only() && !apply_csr(components)) {
-        components.output() << make_vcf_header({}, components.contigs(), components.reference(),
-                                               call_types, command);
-    } else {
-        components.output() << make_vcf_header(components.samples(), components.contigs(),
-                                               components.reference(), call_types, command);
+    auto header = components.sites_only() && !apply_csr(components)
+                  ? make_vcf_header({}, components.contigs(), components.reference(), call_types, command)
+                  : make_vcf_header(components.samples(), components.contigs(), components.reference(),
+                                    call_types, command);
+    if (components.shard()) {
+        VcfHeader::Builder builder {header};
+        add_shard_header_fields(*components.shard(), builder);
+        header = builder.build_once();
     }
+    components.output() << header;
 }
 
 std::string get_caller_name(const GenomeCallingComponents& components)
@@ -251,6 +261,20 @@ void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out)
     calls.shrink_to_fit();
 }
 
+// Fractions of the memory budget left unreserved by running tasks. Below nearBudgetHeadroom new
+// tasks are made smaller so they fit in what is left, and below minTaskHeadroom no new tasks are
+// started until a running task finishes.
+constexpr double nearBudgetHeadroom {0.25};
+constexpr double minTaskHeadroom {0.05};
+
+std::size_t get_max_task_reads(const ContigCallingComponents& components)
+{
+    const auto headroom = components.memory_governor.get().headroom();
+    if (headroom >= nearBudgetHeadroom) return components.read_buffer_size;
+    const auto result = static_cast<std::size_t>(components.read_buffer_size * (headroom / nearBudgetHeadroom));
+    return std::max(result, std::size_t {1});
+}
+
 auto find_max_window(const ContigCallingComponents& components,
                      const GenomicRegion& remaining_call_region)
 {
@@ -258,8 +282,8 @@ auto find_max_window(const ContigCallingComponents& components,
     if (!rm.has_reads(components.samples.get(), remaining_call_region)) {
         return remaining_call_region;
     }
-    auto result = rm.find_covered_subregion(components.samples, remaining_call_region,
-                                            components.read_buffer_size);
+    auto result = rm.estimate_covered_subregion(components.samples, remaining_call_region,
+                                                get_max_task_reads(components));
     if (ends_before(result, remaining_call_region)) {
         auto rest = right_overhang_region(remaining_call_region, result);
         if (!rm.has_reads(components.samples.get(), rest)) {
@@ -298,34 +322,6 @@ auto propose_call_subregion(const ContigCallingComponents& components,
     return propose_call_subregion(components, right_overhang_region(input_region, current_subregion), min_size);
 }
 
-void buffer_connecting_calls(std::deque<VcfRecord>& calls,
-                             const GenomicRegion& next_calling_region,
-                             std::vector<VcfRecord>& buffer)
-{
-    const auto it = std::find_if(std::begin(calls), std::end(calls),
-                                 [&next_calling_region] (const auto& call) {
-                                     return mapped_end(call) > next_calling_region.begin();
-                                 });
-    buffer.insert(std::end(buffer),
-                  std::make_move_iterator(it),
-                  std::make_move_iterator(std::end(calls)));
-    calls.erase(it, std::end(calls));
-}
-
-void buffer_connecting_calls(const GenomicRegion& buffered_region,
-                             std::deque<VcfRecord>& calls,
-                             std::vector<VcfRecord>& buffer)
-{
-    const auto it = std::find_if_not(std::begin(calls), std::end(calls),
-                                     [&buffered_region] (const auto& call) {
-                                         return mapped_begin(call) < buffered_region.end();
-                                     });
-    buffer.insert(std::end(buffer),
-                  std::make_move_iterator(std::begin(calls)),
-                  std::make_move_iterator(it));
-    calls.erase(std::begin(calls), it);
-}
-
 bool is_consistent(const std::deque<VcfRecord>& merged_calls)
 {
     return true; // TODO
@@ -338,17 +334,7 @@ void resolve_connecting_calls(std::vector<VcfRecord>& old_connecting_calls,
     using std::begin; using std::end; using std::make_move_iterator;
     
     if (!old_connecting_calls.empty()) {
-        std::vector<VcfRecord> new_connecting_calls {};
-        const auto old_connecting_calls_region = encompassing_region(old_connecting_calls);
-        buffer_connecting_calls(old_connecting_calls_region, calls, new_connecting_calls);
-        std::deque<VcfRecord> merged_calls {};
-        std::set_union(begin(old_connecting_calls), end(old_connecting_calls),
-                       begin(new_connecting_calls), end(new_connecting_calls),
-                       std::back_inserter(merged_calls));
-        old_connecting_calls.clear();
-        old_connecting_calls.shrink_to_fit();
-        new_connecting_calls.clear();
-        new_connecting_calls.shrink_to_fit();
+        auto merged_calls = merge_connecting_calls(old_connecting_calls, calls);
         if (is_consistent(merged_calls)) {
             calls.insert(begin(calls),
                          make_move_iterator(begin(merged_calls)),
@@ -531,11 +517,20 @@ struct TaskMakerSyncPacket
     std::atomic_bool all_done;
 };
 
+void wait_for_memory(const ContigCallingComponents& components)
+{
+    const auto& governor = components.memory_governor.get();
+    if (governor.budget()) {
+        governor.wait_for(static_cast<std::size_t>(governor.budget()->num_bytes() * minTaskHeadroom));
+    }
+}
+
 void make_region_tasks(const GenomicRegion& region, const ContigCallingComponents& components, const ExecutionPolicy policy,
                        TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_region_in_contig, const bool last_contig)
 {
     static constexpr GenomicRegion::Size minTaskSize {5'000};
     std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
+    wait_for_memory(components);
     auto subregion = propose_call_subregion(components, region, minTaskSize);
     if (ends_equal(subregion, region)) {
         lock.lock();
@@ -554,6 +549,7 @@ void make_region_tasks(const GenomicRegion& region, const ContigCallingComponent
         bool done {false};
         while (true) {
             while (batch.size() < std::max(sync.batch_size_hint.load(), 1u) || !sync.waiting) {
+                wait_for_memory(components);
                 subregion = propose_call_subregion(components, subregion, region, minTaskSize);
                 batch.push_back(subregion);
                 assert(!ends_before(region, subregion));
@@ -587,14 +583,14 @@ void make_region_tasks(const GenomicRegion& region, const ContigCallingComponent
     }
 }
 
-void make_contig_tasks(const ContigCallingComponents& components, const ExecutionPolicy policy,
-                       TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_contig)
+void make_contig_tasks(const ContigCallingComponents& components, const InputRegionMap::mapped_type& regions,
+                       const ExecutionPolicy policy, TaskQueue& result, TaskMakerSyncPacket& sync, const bool last_contig)
 {
-    if (components.regions.empty()) return;
-    std::for_each(std::cbegin(components.regions), std::prev(std::cend(components.regions)), [&] (const auto& region) {
+    if (regions.empty()) return;
+    std::for_each(std::cbegin(regions), std::prev(std::cend(regions)), [&] (const auto& region) {
         make_region_tasks(region, components, policy, result, sync, false, last_contig);
     });
-    make_region_tasks(components.regions.back(), components, policy, result, sync, true, last_contig);
+    make_region_tasks(regions.back(), components, policy, result, sync, true, last_contig);
 }
 
 ExecutionPolicy make_execution_policy(const GenomeCallingComponents& components)
@@ -612,8 +608,9 @@ auto make_contig_components(const ContigName& contig, GenomeCallingComponents& c
     return result;
 }
 
-void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCallingComponents& components,
-                       const unsigned num_threads, ExecutionPolicy execution_policy, TaskMakerSyncPacket& sync)
+void make_tasks_helper(TaskMap& tasks, InputRegionMap regions, std::vector<ContigName> contigs,
+                       GenomeCallingComponents& components, const unsigned num_threads,
+                       ExecutionPolicy execution_policy, TaskMakerSyncPacket& sync)
 {
     try {
         static auto debug_log = get_debug_log();
@@ -622,7 +619,8 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
             const auto& contig = contigs[i];
             if (debug_log) stream(*debug_log) << "Making tasks for contig " << contig;
             auto contig_components = make_contig_components(contig, components, num_threads);
-            make_contig_tasks(contig_components, execution_policy, tasks[contig], sync, i == contigs.size() - 1);
+            make_contig_tasks(contig_components, regions.at(contig), execution_policy, tasks[contig], sync,
+                              i == contigs.size() - 1);
             if (debug_log) stream(*debug_log) << "Finished making tasks for contig " << contig;
         }
         if (debug_log) *debug_log << "Finished making tasks";
@@ -643,10 +641,13 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
     }
 }
 
-std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& components, const unsigned num_threads,
-                                   TaskMakerSyncPacket& sync)
+std::thread make_task_maker_thread(TaskMap& tasks, InputRegionMap regions, GenomeCallingComponents& components,
+                                   const unsigned num_threads, TaskMakerSyncPacket& sync)
 {
-    auto contigs = components.contigs();
+    std::vector<ContigName> contigs {};
+    contigs.reserve(components.contigs().size());
+    std::copy_if(std::cbegin(components.contigs()), std::cend(components.contigs()), std::back_inserter(contigs),
+                 [&] (const auto& contig) { return regions.count(contig) == 1 && !regions.at(contig).empty(); });
     if (contigs.empty()) {
         sync.all_done = true;
         return std::thread {};
@@ -655,7 +656,7 @@ std::thread make_task_maker_thread(TaskMap& tasks, GenomeCallingComponents& comp
     for (const auto& contig : contigs) {
         sync.finished.emplace(contig, false);
     }
-    return std::thread {make_tasks_helper, std::ref(tasks), std::move(contigs), std::ref(components),
+    return std::thread {make_tasks_helper, std::ref(tasks), std::move(regions), std::move(contigs), std::ref(components),
                         num_threads, make_execution_policy(components), std::ref(sync)};
 }
 
@@ -744,11 +745,13 @@ bool is_ready(const std::future<R>& f)
     return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
 }
 
+// Tasks run on the shared pool, which has one worker per task thread, so the parallel work callers
+// do within a task shares those workers rather than adding threads
 auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
 {
     static auto debug_log = get_debug_log();
     if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
+    return shared_thread_pool().push([task = std::move(task), components = std::move(components), &sync] () {
         try {
             CompletedTask result {task};
             result.runtime.start = std::chrono::system_clock::now();
@@ -813,40 +816,16 @@ auto make_contig_calling_component_factory_map(GenomeCallingComponents& componen
     return result;
 }
 
-auto find_first_lhs_connecting(const std::deque<VcfRecord>& lhs_calls, const GenomicRegion& rhs_region)
-{
-    const auto rhs_begin = mapped_begin(rhs_region);
-    return std::find_if(std::cbegin(lhs_calls), std::cend(lhs_calls),
-                        [&rhs_begin] (const auto& call) { return mapped_end(call) > rhs_begin; });
-}
-
-auto find_last_rhs_connecting(const GenomicRegion& lhs_region, const std::deque<VcfRecord>& rhs_calls)
-{
-    const auto lhs_end = mapped_end(lhs_region);
-    return std::find_if_not(std::cbegin(rhs_calls), std::cend(rhs_calls),
-                            [&lhs_end] (const auto& call) { return mapped_begin(call) < lhs_end; });
-}
-
 void resolve_connecting_calls(CompletedTask& lhs, CompletedTask& rhs,
                               const ContigCallingComponentFactory& calling_components)
 {
     static auto debug_log = get_debug_log();
-    using std::begin; using std::end; using std::cbegin; using std::cend; using std::make_move_iterator;
-    if (lhs.calls.empty() || rhs.calls.empty()) return;
-    const auto first_lhs_connecting = find_first_lhs_connecting(lhs.calls, encompassing_region(rhs.calls));
-    const auto last_rhs_connecting  = find_last_rhs_connecting(encompassing_region(lhs.calls), rhs.calls);
-    if (first_lhs_connecting == cend(lhs.calls) && last_rhs_connecting == cbegin(rhs.calls)) {
-        return;
-    }
+    using std::begin; using std::end; using std::make_move_iterator;
+    auto merged_calls = merge_connecting_calls(lhs.calls, rhs.calls);
+    if (merged_calls.empty()) return;
     if (debug_log) {
         stream(*debug_log) << "Resolving connecting calls between tasks " << lhs << " & " << rhs;
     }
-    std::deque<VcfRecord> merged_calls {};
-    std::set_union(first_lhs_connecting, cend(lhs.calls),
-                   cbegin(rhs.calls), last_rhs_connecting,
-                   std::back_inserter(merged_calls));
-    lhs.calls.erase(first_lhs_connecting, cend(lhs.calls));
-    rhs.calls.erase(cbegin(rhs.calls), last_rhs_connecting);
     if (is_consistent(merged_calls)) {
         rhs.calls.insert(begin(rhs.calls),
                          make_move_iterator(begin(merged_calls)),
@@ -900,6 +879,7 @@ struct TaskWriterSyncPacket
     std::condition_variable cv;
     std::mutex mutex;
     std::deque<CompletedTask> tasks = {};
+    bool writing = false;
     bool done = false;
 };
 
@@ -926,9 +906,14 @@ void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync
             sync.cv.wait(lock, [&] () { return !sync.tasks.empty() || sync.done; });
             assert(buffer.empty());
             std::swap(sync.tasks, buffer);
+            sync.writing = true;
             lock.unlock();
             sync.cv.notify_one();
             write(buffer, writers);
+            lock.lock();
+            sync.writing = false;
+            lock.unlock();
+            sync.cv.notify_all();
         }
         logging::DebugLogger debug_log {};
         debug_log << "Task writer finished";
@@ -998,15 +983,23 @@ void write_or_buffer(CompletedTask&& task, CompletedTaskMap::mapped_type& buffer
 void wait_until_finished(TaskWriterSyncPacket& sync)
 {
     std::unique_lock<std::mutex> lock {sync.mutex};
-    sync.cv.wait(lock, [&] () { return sync.tasks.empty(); });
+    sync.cv.wait(lock, [&] () { return sync.tasks.empty() && !sync.writing; });
     sync.done = true;
     lock.unlock();
     sync.cv.notify_one();
 }
 
 using FutureCompletedTasks = std::vector<std::future<CompletedTask>>;
+
 using RemainingTaskMap = std::map<ContigName, std::deque<CompletedTask>>;
 
+bool is_memory_exhausted(const GenomeCallingComponents& components, const FutureCompletedTasks& futures)
+{
+    // There must be a running task to wait on, otherwise a lone task larger than the budget would never start
+    return components.memory_governor().headroom() < minTaskHeadroom
+           && std::any_of(std::cbegin(futures), std::cend(futures), [] (const auto& f) { return f.valid(); });
+}
+
 void extract_remaining_future_tasks(FutureCompletedTasks& futures, std::deque<CompletedTask>& result)
 {
     const auto itr = std::remove_if(std::begin(futures), std::end(futures), [] (const auto& f) { return !f.valid(); });
@@ -1098,6 +1091,231 @@ void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& compone
     merge(temp_readers, components.output(), components.contigs());
 }
 
+class CheckpointMismatch : public UserError
+{
+    std::string do_where() const override { return "run_octopus_multi_threaded"; }
+    std::string do_why() const override
+    {
+        std::ostringstream ss {};
+        ss << "the checkpoint in " << directory_
+           << " was made by a run with different samples, regions, or octopus version";
+        return ss.str();
+    }
+    std::string do_help() const override
+    {
+        return "resume with the same options as the checkpointed run, or delete the checkpoint directory";
+    }
+    
+    boost::filesystem::path directory_;
+    
+public:
+    CheckpointMismatch(boost::filesystem::path directory) : directory_ {std::move(directory)} {}
+};
+
+struct Checkpoint
+{
+    Checkpoint(CheckpointJournal journal, CallTypeSet call_types)
+    : journal {std::move(journal)}
+    , call_types {std::move(call_types)}
+    , last_commit {std::chrono::steady_clock::now()}
+    {}
+    CheckpointJournal journal;
+    CallTypeSet call_types;
+    std::chrono::steady_clock::time_point last_commit;
+};
+
+std::string make_checkpoint_fingerprint(const GenomeCallingComponents& components)
+{
+    std::ostringstream ss {};
+    ss << get_octopus_version();
+    for (const auto& sample : components.samples()) ss << ',' << sample;
+    for (const auto& contig : components.contigs()) {
+        for (const auto& region : components.search_regions().at(contig)) ss << ',' << region;
+    }
+    ss << ',' << components.calling_options();
+    return std::to_string(std::hash<std::string> {}(ss.str()));
+}
+
+// Files written after the last commit are incomplete, and are not needed to resume
+void remove_unjournaled_files(const CheckpointJournal& journal)
+{
+    namespace fs = boost::filesystem;
+    auto journaled_files = journal.files();
+    std::set<fs::path> journaled {std::make_move_iterator(std::begin(journaled_files)),
+                                  std::make_move_iterator(std::end(journaled_files))};
+    journaled.insert(journal.journal_path().filename());
+    std::vector<fs::path> unjournaled {};
+    for (const auto& entry : fs::directory_iterator {journal.directory()}) {
+        if (journaled.count(entry.path().filename()) == 0) unjournaled.push_back(entry.path());
+    }
+    for (const auto& path : unjournaled) fs::remove_all(path);
+}
+
+boost::optional<Checkpoint> open_checkpoint(const GenomeCallingComponents& components)
+{
+    if (!components.checkpoint_directory()) return boost::none;
+    const auto& directory = *components.checkpoint_directory();
+    boost::filesystem::create_directories(directory);
+    CheckpointJournal journal {directory};
+    const auto fingerprint = make_checkpoint_fingerprint(components);
+    if (components.resume()) {
+        if (journal.fingerprint().empty()) {
+            logging::WarningLogger warn_log {};
+            stream(warn_log) << "No checkpoint found in " << directory << " - calling from the beginning";
+        } else if (journal.fingerprint() != fingerprint) {
+            throw CheckpointMismatch {directory};
+        } else {
+            logging::InfoLogger info_log {};
+            stream(info_log) << "Resuming from checkpoint " << journal.journal_path();
+        }
+    }
+    journal.set_fingerprint(fingerprint);
+    remove_unjournaled_files(journal);
+    journal.commit();
+    return Checkpoint {std::move(journal), get_call_types(components, components.contigs())};
+}
+
+VcfWriter create_checkpoint_file(const ContigName& contig, const std::string& type, Checkpoint& checkpoint,
+                                 const GenomeCallingComponents& components)
+{
+    auto path = checkpoint.journal.directory() / checkpoint.journal.make_unique_file_name(contig, type);
+    auto header = make_vcf_header(components.samples(), contig, components.reference(), checkpoint.call_types,
+                                  "octopus-internal");
+    return VcfWriter {std::move(path), std::move(header)};
+}
+
+TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components,
+                                       boost::optional<Checkpoint>& checkpoint)
+{
+    if (!checkpoint) return make_temp_vcf_writers(components);
+    TempVcfWriterMap result {};
+    result.reserve(components.contigs().size());
+    for (const auto& contig : components.contigs()) {
+        result.emplace(contig, create_checkpoint_file(contig, "chunk", *checkpoint, components));
+    }
+    return result;
+}
+
+GenomicRegion::Position get_resume_position(const CheckpointJournal::ContigEntry& entry)
+{
+    if (entry.boundary) return entry.boundary->region.end();
+    assert(entry.completed);
+    return entry.completed->end();
+}
+
+// Returns the search regions that are not covered by tasks in the checkpoint
+InputRegionMap get_uncalled_regions(const GenomeCallingComponents& components,
+                                    const boost::optional<Checkpoint>& checkpoint)
+{
+    auto result = components.search_regions();
+    if (!checkpoint) return result;
+    for (auto& p : result) {
+        if (!checkpoint->journal.contains(p.first)) continue;
+        const auto& entry = checkpoint->journal.at(p.first);
+        if (!entry.boundary && !entry.completed) continue;
+        const auto resume_position = get_resume_position(entry);
+        InputRegionMap::mapped_type uncalled {};
+        for (const auto& region : p.second) {
+            if (region.end() > resume_position) {
+                if (region.begin() >= resume_position) {
+                    uncalled.insert(region);
+                } else {
+                    uncalled.emplace(region.contig_name(), resume_position, region.end());
+                }
+            }
+        }
+        p.second = std::move(uncalled);
+    }
+    return result;
+}
+
+// The boundary tasks become the holdbacks, so calls connecting them to the first new task of each
+// contig are resolved as if the run had not been interrupted
+void restore_boundary_tasks(const Checkpoint& checkpoint, CompletedTaskMap& buffered_tasks,
+                            std::map<ContigName, HoldbackTask>& holdbacks)
+{
+    static auto debug_log = get_debug_log();
+    for (auto& p : buffered_tasks) {
+        if (!checkpoint.journal.contains(p.first) || !checkpoint.journal.at(p.first).boundary) continue;
+        const auto& boundary = *checkpoint.journal.at(p.first).boundary;
+        CompletedTask task {Task {boundary.region}};
+        const VcfReader boundary_calls {checkpoint.journal.directory() / boundary.calls};
+        auto calls = boundary_calls.fetch_records();
+        task.calls.assign(std::make_move_iterator(std::begin(calls)), std::make_move_iterator(std::end(calls)));
+        const auto itr = p.second.emplace(contig_region(task), std::move(task)).first;
+        holdbacks.at(p.first) = itr->second;
+        if (debug_log) stream(*debug_log) << "Restored boundary task " << itr->second << " from checkpoint";
+    }
+}
+
+bool is_checkpoint_due(const Checkpoint& checkpoint)
+{
+    static constexpr std::chrono::minutes checkpointInterval {10};
+    return std::chrono::steady_clock::now() - checkpoint.last_commit >= checkpointInterval;
+}
+
+void write_checkpoint(Checkpoint& checkpoint, TempVcfWriterMap& writers,
+                      const std::map<ContigName, HoldbackTask>& holdbacks,
+                      TaskWriterSyncPacket& sync, const GenomeCallingComponents& components)
+{
+    static auto debug_log = get_debug_log();
+    auto& journal = checkpoint.journal;
+    std::vector<boost::filesystem::path> superseded {};
+    std::unique_lock<std::mutex> lock {sync.mutex};
+    // Every task to the left of a holdback must be written, and the task writer cannot start
+    // writing new tasks until the lock is released
+    sync.cv.wait(lock, [&] () { return sync.tasks.empty() && !sync.writing; });
+    for (const auto& p : holdbacks) {
+        if (!p.second) continue;
+        const auto& contig = p.first;
+        const CompletedTask& holdback = p.second->get();
+        if (journal.contains(contig)) {
+            const auto& old_boundary = journal.at(contig).boundary;
+            if (old_boundary) {
+                // Nothing has been written since the last checkpoint
+                if (old_boundary->region == holdback.region) continue;
+                superseded.push_back(journal.directory() / old_boundary->calls);
+            }
+        }
+        auto& writer = writers.at(contig);
+        auto chunk = writer.path()->filename();
+        writer.close();
+        journal.add_chunk(contig, std::move(chunk));
+        writer = create_checkpoint_file(contig, "chunk", checkpoint, components);
+        auto boundary_writer = create_checkpoint_file(contig, "boundary", checkpoint, components);
+        auto boundary_calls = boundary_writer.path()->filename();
+        write(holdback.calls, boundary_writer);
+        boundary_writer.close();
+        const auto& search_regions = components.search_regions().at(contig);
+        journal.set_completed(GenomicRegion {contig, search_regions.front().begin(), holdback.region.begin()});
+        journal.set_boundary(holdback.region, std::move(boundary_calls));
+    }
+    journal.commit();
+    lock.unlock();
+    for (const auto& path : superseded) boost::filesystem::remove(path);
+    checkpoint.last_commit = std::chrono::steady_clock::now();
+    if (debug_log) stream(*debug_log) << "Wrote checkpoint " << journal.journal_path();
+}
+
+void merge(TempVcfWriterMap&& temp_vcf_writers, boost::optional<Checkpoint>& checkpoint,
+           GenomeCallingComponents& components)
+{
+    if (!checkpoint) {
+        merge(std::move(temp_vcf_writers), components);
+        return;
+    }
+    static auto debug_log = get_debug_log();
+    auto readers = extract_as_readers(std::move(temp_vcf_writers));
+    for (const auto& chunk : checkpoint->journal.chunks()) {
+        readers.emplace_back(checkpoint->journal.directory() / chunk);
+    }
+    if (debug_log) stream(*debug_log) << "Merging " << readers.size() << " checkpoint VCF files";
+    merge(readers, components.output(), components.contigs());
+    readers.clear();
+    boost::filesystem::remove_all(checkpoint->journal.directory());
+    checkpoint = boost::none;
+}
+
 void run_octopus_multi_threaded(GenomeCallingComponents& components)
 {
     using namespace std::chrono_literals;
@@ -1105,17 +1323,20 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     
     const auto num_task_threads = calculate_num_task_threads(components);
     
+    auto checkpoint = open_checkpoint(components);
+    
     TaskMap pending_tasks {components.contigs()};
     TaskMakerSyncPacket task_maker_sync {};
     task_maker_sync.batch_size_hint = 2 * num_task_threads;
     std::unique_lock<std::mutex> pending_task_lock {task_maker_sync.mutex, std::defer_lock};
-    auto task_maker_thread = make_task_maker_thread(pending_tasks, components, num_task_threads, task_maker_sync);
-    if (!task_maker_thread.joinable()) {
+    auto task_maker_thread = make_task_maker_thread(pending_tasks, get_uncalled_regions(components, checkpoint),
+                                                    components, num_task_threads, task_maker_sync);
+    if (!task_maker_thread.joinable() && !task_maker_sync.all_done) {
         logging::FatalLogger fatal_log {};
         fatal_log << "Unable to make task maker thread";
         return;
     }
-    task_maker_thread.detach();
+    if (task_maker_thread.joinable()) task_maker_thread.detach();
     
     FutureCompletedTasks futures(num_task_threads);
     TaskMap running_tasks {ContigOrder {components.contigs()}};
@@ -1127,12 +1348,13 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
         buffered_tasks.emplace(contig, CompletedTaskMap::mapped_type {});
         holdbacks.emplace(contig, boost::none);
     }
+    if (checkpoint) restore_boundary_tasks(*checkpoint, buffered_tasks, holdbacks);
     
     CallerSyncPacket caller_sync {};
     const auto calling_components = make_contig_calling_component_factory_map(components);
     unsigned num_idle_futures {0};
     
-    auto temp_writers = make_temp_vcf_writers(components);
+    auto temp_writers = make_temp_vcf_writers(components, checkpoint);
     TaskWriterSyncPacket task_writer_sync {};
     auto task_writer_thread = make_task_writer_thread(temp_writers, task_writer_sync);
     if (!task_writer_thread.joinable()) {
@@ -1144,9 +1366,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     
     // Wait for the first task to be made
     const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0; };
-    while(task_maker_sync.num_tasks == 0) {
+    while(task_maker_sync.num_tasks == 0 && !task_maker_sync.all_done) {
         pending_task_lock.lock();
-        task_maker_sync.cv.wait(pending_task_lock, tasks_available);
+        task_maker_sync.cv.wait(pending_task_lock, [&] () noexcept { return tasks_available() || task_maker_sync.all_done; });
         pending_task_lock.unlock();
     }
     task_maker_sync.batch_size_hint = num_task_threads / 2;
@@ -1181,6 +1403,10 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
                 --caller_sync.num_finished;
             }
             if (!future.valid()) {
+                if (is_memory_exhausted(components, futures)) {
+                    // Not counted as idle so we wait for a running task to finish and release its memory
+                    continue;
+                }
                 pending_task_lock.lock();
                 if (task_maker_sync.num_tasks > 0) {
                     pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
@@ -1193,6 +1419,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
                 }
             }
         }
+        if (checkpoint && is_checkpoint_due(*checkpoint)) {
+            write_checkpoint(*checkpoint, temp_writers, holdbacks, task_writer_sync, components);
+        }
         // If there are no idle futures then all threads are busy and we must wait for one to finish,
         // otherwise we must have run out of tasks, so we should wait for new ones.
         if (num_idle_futures == 0 && caller_sync.num_finished == 0) {
@@ -1212,7 +1441,24 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     wait_until_finished(task_writer_sync);
     write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
     components.progress_meter().stop();
-    merge(std::move(temp_writers), components);
+    merge(std::move(temp_writers), checkpoint, components);
+}
+
+void log_memory_usage(const MemoryGovernor& governor)
+{
+    std::ostringstream ss {};
+    ss << "Peak tracked memory usage was " << governor.peak_usage();
+    if (governor.budget()) ss << " of " << *governor.budget();
+    ss << " (";
+    print_peak_usage(ss, governor);
+    ss << ")";
+    if (governor.budget()) {
+        logging::InfoLogger log {};
+        log << ss.str();
+    } else {
+        static auto debug_log = get_debug_log();
+        if (debug_log) *debug_log << ss.str();
+    }
 }
 
 } // namespace
@@ -1224,6 +1470,10 @@ bool is_multithreaded(const GenomeCallingComponents& components)
 
 void run_calling(GenomeCallingComponents& components)
 {
+    if (components.checkpoint_directory() && !is_multithreaded(components)) {
+        logging::WarningLogger warn_log {};
+        warn_log << "Checkpointing is only supported for multithreaded runs";
+    }
     if (is_multithreaded(components)) {
         if (DEBUG_MODE) {
             logging::WarningLogger warn_log {};
@@ -1233,6 +1483,8 @@ void run_calling(GenomeCallingComponents& components)
     } else {
         run_octopus_single_threaded(components);
     }
+    report_pending_budget_reductions();
+    log_memory_usage(components.memory_governor());
 }
 
 void destroy(VcfWriter& writer)
@@ -7,7 +7,6 @@
 #include <iterator>
 #include <algorithm>
 #include <utility>
-#include <thread>
 #include <cassert>
 
 #include "basics/genomic_region.hpp"
@@ -17,32 +16,14 @@
 #include "utils/genotype_reader.hpp"
 #include "utils/append.hpp"
 #include "utils/read_stats.hpp"
+#include "utils/parallel_algorithms.hpp"
 #include "read_assigner.hpp"
 #include "read_realigner.hpp"
 
 namespace octopus {
 
-namespace {
-
-unsigned get_pool_size(const BAMRealigner::Config& config)
-{
-    const auto num_cores = std::thread::hardware_concurrency();
-    if (config.max_threads) {
-        if (*config.max_threads > 1) {
-            return num_cores > 0 ? std::min(*config.max_threads, num_cores) : *config.max_threads;
-        } else {
-            return 0;
-        }
-    } else {
-        return num_cores > 0 ? num_cores : 8;
-    }
-}
-
-} // namespace
-
 BAMRealigner::BAMRealigner(Config config)
 : config_ {std::move(config)}
-, workers_ {get_pool_size(config_)}
 {}
 
 namespace {
@@ -103,6 +84,12 @@ auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Ha
     return result;
 }
 
+void add(const BAMRealigner::Report& src, BAMRealigner::Report& dst) noexcept
+{
+    dst.n_reads_assigned += src.n_reads_assigned;
+    dst.n_reads_unassigned += src.n_reads_unassigned;
+}
+
 template <typename Container>
 auto move_merge(Container&& src, std::vector<AlignedRead>& dst)
 {
@@ -119,26 +106,16 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
 {
     Report report {};
     boost::optional<GenomicRegion> batch_region {};
-    std::vector<AlignedRead> buffer {};
     for (auto p = variants.iterate(); p.first != p.second; ) {
         auto batch = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
-        for (auto& sample : batch) {
-            std::vector<AlignedRead> genotype_reads {}, realigned_reads {};
-            auto sample_reads_itr = std::begin(sample.reads);
-            for (const auto& genotype : sample.genotypes) {
-                const auto padded_genotype_region = expand(mapped_region(genotype), 1);
-                const auto overlapped_reads = bases(overlap_range(sample_reads_itr, std::end(sample.reads), padded_genotype_region));
-                genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
-                                      std::make_move_iterator(overlapped_reads.end()));
-                sample_reads_itr = sample.reads.erase(overlapped_reads.begin(), overlapped_reads.end());
-                auto bad_reads = remove_unalignable_reads(genotype_reads);
-                auto realignments = assign_and_realign(genotype_reads, genotype, report);
-                report.n_reads_unassigned += bad_reads.size();
-                move_merge(bad_reads, realignments);
-                move_merge(realignments, realigned_reads);
-            }
-            move_merge(realigned_reads, sample.reads);
-            dst << sample.reads;
+        // Samples are realigned independently, but written in order
+        std::vector<Report> sample_reports(batch.size());
+        parallel_for(std::size_t {0}, batch.size(), [&] (const std::size_t s) {
+            realign_sample(batch[s], sample_reports[s]);
+        }, thread_pool());
+        for (std::size_t s {0}; s < batch.size(); ++s) {
+            dst << batch[s].reads;
+            add(sample_reports[s], report);
         }
         batch_region = encompassing_region(batch.front().genotypes);
     }
@@ -198,26 +175,20 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
     boost::optional<GenomicRegion> batch_region {};
     for (auto p = variants.iterate(); p.first != p.second; ) {
         auto batch = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
-        for (auto& sample : batch) {
-            std::vector<AlignedRead> genotype_reads {}, unassigned_realigned_reads {};
-            auto sample_reads_itr = std::begin(sample.reads);
-            for (const auto& genotype : sample.genotypes) {
-                const auto overlapped_reads = bases(overlap_range(sample_reads_itr, std::end(sample.reads), genotype));
-                genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
-                                      std::make_move_iterator(overlapped_reads.end()));
-                sample_reads_itr = sample.reads.erase(overlapped_reads.begin(), overlapped_reads.end());
-                auto bad_reads = remove_unalignable_reads(genotype_reads);
-                auto realignments = split_and_realign(genotype_reads, genotype, report);
-                report.n_reads_unassigned += bad_reads.size();
-                move_merge(bad_reads, realignments.back());
+        std::vector<SplitReadList> sample_realignments(batch.size());
+        std::vector<Report> sample_reports(batch.size());
+        parallel_for(std::size_t {0}, batch.size(), [&] (const std::size_t s) {
+            sample_realignments[s] = split_and_realign_sample(batch[s], sample_reports[s]);
+        }, thread_pool());
+        for (std::size_t s {0}; s < batch.size(); ++s) {
+            for (auto& realignments : sample_realignments[s]) {
                 assert(realignments.size() <= dsts.size());
-                for (unsigned i {0}; i < realignments.size() - 1; ++i) {
-                    dsts[i] <<  realignments[i];
+                for (unsigned i {0}; i < realignments.size(); ++i) {
+                    dsts[i] << realignments[i];
                 }
-                move_merge(realignments.back(), unassigned_realigned_reads); // end is always unassigned, but ploidy can change
             }
-            move_merge(unassigned_realigned_reads, sample.reads);
-            dsts.back() << sample.reads;
+            dsts.back() << batch[s].reads;
+            add(sample_reports[s], report);
         }
         batch_region = encompassing_region(batch.front().genotypes);
     }
@@ -251,6 +222,57 @@ BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants,
 
 // private methods
 
+ThreadPool& BAMRealigner::thread_pool() const
+{
+    static ThreadPool serial_pool {};
+    return !config_.max_threads || *config_.max_threads > 1 ? shared_thread_pool() : serial_pool;
+}
+
+void BAMRealigner::realign_sample(Batch& sample, Report& report) const
+{
+    std::vector<AlignedRead> genotype_reads {}, realigned_reads {};
+    auto sample_reads_itr = std::begin(sample.reads);
+    for (const auto& genotype : sample.genotypes) {
+        const auto padded_genotype_region = expand(mapped_region(genotype), 1);
+        const auto overlapped_reads = bases(overlap_range(sample_reads_itr, std::end(sample.reads), padded_genotype_region));
+        genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
+                              std::make_move_iterator(overlapped_reads.end()));
+        sample_reads_itr = sample.reads.erase(overlapped_reads.begin(), overlapped_reads.end());
+        auto bad_reads = remove_unalignable_reads(genotype_reads);
+        auto realignments = assign_and_realign(genotype_reads, genotype, report);
+        report.n_reads_unassigned += bad_reads.size();
+        move_merge(bad_reads, realignments);
+        move_merge(realignments, realigned_reads);
+    }
+    move_merge(realigned_reads, sample.reads);
+}
+
+// Returns the assigned reads of each genotype, one set per haplotype; the unassigned reads are
+// merged back into sample.reads
+BAMRealigner::SplitReadList
+BAMRealigner::split_and_realign_sample(Batch& sample, Report& report) const
+{
+    SplitReadList result {};
+    result.reserve(sample.genotypes.size());
+    std::vector<AlignedRead> genotype_reads {}, unassigned_realigned_reads {};
+    auto sample_reads_itr = std::begin(sample.reads);
+    for (const auto& genotype : sample.genotypes) {
+        const auto overlapped_reads = bases(overlap_range(sample_reads_itr, std::end(sample.reads), genotype));
+        genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
+                              std::make_move_iterator(overlapped_reads.end()));
+        sample_reads_itr = sample.reads.erase(overlapped_reads.begin(), overlapped_reads.end());
+        auto bad_reads = remove_unalignable_reads(genotype_reads);
+        auto realignments = split_and_realign(genotype_reads, genotype, report);
+        report.n_reads_unassigned += bad_reads.size();
+        move_merge(bad_reads, realignments.back());
+        move_merge(realignments.back(), unassigned_realigned_reads); // end is always unassigned, but ploidy can change
+        realignments.pop_back();
+        result.push_back(std::move(realignments));
+    }
+    move_merge(unassigned_realigned_reads, sample.reads);
+    return result;
+}
+
 namespace {
 
 GenomicRegion get_phase_set(const VcfRecord& record, const SampleName& sample)
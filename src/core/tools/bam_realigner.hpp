@@ -71,10 +71,13 @@ private:
         std::vector<AlignedRead> reads;
     };
     using BatchList = std::vector<Batch>;
+    using SplitReadList = std::vector<std::vector<std::vector<AlignedRead>>>;
     
     Config config_;
-    mutable ThreadPool workers_;
     
+    ThreadPool& thread_pool() const;
+    void realign_sample(Batch& sample, Report& report) const;
+    SplitReadList split_and_realign_sample(Batch& sample, Report& report) const;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
     BatchList read_next_batch(VcfIterator& first, const VcfIterator& last, ReadReader& src,
                               const ReferenceGenome& reference, const SampleList& samples,
@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "connecting_calls.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "concepts/mappable.hpp"
+#include "utils/mappable_algorithms.hpp"
+
+namespace octopus {
+
+void buffer_connecting_calls(std::deque<VcfRecord>& calls, const GenomicRegion& next_calling_region,
+                             std::vector<VcfRecord>& buffer)
+{
+    const auto it = std::find_if(std::begin(calls), std::end(calls),
+                                 [&next_calling_region] (const auto& call) {
+                                     return mapped_end(call) > next_calling_region.begin();
+                                 });
+    buffer.insert(std::end(buffer),
+                  std::make_move_iterator(it),
+                  std::make_move_iterator(std::end(calls)));
+    calls.erase(it, std::end(calls));
+}
+
+void buffer_connecting_calls(const GenomicRegion& buffered_region, std::deque<VcfRecord>& calls,
+                             std::vector<VcfRecord>& buffer)
+{
+    const auto it = std::find_if_not(std::begin(calls), std::end(calls),
+                                     [&buffered_region] (const auto& call) {
+                                         return mapped_begin(call) < buffered_region.end();
+                                     });
+    buffer.insert(std::end(buffer),
+                  std::make_move_iterator(std::begin(calls)),
+                  std::make_move_iterator(it));
+    calls.erase(std::begin(calls), it);
+}
+
+std::deque<VcfRecord> merge_connecting_calls(std::vector<VcfRecord>& connecting_calls, std::deque<VcfRecord>& calls)
+{
+    std::deque<VcfRecord> result {};
+    if (connecting_calls.empty()) return result;
+    std::vector<VcfRecord> new_connecting_calls {};
+    buffer_connecting_calls(encompassing_region(connecting_calls), calls, new_connecting_calls);
+    std::set_union(std::make_move_iterator(std::begin(connecting_calls)), std::make_move_iterator(std::end(connecting_calls)),
+                   std::make_move_iterator(std::begin(new_connecting_calls)), std::make_move_iterator(std::end(new_connecting_calls)),
+                   std::back_inserter(result));
+    connecting_calls.clear();
+    connecting_calls.shrink_to_fit();
+    return result;
+}
+
+std::deque<VcfRecord> merge_connecting_calls(std::deque<VcfRecord>& lhs, std::deque<VcfRecord>& rhs)
+{
+    std::deque<VcfRecord> result {};
+    if (lhs.empty() || rhs.empty()) return result;
+    const auto rhs_begin = mapped_begin(encompassing_region(rhs));
+    const auto lhs_end = mapped_end(encompassing_region(lhs));
+    const auto first_lhs_connecting = std::find_if(std::begin(lhs), std::end(lhs),
+                                                   [rhs_begin] (const auto& call) { return mapped_end(call) > rhs_begin; });
+    const auto last_rhs_connecting = std::find_if_not(std::begin(rhs), std::end(rhs),
+                                                      [lhs_end] (const auto& call) { return mapped_begin(call) < lhs_end; });
+    std::set_union(std::make_move_iterator(first_lhs_connecting), std::make_move_iterator(std::end(lhs)),
+                   std::make_move_iterator(std::begin(rhs)), std::make_move_iterator(last_rhs_connecting),
+                   std::back_inserter(result));
+    lhs.erase(first_lhs_connecting, std::end(lhs));
+    rhs.erase(std::begin(rhs), last_rhs_connecting);
+    return result;
+}
+
+} // namespace octopus
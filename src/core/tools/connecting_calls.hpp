@@ -0,0 +1,43 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef connecting_calls_hpp
+#define connecting_calls_hpp
+
+#include <vector>
+#include <deque>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf_record.hpp"
+
+namespace octopus {
+
+/*
+ Calls made for adjacent regions independently can both include calls that span the boundary
+ between the regions. These helpers find such connecting calls and merge them, so each call is
+ written once.
+
+ All call sequences must be sorted.
+ */
+
+// Moves the first call of calls that ends after next_calling_region begins, and every call after it,
+// to the end of buffer
+void buffer_connecting_calls(std::deque<VcfRecord>& calls, const GenomicRegion& next_calling_region,
+                             std::vector<VcfRecord>& buffer);
+
+// Moves the calls at the front of calls that begin before buffered_region ends to the end of buffer
+void buffer_connecting_calls(const GenomicRegion& buffered_region, std::deque<VcfRecord>& calls,
+                             std::vector<VcfRecord>& buffer);
+
+// Removes the calls at the front of calls that connect with connecting_calls, which are cleared,
+// and returns the set union of both. Calls at the same site are only kept from connecting_calls.
+std::deque<VcfRecord> merge_connecting_calls(std::vector<VcfRecord>& connecting_calls, std::deque<VcfRecord>& calls);
+
+// Removes the calls of lhs that end after the calls of rhs begin, and the calls of rhs that begin
+// before the calls of lhs end, and returns the set union of both. Calls at the same site are only
+// kept from lhs.
+std::deque<VcfRecord> merge_connecting_calls(std::deque<VcfRecord>& lhs, std::deque<VcfRecord>& rhs);
+
+} // namespace octopus
+
+#endif
@@ -0,0 +1,393 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "genome_sharding.hpp"
+
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <deque>
+#include <iterator>
+
+#include <boost/lexical_cast.hpp>
+
+#include "concepts/mappable.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_utils.hpp"
+#include "utils/mappable_algorithms.hpp"
+#include "connecting_calls.hpp"
+#include "exceptions/user_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+
+namespace octopus {
+
+namespace {
+
+const std::string shardTag {"octopus_shard"};
+
+class MalformedShard : public MalformedFileError
+{
+    std::string do_where() const override { return "merge_shards"; }
+    std::string do_help() const override
+    {
+        return "only the outputs of octopus runs with --shard can be merged";
+    }
+public:
+    MalformedShard(boost::filesystem::path file, std::string reason)
+    : MalformedFileError {std::move(file), "sharded VCF"}
+    {
+        set_reason(std::move(reason));
+    }
+};
+
+class IncompatibleShards : public UserError
+{
+    std::string do_where() const override { return "merge_shards"; }
+    std::string do_why() const override { return why_; }
+    std::string do_help() const override
+    {
+        return "supply the output of every shard of a single sharded run, each exactly once";
+    }
+    std::string why_;
+public:
+    IncompatibleShards(std::string why) : why_ {std::move(why)} {}
+};
+
+// Regions of contigs with a read estimate are costed by their expected read count, the others by
+// their size at the mean read density of the estimated contigs
+struct CostedRegion
+{
+    GenomicRegion region;
+    const CoverageEstimate* reads;
+    double density;
+};
+
+std::vector<CostedRegion>
+order_regions(const InputRegionMap& regions, const std::vector<ContigName>& contigs,
+              const ReadDistributionMap& reads)
+{
+    double known_reads {0}, known_size {0};
+    for (const auto& contig : contigs) {
+        if (regions.count(contig) == 1 && reads.count(contig) == 1) {
+            const auto& estimate = reads.at(contig);
+            known_reads += estimate.total();
+            known_size += size(estimate.mapped_region());
+        }
+    }
+    const bool use_reads {known_reads > 0};
+    const auto default_density = use_reads ? known_reads / known_size : 1.0;
+    std::vector<CostedRegion> result {};
+    for (const auto& contig : contigs) {
+        if (regions.count(contig) == 0) continue;
+        const CoverageEstimate* estimate {nullptr};
+        if (use_reads && reads.count(contig) == 1) {
+            estimate = &reads.at(contig);
+        }
+        for (const auto& region : regions.at(contig)) {
+            if (!is_empty(region)) {
+                result.push_back({region, estimate, default_density});
+            }
+        }
+    }
+    return result;
+}
+
+double cost(const CostedRegion& costed, const GenomicRegion& region)
+{
+    return costed.reads ? costed.reads->count(region) : size(region) * costed.density;
+}
+
+double sum_cost(const std::vector<CostedRegion>& regions)
+{
+    return std::accumulate(std::cbegin(regions), std::cend(regions), 0.0,
+                           [] (double curr, const auto& r) { return curr + cost(r, r.region); });
+}
+
+// The number of bases from the start of region that cost about max_cost
+GenomicRegion::Size find_split_offset(const CostedRegion& costed, const GenomicRegion& region, const double max_cost)
+{
+    if (costed.reads) {
+        return size(costed.reads->find_covered_subregion(region, max_cost));
+    }
+    const auto result = static_cast<GenomicRegion::Size>(std::ceil(max_cost / costed.density));
+    return std::min(result, size(region));
+}
+
+GenomicRegion::Position expand_begin(const GenomicRegion& region, const GenomicRegion& bounds,
+                                     GenomicRegion::Size margin)
+{
+    return region.begin() >= bounds.begin() + margin ? region.begin() - margin : bounds.begin();
+}
+
+GenomicRegion::Position expand_end(const GenomicRegion& region, const GenomicRegion& bounds,
+                                   GenomicRegion::Size margin)
+{
+    return std::min(region.end() + margin, bounds.end());
+}
+
+template <typename T>
+T parse_shard_field(const VcfHeader::StructuredField& field, const char* key)
+{
+    return boost::lexical_cast<T>(field.at(key));
+}
+
+VcfHeader remove_shard_fields(const VcfHeader& header)
+{
+    VcfHeader::StructuredFieldMap structured_fields {};
+    for (const auto& p : header.structured_fields()) {
+        if (p.first.value != shardTag) structured_fields.insert(p);
+    }
+    return VcfHeader {header.file_format(), header.samples(), header.basic_fields(), std::move(structured_fields)};
+}
+
+using RecordIteratorPair = VcfReader::RecordIteratorPair;
+
+bool is_exhausted(const RecordIteratorPair& records)
+{
+    return records.first == records.second;
+}
+
+} // namespace
+
+ReadDistributionMap estimate_read_distributions(const ReadManager& read_manager, const ReferenceGenome& reference,
+                                                const std::vector<ContigName>& contigs)
+{
+    // The BAI linear index resolution
+    static constexpr GenomicRegion::Size binSize {16'384};
+    ReadDistributionMap result {};
+    result.reserve(contigs.size());
+    for (const auto& contig : contigs) {
+        const auto contig_size = reference.contig_size(contig);
+        if (contig_size == 0) continue;
+        const GenomicRegion contig_region {contig, 0, contig_size};
+        auto estimate = read_manager.estimate_coverage(read_manager.samples(), contig_region, binSize);
+        if (!estimate) {
+            const auto num_reads = read_manager.count_mapped_reads(contig);
+            if (!num_reads) continue;
+            estimate = CoverageEstimate {contig_region, contig_size, {static_cast<double>(*num_reads)}};
+        }
+        result.emplace(contig, std::move(*estimate));
+    }
+    return result;
+}
+
+std::vector<GenomeShard>
+make_genome_shards(const InputRegionMap& regions, const std::vector<ContigName>& contigs,
+                   const unsigned count, const ReadDistributionMap& reads, const GenomicRegion::Size margin)
+{
+    if (count == 0) {
+        throw std::invalid_argument {"make_genome_shards: count must be positive"};
+    }
+    std::vector<GenomeShard> result {};
+    result.reserve(count);
+    for (unsigned i {0}; i < count; ++i) {
+        result.push_back({i, count, margin, {}});
+    }
+    auto costed_regions = order_regions(regions, contigs, reads);
+    auto total_cost = sum_cost(costed_regions);
+    if (total_cost <= 0) {
+        // Nothing is expected to map, so balance bases instead
+        for (auto& r : costed_regions) {
+            r.reads = nullptr;
+            r.density = 1.0;
+        }
+        total_cost = sum_cost(costed_regions);
+    }
+    double cumulative_cost {0};
+    unsigned shard {0};
+    for (const auto& costed : costed_regions) {
+        auto region = costed.region;
+        while (shard + 1 < count) {
+            const auto split_cost = total_cost * (shard + 1) / count;
+            if (cumulative_cost + cost(costed, region) <= split_cost) break;
+            const auto split_offset = find_split_offset(costed, region, split_cost - cumulative_cost);
+            if (split_offset > 0) {
+                const GenomicRegion head {region.contig_id(), region.begin(), region.begin() + split_offset};
+                cumulative_cost += cost(costed, head);
+                result[shard].regions.push_back(head);
+                region = GenomicRegion {region.contig_id(), head.end(), region.end()};
+            }
+            ++shard;
+        }
+        if (!is_empty(region)) {
+            cumulative_cost += cost(costed, region);
+            result[shard].regions.push_back(std::move(region));
+        }
+    }
+    return result;
+}
+
+InputRegionMap get_shard_search_regions(const GenomeShard& shard, const InputRegionMap& search_regions)
+{
+    InputRegionMap result {};
+    for (const auto& core : shard.regions) {
+        const auto& contig_regions = search_regions.at(core.contig_name());
+        const auto bounds = std::find_if(std::cbegin(contig_regions), std::cend(contig_regions),
+                                         [&core] (const auto& region) { return contains(region, core); });
+        if (bounds == std::cend(contig_regions)) {
+            throw std::logic_error {"get_shard_search_regions: shard region is not a search region"};
+        }
+        result[core.contig_name()].insert(GenomicRegion {core.contig_id(),
+                                                         expand_begin(core, *bounds, shard.margin),
+                                                         expand_end(core, *bounds, shard.margin)});
+    }
+    return result;
+}
+
+void add_shard_header_fields(const GenomeShard& shard, VcfHeader::Builder& builder)
+{
+    unsigned k {0};
+    for (const auto& region : shard.regions) {
+        builder.add_structured_field(shardTag, {
+            {"ID", std::to_string(shard.index + 1) + "." + std::to_string(++k)},
+            {"Shard", std::to_string(shard.index + 1)},
+            {"Shards", std::to_string(shard.count)},
+            {"Margin", std::to_string(shard.margin)},
+            {"Contig", region.contig_name()},
+            {"Begin", std::to_string(region.begin())},
+            {"End", std::to_string(region.end())}
+        });
+    }
+}
+
+boost::optional<GenomeShard> read_shard(const VcfHeader& header)
+{
+    if (!header.has(VcfHeader::Tag {shardTag})) return boost::none;
+    std::vector<std::pair<unsigned, GenomicRegion>> numbered_regions {};
+    GenomeShard result {};
+    for (const auto& field : header.structured_fields(shardTag)) {
+        result.index  = parse_shard_field<unsigned>(field, "Shard") - 1;
+        result.count  = parse_shard_field<unsigned>(field, "Shards");
+        result.margin = parse_shard_field<GenomicRegion::Size>(field, "Margin");
+        const auto& id = field.at("ID");
+        const auto dot_pos = id.find('.');
+        if (dot_pos == std::string::npos) {
+            throw std::invalid_argument {"read_shard: bad ID " + id};
+        }
+        numbered_regions.emplace_back(boost::lexical_cast<unsigned>(id.substr(dot_pos + 1)),
+                                      GenomicRegion {field.at("Contig"),
+                                                     parse_shard_field<GenomicRegion::Position>(field, "Begin"),
+                                                     parse_shard_field<GenomicRegion::Position>(field, "End")});
+    }
+    std::sort(std::begin(numbered_regions), std::end(numbered_regions),
+              [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    result.regions.reserve(numbered_regions.size());
+    for (auto& p : numbered_regions) {
+        result.regions.push_back(std::move(p.second));
+    }
+    return result;
+}
+
+void merge_shards(const std::vector<VcfReader>& shards, VcfWriter& dst)
+{
+    if (shards.empty()) return;
+    std::vector<GenomeShard> shard_infos {};
+    shard_infos.reserve(shards.size());
+    for (const auto& reader : shards) {
+        boost::optional<GenomeShard> shard {};
+        try {
+            shard = read_shard(reader.fetch_header());
+        } catch (const std::exception& e) {
+            throw MalformedShard {reader.path(), "the octopus_shard header lines are malformed"};
+        }
+        if (!shard) {
+            throw MalformedShard {reader.path(), "there are no octopus_shard header lines"};
+        }
+        shard_infos.push_back(std::move(*shard));
+    }
+    const auto num_shards = shard_infos.front().count;
+    if (shards.size() != num_shards) {
+        throw IncompatibleShards {"the run has " + std::to_string(num_shards) + " shards but "
+                                  + std::to_string(shards.size()) + " files were given"};
+    }
+    std::vector<std::size_t> shard_order(num_shards, shards.size());
+    for (std::size_t i {0}; i < shards.size(); ++i) {
+        const auto& info = shard_infos[i];
+        if (info.count != num_shards || info.margin != shard_infos.front().margin) {
+            throw IncompatibleShards {shards[i].path().string() + " is from a different sharded run"};
+        }
+        if (info.index >= num_shards || shard_order[info.index] != shards.size()) {
+            throw IncompatibleShards {"shard " + std::to_string(info.index + 1) + " was given more than once"};
+        }
+        shard_order[info.index] = i;
+    }
+    struct CoreRegion
+    {
+        GenomicRegion region;
+        std::size_t source;
+    };
+    std::vector<CoreRegion> cores {};
+    std::unordered_map<ContigName, std::size_t> contig_ranks {};
+    std::vector<VcfHeader> headers {};
+    headers.reserve(num_shards);
+    for (const auto source : shard_order) {
+        for (const auto& region : shard_infos[source].regions) {
+            contig_ranks.emplace(region.contig_name(), contig_ranks.size());
+            cores.push_back({region, source});
+        }
+        headers.push_back(shards[source].fetch_header());
+    }
+    if (!dst.is_header_written()) {
+        dst << remove_shard_fields(merge(headers));
+    }
+    std::vector<RecordIteratorPair> records {};
+    records.reserve(shards.size());
+    for (const auto& reader : shards) {
+        records.push_back(reader.iterate());
+    }
+    // Each core is treated like a calling task: its calls are the shard's calls that overlap the core,
+    // and calls connecting adjacent cores are merged as they are between the tasks of a single run.
+    std::vector<VcfRecord> connecting_calls {};
+    std::deque<VcfRecord> calls {};
+    for (std::size_t i {0}; i < cores.size(); ++i) {
+        const auto& core = cores[i].region;
+        auto& source = records[cores[i].source];
+        const auto core_rank = contig_ranks.at(core.contig_name());
+        const bool continued_by_next {i + 1 < cores.size() && is_same_contig(cores[i + 1].region, core)
+                                      && cores[i + 1].region.begin() == core.end()};
+        while (!is_exhausted(source)) {
+            const auto& record = *source.first;
+            const auto rank_itr = contig_ranks.find(record.chrom());
+            if (rank_itr != std::cend(contig_ranks)) {
+                if (rank_itr->second > core_rank) break;
+                if (rank_itr->second == core_rank && mapped_end(record) > core.begin()) break;
+            }
+            ++source.first;
+        }
+        while (!is_exhausted(source)) {
+            const auto& record = *source.first;
+            if (record.chrom() != core.contig_name() || mapped_begin(record) >= core.end()) break;
+            if (mapped_end(record) <= core.begin()) {
+                ++source.first; // in the margin, but not overlapping the core
+                continue;
+            }
+            calls.push_back(record);
+            ++source.first;
+            if (!connecting_calls.empty() && mapped_begin(calls.back()) >= encompassing_region(connecting_calls).end()) {
+                auto merged_calls = merge_connecting_calls(connecting_calls, calls);
+                calls.insert(std::begin(calls), std::make_move_iterator(std::begin(merged_calls)),
+                             std::make_move_iterator(std::end(merged_calls)));
+            }
+            if (connecting_calls.empty()) {
+                // Only calls that may connect with the next core need to be held back
+                while (!calls.empty() && !(continued_by_next && mapped_end(calls.front()) > core.end())) {
+                    dst << calls.front();
+                    calls.pop_front();
+                }
+            }
+        }
+        auto merged_calls = merge_connecting_calls(connecting_calls, calls);
+        calls.insert(std::begin(calls), std::make_move_iterator(std::begin(merged_calls)),
+                     std::make_move_iterator(std::end(merged_calls)));
+        if (continued_by_next) {
+            buffer_connecting_calls(calls, cores[i + 1].region, connecting_calls);
+        }
+        for (const auto& call : calls) dst << call;
+        calls.clear();
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,70 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef genome_sharding_hpp
+#define genome_sharding_hpp
+
+#include <vector>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/read/read_manager.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "utils/coverage_estimate.hpp"
+
+namespace octopus {
+
+/**
+ Sharding splits the search regions into a fixed number of parts that can be called by separate
+ processes. The split only depends on the search regions, the reference, and the read index
+ statistics, so every process computes the same shards.
+
+ A shard owns the calls that overlap its core regions. It calls its core regions expanded by a
+ margin so that calls spanning a split point are seen with full context by both neighbouring
+ shards. The core regions are recorded in the output VCF header, which lets merge_shards
+ reconcile the calls at each split point.
+ */
+struct GenomeShard
+{
+    unsigned index, count; // index is zero-based
+    GenomicRegion::Size margin;
+    std::vector<GenomicRegion> regions;
+};
+
+// The expected number of mapped reads along each contig
+using ReadDistributionMap = std::unordered_map<ContigName, CoverageEstimate>;
+
+// Reads are binned from the read index where it allows (see ReadManager::estimate_coverage). Other
+// contigs get a single bin of their mapped read count, and contigs with neither are left out.
+ReadDistributionMap estimate_read_distributions(const ReadManager& read_manager, const ReferenceGenome& reference,
+                                                const std::vector<ContigName>& contigs);
+
+// Splits regions, in contig order, into count shards of roughly equal expected read count.
+// Contigs missing from reads are costed by size.
+std::vector<GenomeShard>
+make_genome_shards(const InputRegionMap& regions, const std::vector<ContigName>& contigs,
+                   unsigned count, const ReadDistributionMap& reads, GenomicRegion::Size margin);
+
+// Returns the regions the shard should call: its core regions expanded by its margin, but not
+// outside of the search regions
+InputRegionMap get_shard_search_regions(const GenomeShard& shard, const InputRegionMap& search_regions);
+
+void add_shard_header_fields(const GenomeShard& shard, VcfHeader::Builder& builder);
+
+boost::optional<GenomeShard> read_shard(const VcfHeader& header);
+
+// Merges the outputs of all shards of one sharded run. Calls are taken from the shards whose core
+// regions they overlap. The calls connecting two adjacent cores are merged like the calls connecting
+// the tasks of a single run (see merge_connecting_calls), so a call both shards make is written once,
+// from the left shard.
+void merge_shards(const std::vector<VcfReader>& shards, VcfWriter& dst);
+
+} // namespace octopus
+
+#endif
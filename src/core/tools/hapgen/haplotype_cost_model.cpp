@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "haplotype_cost_model.hpp"
+
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "core/models/pairhmm/pair_hmm.hpp"
+#include "logging/logging.hpp"
+
+namespace octopus { namespace coretools {
+
+HaplotypeCostModel::HaplotypeCostModel(Seconds region_budget, unsigned ploidy, Seconds unit_cost)
+: region_budget_ {region_budget}
+, unit_cost_ {unit_cost}
+, ploidy_ {std::max(ploidy, 1u)}
+{}
+
+HaplotypeCostModel::Seconds HaplotypeCostModel::region_budget() const noexcept
+{
+    return region_budget_;
+}
+
+HaplotypeCostModel::Seconds HaplotypeCostModel::unit_cost() const noexcept
+{
+    return unit_cost_;
+}
+
+HaplotypeCostModel::Seconds
+HaplotypeCostModel::predict(const std::size_t num_reads, const std::size_t num_haplotypes,
+                            const GenomicRegion::Size haplotype_length) const noexcept
+{
+    const auto num_units = static_cast<double>(num_reads) * num_haplotypes * haplotype_length * ploidy_;
+    return num_units * unit_cost_;
+}
+
+std::size_t HaplotypeCostModel::max_haplotypes(const std::size_t num_reads,
+                                               const GenomicRegion::Size haplotype_length) const noexcept
+{
+    const auto haplotype_cost = predict(num_reads, 1, haplotype_length);
+    if (haplotype_cost.count() <= 0) return std::numeric_limits<std::size_t>::max();
+    const auto result = std::floor(region_budget_ / haplotype_cost);
+    if (result >= static_cast<double>(std::numeric_limits<std::size_t>::max())) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    return static_cast<std::size_t>(result);
+}
+
+namespace {
+
+constexpr std::size_t calibrationReadLength {150};
+constexpr std::size_t calibrationHaplotypeLength {400};
+constexpr std::size_t numCalibrationReads {500};
+
+std::string make_random_sequence(const std::size_t length, std::mt19937& generator)
+{
+    static constexpr std::array<char, 4> bases {'A', 'C', 'G', 'T'};
+    std::uniform_int_distribution<std::size_t> base_distribution {0, bases.size() - 1};
+    std::string result(length, 'N');
+    std::generate(std::begin(result), std::end(result), [&] () { return bases[base_distribution(generator)]; });
+    return result;
+}
+
+} // namespace
+
+HaplotypeCostModel::Seconds calibrate_haplotype_cost()
+{
+    // A fixed seed so every run benchmarks the same work
+    std::mt19937 generator {42};
+    const auto flank_pad = hmm::min_flank_pad();
+    const auto truth = make_random_sequence(calibrationHaplotypeLength + 2 * flank_pad, generator);
+    std::vector<char> snv_mask(truth.size());
+    std::rotate_copy(std::crbegin(truth), std::next(std::crbegin(truth)), std::crend(truth), std::rbegin(snv_mask));
+    const std::vector<hmm::MutationModel::Penalty> snv_priors(truth.size(), 40), gap_open(truth.size(), 45);
+    const hmm::MutationModel model {snv_mask, snv_priors, gap_open, 3};
+    const std::vector<std::uint8_t> qualities(calibrationReadLength, 30);
+    std::uniform_int_distribution<std::size_t> offset_distribution {flank_pad, flank_pad + calibrationHaplotypeLength - calibrationReadLength};
+    std::vector<std::size_t> offsets(numCalibrationReads);
+    std::vector<std::string> reads(numCalibrationReads);
+    for (std::size_t i {0}; i < numCalibrationReads; ++i) {
+        offsets[i] = offset_distribution(generator);
+        reads[i] = truth.substr(offsets[i], calibrationReadLength);
+        reads[i][calibrationReadLength / 2] = reads[i][calibrationReadLength / 2] == 'A' ? 'C' : 'A';
+    }
+    double total_log_likelihood {0};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i {0}; i < numCalibrationReads; ++i) {
+        total_log_likelihood += hmm::evaluate(reads[i], truth, qualities, offsets[i], model);
+    }
+    const HaplotypeCostModel::Seconds elapsed = std::chrono::steady_clock::now() - start;
+    // Guards against a zero time measurement, and stops the loop being optimised away
+    if (elapsed.count() <= 0 || total_log_likelihood > 0) {
+        return HaplotypeCostModel::Seconds {1e-9};
+    }
+    return elapsed / (static_cast<double>(numCalibrationReads) * calibrationHaplotypeLength);
+}
+
+HaplotypeCostModel make_calibrated_cost_model(HaplotypeCostModel::Seconds region_budget, unsigned ploidy)
+{
+    return HaplotypeCostModel {region_budget, ploidy, calibrate_haplotype_cost()};
+}
+
+namespace {
+
+struct BudgetReductions
+{
+    std::mutex mutex;
+    boost::optional<std::chrono::steady_clock::time_point> last_report;
+    std::size_t num_unreported;
+    boost::optional<GenomicRegion> last_region;
+    unsigned last_max_haplotypes;
+};
+
+BudgetReductions& budget_reductions()
+{
+    static BudgetReductions result {};
+    return result;
+}
+
+void log_budget_reductions(const std::size_t num_reduced, const GenomicRegion& region, const unsigned max_haplotypes)
+{
+    logging::WarningLogger warn_log {};
+    stream(warn_log) << "The region time budget reduced haplotype limits in " << num_reduced
+                     << (num_reduced == 1 ? " region" : " regions") << " since the last report, most recently in "
+                     << region << " to " << max_haplotypes << " haplotypes. Calls in these regions may be less sensitive";
+}
+
+} // namespace
+
+void report_budget_reduction(const GenomicRegion& region, const unsigned max_haplotypes)
+{
+    static constexpr std::chrono::minutes reportInterval {1};
+    auto& reductions = budget_reductions();
+    std::unique_lock<std::mutex> lock {reductions.mutex};
+    ++reductions.num_unreported;
+    reductions.last_region = region;
+    reductions.last_max_haplotypes = max_haplotypes;
+    const auto now = std::chrono::steady_clock::now();
+    if (reductions.last_report && now - *reductions.last_report < reportInterval) return;
+    const auto num_reduced = reductions.num_unreported;
+    reductions.num_unreported = 0;
+    reductions.last_report = now;
+    lock.unlock();
+    log_budget_reductions(num_reduced, region, max_haplotypes);
+}
+
+void report_pending_budget_reductions()
+{
+    auto& reductions = budget_reductions();
+    std::unique_lock<std::mutex> lock {reductions.mutex};
+    if (reductions.num_unreported == 0) return;
+    const auto num_reduced = reductions.num_unreported;
+    const auto region = *reductions.last_region;
+    const auto max_haplotypes = reductions.last_max_haplotypes;
+    reductions.num_unreported = 0;
+    reductions.last_report = std::chrono::steady_clock::now();
+    lock.unlock();
+    log_budget_reductions(num_reduced, region, max_haplotypes);
+}
+
+} // namespace coretools
+} // namespace octopus
@@ -0,0 +1,72 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef haplotype_cost_model_hpp
+#define haplotype_cost_model_hpp
+
+#include <cstddef>
+#include <chrono>
+
+#include "basics/genomic_region.hpp"
+
+namespace octopus { namespace coretools {
+
+/**
+ HaplotypeCostModel predicts the time taken to call an active region. The work in a region is
+ modelled as reads x haplotypes x haplotype length x ploidy, and the time per unit of work is
+ measured on the running machine by timing the pair-HMM (see calibrate_haplotype_cost).
+
+ The model is used to shrink haplotype limits in regions that are predicted to exceed the
+ per-region time budget.
+ */
+class HaplotypeCostModel
+{
+public:
+    using Seconds = std::chrono::duration<double>;
+
+    HaplotypeCostModel() = delete;
+
+    HaplotypeCostModel(Seconds region_budget, unsigned ploidy, Seconds unit_cost);
+
+    HaplotypeCostModel(const HaplotypeCostModel&)            = default;
+    HaplotypeCostModel& operator=(const HaplotypeCostModel&) = default;
+    HaplotypeCostModel(HaplotypeCostModel&&)                 = default;
+    HaplotypeCostModel& operator=(HaplotypeCostModel&&)      = default;
+
+    ~HaplotypeCostModel() = default;
+
+    Seconds region_budget() const noexcept;
+    Seconds unit_cost() const noexcept;
+
+    Seconds predict(std::size_t num_reads, std::size_t num_haplotypes,
+                    GenomicRegion::Size haplotype_length) const noexcept;
+
+    // The largest number of haplotypes that is predicted to be callable within the region budget
+    std::size_t max_haplotypes(std::size_t num_reads, GenomicRegion::Size haplotype_length) const noexcept;
+
+private:
+    Seconds region_budget_, unit_cost_;
+    unsigned ploidy_;
+};
+
+// Times the pair-HMM on synthetic reads to estimate the cost of one read-haplotype base
+HaplotypeCostModel::Seconds calibrate_haplotype_cost();
+
+HaplotypeCostModel make_calibrated_cost_model(HaplotypeCostModel::Seconds region_budget, unsigned ploidy);
+
+// Warns that the region budget reduced a haplotype limit to max_haplotypes in region. Reductions can
+// happen in many regions and threads, so they are reported together at most once per interval, and
+// report_pending_budget_reductions reports any left over at the end of a run.
+void report_budget_reduction(const GenomicRegion& region, unsigned max_haplotypes);
+void report_pending_budget_reductions();
+
+} // namespace coretools
+
+using coretools::HaplotypeCostModel;
+using coretools::make_calibrated_cost_model;
+using coretools::report_budget_reduction;
+using coretools::report_pending_budget_reductions;
+
+} // namespace octopus
+
+#endif
@@ -108,6 +108,24 @@ auto decompose(const MappableFlatSet<Variant>& variants)
     };
 }
 
+auto make_default_walker(const HaplotypeGenerator::Policies& policies)
+{
+    return GenomeWalker {
+        max_included(policies.haplotype_limits.target),
+        GenomeWalker::IndicatorPolicy::includeNone,
+        get_walker_policy(policies.extension)
+    };
+}
+
+auto make_holdout_walker(const HaplotypeGenerator::Policies& policies)
+{
+    return GenomeWalker {
+        max_included(policies.haplotype_limits.target),
+        GenomeWalker::IndicatorPolicy::includeAll,
+        get_walker_policy(policies.extension)
+    };
+}
+
 auto make_lagged_walker(const HaplotypeGenerator::Policies& policies)
 {
     return GenomeWalker {
@@ -133,17 +151,10 @@ HaplotypeGenerator::HaplotypeGenerator(const ReferenceGenome& reference,
                                        Policies policies,
                                        DenseVariationDetector dense_variation_detector)
 : policies_ {std::move(policies)}
+, base_limits_ {policies_.haplotype_limits}
 , tree_ {get_contig(candidates), reference}
-, default_walker_ {
-    max_included(policies_.haplotype_limits.target),
-    GenomeWalker::IndicatorPolicy::includeNone,
-    get_walker_policy(policies.extension)
-}
-, holdout_walker_ {
-    max_included(policies_.haplotype_limits.target),
-    GenomeWalker::IndicatorPolicy::includeAll,
-    get_walker_policy(policies.extension)
-  }
+, default_walker_ {make_default_walker(policies_)}
+, holdout_walker_ {make_holdout_walker(policies_)}
 , lagged_walker_ {}
 , alleles_ {decompose(candidates)}
 , reads_ {reads}
@@ -221,6 +232,7 @@ HaplotypeGenerator::HaplotypePacket HaplotypeGenerator::generate()
     if (alleles_.empty()) {
         return std::make_tuple(std::vector<Haplotype> {}, boost::none, boost::none);
     }
+    if (policies_.cost_model && !in_holdout_mode()) budget_haplotype_limits();
     populate_tree();
     const auto haplotype_region = calculate_haplotype_region();
     assert(contains(haplotype_region, active_region_));
@@ -309,6 +321,50 @@ void HaplotypeGenerator::reset_next_active_region() const noexcept
     next_active_region_ = boost::none;
 }
 
+namespace {
+
+constexpr unsigned minBudgetedHaplotypes {2};
+
+} // namespace
+
+void HaplotypeGenerator::budget_haplotype_limits()
+{
+    if (policies_.haplotype_limits.target != base_limits_.target) {
+        policies_.haplotype_limits = base_limits_;
+        update_walker_limits();
+    }
+    // The unlagged next active region is a cheap proxy for the region about to be generated
+    const auto probe_region = default_walker_.walk(active_region_, reads_, alleles_);
+    const auto num_reads = count_overlapped(reads_.get(), probe_region);
+    if (num_reads == 0) return;
+    const auto read_region = closed_region(*leftmost_overlapped(reads_.get(), probe_region),
+                                           *rightmost_overlapped(reads_.get(), probe_region));
+    const auto haplotype_length = size(encompassing_region(read_region, probe_region)) + 2 * policies_.min_flank_pad;
+    const auto max_haplotypes = policies_.cost_model->max_haplotypes(num_reads, haplotype_length);
+    if (max_haplotypes >= base_limits_.target) return;
+    auto& limits = policies_.haplotype_limits;
+    limits.target = std::max(static_cast<unsigned>(max_haplotypes), minBudgetedHaplotypes);
+    // Keep the holdout limit in proportion so holdouts are tried before the region overflows
+    const auto holdout_scale = static_cast<double>(base_limits_.holdout) / base_limits_.target;
+    limits.holdout = std::max(static_cast<unsigned>(limits.target * holdout_scale), limits.target + 1);
+    update_walker_limits();
+    if (debug_log_) {
+        stream(*debug_log_) << "Region time budget reduced haplotype limits in " << probe_region
+                            << " (" << num_reads << " reads, haplotype length " << haplotype_length
+                            << ") to target " << limits.target << " and holdout " << limits.holdout;
+    }
+    report_budget_reduction(probe_region, limits.target);
+}
+
+// The walkers limit how many alleles a region includes by the target haplotype limit, so they must
+// follow it or the tree overflows the budgeted limits
+void HaplotypeGenerator::update_walker_limits()
+{
+    default_walker_ = make_default_walker(policies_);
+    holdout_walker_ = make_holdout_walker(policies_);
+    if (is_lagging_enabled()) lagged_walker_ = make_lagged_walker(policies_);
+}
+
 void HaplotypeGenerator::update_next_active_region() const
 {
     if (!next_active_region_) {
@@ -1359,6 +1415,12 @@ HaplotypeGenerator::Builder& HaplotypeGenerator::Builder::set_dense_variation_de
     return *this;
 }
 
+HaplotypeGenerator::Builder& HaplotypeGenerator::Builder::set_cost_model(HaplotypeCostModel model) noexcept
+{
+    policies_.cost_model = std::move(model);
+    return *this;
+}
+
 HaplotypeGenerator HaplotypeGenerator::Builder::build(const ReferenceGenome& reference,
                                                       const MappableFlatSet<Variant>& candidates,
                                                       const ReadMap& reads,
@@ -23,6 +23,7 @@
 #include "genome_walker.hpp"
 #include "haplotype_tree.hpp"
 #include "dense_variation_detector.hpp"
+#include "haplotype_cost_model.hpp"
 
 namespace octopus {
 
@@ -47,6 +48,7 @@ public:
         Haplotype::MappingDomain::Size min_flank_pad = 30;
         boost::optional<Haplotype::NucleotideSequence::size_type> max_indicator_join_distance = boost::none;
         boost::optional<double> max_expected_log_allele_count_per_base = boost::none;
+        boost::optional<HaplotypeCostModel> cost_model = boost::none;
     };
     
     class HaplotypeOverflow;
@@ -119,6 +121,7 @@ private:
     };
     
     Policies policies_;
+    Policies::HaplotypeLimits base_limits_;
     
     HaplotypeTree tree_;
     GenomeWalker default_walker_, holdout_walker_;
@@ -145,6 +148,8 @@ private:
     bool is_lagging_enabled(const GenomicRegion& region) const;
     bool is_active_region_lagged() const;
     void reset_next_active_region() const noexcept;
+    void budget_haplotype_limits();
+    void update_walker_limits();
     GenomicRegion find_max_lagged_region() const;
     void update_next_active_region() const;
     void update_lagged_next_active_region() const;
@@ -234,6 +239,7 @@ public:
     Builder& set_max_indicator_join_distance(Haplotype::NucleotideSequence::size_type n) noexcept;
     Builder& set_max_expected_log_allele_count_per_base(double v) noexcept;
     Builder& set_dense_variation_detector(DenseVariationDetector detector) noexcept;
+    Builder& set_cost_model(HaplotypeCostModel model) noexcept;
     
     HaplotypeGenerator build(const ReferenceGenome& reference,
                              const MappableFlatSet<Variant>& candidates,
@@ -4,26 +4,25 @@
 #include "haplotype_tree.hpp"
 
 #include <deque>
-#include <stack>
 #include <stdexcept>
 #include <cassert>
-#include <iostream>
-
-#include <boost/property_map/property_map.hpp>
-#include <boost/graph/breadth_first_search.hpp>
-#include <boost/graph/depth_first_search.hpp>
-#include <boost/graph/visitors.hpp>
-#include <boost/graph/copy.hpp>
 
 #include "io/reference/reference_genome.hpp"
 #include "utils/mappable_algorithms.hpp"
 
 namespace octopus { namespace coretools {
 
+constexpr HaplotypeTree::Vertex HaplotypeTree::root_;
+constexpr HaplotypeTree::Vertex HaplotypeTree::null_vertex_;
+
 HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference)
 : reference_ {reference}
-, tree_ {}
-, root_ {boost::add_vertex(tree_)}
+, nodes_ {Node {0, null_vertex_, null_vertex_, null_vertex_, 0, 0}}
+, free_vertices_ {}
+, alleles_ {}
+, allele_counts_ {}
+, free_alleles_ {}
+, allele_ids_ {}
 , haplotype_leafs_ {root_}
 , contig_ {contig}
 , haplotype_leaf_cache_ {}
@@ -35,78 +34,6 @@ HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const Refe
     }
 }
 
-namespace debug {
-
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs);
-
-} // namespace debug
-
-namespace {
-
-template <typename Graph>
-bool is_empty(const Graph& g)
-{
-    return boost::num_vertices(g) == 0 && boost::num_edges(g) == 0;
-}
-
-template <typename Graph>
-auto copy_graph(const Graph& src, Graph& dst)
-{
-    assert(is_empty(dst));
-    using Vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
-    std::unordered_map<Vertex, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(src));
-    const auto p = boost::vertices(src);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const Vertex& v) { index_map.emplace(v, i++); });
-    std::unordered_map<Vertex, Vertex> vertex_copy_map {};
-    vertex_copy_map.reserve(boost::num_vertices(src));
-    boost::copy_graph(src, dst,
-                      boost::vertex_index_map(boost::make_assoc_property_map(index_map))
-                      .orig_to_copy(boost::make_assoc_property_map(vertex_copy_map)));
-    assert(vertex_copy_map.size() == boost::num_vertices(src));
-    return vertex_copy_map;
-}
-
-template <typename Container, typename Map>
-void copy_leafs(const Container& src, Container& dst, const Map& vertex_copy_map)
-{
-    assert(dst.empty());
-    std::transform(std::cbegin(src), std::cend(src), std::back_inserter(dst),
-                   [&vertex_copy_map] (const auto& v) { return vertex_copy_map.at(v); });
-}
-
-} // namespace
-
-HaplotypeTree::HaplotypeTree(const HaplotypeTree& other)
-: reference_ {other.reference_}
-, tree_ {}
-, root_ {}
-, haplotype_leafs_ {}
-, contig_ {other.contig_}
-, haplotype_leaf_cache_ {}
-{
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-}
-
-HaplotypeTree& HaplotypeTree::operator=(const HaplotypeTree& other)
-{
-    if (&other == this) return *this;
-    tree_.clear();
-    haplotype_leafs_.clear();
-    haplotype_leaf_cache_.clear();
-    reference_ = other.reference_;
-    contig_    = other.contig_;
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-    assert(debug::is_tree(tree_, root_, haplotype_leafs_));
-    return *this;
-}
-
 bool HaplotypeTree::is_empty() const noexcept
 {
     return haplotype_leafs_.front() == root_;
@@ -143,7 +70,7 @@ bool HaplotypeTree::is_unique(const Haplotype& haplotype) const
         return haplotype_leaf_cache_.count(haplotype) == 1;
     }
     bool haplotype_seen {false};
-    for (const Vertex& leaf : haplotype_leafs_) {
+    for (const Vertex leaf : haplotype_leafs_) {
         if (is_branch_equal_haplotype(leaf, haplotype)) {
             if (haplotype_seen) {
                 return false;
@@ -157,9 +84,14 @@ bool HaplotypeTree::is_unique(const Haplotype& haplotype) const
 
 HaplotypeTree& HaplotypeTree::extend(const ContigAllele& allele)
 {
-    for (auto it = std::cbegin(haplotype_leafs_), end = std::cend(haplotype_leafs_); it != end; ++it) {
-        it = extend_haplotype(it, allele);
+    const auto allele_id = intern(allele);
+    std::vector<Vertex> new_leafs {};
+    new_leafs.reserve(2 * haplotype_leafs_.size());
+    for (const auto leaf : haplotype_leafs_) {
+        extend_haplotype(leaf, allele_id, new_leafs);
     }
+    haplotype_leafs_ = std::move(new_leafs);
+    release_if_unused(allele_id);
     haplotype_leaf_cache_.clear();
     tree_region_ = boost::none;
     return *this;
@@ -173,53 +105,14 @@ HaplotypeTree& HaplotypeTree::extend(const Allele& allele)
     return extend(demote(allele));
 }
 
-template <typename Container, typename V>
-struct Splicer : public boost::default_dfs_visitor
-{
-    Splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites, Container& splice_sites,
-            V root)
-    : allele_ {allele}
-    , candidate_splice_sites_ {candidate_splice_sites}
-    , splice_sites_ {splice_sites}
-    , root_ {root}
-    {}
-    
-    template <typename G>
-    void finish_vertex(const V v, const G& tree)
-    {
-        if (!candidate_splice_sites_.empty() && v == candidate_splice_sites_.top()) {
-            candidate_splice_sites_.pop();
-            if (v == root_ || is_after(allele_.get(), tree[v])) {
-                splice_sites_.push_back(v);
-            } else {
-                const auto u = *boost::inv_adjacent_vertices(v, tree).first;
-                if (candidate_splice_sites_.empty() || candidate_splice_sites_.top() != u) {
-                    candidate_splice_sites_.push(u);
-                }
-            }
-        }
-    }
-private:
-    std::reference_wrapper<const ContigAllele> allele_;
-    std::stack<V>& candidate_splice_sites_;
-    Container& splice_sites_;
-    V root_;
-};
-
-template <typename Container, typename V>
-auto make_splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites,
-                  Container& splice_sites, V root)
-{
-    return Splicer<Container, V> {allele, candidate_splice_sites, splice_sites, root};
-}
+namespace {
 
-template <typename V, typename G>
-bool is_possible_splice_site(const ContigAllele& allele, const V& v, const G& tree)
+bool is_possible_splice_site(const ContigAllele& allele, const ContigAllele& v_allele, const bool v_is_leaf)
 {
     // Can allele go before v in the tree?
-    return begins_before(allele, tree[v])
-           || (boost::out_degree(v, tree) == 0 && overlaps(allele, tree[v]))
-           || (begins_equal(allele, tree[v]) && (!is_empty_region(tree[v]) || (is_insertion(tree[v]) && is_deletion(allele))));
+    return begins_before(allele, v_allele)
+           || (v_is_leaf && overlaps(allele, v_allele))
+           || (begins_equal(allele, v_allele) && (!is_empty_region(v_allele) || (is_insertion(v_allele) && is_deletion(allele))));
 }
 
 bool is_deletion_and_insertion(const ContigAllele& new_allele, const ContigAllele& leaf)
@@ -232,42 +125,23 @@ bool can_add_to_branch(const ContigAllele& new_allele, const ContigAllele& leaf)
     return !are_adjacent(leaf, new_allele) || !is_deletion_and_insertion(new_allele, leaf);
 }
 
+} // namespace
+
 void HaplotypeTree::splice(const ContigAllele& allele)
 {
     if (is_empty()) {
         extend(allele);
         return;
     }
-    std::unordered_map<Vertex, boost::default_color_type> colours {};
-    colours.reserve(boost::num_vertices(tree_));
-    std::deque<Vertex> splice_sites {};
-    std::stack<Vertex> candidate_splice_sites {};
-    boost::depth_first_visit(tree_, root_,
-                             make_splicer(allele, candidate_splice_sites, splice_sites, root_),
-                             boost::make_assoc_property_map(colours),
-                             [&] (const Vertex v, const Tree& tree) -> bool {
-                                 if (v != root_) {
-                                     if (is_possible_splice_site(allele, v, tree_)) {
-                                         const auto p = boost::inv_adjacent_vertices(v, tree);
-                                         if (p.first != p.second) {
-                                             const auto u = *p.first;
-                                             if (candidate_splice_sites.empty() || candidate_splice_sites.top() != u) {
-                                                 candidate_splice_sites.push(u);
-                                             }
-                                         }
-                                         return true;
-                                     }
-                                 }
-                                 return false;
-                             });
-    assert(candidate_splice_sites.empty());
-    for (const auto v : splice_sites) {
-        if (can_add_to_branch(allele, tree_[v])) {
-            const auto spliced = boost::add_vertex(allele, tree_);
-            boost::add_edge(v, spliced, tree_);
-            haplotype_leafs_.push_back(spliced);
+    std::vector<Vertex> sites {};
+    splice_sites(allele, sites);
+    const auto allele_id = intern(allele);
+    for (const auto v : sites) {
+        if (v == root_ || can_add_to_branch(allele, this->allele(v))) {
+            haplotype_leafs_.push_back(add_vertex(allele_id, v));
         }
     }
+    release_if_unused(allele_id);
     tree_region_ = boost::none;
 }
 
@@ -285,16 +159,15 @@ GenomicRegion HaplotypeTree::encompassing_region() const
     if (is_empty()) {
         throw std::runtime_error {"HaplotypeTree::encompassing_region called on empty tree"};
     }
-    const auto p = boost::adjacent_vertices(root_, tree_);
-    const auto leftmost = *std::min_element(p.first, p.second,
-                                            [this] (const auto& lhs, const auto& rhs) {
-                                                return begins_before(tree_[lhs], tree_[rhs]);
-                                            });
+    auto leftmost = nodes_[root_].first_child;
+    for (auto v = nodes_[leftmost].next_sibling; v != null_vertex_; v = nodes_[v].next_sibling) {
+        if (begins_before(allele(v), allele(leftmost))) leftmost = v;
+    }
     const auto rightmost = *std::max_element(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
                                              [this] (const auto& lhs, const auto& rhs) {
-                                                 return ends_before(tree_[lhs], tree_[rhs]);
+                                                 return ends_before(allele(lhs), allele(rhs));
                                              });
-    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(tree_[leftmost], tree_[rightmost])};
+    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(allele(leftmost), allele(rightmost))};
     return *tree_region_;
 }
 
@@ -314,8 +187,9 @@ std::vector<Haplotype> HaplotypeTree::extract_haplotypes(const GenomicRegion& re
     std::vector<Haplotype> result {};
     if (is_empty() || !overlaps(region, encompassing_region())) return result;
     result.reserve(num_haplotypes());
+    BranchPath path {};
     for (const auto leaf : haplotype_leafs_) {
-        auto haplotype = extract_haplotype(leaf, region);
+        auto haplotype = extract_haplotype(leaf, region, path);
         // recently retreived haplotypes are added to the cache as it is likely these
         // are the haplotypes that will be pruned next
         haplotype_leaf_cache_.emplace(haplotype, leaf);
@@ -344,41 +218,30 @@ std::vector<HaplotypeTree::HaplotypeLength> HaplotypeTree::extract_haplotype_len
 
 void HaplotypeTree::prune_all(const Haplotype& haplotype)
 {
-    using std::cbegin; using std::cend; using std::for_each; using std::find;
     if (is_empty() || contig_name(haplotype) != contig_) return;
+    tree_region_ = boost::none;
     // If any of the haplotypes in cache match the query haplotype then the cache must contain
     // all possible leaves corrosponding to that haplotype. So we don't need to look through
     // the list of all leaves. Win.
-    tree_region_ = boost::none;
     if (haplotype_leaf_cache_.count(haplotype) > 0) {
         const auto possible_leafs = haplotype_leaf_cache_.equal_range(haplotype);
-        for_each(possible_leafs.first, possible_leafs.second,
-                 [this, &haplotype] (const HaplotypeVertexMultiMap::value_type& leaf_pair) {
-                     const auto p = clear(leaf_pair.second, contig_region(haplotype));
-                     auto leaf_itr = find(cbegin(haplotype_leafs_), cend(haplotype_leafs_), leaf_pair.second);
-                     leaf_itr = haplotype_leafs_.erase(leaf_itr);
-                     if (p.second) {
-                         haplotype_leafs_.insert(leaf_itr, p.first);
-                     }
-                 });
+        std::vector<Vertex> leafs_to_clear {};
+        std::transform(possible_leafs.first, possible_leafs.second, std::back_inserter(leafs_to_clear),
+                       [] (const HaplotypeVertexMultiMap::value_type& leaf_pair) { return leaf_pair.second; });
+        std::sort(std::begin(leafs_to_clear), std::end(leafs_to_clear));
         haplotype_leaf_cache_.erase(haplotype);
+        clear_leafs_if(contig_region(haplotype), [&leafs_to_clear] (const Vertex leaf) {
+            return std::binary_search(std::cbegin(leafs_to_clear), std::cend(leafs_to_clear), leaf);
+        });
     } else {
-        auto leaf_itr = cbegin(haplotype_leafs_);
-        while (true) {
-            leaf_itr = find_equal_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
-            if (leaf_itr == cend(haplotype_leafs_)) return;
-            const auto p = clear(*leaf_itr, contig_region(haplotype));
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
-            if (p.second) {
-                leaf_itr = haplotype_leafs_.insert(leaf_itr, p.first);
-            }
-        }
+        clear_leafs_if(contig_region(haplotype), [this, &haplotype] (const Vertex leaf) {
+            return is_branch_equal_haplotype(leaf, haplotype);
+        });
     }
 }
 
 void HaplotypeTree::prune_unique(const Haplotype& haplotype)
 {
-    using std::cbegin; using std::cend; using std::for_each;
     if (is_empty()) return;
     tree_region_ = boost::none;
     if (haplotype_leaf_cache_.count(haplotype) > 0) {
@@ -390,34 +253,27 @@ void HaplotypeTree::prune_unique(const Haplotype& haplotype)
         if (match_itr == possible_leafs.second) {
             throw std::runtime_error {"HaplotypeTree::prune_unique called with matching Haplotype not in tree"};
         }
-        const auto leaf_to_keep_itr = match_itr->second;
+        const auto leaf_to_keep = match_itr->second;
+        std::vector<Vertex> leafs_to_clear {};
         std::for_each(possible_leafs.first, possible_leafs.second,
-                      [this, &haplotype, leaf_to_keep_itr] (HaplotypeVertexMultiMap::value_type& leaf_pair) {
-                          if (leaf_pair.second != leaf_to_keep_itr) {
-                              const auto p = clear(leaf_pair.second, contig_region(haplotype));
-                              auto leaf_itr = std::find(cbegin(haplotype_leafs_), cend(haplotype_leafs_), leaf_pair.second);
-                              leaf_itr = haplotype_leafs_.erase(leaf_itr);
-                              if (p.second) haplotype_leafs_.insert(leaf_itr, p.first);
-                          }
+                      [&leafs_to_clear, leaf_to_keep] (const HaplotypeVertexMultiMap::value_type& leaf_pair) {
+                          if (leaf_pair.second != leaf_to_keep) leafs_to_clear.push_back(leaf_pair.second);
                       });
+        std::sort(std::begin(leafs_to_clear), std::end(leafs_to_clear));
         haplotype_leaf_cache_.erase(haplotype);
-        haplotype_leaf_cache_.emplace(haplotype, leaf_to_keep_itr);
+        haplotype_leaf_cache_.emplace(haplotype, leaf_to_keep);
+        clear_leafs_if(contig_region(haplotype), [&leafs_to_clear] (const Vertex leaf) {
+            return std::binary_search(std::cbegin(leafs_to_clear), std::cend(leafs_to_clear), leaf);
+        });
     } else {
-        auto leaf_itr = cbegin(haplotype_leafs_);
-        const auto leaf_to_keep_itr = find_exact_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
-        while (true) {
-            leaf_itr = find_equal_haplotype_leaf(leaf_itr, cend(haplotype_leafs_), haplotype);
-            if (leaf_itr == cend(haplotype_leafs_)) {
-                return;
-            }
-            if (leaf_itr == leaf_to_keep_itr) {
-                std::advance(leaf_itr, 1);
-                continue;
-            }
-            const auto p = clear(*leaf_itr, contig_region(haplotype));
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
-            if (p.second) leaf_itr = haplotype_leafs_.insert(leaf_itr, p.first);
-        }
+        const auto leaf_to_keep_itr = std::find_if(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
+                                                   [this, &haplotype] (const Vertex leaf) {
+                                                       return is_branch_exact_haplotype(leaf, haplotype);
+                                                   });
+        const auto leaf_to_keep = leaf_to_keep_itr != std::cend(haplotype_leafs_) ? *leaf_to_keep_itr : null_vertex_;
+        clear_leafs_if(contig_region(haplotype), [this, &haplotype, leaf_to_keep] (const Vertex leaf) {
+            return leaf != leaf_to_keep && is_branch_equal_haplotype(leaf, haplotype);
+        });
     }
 }
 
@@ -429,12 +285,7 @@ void HaplotypeTree::clear(const GenomicRegion& region)
         clear();
     } else if (overlaps(region, tree_region)) {
         haplotype_leaf_cache_.clear();
-        std::list<Vertex> new_leafs {};
-        for (const Vertex leaf : haplotype_leafs_) {
-            const auto p = clear(leaf, contig_region(region));
-            if (p.second) new_leafs.push_back(p.first);
-        }
-        haplotype_leafs_ = new_leafs;
+        clear_leafs_if(contig_region(region), [] (Vertex) { return true; });
         tree_region_ = boost::none;
     }
 }
@@ -442,58 +293,174 @@ void HaplotypeTree::clear(const GenomicRegion& region)
 void HaplotypeTree::clear() noexcept
 {
     haplotype_leaf_cache_.clear();
-    haplotype_leafs_.clear();
-    tree_.clear();
-    root_ = boost::add_vertex(tree_);
-    haplotype_leafs_.push_back(root_);
+    nodes_.resize(1);
+    nodes_.front() = Node {0, null_vertex_, null_vertex_, null_vertex_, 0, 0};
+    free_vertices_.clear();
+    alleles_.clear();
+    allele_counts_.clear();
+    free_alleles_.clear();
+    allele_ids_.clear();
+    haplotype_leafs_.assign(1, root_);
     tree_region_ = boost::none;
 }
 
 // Private methods
 
-HaplotypeTree::Vertex HaplotypeTree::get_previous_allele(const Vertex allele) const
+const ContigAllele& HaplotypeTree::allele(const Vertex v) const noexcept
 {
-    const auto p = boost::inv_adjacent_vertices(allele, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    return *p.first;
+    assert(v != root_);
+    return alleles_[nodes_[v].allele];
 }
 
-bool HaplotypeTree::is_bifurcating(const Vertex v) const
+HaplotypeTree::AlleleId HaplotypeTree::intern(const ContigAllele& allele)
 {
-    return boost::out_degree(v, tree_) > 1;
+    const auto itr = allele_ids_.find(allele);
+    if (itr != std::cend(allele_ids_)) return itr->second;
+    AlleleId result;
+    if (free_alleles_.empty()) {
+        result = static_cast<AlleleId>(alleles_.size());
+        alleles_.push_back(allele);
+        allele_counts_.push_back(0);
+    } else {
+        result = free_alleles_.back();
+        free_alleles_.pop_back();
+        alleles_[result] = allele;
+    }
+    allele_ids_.emplace(allele, result);
+    return result;
 }
 
-HaplotypeTree::Vertex HaplotypeTree::remove_forward(const Vertex u)
+void HaplotypeTree::release_if_unused(const AlleleId allele) noexcept
 {
-    const auto p = boost::adjacent_vertices(u, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    const auto v = *p.first;
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(u, tree_);
+    if (allele_counts_[allele] == 0) {
+        allele_ids_.erase(alleles_[allele]);
+        free_alleles_.push_back(allele);
+    }
+}
+
+std::size_t HaplotypeTree::num_vertices() const noexcept
+{
+    return nodes_.size() - free_vertices_.size();
+}
+
+HaplotypeTree::Vertex HaplotypeTree::add_vertex(const AlleleId allele)
+{
+    const Node node {allele, null_vertex_, null_vertex_, null_vertex_, 0, 0};
+    Vertex result;
+    if (free_vertices_.empty()) {
+        result = static_cast<Vertex>(nodes_.size());
+        nodes_.push_back(node);
+    } else {
+        result = free_vertices_.back();
+        free_vertices_.pop_back();
+        nodes_[result] = node;
+    }
+    ++allele_counts_[allele];
+    return result;
+}
+
+HaplotypeTree::Vertex HaplotypeTree::add_vertex(const AlleleId allele, const Vertex parent)
+{
+    const auto result = add_vertex(allele);
+    add_edge(parent, result);
+    nodes_[result].depth = nodes_[parent].depth + 1;
+    return result;
+}
+
+void HaplotypeTree::add_edge(const Vertex parent, const Vertex child) noexcept
+{
+    assert(nodes_[child].parent == null_vertex_);
+    nodes_[child].parent = parent;
+    nodes_[child].next_sibling = null_vertex_;
+    // Children are kept in insertion order
+    auto& parent_node = nodes_[parent];
+    if (parent_node.first_child == null_vertex_) {
+        parent_node.first_child = child;
+    } else {
+        auto v = parent_node.first_child;
+        while (nodes_[v].next_sibling != null_vertex_) v = nodes_[v].next_sibling;
+        nodes_[v].next_sibling = child;
+    }
+    ++parent_node.num_children;
+}
+
+void HaplotypeTree::remove_edge(const Vertex child) noexcept
+{
+    auto& parent_node = nodes_[nodes_[child].parent];
+    if (parent_node.first_child == child) {
+        parent_node.first_child = nodes_[child].next_sibling;
+    } else {
+        auto v = parent_node.first_child;
+        while (nodes_[v].next_sibling != child) v = nodes_[v].next_sibling;
+        nodes_[v].next_sibling = nodes_[child].next_sibling;
+    }
+    --parent_node.num_children;
+    nodes_[child].parent = null_vertex_;
+    nodes_[child].next_sibling = null_vertex_;
+}
+
+void HaplotypeTree::remove_vertex(const Vertex v) noexcept
+{
+    assert(v != root_ && nodes_[v].parent == null_vertex_ && nodes_[v].num_children == 0);
+    const auto allele = nodes_[v].allele;
+    --allele_counts_[allele];
+    release_if_unused(allele);
+    free_vertices_.push_back(v);
+}
+
+void HaplotypeTree::update_depths(const Vertex v) noexcept
+{
+    std::deque<Vertex> stale {v};
+    while (!stale.empty()) {
+        const auto u = stale.front();
+        stale.pop_front();
+        nodes_[u].depth = nodes_[nodes_[u].parent].depth + 1;
+        for (auto child = nodes_[u].first_child; child != null_vertex_; child = nodes_[child].next_sibling) {
+            stale.push_back(child);
+        }
+    }
+}
+
+HaplotypeTree::Vertex HaplotypeTree::get_previous_allele(const Vertex allele) const noexcept
+{
+    assert(nodes_[allele].parent != null_vertex_);
+    return nodes_[allele].parent;
+}
+
+bool HaplotypeTree::is_bifurcating(const Vertex v) const noexcept
+{
+    return nodes_[v].num_children > 1;
+}
+
+HaplotypeTree::Vertex HaplotypeTree::remove_forward(const Vertex u) noexcept
+{
+    assert(nodes_[u].num_children == 1);
+    const auto v = nodes_[u].first_child;
+    remove_edge(v);
+    remove_vertex(u);
     return v;
 }
 
-HaplotypeTree::Vertex HaplotypeTree::remove_backward(const Vertex v)
+HaplotypeTree::Vertex HaplotypeTree::remove_backward(const Vertex v) noexcept
 {
     const auto u = get_previous_allele(v);
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(v, tree_);
+    remove_edge(v);
+    remove_vertex(v);
     return u;
 }
 
-bool HaplotypeTree::allele_exists(Vertex leaf, const ContigAllele& allele) const
+bool HaplotypeTree::allele_exists(const Vertex leaf, const AlleleId allele) const noexcept
 {
-    const auto vertex_range = boost::adjacent_vertices(leaf, tree_);
-    return std::any_of(vertex_range.first, vertex_range.second,
-                       [this, &allele] (const Vertex vertex) {
-                           return tree_[vertex] == allele;
-                       });
+    for (auto v = nodes_[leaf].first_child; v != null_vertex_; v = nodes_[v].next_sibling) {
+        if (nodes_[v].allele == allele) return true;
+    }
+    return false;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAllele& allele) const
 {
-    while (v != root_ && overlaps(allele, tree_[v])) {
-        if (is_same_region(allele, tree_[v])) { // for insertions
+    while (v != root_ && overlaps(allele, this->allele(v))) {
+        if (is_same_region(allele, this->allele(v))) { // for insertions
             v = get_previous_allele(v);
             break;
         }
@@ -502,96 +469,168 @@ HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAl
     return v;
 }
 
-HaplotypeTree::LeafIterator
-HaplotypeTree::extend_haplotype(LeafIterator leaf_itr, const ContigAllele& new_allele)
+void HaplotypeTree::extend_haplotype(const Vertex leaf, const AlleleId new_allele_id, std::vector<Vertex>& new_leafs)
 {
-    if (*leaf_itr == root_) {
-        const auto new_leaf = boost::add_vertex(new_allele, tree_);
-        boost::add_edge(*leaf_itr, new_leaf, tree_);
-        leaf_itr = haplotype_leafs_.erase(leaf_itr);
-        return haplotype_leafs_.insert(leaf_itr, new_leaf);
+    if (leaf == root_) {
+        new_leafs.push_back(add_vertex(new_allele_id, root_));
+        return;
     }
-    const auto& leaf_allele = tree_[*leaf_itr];
+    const auto& new_allele = alleles_[new_allele_id];
+    const auto& leaf_allele = allele(leaf);
     if (can_add_to_branch(new_allele, leaf_allele)) {
         if (is_after(new_allele, leaf_allele)) {
-            const auto new_leaf = boost::add_vertex(new_allele, tree_);
-            boost::add_edge(*leaf_itr, new_leaf, tree_);
-            leaf_itr = haplotype_leafs_.erase(leaf_itr);
-            leaf_itr = haplotype_leafs_.insert(leaf_itr, new_leaf);
-        } else if (overlaps(new_allele, tree_[*leaf_itr])) {
-            const auto branch_point = find_allele_before(*leaf_itr, new_allele);
-            if ((branch_point == root_ || can_add_to_branch(new_allele, tree_[branch_point]))
-                && !allele_exists(branch_point, new_allele)) {
-                const auto new_leaf = boost::add_vertex(new_allele, tree_);
-                boost::add_edge(branch_point, new_leaf, tree_);
-                haplotype_leafs_.insert(leaf_itr, new_leaf);
+            new_leafs.push_back(add_vertex(new_allele_id, leaf));
+            return;
+        } else if (overlaps(new_allele, leaf_allele)) {
+            const auto branch_point = find_allele_before(leaf, new_allele);
+            if ((branch_point == root_ || can_add_to_branch(new_allele, allele(branch_point)))
+                && !allele_exists(branch_point, new_allele_id)) {
+                new_leafs.push_back(add_vertex(new_allele_id, branch_point));
             }
         }
     }
-    return leaf_itr;
+    new_leafs.push_back(leaf);
 }
 
-Haplotype HaplotypeTree::extract_haplotype(Vertex leaf, const GenomicRegion& region) const
+void HaplotypeTree::splice_sites(const ContigAllele& allele, std::vector<Vertex>& result) const
 {
+    // Depth first search that does not descend past vertices the allele could go before. Each
+    // such vertex makes its parent a candidate site, which is moved up the branch until the
+    // allele can follow it.
+    std::vector<Vertex> candidate_splice_sites {};
+    const auto finish_vertex = [&] (const Vertex v) {
+        if (!candidate_splice_sites.empty() && v == candidate_splice_sites.back()) {
+            candidate_splice_sites.pop_back();
+            if (v == root_ || is_after(allele, this->allele(v))) {
+                result.push_back(v);
+            } else {
+                const auto u = get_previous_allele(v);
+                if (candidate_splice_sites.empty() || candidate_splice_sites.back() != u) {
+                    candidate_splice_sites.push_back(u);
+                }
+            }
+        }
+    };
+    // Each entry is a vertex and the next child to visit
+    std::vector<std::pair<Vertex, Vertex>> stack {{root_, nodes_[root_].first_child}};
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second == null_vertex_) {
+            const auto v = top.first;
+            stack.pop_back();
+            finish_vertex(v);
+            continue;
+        }
+        const auto v = top.second;
+        top.second = nodes_[v].next_sibling;
+        if (is_possible_splice_site(allele, this->allele(v), nodes_[v].num_children == 0)) {
+            const auto u = get_previous_allele(v);
+            if (candidate_splice_sites.empty() || candidate_splice_sites.back() != u) {
+                candidate_splice_sites.push_back(u);
+            }
+            finish_vertex(v);
+        } else {
+            stack.emplace_back(v, nodes_[v].first_child);
+        }
+    }
+    assert(candidate_splice_sites.empty());
+}
+
+void HaplotypeTree::update_path(const Vertex leaf, BranchPath& path) const
+{
+    // path[d - 1] is the vertex at depth d. If a vertex is already in the path then so are its ancestors.
+    path.resize(nodes_[leaf].depth, root_);
+    for (auto v = leaf; v != root_; v = get_previous_allele(v)) {
+        auto& entry = path[nodes_[v].depth - 1];
+        if (entry == v) break;
+        entry = v;
+    }
+}
+
+Haplotype HaplotypeTree::extract_haplotype(const Vertex leaf, const GenomicRegion& region, BranchPath& path) const
+{
+    update_path(leaf, path);
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
-        leaf = get_previous_allele(leaf);
-    }
-    Haplotype::Builder result {region, reference_};
-    while (leaf != root_ && contains(contig_region, tree_[leaf])) {
-        result.push_front(tree_[leaf]);
-        leaf = get_previous_allele(leaf);
+    auto last = std::crbegin(path);
+    last = std::find_if(last, std::crend(path), [&] (const Vertex v) { return contains(contig_region, allele(v)); });
+    const auto first = std::find_if(last, std::crend(path), [&] (const Vertex v) { return !contains(contig_region, allele(v)); });
+    std::vector<ContigAllele> alleles {};
+    if (first != last) {
+        alleles.reserve(2 * static_cast<std::size_t>(std::distance(last, first)) - 1);
+        // Reference gaps between alleles are filled from a single fetch of the branch region
+        const auto branch_region = octopus::encompassing_region(allele(*std::prev(first)), allele(*last));
+        boost::optional<Haplotype::NucleotideSequence> branch_reference {};
+        std::for_each(first.base(), last.base(), [&] (const Vertex v) {
+            const auto& next_allele = allele(v);
+            if (!alleles.empty() && !are_adjacent(alleles.back(), next_allele)) {
+                if (!branch_reference) {
+                    branch_reference = reference_.get().fetch_sequence(GenomicRegion {contig_, branch_region});
+                }
+                const auto gap = *intervening_region(alleles.back(), next_allele);
+                alleles.emplace_back(gap, branch_reference->substr(begin_distance(branch_region, gap), region_size(gap)));
+            }
+            alleles.push_back(next_allele);
+        });
     }
-    return result.build();
+    return Haplotype {region, std::make_move_iterator(std::begin(alleles)), std::make_move_iterator(std::end(alleles)), reference_};
+}
+
+Haplotype HaplotypeTree::extract_haplotype(const Vertex leaf, const GenomicRegion& region) const
+{
+    BranchPath path {};
+    return extract_haplotype(leaf, region, path);
 }
 
 HaplotypeTree::HaplotypeLength HaplotypeTree::extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
+    while (leaf != root_ && !contains(contig_region, allele(leaf))) {
         leaf = get_previous_allele(leaf);
     }
     if (leaf == root_) {
         return size(contig_region);
     }
-    HaplotypeLength result {right_overhang_size(contig_region, tree_[leaf])};
+    HaplotypeLength result {right_overhang_size(contig_region, allele(leaf))};
     auto prev_node = leaf;
     while (true) {
-        result += sequence_size(tree_[leaf]);
+        result += sequence_size(allele(leaf));
         prev_node = leaf;
         leaf = get_previous_allele(leaf);
-        if (leaf != root_ && contains(contig_region, tree_[leaf])) {
-            result += inner_distance(tree_[leaf], tree_[prev_node]);
+        if (leaf != root_ && contains(contig_region, allele(leaf))) {
+            result += inner_distance(allele(leaf), allele(prev_node));
         } else {
             break;
         }
     }
-    result += left_overhang_size(contig_region, tree_[prev_node]);
+    result += left_overhang_size(contig_region, allele(prev_node));
     return result;
 }
 
-bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
+bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const noexcept
 {
     if (leaf1 == leaf2) {
         return true;
     }
+    if (nodes_[leaf1].depth != nodes_[leaf2].depth) {
+        return false;
+    }
     while (leaf1 != root_) {
-        if (leaf2 == root_ || tree_[leaf1] != tree_[leaf2]) return false;
+        if (nodes_[leaf1].allele != nodes_[leaf2].allele) return false;
         leaf1 = get_previous_allele(leaf1);
         leaf2 = get_previous_allele(leaf2);
     }
-    return leaf2 == root_;
+    return true;
 }
 
 bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& haplotype) const
 {
-    if (leaf == root_ || !overlaps(tree_[leaf], contig_region(haplotype))) {
+    if (leaf == root_ || !overlaps(allele(leaf), contig_region(haplotype))) {
         return false;
     }
     while (leaf != root_) {
-        if (!haplotype.includes(tree_[leaf])) {
+        if (!haplotype.includes(allele(leaf))) {
             return false;
         }
         leaf = get_previous_allele(leaf);
@@ -601,35 +640,32 @@ bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& hapl
 
 bool HaplotypeTree::is_branch_equal_haplotype(const Vertex leaf, const Haplotype& haplotype) const
 {
-    // TODO: check if this is quicker than calling Haplotype::contains for each ContigAllele
-    return leaf != root_ && overlaps(contig_region(haplotype), tree_[leaf])
+    // The branch length is cheap to compute and rules out most branches without making a haplotype
+    return leaf != root_ && overlaps(contig_region(haplotype), allele(leaf))
+            && extract_haplotype_length(leaf, haplotype.mapped_region()) == sequence_size(haplotype)
             && extract_haplotype(leaf, haplotype.mapped_region()) == haplotype;
 }
 
-HaplotypeTree::LeafIterator
-HaplotypeTree::find_exact_haplotype_leaf(const LeafIterator first, const LeafIterator last,
-                                         const Haplotype& haplotype) const
-{
-    return std::find_if(first, last,
-                        [this, &haplotype] (Vertex leaf) {
-                            return is_branch_exact_haplotype(leaf, haplotype);
-                        });
-}
-
-HaplotypeTree::LeafIterator
-HaplotypeTree::find_equal_haplotype_leaf(const LeafIterator first, const LeafIterator last,
-                                         const Haplotype& haplotype) const
+template <typename UnaryPredicate>
+void HaplotypeTree::clear_leafs_if(const ContigRegion& region, UnaryPredicate pred)
 {
-    return std::find_if(first, last,
-                        [this, &haplotype] (Vertex leaf) {
-                            return is_branch_equal_haplotype(leaf, haplotype);
-                        });
+    // Leafs are tested in order, after clearing any leafs before them, and compacted in place
+    auto leaf_itr = std::begin(haplotype_leafs_);
+    for (const auto leaf : haplotype_leafs_) {
+        if (pred(leaf)) {
+            const auto p = clear(leaf, region);
+            if (p.second) *leaf_itr++ = p.first;
+        } else {
+            *leaf_itr++ = leaf;
+        }
+    }
+    haplotype_leafs_.erase(leaf_itr, std::end(haplotype_leafs_));
 }
 
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 {
-    if (overlaps(region, tree_[leaf])) {
+    if (leaf != root_ && overlaps(region, allele(leaf))) {
         return clear_external(leaf, region);
     } else {
         return clear_internal(leaf, region);
@@ -639,25 +675,25 @@ HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear_external(Vertex leaf, const ContigRegion& region)
 {
-    assert(boost::out_degree(leaf, tree_) == 0);
+    assert(nodes_[leaf].num_children == 0);
     while (leaf != root_) {
-        if (boost::out_degree(leaf, tree_) > 0) {
+        if (nodes_[leaf].num_children > 0) {
             return std::make_pair(leaf, false);
-        } else if (begins_before(tree_[leaf], region)) {
+        } else if (begins_before(allele(leaf), region)) {
             return std::make_pair(leaf, true);
         } else {
             leaf = remove_backward(leaf);
         }
     }
     // the root should only be indicated as a leaf node if there are no other nodes in the tree
-    return std::make_pair(leaf, boost::num_vertices(tree_) == 1);
+    return std::make_pair(leaf, num_vertices() == 1);
 }
 
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
 {
     // TODO: we can optimise this for cases where region overlaps the leftmost alleles in the tree
-    if (leaf == root_ || is_after(region, tree_[leaf])) {
+    if (leaf == root_ || is_after(region, allele(leaf))) {
         return std::make_pair(leaf, true);
     }
     Vertex current_allele {leaf}, allele_to_move {leaf};
@@ -665,7 +701,7 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     bool is_bifurcating_branch {false};
     while (true) {
         current_allele = get_previous_allele(current_allele);
-        if (current_allele == root_ || overlaps(tree_[current_allele], region)) {
+        if (current_allele == root_ || overlaps(allele(current_allele), region)) {
             break;
         }
         is_bifurcating_branch = is_bifurcating_branch || is_bifurcating(current_allele);
@@ -675,27 +711,23 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
             alleles_to_copy.push_front(current_allele);
         }
     }
-    if (alleles_to_copy.empty()) {
-        boost::remove_edge(current_allele, allele_to_move, tree_);
-    } else {
-        assert(alleles_to_copy.back() != allele_to_move);
-        boost::remove_edge(alleles_to_copy.back(), allele_to_move, tree_);
-    }
-    while (current_allele != root_ && overlaps(region, tree_[current_allele])) {
+    assert(alleles_to_copy.empty() || get_previous_allele(allele_to_move) == alleles_to_copy.back());
+    remove_edge(allele_to_move);
+    while (current_allele != root_ && overlaps(region, allele(current_allele))) {
         const auto previous_allele = get_previous_allele(current_allele);
-        is_bifurcating_branch = is_bifurcating_branch || boost::out_degree(current_allele, tree_) > 0;
+        is_bifurcating_branch = is_bifurcating_branch || nodes_[current_allele].num_children > 0;
         if (!is_bifurcating_branch) {
-            assert(boost::out_degree(current_allele, tree_) <= 1);
-            boost::remove_edge(previous_allele, current_allele, tree_);
-            boost::remove_vertex(current_allele, tree_);
+            assert(nodes_[current_allele].num_children == 0);
+            remove_edge(current_allele);
+            remove_vertex(current_allele);
         }
         current_allele = previous_allele;
     }
     // Simpler to prepend onto the movable branch and then call that moveable than treat each separately
     std::for_each(std::crbegin(alleles_to_copy), std::crend(alleles_to_copy),
                   [this, &allele_to_move] (const Vertex allele) {
-                      const auto v = boost::add_vertex(tree_[allele], tree_);
-                      boost::add_edge(v, allele_to_move, tree_);
+                      const auto v = add_vertex(nodes_[allele].allele);
+                      add_edge(v, allele_to_move);
                       allele_to_move = v;
                   });
     alleles_to_copy.clear();
@@ -703,26 +735,26 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     auto allele_to_move_to = current_allele;
     // Now avoid duplicate branches
     while (true) {
-        const auto vertex_range = boost::adjacent_vertices(allele_to_move_to, tree_);
-        const auto it = std::find_if(vertex_range.first, vertex_range.second,
-                                     [this, allele_to_move] (const Vertex allele) {
-                                         return tree_[allele] == tree_[allele_to_move];
-                                     });
-        if (it == vertex_range.second) break;
-        allele_to_move_to = *it; // i.e. move forward
-        if (boost::out_degree(allele_to_move, tree_) == 0) break;
+        auto v = nodes_[allele_to_move_to].first_child;
+        while (v != null_vertex_ && nodes_[v].allele != nodes_[allele_to_move].allele) {
+            v = nodes_[v].next_sibling;
+        }
+        if (v == null_vertex_) break;
+        allele_to_move_to = v; // i.e. move forward
+        if (nodes_[allele_to_move].num_children == 0) break;
         // Safe to remove forward as we made this branch earlier via copies
         allele_to_move = remove_forward(allele_to_move);
     }
-    if (allele_to_move_to == root_ || tree_[allele_to_move_to] != tree_[allele_to_move]) {
-        boost::add_edge(allele_to_move_to, allele_to_move, tree_);
+    if (allele_to_move_to == root_ || nodes_[allele_to_move_to].allele != nodes_[allele_to_move].allele) {
+        add_edge(allele_to_move_to, allele_to_move);
+        update_depths(allele_to_move);
         return std::make_pair(leaf, true);
     } else {
         // Ditch the entire copied branch as it's already in the tree
-        while (boost::out_degree(allele_to_move, tree_) > 0) {
+        while (nodes_[allele_to_move].num_children > 0) {
             allele_to_move = remove_forward(allele_to_move);
         }
-        boost::remove_vertex(allele_to_move, tree_);
+        remove_vertex(allele_to_move);
         return std::make_pair(allele_to_move_to, false);
     }
 }
@@ -793,44 +825,5 @@ minmax_haplotype_lengths(const HaplotypeTree& tree, const GenomicRegion& region)
     }
 }
 
-namespace debug {
-
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs)
-{
-    if (boost::num_vertices(graph) == 1) {
-        return *boost::vertices(graph).first == root;
-    }
-    std::unordered_set<V> visited_vertices {};
-    visited_vertices.reserve(boost::num_vertices(graph));
-    auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<V>(),
-                                                             std::inserter(visited_vertices,
-                                                                           std::begin(visited_vertices)),
-                                                             boost::on_discover_vertex()));
-    std::unordered_map<V, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(graph));
-    const auto p = boost::vertices(graph);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const auto& v) { index_map.emplace(v, i++); });
-    boost::breadth_first_search(graph, root,
-                                boost::visitor(vis)
-                                .vertex_index_map(boost::make_assoc_property_map(index_map)));
-    if (visited_vertices.size() != boost::num_vertices(graph) || visited_vertices.count(root) == 0) {
-        return false;
-    }
-    return std::all_of(std::cbegin(leafs), std::cend(leafs),
-                       [&graph, &root] (auto v) {
-                           if (boost::out_degree(v, graph) != 0) return false;
-                           while (v != root) {
-                               const auto p = boost::inv_adjacent_vertices(v, graph);
-                               if (std::distance(p.first, p.second) != 1) return false;
-                               v = *p.first;
-                           }
-                           return true;
-                       });
-}
-
-} // namespace debug
-
 } // namespace coretools
 } // namespace octopus
@@ -5,9 +5,7 @@
 #define haplotype_tree_hpp
 
 #include <vector>
-#include <list>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <functional>
 #include <iterator>
@@ -15,8 +13,8 @@
 #include <type_traits>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/optional.hpp>
 
 #include "basics/genomic_region.hpp"
@@ -30,6 +28,11 @@ class ReferenceGenome;
 
 namespace coretools {
 
+/**
+ The tree is stored in a contiguous node arena: each node holds its parent, children and depth as
+ indices, and an ID into a table of the distinct alleles in the tree. Removed nodes and alleles are
+ recycled, so growing and pruning the tree rarely allocates, and copying the tree is a few vector copies.
+ */
 class HaplotypeTree
 {
 public:
@@ -39,9 +42,9 @@ public:
     
     HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference);
     
-    HaplotypeTree(const HaplotypeTree&);
-    HaplotypeTree& operator=(const HaplotypeTree&);
-    HaplotypeTree(HaplotypeTree&&)            = default;
+    HaplotypeTree(const HaplotypeTree&)            = default;
+    HaplotypeTree& operator=(const HaplotypeTree&) = default;
+    HaplotypeTree(HaplotypeTree&&)                 = default;
     HaplotypeTree& operator=(HaplotypeTree&&) = default;
     
     ~HaplotypeTree() = default;
@@ -86,43 +89,63 @@ public:
     void clear() noexcept;
     
 private:
-    using Tree = boost::adjacency_list<
-        boost::listS, boost::listS, boost::bidirectionalS, ContigAllele, boost::no_property
-    >;
+    using Vertex   = std::uint32_t;
+    using AlleleId = std::uint32_t;
     
-    using Vertex = boost::graph_traits<Tree>::vertex_descriptor;
-    using Edge   = boost::graph_traits<Tree>::edge_descriptor;
+    struct Node
+    {
+        AlleleId allele;
+        Vertex parent, first_child, next_sibling;
+        std::uint32_t depth, num_children;
+    };
+    
+    // Root-to-leaf vertices of the last extracted branch, so branches can share prefix walks
+    using BranchPath = std::vector<Vertex>;
     
     using HaplotypeVertexMultiMap = std::unordered_multimap<Haplotype, Vertex>;
     
+    static constexpr Vertex root_ {0};
+    static constexpr Vertex null_vertex_ {static_cast<Vertex>(-1)};
+    
     std::reference_wrapper<const ReferenceGenome> reference_;
-    Tree tree_;
-    Vertex root_;
-    std::list<Vertex> haplotype_leafs_;
+    std::vector<Node> nodes_;
+    std::vector<Vertex> free_vertices_;
+    std::vector<ContigAllele> alleles_;
+    std::vector<std::uint32_t> allele_counts_;
+    std::vector<AlleleId> free_alleles_;
+    std::unordered_map<ContigAllele, AlleleId> allele_ids_;
+    std::vector<Vertex> haplotype_leafs_;
     GenomicRegion::ContigName contig_;
     
     mutable HaplotypeVertexMultiMap haplotype_leaf_cache_;
     mutable boost::optional<GenomicRegion> tree_region_;
     
-    using LeafIterator  = decltype(haplotype_leafs_)::const_iterator;
-    using CacheIterator = decltype(haplotype_leaf_cache_)::iterator;
-    
-    bool is_bifurcating(Vertex v) const;
-    Vertex remove_forward(Vertex u);
-    Vertex remove_backward(Vertex v);
-    Vertex get_previous_allele(Vertex allele) const;
+    const ContigAllele& allele(Vertex v) const noexcept;
+    AlleleId intern(const ContigAllele& allele);
+    void release_if_unused(AlleleId allele) noexcept;
+    std::size_t num_vertices() const noexcept;
+    Vertex add_vertex(AlleleId allele);
+    Vertex add_vertex(AlleleId allele, Vertex parent);
+    void add_edge(Vertex parent, Vertex child) noexcept;
+    void remove_edge(Vertex child) noexcept;
+    void remove_vertex(Vertex v) noexcept;
+    void update_depths(Vertex v) noexcept;
+    bool is_bifurcating(Vertex v) const noexcept;
+    Vertex remove_forward(Vertex u) noexcept;
+    Vertex remove_backward(Vertex v) noexcept;
+    Vertex get_previous_allele(Vertex allele) const noexcept;
     Vertex find_allele_before(Vertex v, const ContigAllele& allele) const;
-    bool allele_exists(Vertex leaf, const ContigAllele& allele) const;
-    LeafIterator extend_haplotype(LeafIterator leaf, const ContigAllele& new_allele);
+    bool allele_exists(Vertex leaf, AlleleId allele) const noexcept;
+    void extend_haplotype(Vertex leaf, AlleleId new_allele, std::vector<Vertex>& new_leafs);
+    void splice_sites(const ContigAllele& allele, std::vector<Vertex>& result) const;
+    void update_path(Vertex leaf, BranchPath& path) const;
+    Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region, BranchPath& path) const;
     Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region) const;
     HaplotypeLength extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const;
-    bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const;
+    bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const noexcept;
     bool is_branch_exact_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
     bool is_branch_equal_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
-    LeafIterator find_exact_haplotype_leaf(LeafIterator first, LeafIterator last,
-                                           const Haplotype& haplotype) const;
-    LeafIterator find_equal_haplotype_leaf(LeafIterator first, LeafIterator last,
-                                           const Haplotype& haplotype) const;
+    template <typename UnaryPredicate> void clear_leafs_if(const ContigRegion& region, UnaryPredicate pred);
     std::pair<Vertex, bool> clear(Vertex leaf, const ContigRegion& region);
     std::pair<Vertex, bool> clear_external(Vertex leaf, const ContigRegion& region);
     std::pair<Vertex, bool> clear_internal(Vertex leaf, const ContigRegion& region);
@@ -0,0 +1,131 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "isolated_snv_screener.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <cassert>
+
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "utils/mappable_algorithms.hpp"
+#include "utils/repeat_finder.hpp"
+
+namespace octopus {
+
+namespace {
+
+constexpr GenomicRegion::Size repeatContextSize {20};
+constexpr unsigned maxRepeatPeriod {6};
+constexpr GenomicRegion::Size minRepeatLength {8};
+
+bool is_acgt(const char base) noexcept
+{
+    return base == 'A' || base == 'C' || base == 'G' || base == 'T';
+}
+
+bool is_acgt_snv(const Variant& candidate)
+{
+    return is_snv(candidate) && is_acgt(ref_sequence(candidate).front()) && is_acgt(alt_sequence(candidate).front());
+}
+
+bool is_isolated(const Variant& snv, const MappableFlatSet<Variant>& candidates,
+                 const GenomicRegion::Size min_distance)
+{
+    return candidates.count_overlapped(expand(mapped_region(snv), min_distance)) == 1;
+}
+
+bool in_short_tandem_repeat(const Variant& snv, const ReferenceGenome& reference)
+{
+    const auto context = overlapped_region(expand(mapped_region(snv), repeatContextSize),
+                                           reference.contig_region(contig_name(snv)));
+    assert(context);
+    const auto repeats = find_exact_tandem_repeats(reference, *context, maxRepeatPeriod);
+    return std::any_of(std::cbegin(repeats), std::cend(repeats), [&] (const TandemRepeat& repeat) {
+        return region_size(repeat) >= minRepeatLength && overlaps(repeat, snv);
+    });
+}
+
+// Returns the offset of the read base aligned to position, if there is one
+boost::optional<std::size_t>
+aligned_offset(const AlignedRead& read, const GenomicRegion::Position position)
+{
+    auto reference_position = mapped_begin(read);
+    std::size_t sequence_offset {0};
+    for (const auto& op : read.cigar()) {
+        const auto ref_advance = advances_reference(op) ? op.size() : 0;
+        if (position < reference_position + ref_advance) {
+            if (!advances_sequence(op)) return boost::none; // deletion or skip
+            return sequence_offset + (position - reference_position);
+        }
+        reference_position += ref_advance;
+        if (advances_sequence(op)) sequence_offset += op.size();
+    }
+    return boost::none;
+}
+
+double error_probability(const AlignedRead& read, const std::size_t offset) noexcept
+{
+    const auto quality = std::min<unsigned>(read.base_qualities()[offset], read.mapping_quality());
+    return std::min(std::pow(10.0, -static_cast<double>(quality) / 10), 0.75);
+}
+
+} // namespace
+
+std::vector<Variant>
+find_isolated_snvs(const MappableFlatSet<Variant>& candidates, const ReferenceGenome& reference,
+                   const GenomicRegion::Size min_distance)
+{
+    std::vector<Variant> result {};
+    std::copy_if(std::cbegin(candidates), std::cend(candidates), std::back_inserter(result),
+                 [&] (const Variant& candidate) {
+                     return is_acgt_snv(candidate) && is_isolated(candidate, candidates, min_distance)
+                            && !in_short_tandem_repeat(candidate, reference);
+                 });
+    return result;
+}
+
+std::vector<Haplotype>
+populate_isolated_snv_likelihoods(const Variant& snv, const ReadViewMap& reads,
+                                  const std::vector<SampleName>& samples,
+                                  const ReferenceGenome& reference,
+                                  HaplotypeLikelihoodArray& haplotype_likelihoods)
+{
+    assert(is_snv(snv) && haplotype_likelihoods.is_empty());
+    const auto& region = mapped_region(snv);
+    std::vector<Haplotype> result {};
+    result.reserve(2);
+    result.emplace_back(region, reference);
+    result.emplace_back(region, alt_sequence(snv), reference);
+    const auto position = mapped_begin(snv);
+    const auto ref_base = ref_sequence(snv).front(), alt_base = alt_sequence(snv).front();
+    HaplotypeLikelihoodArray::LikelihoodVector ref_likelihoods {}, alt_likelihoods {};
+    for (const auto& sample : samples) {
+        const auto& sample_reads = reads.at(sample);
+        ref_likelihoods.assign(sample_reads.size(), 0);
+        alt_likelihoods.assign(sample_reads.size(), 0);
+        std::size_t read_idx {0};
+        for (const AlignedRead& read : sample_reads) {
+            const auto offset = aligned_offset(read, position);
+            if (offset && is_acgt(read.sequence()[*offset])) {
+                const auto base = read.sequence()[*offset];
+                const auto e = error_probability(read, *offset);
+                const auto match = std::log(1 - e), mismatch = std::log(e / 3);
+                ref_likelihoods[read_idx] = base == ref_base ? match : mismatch;
+                alt_likelihoods[read_idx] = base == alt_base ? match : mismatch;
+            }
+            ++read_idx;
+        }
+        haplotype_likelihoods.insert(sample, result.front(), ref_likelihoods);
+        haplotype_likelihoods.insert(sample, result.back(), alt_likelihoods);
+    }
+    return result;
+}
+
+} // namespace octopus
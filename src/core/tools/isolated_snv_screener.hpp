@@ -0,0 +1,48 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef isolated_snv_screener_hpp
+#define isolated_snv_screener_hpp
+
+#include <vector>
+
+#include "config/common.hpp"
+#include "containers/mappable_flat_set.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/types/variant.hpp"
+#include "core/types/haplotype.hpp"
+
+namespace octopus {
+
+class HaplotypeLikelihoodArray;
+
+/*
+ Isolated SNVs can be genotyped without haplotype generation or pair-HMM alignment. Such a
+ site only has two haplotypes, the reference and the SNV, and they are identical apart from
+ the SNV base. So the ratio of a read's likelihoods under the two haplotypes only depends on
+ the base aligned to the SNV position. A read's likelihood is therefore given by the closed
+ form 1 - e if its base matches the haplotype and e / 3 otherwise, where e is the error rate of
+ the lesser of its base and mapping quality. Reads with no base at the SNV position (e.g.
+ deletions), or an N, are equally likely under both haplotypes.
+
+ The approximation breaks down near other variation, or in tandem repeats where reads may be
+ misaligned, so those SNVs are not screened in.
+ */
+
+// Returns the SNV candidates with no other candidate within min_distance bases that do not
+// overlap a short tandem repeat in the reference. The result is sorted.
+std::vector<Variant>
+find_isolated_snvs(const MappableFlatSet<Variant>& candidates, const ReferenceGenome& reference,
+                   GenomicRegion::Size min_distance);
+
+// Returns the reference and SNV haplotypes, and fills haplotype_likelihoods with likelihoods
+// for every read in reads, which should all overlap the SNV. haplotype_likelihoods must be empty.
+std::vector<Haplotype>
+populate_isolated_snv_likelihoods(const Variant& snv, const ReadViewMap& reads,
+                                  const std::vector<SampleName>& samples,
+                                  const ReferenceGenome& reference,
+                                  HaplotypeLikelihoodArray& haplotype_likelihoods);
+
+} // namespace octopus
+
+#endif
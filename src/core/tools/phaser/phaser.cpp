@@ -9,12 +9,15 @@
 #include <cstddef>
 #include <cmath>
 #include <utility>
+#include <memory>
+#include <unordered_map>
 #include <iostream>
 
 #include <boost/functional/hash.hpp>
 
 #include "utils/mappable_algorithms.hpp"
 #include "utils/maths.hpp"
+#include "utils/parallel_algorithms.hpp"
 
 #include "timers.hpp"
 
@@ -28,57 +31,86 @@ using GenotypeReference    = std::reference_wrapper<const Genotype<Haplotype>>;
 using PhaseComplementSet   = std::deque<GenotypeReference>;
 using PhaseComplementSets  = std::vector<PhaseComplementSet>;
 using PartitionIterator    = std::vector<GenomicRegion>::const_iterator;
-using GenotypeChunkVector = std::vector<Genotype<Haplotype>>;
+using HaplotypeClass       = unsigned;
 
-struct GenotypeChunkPartitions
+const Genotype<Haplotype>& get_genotype(const Genotype<Haplotype>& genotype) noexcept
 {
-    GenotypeReference genotype;
-    GenotypeChunkVector chunks;
-};
+    return genotype;
+}
+
+const Genotype<Haplotype>& get_genotype(const GenotypeReference& genotype) noexcept
+{
+    return genotype.get();
+}
 
-using GenotypeChunkTable = std::vector<GenotypeChunkPartitions>;
+struct HaplotypeIndex
+{
+    std::vector<const Haplotype*> haplotypes;
+    std::vector<std::vector<std::size_t>> genotype_haplotypes; // indices into haplotypes
+};
 
+// Genotypes share haplotypes, so only distinct haplotype objects are indexed. Equal haplotypes held
+// by different objects get the same class in every partition, so they need not be merged here.
 template <typename Container>
-GenotypeChunkTable
-make_chunk_table(const Container& genotypes, PartitionIterator first_parition, PartitionIterator last_partition)
+HaplotypeIndex index_haplotypes(const Container& genotypes)
 {
-    const auto num_partitions = std::distance(first_parition, last_partition);
-    GenotypeChunkTable result {};
-    result.reserve(genotypes.size());
+    HaplotypeIndex result {};
+    result.genotype_haplotypes.reserve(genotypes.size());
+    std::unordered_map<const Haplotype*, std::size_t> indices {};
     for (const auto& genotype : genotypes) {
-        result.push_back({std::cref(genotype), GenotypeChunkVector {}});
-        result.back().chunks.reserve(num_partitions);
-    }
-    std::for_each(first_parition, last_partition, [&] (const auto& region) {
-        auto chunks = copy_each<Haplotype>(genotypes, region);
-        for (std::size_t i {0}; i < genotypes.size(); ++i) {
-            result[i].chunks.push_back(std::move(chunks[i]));
+        const auto& g = get_genotype(genotype);
+        std::vector<std::size_t> haplotype_indices(g.ploidy());
+        for (unsigned i {0}; i < g.ploidy(); ++i) {
+            const auto itr = indices.emplace(std::addressof(g[i]), result.haplotypes.size()).first;
+            if (itr->second == result.haplotypes.size()) result.haplotypes.push_back(itr->first);
+            haplotype_indices[i] = itr->second;
         }
-    });
+        result.genotype_haplotypes.push_back(std::move(haplotype_indices));
+    }
     return result;
 }
 
-struct GenotypeChunkVectorHash
+// result[p][h] identifies the haplotypes that are equal to haplotype h within partition p
+std::vector<std::vector<HaplotypeClass>>
+classify_haplotypes(const std::vector<const Haplotype*>& haplotypes, PartitionIterator first_partition, PartitionIterator last_partition)
 {
-    auto operator()(const GenotypeChunkVector& chunks) const noexcept
-    {
-        std::size_t result {};
-        for (const auto& genotype : chunks) {
-            using boost::hash_combine;
-            hash_combine(result, std::hash<Genotype<Haplotype>>{}(genotype));
+    std::vector<std::vector<HaplotypeClass>> result(std::distance(first_partition, last_partition));
+    parallel_for(std::size_t {0}, result.size(), [&] (const std::size_t p) {
+        const auto& partition = *std::next(first_partition, p);
+        std::unordered_map<Haplotype, HaplotypeClass> classes {};
+        classes.reserve(haplotypes.size());
+        result[p].reserve(haplotypes.size());
+        for (const auto* haplotype : haplotypes) {
+            const auto next_class = static_cast<HaplotypeClass>(classes.size());
+            result[p].push_back(classes.emplace(copy<Haplotype>(*haplotype, partition), next_class).first->second);
         }
-        return result;
-    }
-};
-
-using PhaseSetMap = std::unordered_map<GenotypeChunkVector, PhaseComplementSet, GenotypeChunkVectorHash>;
+    });
+    return result;
+}
 
-PhaseComplementSets make_phase_sets(const GenotypeChunkTable& table)
+// Two genotypes are in the same phase complement set if they have the same haplotype classes in
+// every partition. Genotypes are unordered, so the classes of each partition are sorted.
+template <typename Container>
+PhaseComplementSets
+make_phase_sets(const Container& genotypes, const HaplotypeIndex& index,
+                const std::vector<std::vector<HaplotypeClass>>& partition_classes)
 {
-    PhaseSetMap phase_sets {};
-    phase_sets.reserve(table.size());
-    for (const auto& row : table) {
-        phase_sets[row.chunks].push_back(row.genotype);
+    using PhaseKey = std::vector<HaplotypeClass>;
+    std::unordered_map<PhaseKey, PhaseComplementSet, boost::hash<PhaseKey>> phase_sets {};
+    phase_sets.reserve(genotypes.size());
+    PhaseKey key {};
+    auto genotype_haplotypes_itr = std::cbegin(index.genotype_haplotypes);
+    for (const auto& genotype : genotypes) {
+        const auto& haplotype_indices = *genotype_haplotypes_itr++;
+        key.clear();
+        key.reserve(1 + partition_classes.size() * haplotype_indices.size());
+        key.push_back(haplotype_indices.size());
+        for (const auto& classes : partition_classes) {
+            const auto partition_begin = key.size();
+            for (const auto h : haplotype_indices) key.push_back(classes[h]);
+            std::sort(std::next(std::begin(key), partition_begin), std::end(key));
+        }
+        phase_sets[key].push_back(std::cref(get_genotype(genotype)));
     }
     PhaseComplementSets result {};
     result.reserve(phase_sets.size());
@@ -92,8 +124,9 @@ template <typename Container>
 PhaseComplementSets
 generate_phase_complement_sets(const Container& genotypes, PartitionIterator first_parition, PartitionIterator last_partition)
 {
-    const auto table = make_chunk_table(genotypes, first_parition, last_partition);
-    return make_phase_sets(table);
+    const auto index = index_haplotypes(genotypes);
+    const auto partition_classes = classify_haplotypes(index.haplotypes, first_parition, last_partition);
+    return make_phase_sets(genotypes, index, partition_classes);
 }
 
 template <typename Map>
@@ -204,20 +237,20 @@ Phaser::PhaseSet::SamplePhaseRegions
 force_phase_sample(const GenomicRegion& region,
                    const std::vector<GenomicRegion>& partitions,
                    const std::vector<GenotypeReference>& genotypes,
+                   const PhaseComplementSets& phase_sets,
                    const Phaser::SampleGenotypePosteriorMap& genotype_posteriors,
                    const Phred<double> min_phase_score)
 {
-    auto first_partition = std::cbegin(partitions);
-    auto last_partition  = std::cend(partitions);
-    auto phase_set = generate_phase_complement_sets(genotypes, first_partition, last_partition);
-    auto phase_score = calculate_phase_score(phase_set, genotype_posteriors);
+    auto phase_score = calculate_phase_score(phase_sets, genotype_posteriors);
     if (phase_score >= min_phase_score) {
         return {Phaser::PhaseSet::PhaseRegion {region, phase_score}};
     }
     Phaser::PhaseSet::SamplePhaseRegions result {};
-    --last_partition;
+    auto first_partition = std::cbegin(partitions);
+    auto last_partition  = std::prev(std::cend(partitions));
     std::vector<Genotype<Haplotype>> chunks;
     GenotypeChunkPosteriorMap chunk_posteriors;
+    PhaseComplementSets phase_set;
     while (first_partition != std::cend(partitions)) {
         auto curr_region = encompassing_region(first_partition, last_partition);
         std::tie(chunks, chunk_posteriors) = copy_and_marginalise(genotypes, genotype_posteriors, curr_region);
@@ -260,11 +293,16 @@ Phaser::force_phase(const std::vector<Haplotype>& haplotypes,
         }
         return result;
     }
+    // The phase complement sets over all partitions do not depend on the sample
+    boost::optional<PhaseComplementSets> phase_sets {};
     for (const auto& p : genotype_posteriors) {
         if (genotype_calls && max_phase_score_ && min_phase_score(genotype_calls->at(p.first), p.second) >= *max_phase_score_) {
             result.phase_regions[p.first].emplace_back(haplotype_region, *max_phase_score_);
         } else {
-            auto phases = force_phase_sample(haplotype_region, partitions, genotypes, p.second, min_phase_score_);
+            if (!phase_sets) {
+                phase_sets = generate_phase_complement_sets(genotypes, std::cbegin(partitions), std::cend(partitions));
+            }
+            auto phases = force_phase_sample(haplotype_region, partitions, genotypes, *phase_sets, p.second, min_phase_score_);
             if (max_phase_score_) {
                 for (auto& phase : phases) phase.score = std::min(phase.score, *max_phase_score_);
             }
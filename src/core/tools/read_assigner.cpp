@@ -185,22 +185,20 @@ auto calculate_likelihoods(const std::vector<Haplotype>& haplotypes, const Conta
     const auto read_hashes = compute_read_hashes(reads);
     static constexpr unsigned char mapperKmerSize {6};
     auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    MappedIndexCounts haplotype_mapping_counts {};
     HaplotypeLikelihoods result {};
     result.reserve(haplotypes.size());
     const auto max_indel_size = estimate_max_indel_size(haplotypes);
     for (const auto& haplotype : haplotypes) {
         const auto expanded_haplotype = expand_for_alignment(haplotype, reads_region, max_indel_size);
         populate_kmer_hash_table<mapperKmerSize>(expanded_haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
         model.reset(expanded_haplotype);
         std::vector<double> likelihoods(reads.size());
         std::transform(std::cbegin(reads), std::cend(reads), std::cbegin(read_hashes), std::begin(likelihoods),
                        [&] (const auto& read, const auto& read_hash) {
                            auto mapping_positions = map_query_to_target(read_hash, haplotype_hashes, haplotype_mapping_counts);
-                           reset_mapping_counts(haplotype_mapping_counts);
                            return model.evaluate(read, mapping_positions);
                        });
-        clear_kmer_hash_table(haplotype_hashes);
         result.push_back(std::move(likelihoods));
     }
     return result;
@@ -36,7 +36,7 @@ GenomicRegion::Size max_deletion_length(const std::vector<AlignedRead>& reads) n
 auto safe_expand(const GenomicRegion& region, const GenomicRegion::Size n)
 {
     if (region.begin() < n) {
-        return GenomicRegion {region.contig_name(), 0, region.end() + 2 * n - region.begin()};
+        return GenomicRegion {region.contig_id(), 0, region.end() + 2 * n - region.begin()};
     } else {
         return expand(region, n);
     }
@@ -76,7 +76,7 @@ void realign(AlignedRead& read, const Haplotype& haplotype,
 {
     const auto remapped_read_begin = mapped_begin(haplotype) + mapping_position;
     const auto remapped_read_end = remapped_read_begin + reference_size(alignment);
-    read.realign(GenomicRegion {contig_name(read), remapped_read_begin, remapped_read_end}, std::move(alignment));
+    read.realign(GenomicRegion {contig_id(read), remapped_read_begin, remapped_read_end}, std::move(alignment));
 }
 
 void realign(AlignedRead& read, const Haplotype& haplotype, HaplotypeLikelihoodModel::Alignment alignment)
@@ -109,7 +109,6 @@ void realign(std::vector<AlignedRead>& reads, const Haplotype& haplotype, Haplot
         model.reset(haplotype);
         for (std::size_t i {0}; i < reads.size(); ++i) {
             auto mapping_positions = map_query_to_target(read_hashes[i], haplotype_hashes, haplotype_mapping_counts);
-            reset_mapping_counts(haplotype_mapping_counts);
             realign(reads[i], haplotype, model.align(reads[i], mapping_positions));
         }
     }
@@ -0,0 +1,129 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "reference_confidence_engine.hpp"
+
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cassert>
+
+#include "core/types/allele.hpp"
+
+namespace octopus {
+
+ReferenceConfidenceEngine::ReferenceConfidenceEngine(const ReferenceGenome& reference, std::vector<SampleName> samples,
+                                                     const unsigned ploidy, Parameters parameters)
+: reference_ {reference}
+, samples_ {std::move(samples)}
+, ploidy_ {ploidy}
+, parameters_ {std::move(parameters)}
+, model_ {ploidy, parameters_.model_options}
+, qualities_ (samples_.size())
+{
+    assert(std::is_sorted(std::cbegin(parameters_.quality_bands), std::cend(parameters_.quality_bands)));
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+ReferenceConfidenceEngine::call(const GenomicRegion& region, const ReadMap& reads) const
+{
+    return call_helper({region}, reads);
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+ReferenceConfidenceEngine::call(const GenomicRegion& region, const ReadViewMap& reads) const
+{
+    return call_helper({region}, reads);
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+ReferenceConfidenceEngine::call(const std::vector<GenomicRegion>& regions, const ReadMap& reads) const
+{
+    return call_helper(regions, reads);
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+ReferenceConfidenceEngine::call(const std::vector<GenomicRegion>& regions, const ReadViewMap& reads) const
+{
+    return call_helper(regions, reads);
+}
+
+// private methods
+
+template <typename Map>
+std::vector<std::unique_ptr<ReferenceCall>>
+ReferenceConfidenceEngine::call_helper(const std::vector<GenomicRegion>& regions, const Map& reads) const
+{
+    std::vector<std::unique_ptr<ReferenceCall>> result {};
+    for (const auto& region : regions) {
+        call(region, reads, result);
+    }
+    return result;
+}
+
+template <typename Map>
+void ReferenceConfidenceEngine::call(const GenomicRegion& region, const Map& reads,
+                                     std::vector<std::unique_ptr<ReferenceCall>>& result) const
+{
+    if (is_empty(region) || samples_.empty() || ploidy_ == 0) return;
+    const auto sequence = reference_.get().fetch_sequence(region);
+    const auto num_samples = samples_.size();
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        model_.evaluate(region, sequence, reads.at(samples_[s]), qualities_[s]);
+    }
+    const auto min_quality = parameters_.min_call_posterior.score();
+    std::vector<std::size_t> block_bands(num_samples);
+    std::vector<double> block_qualities(num_samples);
+    std::size_t block_begin {0};
+    bool in_block {false};
+    const auto call_block = [&] (const std::size_t block_end) {
+        const GenomicRegion block_region {region.contig_name(), region.begin() + static_cast<GenomicRegion::Position>(block_begin),
+                                          region.begin() + static_cast<GenomicRegion::Position>(block_end)};
+        std::map<SampleName, ReferenceCall::GenotypeCall> genotypes {};
+        for (std::size_t s {0}; s < num_samples; ++s) {
+            genotypes.emplace(samples_[s], ReferenceCall::GenotypeCall {ploidy_, Phred<double> {block_qualities[s]}});
+        }
+        const Phred<double> quality {*std::min_element(std::cbegin(block_qualities), std::cend(block_qualities))};
+        Allele reference {block_region, sequence.substr(block_begin, block_end - block_begin)};
+        result.push_back(std::make_unique<ReferenceCall>(std::move(reference), quality, std::move(genotypes)));
+    };
+    const auto num_positions = sequence.size();
+    for (std::size_t position {0}; position < num_positions; ++position) {
+        const auto is_callable = std::all_of(std::cbegin(qualities_), std::cend(qualities_),
+                                             [=] (const auto& qualities) { return qualities[position] >= min_quality; });
+        if (!is_callable) {
+            if (in_block) call_block(position);
+            in_block = false;
+            continue;
+        }
+        if (in_block && parameters_.resolution == Resolution::blocked) {
+            bool same_bands {true};
+            for (std::size_t s {0}; s < num_samples && same_bands; ++s) {
+                same_bands = band(qualities_[s][position]) == block_bands[s];
+            }
+            if (same_bands) {
+                for (std::size_t s {0}; s < num_samples; ++s) {
+                    block_qualities[s] = std::min(block_qualities[s], qualities_[s][position]);
+                }
+                continue;
+            }
+        }
+        if (in_block) call_block(position);
+        block_begin = position;
+        in_block = true;
+        for (std::size_t s {0}; s < num_samples; ++s) {
+            block_bands[s] = band(qualities_[s][position]);
+            block_qualities[s] = qualities_[s][position];
+        }
+    }
+    if (in_block) call_block(num_positions);
+}
+
+std::size_t ReferenceConfidenceEngine::band(const double quality) const noexcept
+{
+    const auto& bands = parameters_.quality_bands;
+    return std::distance(std::cbegin(bands), std::upper_bound(std::cbegin(bands), std::cend(bands), quality));
+}
+
+} // namespace octopus
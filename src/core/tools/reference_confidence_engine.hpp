@@ -0,0 +1,80 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef reference_confidence_engine_hpp
+#define reference_confidence_engine_hpp
+
+#include <vector>
+#include <memory>
+#include <functional>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/phred.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/models/reference/individual_reference_likelihood_model.hpp"
+#include "core/types/calls/reference_call.hpp"
+
+namespace octopus {
+
+/*
+ Makes reference calls for regions without called variation directly from the reads, without
+ haplotypes, pileups or realignment.
+
+ Reference genotype qualities are computed for every position with IndividualReferenceLikelihoodModel
+ and streamed into calls. With blocked resolution, consecutive positions are merged while every
+ sample's quality stays in the same band (bands are given by their lower bounds), and each block is
+ called with the minimum quality of its positions. Positions with a sample quality below the minimum
+ call posterior are not called and end any open block. Nothing is called when the ploidy is zero.
+
+ The engine reuses its working buffers between calls, so it must not be shared between threads.
+ */
+class ReferenceConfidenceEngine
+{
+public:
+    enum class Resolution { positional, blocked };
+
+    struct Parameters
+    {
+        Resolution resolution;
+        Phred<double> min_call_posterior;
+        std::vector<double> quality_bands = {0, 5, 10, 15, 20, 30, 40, 50, 60, 70, 80, 90, 99};
+        model::IndividualReferenceLikelihoodModel::Options model_options = {};
+    };
+
+    ReferenceConfidenceEngine() = delete;
+
+    ReferenceConfidenceEngine(const ReferenceGenome& reference, std::vector<SampleName> samples,
+                              unsigned ploidy, Parameters parameters);
+
+    ReferenceConfidenceEngine(const ReferenceConfidenceEngine&)            = default;
+    ReferenceConfidenceEngine& operator=(const ReferenceConfidenceEngine&) = default;
+    ReferenceConfidenceEngine(ReferenceConfidenceEngine&&)                 = default;
+    ReferenceConfidenceEngine& operator=(ReferenceConfidenceEngine&&)      = default;
+
+    ~ReferenceConfidenceEngine() = default;
+
+    std::vector<std::unique_ptr<ReferenceCall>> call(const GenomicRegion& region, const ReadMap& reads) const;
+    std::vector<std::unique_ptr<ReferenceCall>> call(const GenomicRegion& region, const ReadViewMap& reads) const;
+    // regions must be sorted and non-overlapping
+    std::vector<std::unique_ptr<ReferenceCall>> call(const std::vector<GenomicRegion>& regions, const ReadMap& reads) const;
+    std::vector<std::unique_ptr<ReferenceCall>> call(const std::vector<GenomicRegion>& regions, const ReadViewMap& reads) const;
+
+private:
+    std::reference_wrapper<const ReferenceGenome> reference_;
+    std::vector<SampleName> samples_;
+    unsigned ploidy_;
+    Parameters parameters_;
+    model::IndividualReferenceLikelihoodModel model_;
+    mutable std::vector<std::vector<double>> qualities_; // one per sample
+
+    template <typename Map>
+    std::vector<std::unique_ptr<ReferenceCall>> call_helper(const std::vector<GenomicRegion>& regions, const Map& reads) const;
+    template <typename Map>
+    void call(const GenomicRegion& region, const Map& reads, std::vector<std::unique_ptr<ReferenceCall>>& result) const;
+    std::size_t band(double quality) const noexcept;
+};
+
+} // namespace octopus
+
+#endif
@@ -283,7 +283,7 @@ double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const
         const char ref_base {ref_segment[ref_index]}, read_base {read.sequence()[read_index]};
         if (ref_base != read_base && ref_base != 'N' && read_base != 'N') {
             const auto begin_pos = region.begin() + static_cast<GenomicRegion::Position>(ref_index);
-            add_candidate(GenomicRegion {region.contig_name(), begin_pos, begin_pos + 1},
+            add_candidate(GenomicRegion {region.contig_id(), begin_pos, begin_pos + 1},
                           ref_base, read_base, read, read_index, origin);
             if (read.base_qualities()[read_index] >= options_.misalignment_parameters.snv_threshold) {
                 misalignment_penalty += options_.misalignment_parameters.snv_penalty;
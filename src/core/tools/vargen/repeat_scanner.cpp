@@ -91,7 +91,7 @@ void RepeatScanner::add_read(const AlignedRead& read)
         using Flag = CigarOperation::Flag;
         switch (cigar_operation.flag()) {
             case Flag::alignmentMatch:
-                add_match_range(GenomicRegion {contig_name(read), ref_index, ref_index + op_size}, read, read_index);
+                add_match_range(GenomicRegion {contig_id(read), ref_index, ref_index + op_size}, read, read_index);
                 read_index += op_size;
                 ref_index  += op_size;
                 break;
@@ -366,7 +366,7 @@ bool AssemblerActiveRegionGenerator::is_interesting(const AlignedRead& read) con
             case Flag::substitution:
             {
                 if (snvs_interesting_) {
-                    GenomicRegion {contig_name(read), ref_index, ref_index + op_size};
+                    GenomicRegion {contig_id(read), ref_index, ref_index + op_size};
                     if (std::any_of(next(base_quality_itr, read_index), next(base_quality_itr, read_index + op_size),
                                     [this] (const AlignedRead::BaseQuality quality) { return quality >= trigger_quality_; })) {
                         return true;
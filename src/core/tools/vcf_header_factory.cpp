@@ -18,6 +18,7 @@ VcfHeaderFactory::AnnotatorMap VcfHeaderFactory::annotators_ =
     }},
     {std::type_index(typeid(ReferenceCall)), [] (auto& hb) {
         hb.add_info("MP", "1", "Float", "Model posterior");
+        hb.add_info("END", "1", "Integer", "End position of the reference block described in this record");
     }},
     {std::type_index(typeid(SomaticCall)), [] (auto& hb) {
         hb.add_info("SOMATIC", "0", "Flag", "Indicates that the record is a somatic mutation, for cancer genomics");
@@ -4,6 +4,7 @@
 #include "reference_call.hpp"
 
 #include "concepts/mappable.hpp"
+#include "io/variant/vcf_spec.hpp"
 
 namespace octopus {
 
@@ -49,7 +50,11 @@ void ReferenceCall::replace_uncalled_genotype_alleles(const Allele& replacement,
 
 void ReferenceCall::decorate(VcfRecord::Builder& record) const
 {
-    
+    if (region_size(reference_) > 1) {
+        // reference blocks only need the first base, the rest is implied by END
+        record.set_ref(reference_.sequence().front());
+        record.set_info(vcfspec::info::endPosition, mapped_end(reference_));
+    }
 }
 
 std::unique_ptr<Call> ReferenceCall::do_clone() const
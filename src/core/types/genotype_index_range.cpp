@@ -0,0 +1,228 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "genotype_index_range.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+auto make_binomial_table(const unsigned max_n, const unsigned max_k)
+{
+    // table[n * (max_k + 1) + k] = n choose k, saturating on overflow
+    const auto num_cols = max_k + 1;
+    std::vector<std::size_t> result((max_n + 1) * num_cols, 0);
+    for (unsigned n {0}; n <= max_n; ++n) {
+        result[n * num_cols] = 1;
+        for (unsigned k {1}; k <= std::min(n, max_k); ++k) {
+            const auto a = result[(n - 1) * num_cols + k - 1], b = result[(n - 1) * num_cols + k];
+            result[n * num_cols + k] = a > std::numeric_limits<std::size_t>::max() - b ? std::numeric_limits<std::size_t>::max() : a + b;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// GenotypeIndexRange::Iterator
+
+GenotypeIndexRange::Iterator::Iterator(const GenotypeIndexRange& range, const RankType rank)
+: range_ {std::addressof(range)}
+, rank_ {rank}
+, indices_ {}
+{
+    if (rank_ < range_->size()) range_->unrank(rank_, indices_);
+}
+
+GenotypeIndexRange::Iterator& GenotypeIndexRange::Iterator::operator++()
+{
+    assert(range_ && rank_ < range_->size());
+    ++rank_;
+    if (rank_ < range_->size()) range_->next(indices_);
+    return *this;
+}
+
+GenotypeIndexRange::Iterator GenotypeIndexRange::Iterator::operator++(int)
+{
+    auto result = *this;
+    this->operator++();
+    return result;
+}
+
+GenotypeIndexRange::Iterator& GenotypeIndexRange::Iterator::operator+=(const difference_type n)
+{
+    assert(range_);
+    if (n == 1) return this->operator++();
+    rank_ = static_cast<RankType>(static_cast<difference_type>(rank_) + n);
+    if (rank_ < range_->size()) range_->unrank(rank_, indices_);
+    return *this;
+}
+
+// GenotypeIndexRange
+
+GenotypeIndexRange::GenotypeIndexRange(const unsigned num_elements, const unsigned ploidy)
+: num_elements_ {num_elements}
+, ploidy_ {ploidy}
+, size_ {0}
+, binomials_ {}
+{
+    if (num_elements_ > 0 && ploidy_ > 0) {
+        binomials_ = std::make_shared<std::vector<std::size_t>>(make_binomial_table(num_elements_ + ploidy_ - 1, ploidy_));
+        size_ = choose(num_elements_ + ploidy_ - 1, ploidy_);
+    }
+}
+
+unsigned GenotypeIndexRange::num_elements() const noexcept
+{
+    return num_elements_;
+}
+
+unsigned GenotypeIndexRange::ploidy() const noexcept
+{
+    return ploidy_;
+}
+
+GenotypeIndexRange::size_type GenotypeIndexRange::size() const noexcept
+{
+    return size_;
+}
+
+bool GenotypeIndexRange::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+GenotypeIndexRange::Iterator GenotypeIndexRange::begin() const
+{
+    return Iterator {*this, 0};
+}
+
+GenotypeIndexRange::Iterator GenotypeIndexRange::end() const
+{
+    return Iterator {*this, size_};
+}
+
+GenotypeIndexRange::Iterator GenotypeIndexRange::cbegin() const
+{
+    return begin();
+}
+
+GenotypeIndexRange::Iterator GenotypeIndexRange::cend() const
+{
+    return end();
+}
+
+GenotypeIndex GenotypeIndexRange::operator[](const RankType rank) const
+{
+    GenotypeIndex result {};
+    unrank(rank, result);
+    return result;
+}
+
+// Genotype indices are stored in non-increasing order (i.e. indices[0] is the largest). Mapping each
+// index i to (n - 1 - i) gives a non-decreasing multiset whose colex rank is the reverse of the lexicographic
+// rank of the original, which is the enumeration order of generate_all_genotypes.
+
+void GenotypeIndexRange::unrank(const RankType rank, GenotypeIndex& result) const
+{
+    assert(rank < size_);
+    result.resize(ploidy_);
+    auto r = size_ - 1 - rank;
+    for (unsigned j {ploidy_}; j-- > 0;) {
+        // find the largest d in [j, n - 1 + j] with choose(d, j + 1) <= r
+        unsigned lo {j}, hi {num_elements_ - 1 + j};
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo + 1) / 2;
+            if (choose(mid, j + 1) <= r) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        r -= choose(lo, j + 1);
+        result[j] = num_elements_ - 1 - (lo - j);
+    }
+}
+
+GenotypeIndexRange::RankType GenotypeIndexRange::rank(const GenotypeIndex& genotype) const
+{
+    assert(genotype.size() == ploidy_);
+    assert(std::is_sorted(std::crbegin(genotype), std::crend(genotype)));
+    RankType result {0};
+    for (unsigned j {0}; j < ploidy_; ++j) {
+        assert(genotype[j] < num_elements_);
+        result += choose(num_elements_ - 1 - genotype[j] + j, j + 1);
+    }
+    return size_ - 1 - result;
+}
+
+GenotypeIndexRange::RankType GenotypeIndexRange::homozygous_rank(const unsigned element_index) const
+{
+    return rank(GenotypeIndex(ploidy_, element_index));
+}
+
+std::vector<GenotypeIndex> GenotypeIndexRange::materialise() const
+{
+    return {begin(), end()};
+}
+
+std::vector<GenotypeIndex> GenotypeIndexRange::materialise(const std::vector<RankType>& ranks) const
+{
+    std::vector<GenotypeIndex> result(ranks.size());
+    std::transform(std::cbegin(ranks), std::cend(ranks), std::begin(result),
+                   [this] (auto rank) { return (*this)[rank]; });
+    return result;
+}
+
+// private methods
+
+std::size_t GenotypeIndexRange::choose(const unsigned n, const unsigned k) const noexcept
+{
+    assert(binomials_);
+    if (k > n) return 0;
+    return (*binomials_)[n * (ploidy_ + 1) + k];
+}
+
+void GenotypeIndexRange::next(GenotypeIndex& indices) const noexcept
+{
+    // Same successor function as detail::do_generate_all_genotypes
+    if (++indices[0] == num_elements_) {
+        unsigned i {0};
+        while (++i < ploidy_ && indices[i] == num_elements_ - 1);
+        assert(i < ploidy_);
+        ++indices[i];
+        std::fill_n(std::begin(indices), i, indices[i]);
+    }
+}
+
+// non-member methods
+
+Genotype<Haplotype>
+materialise(const GenotypeIndex& genotype, const std::vector<std::shared_ptr<Haplotype>>& haplotypes)
+{
+    Genotype<Haplotype> result {static_cast<unsigned>(genotype.size())};
+    for (const auto idx : genotype) {
+        result.emplace(haplotypes[idx]);
+    }
+    return result;
+}
+
+std::vector<Genotype<Haplotype>>
+materialise(const GenotypeIndexRange& genotypes, const std::vector<GenotypeIndexRange::RankType>& ranks,
+            const std::vector<std::shared_ptr<Haplotype>>& haplotypes)
+{
+    std::vector<Genotype<Haplotype>> result {};
+    result.reserve(ranks.size());
+    GenotypeIndex buffer {};
+    for (const auto rank : ranks) {
+        genotypes.unrank(rank, buffer);
+        result.push_back(materialise(buffer, haplotypes));
+    }
+    return result;
+}
+
+} // namespace octopus
@@ -0,0 +1,133 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef genotype_index_range_hpp
+#define genotype_index_range_hpp
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+
+#include "genotype.hpp"
+#include "haplotype.hpp"
+
+namespace octopus {
+
+/*
+ Lazily enumerates every genotype of a given ploidy over a set of elements without materialising
+ Genotype objects. Genotypes are identified by their rank in the combinatorial number system
+ (multiset combinations of element indices), so a single std::size_t is a complete, packed
+ description of a genotype. Ranks follow the same order as generate_all_genotypes, so a rank
+ indexes into vectors computed from either representation, and GenotypeIndex values produced
+ here are identical to those produced by generate_all_genotypes(elements, ploidy, indices).
+
+ Iteration reuses a single GenotypeIndex buffer, so dereferenced values are only valid until the
+ iterator is next advanced.
+ */
+class GenotypeIndexRange
+{
+public:
+    using RankType = std::size_t;
+
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = GenotypeIndex;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const GenotypeIndex*;
+        using reference         = const GenotypeIndex&;
+
+        Iterator() = default;
+
+        Iterator(const Iterator&)            = default;
+        Iterator& operator=(const Iterator&) = default;
+        Iterator(Iterator&&)                 = default;
+        Iterator& operator=(Iterator&&)      = default;
+
+        ~Iterator() = default;
+
+        reference operator*() const noexcept { return indices_; }
+        pointer operator->() const noexcept { return &indices_; }
+
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator+=(difference_type n);
+
+        RankType rank() const noexcept { return rank_; }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.rank_ == rhs.rank_; }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept { return !(lhs == rhs); }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.rank_) - static_cast<difference_type>(rhs.rank_);
+        }
+
+    private:
+        friend GenotypeIndexRange;
+
+        Iterator(const GenotypeIndexRange& range, RankType rank);
+
+        const GenotypeIndexRange* range_ = nullptr;
+        RankType rank_ = 0;
+        GenotypeIndex indices_ = {};
+    };
+
+    using iterator       = Iterator;
+    using const_iterator = Iterator;
+    using value_type     = GenotypeIndex;
+    using size_type      = std::size_t;
+
+    GenotypeIndexRange() = default;
+
+    GenotypeIndexRange(unsigned num_elements, unsigned ploidy);
+
+    GenotypeIndexRange(const GenotypeIndexRange&)            = default;
+    GenotypeIndexRange& operator=(const GenotypeIndexRange&) = default;
+    GenotypeIndexRange(GenotypeIndexRange&&)                 = default;
+    GenotypeIndexRange& operator=(GenotypeIndexRange&&)      = default;
+
+    ~GenotypeIndexRange() = default;
+
+    unsigned num_elements() const noexcept;
+    unsigned ploidy() const noexcept;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+    Iterator begin() const;
+    Iterator end() const;
+    Iterator cbegin() const;
+    Iterator cend() const;
+
+    GenotypeIndex operator[](RankType rank) const;
+
+    void unrank(RankType rank, GenotypeIndex& result) const;
+    RankType rank(const GenotypeIndex& genotype) const;
+
+    // The rank of the genotype with ploidy copies of the given element
+    RankType homozygous_rank(unsigned element_index) const;
+
+    std::vector<GenotypeIndex> materialise() const;
+    std::vector<GenotypeIndex> materialise(const std::vector<RankType>& ranks) const;
+
+private:
+    unsigned num_elements_ = 0, ploidy_ = 0;
+    size_type size_ = 0;
+    // binomial coefficient table; shared so iterators and copies are cheap
+    std::shared_ptr<const std::vector<std::size_t>> binomials_;
+
+    std::size_t choose(unsigned n, unsigned k) const noexcept;
+    void next(GenotypeIndex& indices) const noexcept;
+};
+
+Genotype<Haplotype>
+materialise(const GenotypeIndex& genotype, const std::vector<std::shared_ptr<Haplotype>>& haplotypes);
+
+std::vector<Genotype<Haplotype>>
+materialise(const GenotypeIndexRange& genotypes, const std::vector<GenotypeIndexRange::RankType>& ranks,
+            const std::vector<std::shared_ptr<Haplotype>>& haplotypes);
+
+} // namespace octopus
+
+#endif
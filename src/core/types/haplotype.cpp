@@ -5,6 +5,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <numeric>
+#include <tuple>
 #include <stdexcept>
 #include <iostream>
 #include <cassert>
@@ -107,17 +109,11 @@ bool Haplotype::includes(const ContigAllele& allele) const
             return std::binary_search(std::cbegin(explicit_alleles_), std::cend(explicit_alleles_), allele);
         } else if (overlaps(explicit_allele_region_, allele)) {
             return false;
-        } else if (is_after(allele, explicit_allele_region_)) {
-            if (is_indel(allele)) return false;
-            const auto ref_ritr = std::next(std::crbegin(sequence_), end_distance(allele, region_.contig_region()));
-            assert(static_cast<std::size_t>(std::distance(ref_ritr, std::crend(sequence_))) >= allele.sequence().size());
-            return std::equal(std::crbegin(allele.sequence()), std::crend(allele.sequence()), ref_ritr);
         }
     }
+    // The allele is in a reference flank
     if (is_indel(allele)) return false;
-    const auto ref_itr = std::next(std::cbegin(sequence_), begin_distance(region_.contig_region(), allele));
-    assert(static_cast<std::size_t>(std::distance(ref_itr, std::cend(sequence_))) >= allele.sequence().size());
-    return std::equal(std::cbegin(allele.sequence()), std::cend(allele.sequence()), ref_itr);
+    return std::equal(std::cbegin(allele.sequence()), std::cend(allele.sequence()), reference_begin(allele.mapped_region()));
 }
 
 bool Haplotype::includes(const Allele& allele) const
@@ -148,7 +144,7 @@ Haplotype::NucleotideSequence Haplotype::sequence(const ContigRegion& region) co
         throw std::out_of_range {"Haplotype: attempting to sequence from region not contained by Haplotype region"};
     }
     if (explicit_alleles_.empty()) {
-        return sequence_.substr(begin_distance(region_.contig_region(), region), region_size(region));
+        return fetch_reference_sequence(region);
     }
     if (is_in_reference_flank(region, explicit_allele_region_, explicit_alleles_)) {
         return fetch_reference_sequence(region);
@@ -200,9 +196,10 @@ Haplotype::NucleotideSequence Haplotype::sequence(const GenomicRegion& region) c
     return sequence(region.contig_region());
 }
 
-const Haplotype::NucleotideSequence& Haplotype::sequence() const noexcept
+const Haplotype::NucleotideSequence& Haplotype::sequence() const
 {
-    return sequence_;
+    std::call_once(sequence_->materialised, [this] () { sequence_->sequence = materialise(); });
+    return sequence_->sequence;
 }
 
 Haplotype::NucleotideSequence::size_type Haplotype::sequence_size(const ContigRegion& region) const
@@ -236,7 +233,7 @@ CigarString Haplotype::cigar() const
     using Flag = CigarOperation::Flag;
     CigarString result {};
     if (!explicit_alleles_.empty()) {
-        const auto reference = reference_.get().fetch_sequence(GenomicRegion {region_.contig_name(), explicit_allele_region_});
+        const auto reference = fetch_reference_sequence(explicit_allele_region_);
         result.reserve(2 * explicit_alleles_.size() + 2);
         auto curr_op_size = begin_distance(region_.contig_region(), explicit_allele_region_);
         auto curr_op_flag = Flag::sequenceMatch;
@@ -325,7 +322,7 @@ CigarString Haplotype::cigar() const
     } else {
         result.emplace_back(size(region_), Flag::sequenceMatch);
     }
-    assert(octopus::sequence_size(result) == sequence_.size());
+    assert(octopus::sequence_size(result) == octopus::sequence_size(*this));
     assert(reference_size(result) == size(region_));
     return result;
 }
@@ -337,6 +334,116 @@ std::size_t Haplotype::get_hash() const noexcept
 
 // private methods
 
+namespace {
+
+struct ReferenceWindowCache
+{
+    boost::optional<ReferenceGenome::Id> reference;
+    GenomicRegion::ContigName contig;
+    ContigRegion region;
+    std::shared_ptr<const Haplotype::NucleotideSequence> sequence;
+};
+
+// Haplotypes are usually made in batches over the same region, so each thread keeps the last
+// reference window it fetched and shares it while it contains the requested region.
+auto get_reference_window(const ReferenceGenome& reference, const GenomicRegion& region)
+{
+    thread_local ReferenceWindowCache cache {};
+    if (!cache.sequence || cache.reference != reference.id() || cache.contig != region.contig_name()
+        || !contains(cache.region, region.contig_region())) {
+        cache.reference = reference.id();
+        cache.contig    = region.contig_name();
+        cache.region    = region.contig_region();
+        cache.sequence  = std::make_shared<const Haplotype::NucleotideSequence>(reference.fetch_sequence(region));
+    }
+    return std::make_pair(cache.region, cache.sequence);
+}
+
+} // namespace
+
+void Haplotype::init()
+{
+    if (explicit_alleles_.empty()) {
+        init(NucleotideSequence {});
+        return;
+    }
+    NucleotideSequence explicit_sequence {};
+    explicit_sequence.reserve(std::accumulate(std::cbegin(explicit_alleles_), std::cend(explicit_alleles_), std::size_t {0},
+                                              [] (const auto curr, const auto& allele) {
+                                                  return curr + ::octopus::sequence_size(allele);
+                                              }));
+    append(explicit_sequence, std::cbegin(explicit_alleles_), std::cend(explicit_alleles_));
+    std::tie(reference_window_.region, reference_window_.sequence) = get_reference_window(reference_, region_);
+    const auto reference = reference_begin(region_.contig_region());
+    const auto reference_size = static_cast<SequenceSize>(region_size(region_));
+    const auto explicit_offset = static_cast<SequenceSize>(begin_distance(region_.contig_region(), explicit_allele_region_));
+    const auto explicit_reference_size = static_cast<SequenceSize>(region_size(explicit_allele_region_));
+    const auto explicit_size = explicit_sequence.size();
+    const auto haplotype_size = reference_size - explicit_reference_size + explicit_size;
+    const auto base = [&] (const SequenceSize idx) {
+        if (idx < explicit_offset) return reference[idx];
+        if (idx < explicit_offset + explicit_size) return explicit_sequence[idx - explicit_offset];
+        return reference[idx - explicit_size + explicit_reference_size];
+    };
+    // Trim the longest common prefix and then suffix of the haplotype and reference sequences.
+    // The reference flanks always match so only the explicit sequence needs checking.
+    const auto max_trim_size = std::min(haplotype_size, reference_size);
+    auto prefix_size = explicit_offset;
+    while (prefix_size < max_trim_size && base(prefix_size) == reference[prefix_size]) ++prefix_size;
+    auto suffix_size = std::min(reference_size - explicit_offset - explicit_reference_size, max_trim_size - prefix_size);
+    while (prefix_size + suffix_size < max_trim_size
+           && base(haplotype_size - suffix_size - 1) == reference[reference_size - suffix_size - 1]) {
+        ++suffix_size;
+    }
+    delta_.core_offset = prefix_size;
+    delta_.core_reference_size = reference_size - prefix_size - suffix_size;
+    delta_.core_sequence.clear();
+    delta_.core_sequence.reserve(haplotype_size - prefix_size - suffix_size);
+    for (auto idx = prefix_size; idx < haplotype_size - suffix_size; ++idx) {
+        delta_.core_sequence.push_back(base(idx));
+    }
+    cached_hash_ = 0;
+    using boost::hash_combine;
+    hash_combine(cached_hash_, delta_.core_offset);
+    hash_combine(cached_hash_, delta_.core_reference_size);
+    hash_combine(cached_hash_, std::hash<NucleotideSequence>()(delta_.core_sequence));
+}
+
+void Haplotype::init(NucleotideSequence sequence)
+{
+    if (!sequence.empty() || !explicit_alleles_.empty()) {
+        // sequence is the full haplotype sequence and the only explicit allele, so it can be kept
+        init();
+        std::call_once(sequence_->materialised, [&] () { sequence_->sequence = std::move(sequence); });
+        return;
+    }
+    // A reference haplotype
+    std::tie(reference_window_.region, reference_window_.sequence) = get_reference_window(reference_, region_);
+    delta_ = Delta {static_cast<SequenceSize>(region_size(region_)), 0, {}};
+    cached_hash_ = 0;
+    boost::hash_combine(cached_hash_, delta_.core_offset);
+    boost::hash_combine(cached_hash_, delta_.core_reference_size);
+    boost::hash_combine(cached_hash_, std::hash<NucleotideSequence>()(delta_.core_sequence));
+}
+
+Haplotype::NucleotideSequence::const_iterator Haplotype::reference_begin(const ContigRegion& region) const
+{
+    assert(::octopus::contains(reference_window_.region, region));
+    return std::next(std::cbegin(*reference_window_.sequence), begin_distance(reference_window_.region, region));
+}
+
+Haplotype::NucleotideSequence Haplotype::materialise() const
+{
+    NucleotideSequence result {};
+    result.reserve(octopus::sequence_size(*this));
+    const auto reference = reference_begin(region_.contig_region());
+    const auto core_reference_end = delta_.core_offset + delta_.core_reference_size;
+    result.append(reference, std::next(reference, delta_.core_offset));
+    result.append(delta_.core_sequence);
+    result.append(std::next(reference, core_reference_end), std::next(reference, region_size(region_)));
+    return result;
+}
+
 void Haplotype::append(NucleotideSequence& result, const ContigAllele& allele) const
 {
     result.append(allele.sequence());
@@ -349,15 +456,8 @@ void Haplotype::append(NucleotideSequence& result, AlleleIterator first, AlleleI
 
 void Haplotype::append_reference(NucleotideSequence& result, const ContigRegion& region) const
 {
-    if (is_before(region, explicit_allele_region_)) {
-        const auto offset = begin_distance(region_.contig_region(), region);
-        const auto it = std::next(std::cbegin(sequence_), offset);
-        result.append(it, std::next(it, region_size(region)));
-    } else {
-        const auto offset = end_distance(region, region_.contig_region());
-        const auto it = std::prev(std::cend(sequence_), offset);
-        result.append(std::prev(it, region_size(region)), it);
-    }
+    const auto it = reference_begin(region);
+    result.append(it, std::next(it, region_size(region)));
 }
 
 Haplotype::NucleotideSequence Haplotype::fetch_reference_sequence(const ContigRegion& region) const
@@ -487,7 +587,7 @@ Haplotype Haplotype::Builder::build()
 void Haplotype::Builder::update_region(const ContigAllele& allele) noexcept
 {
     const auto new_contig_region = encompassing_region(region_.contig_region(), allele);
-    region_ = GenomicRegion {region_.contig_name(), new_contig_region};
+    region_ = GenomicRegion {region_.contig_id(), new_contig_region};
 }
 
 void Haplotype::Builder::update_region(const Allele& allele)
@@ -498,19 +598,19 @@ void Haplotype::Builder::update_region(const Allele& allele)
 ContigAllele Haplotype::Builder::get_intervening_reference_allele(const ContigAllele& lhs, const ContigAllele& rhs) const
 {
     const auto region = *intervening_region(lhs, rhs);
-    return ContigAllele {region, reference_.get().fetch_sequence(GenomicRegion {region_.contig_name(), region})};
+    return ContigAllele {region, reference_.get().fetch_sequence(GenomicRegion {region_.contig_id(), region})};
 }
 
 // non-member methods
 
 Haplotype::NucleotideSequence::size_type sequence_size(const Haplotype& haplotype) noexcept
 {
-    return haplotype.sequence().size();
+    return region_size(haplotype) - haplotype.delta_.core_reference_size + haplotype.delta_.core_sequence.size();
 }
 
 bool is_sequence_empty(const Haplotype& haplotype) noexcept
 {
-    return haplotype.sequence().empty();
+    return sequence_size(haplotype) == 0;
 }
 
 bool contains(const Haplotype& lhs, const Allele& rhs)
@@ -585,8 +685,7 @@ ContigAllele copy(const Haplotype& haplotype, const ContigRegion& region)
 
 bool is_reference(const Haplotype& haplotype)
 {
-    if (haplotype.explicit_alleles_.empty()) return true;
-    return haplotype.sequence() == haplotype.reference_.get().fetch_sequence(haplotype.mapped_region());
+    return haplotype.delta_.core_reference_size == 0 && haplotype.delta_.core_sequence.empty();
 }
 
 Haplotype expand(const Haplotype& haplotype, Haplotype::MappingDomain::Size n)
@@ -632,13 +731,39 @@ std::vector<Variant> difference(const Haplotype& lhs, const Haplotype& rhs)
 
 bool operator==(const Haplotype& lhs, const Haplotype& rhs)
 {
-    return lhs.mapped_region() == rhs.mapped_region() && lhs.sequence() == rhs.sequence();
+    // Deltas are canonical so equal sequences have equal deltas
+    return lhs.get_hash() == rhs.get_hash()
+           && lhs.delta_.core_offset == rhs.delta_.core_offset
+           && lhs.delta_.core_reference_size == rhs.delta_.core_reference_size
+           && lhs.mapped_region() == rhs.mapped_region()
+           && lhs.delta_.core_sequence == rhs.delta_.core_sequence;
 }
 
 bool operator<(const Haplotype& lhs, const Haplotype& rhs)
 {
-    return (lhs.mapped_region() == rhs.mapped_region()) ? lhs.sequence() < rhs.sequence() :
-            lhs.mapped_region() < rhs.mapped_region();
+    if (lhs.mapped_region() != rhs.mapped_region()) return lhs.mapped_region() < rhs.mapped_region();
+    // Lexicographical sequence comparison without materialising either sequence. Both sequences are
+    // the same reference up to the first core.
+    const auto& lhs_delta = lhs.delta_;
+    const auto& rhs_delta = rhs.delta_;
+    const auto reference = lhs.reference_begin(lhs.region_.contig_region());
+    const auto base = [&reference] (const Haplotype::Delta& delta, const std::size_t idx) {
+        if (idx < delta.core_offset) return reference[idx];
+        if (idx < delta.core_offset + delta.core_sequence.size()) return delta.core_sequence[idx - delta.core_offset];
+        return reference[idx - delta.core_sequence.size() + delta.core_reference_size];
+    };
+    const auto lhs_size = sequence_size(lhs), rhs_size = sequence_size(rhs);
+    const auto cores_end = std::max(lhs_delta.core_offset + lhs_delta.core_sequence.size(),
+                                    rhs_delta.core_offset + rhs_delta.core_sequence.size());
+    for (auto idx = std::min(lhs_delta.core_offset, rhs_delta.core_offset); idx < std::min(lhs_size, rhs_size); ++idx) {
+        if (idx >= cores_end && lhs_size == rhs_size) {
+            // Past both cores the sequences are the same reference suffix
+            return false;
+        }
+        const auto lhs_base = base(lhs_delta, idx), rhs_base = base(rhs_delta, idx);
+        if (lhs_base != rhs_base) return lhs_base < rhs_base;
+    }
+    return lhs_size < rhs_size;
 }
 
 bool HaveSameAlleles::operator()(const Haplotype &lhs, const Haplotype &rhs) const
@@ -5,6 +5,9 @@
 #define haplotype_hpp
 
 #include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
 #include <cstddef>
 #include <functional>
 #include <type_traits>
@@ -84,7 +87,8 @@ public:
     
     NucleotideSequence sequence(const ContigRegion& region) const;
     NucleotideSequence sequence(const GenomicRegion& region) const;
-    const NucleotideSequence& sequence() const noexcept;
+    // The full sequence is materialised on first use and then shared by all copies
+    const NucleotideSequence& sequence() const;
     
     NucleotideSequence::size_type sequence_size(const ContigRegion& region) const;
     NucleotideSequence::size_type sequence_size(const GenomicRegion& region) const;
@@ -94,6 +98,9 @@ public:
     
     std::size_t get_hash() const noexcept;
     
+    friend Haplotype::NucleotideSequence::size_type sequence_size(const Haplotype& haplotype) noexcept;
+    friend bool operator==(const Haplotype& lhs, const Haplotype& rhs);
+    friend bool operator<(const Haplotype& lhs, const Haplotype& rhs);
     friend struct HaveSameAlleles;
     friend struct IsLessComplex;
     
@@ -107,15 +114,47 @@ public:
     template <typename S> friend void debug::print_variant_alleles(S&&, const Haplotype&);
     
 private:
+    using SequenceSize = NucleotideSequence::size_type;
+    
+    // An immutable reference sequence shared by all haplotypes built in the same window
+    struct ReferenceWindow
+    {
+        ContigRegion region;
+        std::shared_ptr<const NucleotideSequence> sequence;
+    };
+    
+    // The haplotype sequence differs from the reference only in the core: the haplotype sequence
+    // is the first core_offset reference bases, then core_sequence, then the reference after
+    // core_reference_size more bases. The core is trimmed of reference-matching bases, so it is
+    // the same for every allele representation of the same sequence.
+    struct Delta
+    {
+        SequenceSize core_offset, core_reference_size;
+        NucleotideSequence core_sequence;
+    };
+    
+    // The full haplotype sequence, built on first use and shared by copies
+    struct LazySequence
+    {
+        std::once_flag materialised;
+        NucleotideSequence sequence;
+    };
+    
     GenomicRegion region_;
     std::vector<ContigAllele> explicit_alleles_;
     ContigRegion explicit_allele_region_;
-    NucleotideSequence sequence_;
+    ReferenceWindow reference_window_;
+    Delta delta_;
+    std::shared_ptr<LazySequence> sequence_;
     std::size_t cached_hash_;
     std::reference_wrapper<const ReferenceGenome> reference_;
     
     using AlleleIterator = decltype(explicit_alleles_)::const_iterator;
     
+    void init();
+    void init(NucleotideSequence sequence);
+    NucleotideSequence::const_iterator reference_begin(const ContigRegion& region) const;
+    NucleotideSequence materialise() const;
     void append(NucleotideSequence& result, const ContigAllele& allele) const;
     void append(NucleotideSequence& result, AlleleIterator first, AlleleIterator last) const;
     void append_reference(NucleotideSequence& result, const ContigRegion& region) const;
@@ -127,32 +166,30 @@ Haplotype::Haplotype(R&& region, const ReferenceGenome& reference)
 : region_ {std::forward<R>(region)}
 , explicit_alleles_ {}
 , explicit_allele_region_ {}
-, sequence_ {reference.fetch_sequence(region_)}
-, cached_hash_ {std::hash<NucleotideSequence>()(sequence_)}
+, reference_window_ {}
+, delta_ {}
+, sequence_ {std::make_shared<LazySequence>()}
+, cached_hash_ {0}
 , reference_ {reference}
-{}
+{
+    init();
+}
 
 template <typename R, typename S>
 Haplotype::Haplotype(R&& region, S&& sequence, const ReferenceGenome& reference)
 : region_ {std::forward<R>(region)}
 , explicit_alleles_ {}
 , explicit_allele_region_ {region_.contig_region()}
-, sequence_ {std::forward<S>(sequence)}
-, cached_hash_ {std::hash<NucleotideSequence>()(sequence_)}
+, reference_window_ {}
+, delta_ {}
+, sequence_ {std::make_shared<LazySequence>()}
+, cached_hash_ {0}
 , reference_ {reference}
 {
+    NucleotideSequence haplotype_sequence {std::forward<S>(sequence)};
     explicit_alleles_.reserve(1);
-    explicit_alleles_.emplace_back(explicit_allele_region_, sequence_);
-}
-
-namespace detail {
-    template <typename T>
-    void append(T& result, const ReferenceGenome& reference,
-                const GenomicRegion::ContigName& contig,
-                const ContigRegion& region)
-    {
-        result.append(reference.fetch_sequence(GenomicRegion {contig, region}));
-    }
+    explicit_alleles_.emplace_back(explicit_allele_region_, haplotype_sequence);
+    init(std::move(haplotype_sequence));
 }
 
 template <typename R, typename ForwardIt>
@@ -161,35 +198,16 @@ Haplotype::Haplotype(R&& region, ForwardIt first_allele, ForwardIt last_allele,
 : region_ {std::forward<R>(region)}
 , explicit_alleles_ {first_allele, last_allele}
 , explicit_allele_region_ {}
-, sequence_ {}
+, reference_window_ {}
+, delta_ {}
+, sequence_ {std::make_shared<LazySequence>()}
 , cached_hash_ {0}
 , reference_ {reference}
 {
     if (!explicit_alleles_.empty()) {
         explicit_allele_region_ = encompassing_region(explicit_alleles_.front(), explicit_alleles_.back());
-        auto num_bases = std::accumulate(std::cbegin(explicit_alleles_), std::cend(explicit_alleles_),
-                                         0, [] (const auto curr, const auto& allele) {
-                                             return curr + ::octopus::sequence_size(allele);
-                                         });
-        const auto lhs_reference_region = left_overhang_region(region_.contig_region(),
-                                                               explicit_allele_region_);
-        const auto rhs_reference_region = right_overhang_region(region_.contig_region(),
-                                                                explicit_allele_region_);
-        num_bases += region_size(lhs_reference_region) + region_size(rhs_reference_region);
-        
-        sequence_.reserve(num_bases);
-        const auto& contig = region_.contig_name();
-        if (!is_empty(lhs_reference_region)) {
-            detail::append(sequence_, reference, contig, lhs_reference_region);
-        }
-        append(sequence_, std::cbegin(explicit_alleles_), std::cend(explicit_alleles_));
-        if (!is_empty(rhs_reference_region)) {
-            detail::append(sequence_, reference, contig, rhs_reference_region);
-        }
-    } else {
-        sequence_ = reference.fetch_sequence(region_);
     }
-    cached_hash_ = std::hash<NucleotideSequence>()(sequence_);
+    init();
 }
 
 class Haplotype::Builder
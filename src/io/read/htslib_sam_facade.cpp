@@ -175,6 +175,7 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
 , hts_index_ {(hts_file_) ? sam_index_load(hts_file_.get(), file_path_.c_str()) : nullptr, HtsIndexDeleter {}}
 , hts_targets_ {}
 , contig_names_ {}
+, contig_ids_ {}
 , sample_names_ {}
 , samples_ {}
 {
@@ -506,11 +507,12 @@ bool try_reserve(Container& c, const std::size_t max, const std::size_t min)
 
 } // namespace
 
-HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion& region) const
+HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion& region,
+                                                            const ReadPrefilter& prefilter) const
 {
     SampleReadMap result {samples_.size()};
     if (samples_.size() == 1) {
-        return {{samples_.front(), fetch_reads(samples_.front(), region)}};
+        return {{samples_.front(), fetch_reads(samples_.front(), region, prefilter)}};
     }
     HtslibIterator it {*this, region};
     for (const auto& sample : samples_) {
@@ -518,6 +520,7 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion&
         try_reserve(p.first->second, defaultReserve_, defaultReserve_ / 10);
     }
     while (++it) {
+        if (!it.passes(prefilter)) continue;
         try {
             result.at(sample_names_.at(it.read_group())).emplace_back(*it);
         } catch (InvalidBamRecord& e) {
@@ -530,15 +533,16 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const GenomicRegion&
     return result;
 }
 
-HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
+HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_reads(const SampleName& sample, const GenomicRegion& region,
+                                                            const ReadPrefilter& prefilter) const
 {
     if (!contains(samples_, sample)) return {};
-    if (samples_.size() == 1) return fetch_all_reads(region);
+    if (samples_.size() == 1) return fetch_all_reads(region, prefilter);
     HtslibIterator it {*this, region};
     ReadContainer result {};
     try_reserve(result, defaultReserve_, defaultReserve_ / 10);
     while (++it) {
-        if (sample_names_.at(it.read_group()) == sample) {
+        if (it.passes(prefilter) && sample_names_.at(it.read_group()) == sample) {
             try {
                 result.emplace_back(*it);
             } catch (InvalidBamRecord& e) {
@@ -552,12 +556,13 @@ HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_reads(const SampleName& sa
 }
 
 HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const std::vector<SampleName>& samples,
-                                                            const GenomicRegion& region) const
+                                                            const GenomicRegion& region,
+                                                            const ReadPrefilter& prefilter) const
 {
     if (samples.size() == 1) {
-        return {{samples.front(), fetch_reads(samples.front(), region)}};
+        return {{samples.front(), fetch_reads(samples.front(), region, prefilter)}};
     }
-    if (is_subset(samples_, samples)) return fetch_reads(region);
+    if (is_subset(samples_, samples)) return fetch_reads(region, prefilter);
     HtslibIterator it {*this, region};
     SampleReadMap result {samples.size()};
     for (const auto& sample : samples) {
@@ -570,6 +575,7 @@ HtslibSamFacade::SampleReadMap HtslibSamFacade::fetch_reads(const std::vector<Sa
     }
     if (result.empty()) return result; // no matching samples
     while (++it) {
+        if (!it.passes(prefilter)) continue;
         const auto& sample = sample_names_.at(it.read_group());
         if (result.count(sample) == 1) {
             try {
@@ -609,6 +615,64 @@ boost::optional<std::vector<GenomicRegion::ContigName>> HtslibSamFacade::mapped_
     return result;
 }
 
+boost::optional<std::size_t> HtslibSamFacade::count_mapped_reads(const GenomicRegion::ContigName& contig) const
+{
+    // CRAM indices do not record mapped read counts
+    if (hts_file_->is_cram || !hts_index_) return boost::none;
+    if (hts_targets_.count(contig) == 0) return 0;
+    std::uint64_t num_mapped {}, num_unmapped {};
+    if (hts_idx_get_stat(hts_index_.get(), get_htslib_target(contig), &num_mapped, &num_unmapped) < 0) {
+        return boost::none;
+    }
+    return static_cast<std::size_t>(num_mapped);
+}
+
+namespace {
+
+// BGZF virtual offsets hold the compressed block offset in the upper 48 bits and the offset into
+// the uncompressed block in the lower 16 bits
+constexpr double approxBgzfCompressionRatio {3.0};
+
+double estimate_compressed_bytes(const hts_idx_t* index, const int tid,
+                                 const GenomicRegion::Position begin, const GenomicRegion::Position end)
+{
+    std::unique_ptr<hts_itr_t, decltype(&hts_itr_destroy)> itr {sam_itr_queryi(index, tid, begin, end), hts_itr_destroy};
+    if (!itr) return 0;
+    double result {0};
+    for (int i {0}; i < itr->n_off; ++i) {
+        const auto& chunk = itr->off[i];
+        result += static_cast<double>(chunk.v >> 16) - static_cast<double>(chunk.u >> 16);
+        result += (static_cast<double>(chunk.v & 0xffff) - static_cast<double>(chunk.u & 0xffff)) / approxBgzfCompressionRatio;
+    }
+    return std::max(result, 0.0);
+}
+
+} // namespace
+
+boost::optional<std::vector<double>>
+HtslibSamFacade::estimate_read_counts(const GenomicRegion& region, const GenomicRegion::Size bin_size) const
+{
+    // The index chunks overlapping each bin give the compressed bytes of the reads in the bin, which
+    // are converted to reads with the contig mapped read count from the index statistics
+    const auto num_contig_reads = count_mapped_reads(region.contig_name());
+    if (!num_contig_reads) return boost::none;
+    std::vector<double> result((size(region) + bin_size - 1) / bin_size, 0.0);
+    if (*num_contig_reads == 0) return result;
+    const auto tid = get_htslib_target(region.contig_name());
+    auto reads_per_byte_itr = reads_per_index_byte_.find(tid);
+    if (reads_per_byte_itr == std::cend(reads_per_index_byte_)) {
+        const auto contig_bytes = estimate_compressed_bytes(hts_index_.get(), tid, 0, hts_header_->target_len[tid]);
+        const auto reads_per_byte = contig_bytes > 0 ? *num_contig_reads / contig_bytes : 0.0;
+        reads_per_byte_itr = reads_per_index_byte_.emplace(tid, reads_per_byte).first;
+    }
+    for (std::size_t bin {0}; bin < result.size(); ++bin) {
+        const auto bin_begin = region.begin() + bin * bin_size;
+        const auto bin_end = std::min(bin_begin + bin_size, region.end());
+        result[bin] = reads_per_byte_itr->second * estimate_compressed_bytes(hts_index_.get(), tid, bin_begin, bin_end);
+    }
+    return result;
+}
+
 void HtslibSamFacade::write(const AlignedRead& read)
 {
     if (!hts_file_ || !hts_header_) {
@@ -626,12 +690,14 @@ void HtslibSamFacade::write(const AlignedRead& read)
 
 // private methods
 
-HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_all_reads(const GenomicRegion& region) const
+HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_all_reads(const GenomicRegion& region,
+                                                                const ReadPrefilter& prefilter) const
 {
     HtslibIterator it {*this, region};
     ReadContainer result {};
     try_reserve(result, defaultReserve_, defaultReserve_ / 10);
     while (++it) {
+        if (!it.passes(prefilter)) continue;
         try {
             result.emplace_back(*it);
         } catch (InvalidBamRecord& e) {
@@ -666,10 +732,12 @@ void HtslibSamFacade::init_maps()
 {
     hts_targets_.reserve(hts_header_->n_targets);
     contig_names_.reserve(hts_header_->n_targets);
+    contig_ids_.reserve(hts_header_->n_targets);
     
     for (HtsTid target {0}; target < hts_header_->n_targets; ++target) {
         hts_targets_.emplace(hts_header_->target_name[target], target);
         contig_names_.emplace(target, hts_header_->target_name[target]);
+        contig_ids_.emplace(target, intern_contig(hts_header_->target_name[target]));
     }
     
     const std::string header_text(hts_header_->text, hts_header_->l_text);
@@ -714,6 +782,11 @@ const std::string& HtslibSamFacade::get_contig_name(HtsTid target) const
     return contig_names_.at(target);
 }
 
+GenomicRegion::ContigId HtslibSamFacade::get_contig_id(HtsTid target) const
+{
+    return contig_ids_.at(target);
+}
+
 // HtslibIterator
 
 auto make_hts_iterator(const hts_idx_t* idx, bam_hdr_t* hdr, const GenomicRegion& region)
@@ -884,18 +957,18 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
         read_begin_tmp = 0;
     }
     const auto read_begin = static_cast<AlignedRead::MappingDomain::Position>(read_begin_tmp);
-    const auto& contig_name = hts_facade_.get_contig_name(info.tid);
+    const auto contig_id = hts_facade_.get_contig_id(info.tid);
     if (has_multiple_segments(info)) {
         return AlignedRead {
             extract_read_name(hts_bam1_.get()),
-            GenomicRegion {contig_name, read_begin, read_begin + octopus::reference_size<AlignedRead::MappingDomain::Position>(cigar)},
+            GenomicRegion {contig_id, read_begin, read_begin + octopus::reference_size<AlignedRead::MappingDomain::Position>(cigar)},
             move(sequence),
             move(qualities),
             move(cigar),
             mapping_quality(info),
             extract_flags(info),
             read_group(),
-            hts_facade_.get_contig_name(info.mtid),
+            hts_facade_.get_contig_id(info.mtid),
             next_segment_position(info),
             template_length(info),
             extract_next_segment_flags(info)
@@ -903,7 +976,7 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
     } else {
         return AlignedRead {
             extract_read_name(hts_bam1_.get()),
-            GenomicRegion {contig_name, read_begin, read_begin + octopus::reference_size<AlignedRead::MappingDomain::Size>(cigar)},
+            GenomicRegion {contig_id, read_begin, read_begin + octopus::reference_size<AlignedRead::MappingDomain::Size>(cigar)},
             move(sequence),
             move(qualities),
             move(cigar),
@@ -938,6 +1011,20 @@ bool HtslibSamFacade::HtslibIterator::is_good() const noexcept
                        [] (const auto op) { return bam_cigar_oplen(op) > 0; });
 }
 
+bool HtslibSamFacade::HtslibIterator::passes(const ReadPrefilter& prefilter) const noexcept
+{
+    const auto& info = hts_bam1_->core;
+    decltype(info.flag) rejected_flags {0};
+    if (prefilter.skip_unmapped)      rejected_flags |= BAM_FUNMAP;
+    if (prefilter.skip_secondary)     rejected_flags |= BAM_FSECONDARY;
+    if (prefilter.skip_supplementary) rejected_flags |= BAM_FSUPPLEMENTARY;
+    if (prefilter.skip_duplicates)    rejected_flags |= BAM_FDUP;
+    if (prefilter.skip_qc_fail)       rejected_flags |= BAM_FQCFAIL;
+    return (info.flag & rejected_flags) == 0
+           && mapping_quality(info) >= prefilter.min_mapping_quality
+           && static_cast<ReadPrefilter::Length>(extract_sequence_length(hts_bam1_.get())) >= prefilter.min_sequence_size;
+}
+
 std::size_t HtslibSamFacade::HtslibIterator::begin() const noexcept
 {
     return hts_bam1_->core.pos;
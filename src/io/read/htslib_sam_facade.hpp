@@ -82,15 +82,21 @@ public:
                                         const GenomicRegion& region,
                                         std::size_t max_reads) const override;
     
-    SampleReadMap fetch_reads(const GenomicRegion& region) const override;
+    SampleReadMap fetch_reads(const GenomicRegion& region,
+                              const ReadPrefilter& prefilter) const override;
     ReadContainer fetch_reads(const SampleName& sample,
-                              const GenomicRegion& region) const override;
+                              const GenomicRegion& region,
+                              const ReadPrefilter& prefilter) const override;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
-                              const GenomicRegion& region) const override;
+                              const GenomicRegion& region,
+                              const ReadPrefilter& prefilter) const override;
     
     GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const override;
     std::vector<GenomicRegion::ContigName> reference_contigs() const override;
     boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const override;
+    boost::optional<std::size_t> count_mapped_reads(const GenomicRegion::ContigName& contig) const override;
+    boost::optional<std::vector<double>>
+    estimate_read_counts(const GenomicRegion& region, GenomicRegion::Size bin_size) const override;
     
     void write(const AlignedRead& read);
     
@@ -135,6 +141,8 @@ private:
         HtslibSamFacade::ReadGroupIdType read_group() const;
         
         bool is_good() const noexcept;
+        // Checks the undecoded record so rejected reads are never converted
+        bool passes(const ReadPrefilter& prefilter) const noexcept;
         std::size_t begin() const noexcept;
     
     private:
@@ -161,15 +169,19 @@ private:
     
     std::unordered_map<GenomicRegion::ContigName, HtsTid> hts_targets_;
     std::unordered_map<HtsTid, GenomicRegion::ContigName> contig_names_;
+    std::unordered_map<HtsTid, GenomicRegion::ContigId> contig_ids_;
     std::unordered_map<ReadGroupIdType, SampleName> sample_names_;
     
     std::vector<SampleName> samples_;
     
+    mutable std::unordered_map<HtsTid, double> reads_per_index_byte_;
+    
     void init_maps();
     HtsTid get_htslib_target(const GenomicRegion::ContigName& contig) const;
     const GenomicRegion::ContigName& get_contig_name(HtsTid target) const;
+    GenomicRegion::ContigId get_contig_id(HtsTid target) const;
     std::uint64_t get_num_mapped_reads(const GenomicRegion::ContigName& contig) const;
-    ReadContainer fetch_all_reads(const GenomicRegion& region) const;
+    ReadContainer fetch_all_reads(const GenomicRegion& region, const ReadPrefilter& prefilter) const;
     void write(const AlignedRead& read, bam1_t* result) const;
 };
 
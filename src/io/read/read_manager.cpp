@@ -8,6 +8,7 @@
 #include <utility>
 #include <deque>
 #include <numeric>
+#include <functional>
 #include <cassert>
 
 #include <boost/filesystem/operations.hpp>
@@ -265,6 +266,23 @@ std::size_t ReadManager::count_reads(const GenomicRegion& region) const
     return count_reads(samples(), region);
 }
 
+boost::optional<std::size_t> ReadManager::count_mapped_reads(const GenomicRegion::ContigName& contig) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    std::size_t result {0};
+    for (const auto& p : open_readers_) {
+        const auto num_reads = p.second.count_mapped_reads(contig);
+        if (!num_reads) return boost::none;
+        result += *num_reads;
+    }
+    for (const auto& reader_path : closed_readers_) {
+        const auto num_reads = make_reader(reader_path).count_mapped_reads(contig);
+        if (!num_reads) return boost::none;
+        result += *num_reads;
+    }
+    return result;
+}
+
 GenomicRegion ReadManager::find_covered_subregion(const SampleName& sample, const GenomicRegion& region,
                                                   const std::size_t max_reads) const
 {
@@ -288,7 +306,7 @@ auto max_head_region(const CoverageTracker<ContigRegion>& position_tracker, cons
         if (ends_before(region.contig_region(), *tracker_region)) {
             return region;
         } else {
-            return GenomicRegion {region.contig_name(), closed_region(region.contig_region(), *tracker_region)};
+            return GenomicRegion {region.contig_id(), closed_region(region.contig_region(), *tracker_region)};
         }
     } else {
         return region;
@@ -346,6 +364,48 @@ GenomicRegion ReadManager::find_covered_subregion(const GenomicRegion& region, c
     return find_covered_subregion(samples(), region, max_reads);
 }
 
+boost::optional<CoverageEstimate>
+ReadManager::estimate_coverage(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                               const GenomicRegion::Size bin_size) const
+{
+    std::vector<double> bin_counts((size(region) + bin_size - 1) / bin_size, 0.0);
+    std::lock_guard<std::mutex> lock {mutex_};
+    auto reader_paths = get_possible_reader_paths(samples, region);
+    auto reader_itr = partition_open(reader_paths);
+    while (!reader_paths.empty()) {
+        for (auto itr = reader_itr; itr != std::end(reader_paths); ++itr) {
+            const auto reader_counts = open_readers_.at(*itr).estimate_read_counts(region, bin_size);
+            if (!reader_counts) return boost::none;
+            std::transform(std::cbegin(*reader_counts), std::cend(*reader_counts), std::cbegin(bin_counts),
+                           std::begin(bin_counts), std::plus<> {});
+        }
+        reader_paths.erase(reader_itr, std::end(reader_paths));
+        reader_itr = open_readers(std::begin(reader_paths), std::end(reader_paths));
+    }
+    return CoverageEstimate {region, bin_size, bin_counts};
+}
+
+GenomicRegion ReadManager::estimate_covered_subregion(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                                                      const std::size_t max_reads) const
+{
+    // Same resolution as the BAI linear index, estimated a block at a time as the subregion is usually
+    // much smaller than region
+    static constexpr GenomicRegion::Size binSize {16'384}, blockSize {64 * binSize};
+    if (samples.empty() || is_empty(region)) return region;
+    double num_reads {0};
+    for (auto block_begin = region.begin(); block_begin < region.end(); block_begin += blockSize) {
+        const GenomicRegion block {region.contig_name(), block_begin, std::min(block_begin + blockSize, region.end())};
+        const auto estimate = estimate_coverage(samples, block, binSize);
+        if (!estimate) return find_covered_subregion(samples, region, max_reads);
+        if (num_reads + estimate->total() > max_reads) {
+            const auto block_head = estimate->find_covered_subregion(block, max_reads - num_reads);
+            return GenomicRegion {region.contig_id(), region.begin(), block_head.end()};
+        }
+        num_reads += estimate->total();
+    }
+    return region;
+}
+
 namespace {
 
 template <typename Container>
@@ -357,12 +417,13 @@ void merge_insert(Container&& src, Container& dst)
 
 } // namespace
 
-ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
+ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, const GenomicRegion& region,
+                                                    const ReadPrefilter& prefilter) const
 {
     ReadContainer result {};
     if (all_readers_are_open()) {
         for (const auto& p : open_readers_) {
-            merge_insert(p.second.fetch_reads(sample, region), result);
+            merge_insert(p.second.fetch_reads(sample, region, prefilter), result);
         }
     } else {
         std::lock_guard<std::mutex> lock {mutex_};
@@ -371,7 +432,7 @@ ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, co
         while (!reader_paths.empty()) {
             using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
             for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                merge_insert(open_readers_.at(reader_path).fetch_reads(sample, region), result);
+                merge_insert(open_readers_.at(reader_path).fetch_reads(sample, region, prefilter), result);
             });
             reader_paths.erase(reader_itr, end(reader_paths));
             reader_itr = open_readers(begin(reader_paths), end(reader_paths));
@@ -380,7 +441,8 @@ ReadManager::ReadContainer ReadManager::fetch_reads(const SampleName& sample, co
     return result;
 }
 
-ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const
+ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                                                    const ReadPrefilter& prefilter) const
 {
     SampleReadMap result {samples.size()};
     // Populate here so we can make unchecked access
@@ -389,7 +451,7 @@ ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName
     }
     if (all_readers_are_open()) {
         for (const auto& p : open_readers_) {
-            auto reads = p.second.fetch_reads(samples, region);
+            auto reads = p.second.fetch_reads(samples, region, prefilter);
             for (auto&& r : reads) {
                 merge_insert(std::move(r.second), result.at(r.first));
                 r.second.clear();
@@ -403,7 +465,7 @@ ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName
         while (!reader_paths.empty()) {
             using std::begin; using std::end; using std::make_move_iterator; using std::for_each;
             for_each(reader_itr, end(reader_paths), [&] (const auto& reader_path) {
-                auto reads = open_readers_.at(reader_path).fetch_reads(samples, region);
+                auto reads = open_readers_.at(reader_path).fetch_reads(samples, region, prefilter);
                 for (auto&& r : reads) {
                     merge_insert(std::move(r.second), result.at(r.first));
                     r.second.clear();
@@ -417,9 +479,9 @@ ReadManager::SampleReadMap ReadManager::fetch_reads(const std::vector<SampleName
     return result;
 }
 
-ReadManager::SampleReadMap ReadManager::fetch_reads(const GenomicRegion& region) const
+ReadManager::SampleReadMap ReadManager::fetch_reads(const GenomicRegion& region, const ReadPrefilter& prefilter) const
 {
-    return fetch_reads(samples(), region);
+    return fetch_reads(samples(), region, prefilter);
 }
 
 // Private methods
@@ -18,8 +18,10 @@
 #include "basics/genomic_region.hpp"
 #include "containers/mappable_map.hpp"
 #include "utils/hash_functions.hpp"
+#include "utils/coverage_estimate.hpp"
 #include "read_reader.hpp"
 #include "read_reader_impl.hpp"
+#include "read_prefilter.hpp"
 
 namespace octopus {
 
@@ -66,15 +68,32 @@ public:
     std::size_t count_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
     std::size_t count_reads(const GenomicRegion& region) const;
     
+    // Uses index statistics so is fast, but is only available if every file's index has them
+    boost::optional<std::size_t> count_mapped_reads(const GenomicRegion::ContigName& contig) const;
+    
     GenomicRegion find_covered_subregion(const SampleName& sample, const GenomicRegion& region,
                                          std::size_t max_reads) const;
     GenomicRegion find_covered_subregion(const std::vector<SampleName>& samples, const GenomicRegion& region,
                                          std::size_t max_reads) const;
     GenomicRegion find_covered_subregion(const GenomicRegion& region, std::size_t max_reads) const;
     
-    ReadContainer fetch_reads(const SampleName& sample,  const GenomicRegion& region) const;
-    SampleReadMap fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const;
-    SampleReadMap fetch_reads(const GenomicRegion& region) const;
+    // Estimates the reads in each bin_size bin of region from the file indices without reading any
+    // reads. Files are counted whole if they contain any of the samples. Only available if every
+    // file's index supports it.
+    boost::optional<CoverageEstimate> estimate_coverage(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                                                        GenomicRegion::Size bin_size) const;
+    
+    // As find_covered_subregion but uses index estimates if they are available, which is much faster
+    // but may be off by the accuracy of the estimates
+    GenomicRegion estimate_covered_subregion(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                                             std::size_t max_reads) const;
+    
+    // Reads rejected by the prefilter are skipped before they are decoded
+    ReadContainer fetch_reads(const SampleName& sample,  const GenomicRegion& region,
+                              const ReadPrefilter& prefilter = {}) const;
+    SampleReadMap fetch_reads(const std::vector<SampleName>& samples, const GenomicRegion& region,
+                              const ReadPrefilter& prefilter = {}) const;
+    SampleReadMap fetch_reads(const GenomicRegion& region, const ReadPrefilter& prefilter = {}) const;
     
 private:
     using PathHash = octopus::utils::FilepathHash;
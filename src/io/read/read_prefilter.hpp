@@ -0,0 +1,29 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_prefilter_hpp
+#define read_prefilter_hpp
+
+#include "basics/aligned_read.hpp"
+
+namespace octopus { namespace io {
+
+/*
+ ReadPrefilter describes reads that can be rejected using only the flags, mapping quality,
+ and length of an alignment record, so readers can skip them before decoding the full AlignedRead.
+ */
+struct ReadPrefilter
+{
+    using MappingQuality = AlignedRead::MappingQuality;
+    using Length         = AlignedRead::NucleotideSequence::size_type;
+    
+    bool skip_unmapped = false, skip_secondary = false, skip_supplementary = false;
+    bool skip_duplicates = false, skip_qc_fail = false;
+    MappingQuality min_mapping_quality = 0;
+    Length min_sequence_size = 0;
+};
+
+} // namespace io
+} // namespace octopus
+
+#endif
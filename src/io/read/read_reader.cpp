@@ -158,6 +158,19 @@ boost::optional<std::vector<GenomicRegion>> ReadReader::mapped_regions() const
     return impl_->mapped_regions();
 }
 
+boost::optional<std::size_t> ReadReader::count_mapped_reads(const GenomicRegion::ContigName& contig) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return impl_->count_mapped_reads(contig);
+}
+
+boost::optional<std::vector<double>>
+ReadReader::estimate_read_counts(const GenomicRegion& region, const GenomicRegion::Size bin_size) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return impl_->estimate_read_counts(region, bin_size);
+}
+
 bool ReadReader::has_reads(const GenomicRegion& region) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
@@ -218,23 +231,25 @@ ReadReader::extract_read_positions(const std::vector<SampleName>& samples,
     return impl_->extract_read_positions(samples, region, max_coverage);
 }
 
-ReadReader::SampleReadMap ReadReader::fetch_reads(const GenomicRegion& region) const
+ReadReader::SampleReadMap ReadReader::fetch_reads(const GenomicRegion& region, const ReadPrefilter& prefilter) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(region);
+    return impl_->fetch_reads(region, prefilter);
 }
 
-ReadReader::ReadContainer ReadReader::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
+ReadReader::ReadContainer ReadReader::fetch_reads(const SampleName& sample, const GenomicRegion& region,
+                                                  const ReadPrefilter& prefilter) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(sample, region);
+    return impl_->fetch_reads(sample, region, prefilter);
 }
 
 ReadReader::SampleReadMap ReadReader::fetch_reads(const std::vector<SampleName>& samples,
-                                                  const GenomicRegion& region) const
+                                                  const GenomicRegion& region,
+                                                  const ReadPrefilter& prefilter) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(samples, region);
+    return impl_->fetch_reads(samples, region, prefilter);
 }
 
 bool operator==(const ReadReader& lhs, const ReadReader& rhs)
@@ -64,6 +64,8 @@ public:
     GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const;
     boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const;
     boost::optional<std::vector<GenomicRegion>> mapped_regions() const;
+    boost::optional<std::size_t> count_mapped_reads(const GenomicRegion::ContigName& contig) const;
+    boost::optional<std::vector<double>> estimate_read_counts(const GenomicRegion& region, GenomicRegion::Size bin_size) const;
     
     bool has_reads(const GenomicRegion& region) const;
     bool has_reads(const SampleName& sample,
@@ -86,11 +88,14 @@ public:
                                         const GenomicRegion& region,
                                         std::size_t max_coverage) const;
     
-    SampleReadMap fetch_reads(const GenomicRegion& region) const;
+    SampleReadMap fetch_reads(const GenomicRegion& region,
+                              const ReadPrefilter& prefilter = {}) const;
     ReadContainer fetch_reads(const SampleName& sample,
-                              const GenomicRegion& region) const;
+                              const GenomicRegion& region,
+                              const ReadPrefilter& prefilter = {}) const;
     SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
-                              const GenomicRegion& region) const;
+                              const GenomicRegion& region,
+                              const ReadPrefilter& prefilter = {}) const;
     
 private:
     Path file_path_;
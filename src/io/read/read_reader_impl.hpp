@@ -14,6 +14,7 @@
 
 #include "basics/genomic_region.hpp"
 #include "basics/aligned_read.hpp"
+#include "read_prefilter.hpp"
 
 namespace octopus { namespace io {
 
@@ -55,17 +56,24 @@ public:
                                                 const GenomicRegion& region,
                                                 std::size_t max_reads) const = 0;
     
-    virtual SampleReadMap fetch_reads(const GenomicRegion& region) const = 0;
+    virtual SampleReadMap fetch_reads(const GenomicRegion& region,
+                                      const ReadPrefilter& prefilter) const = 0;
     virtual ReadContainer fetch_reads(const SampleName& sample,
-                                      const GenomicRegion& region) const = 0;
+                                      const GenomicRegion& region,
+                                      const ReadPrefilter& prefilter) const = 0;
     virtual SampleReadMap fetch_reads(const std::vector<SampleName>& samples,
-                                      const GenomicRegion& region) const = 0;
+                                      const GenomicRegion& region,
+                                      const ReadPrefilter& prefilter) const = 0;
     
     virtual std::vector<GenomicRegion::ContigName> reference_contigs() const = 0;
     virtual GenomicRegion::Size reference_size(const GenomicRegion::ContigName& contig) const = 0;
     
     virtual boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const { return boost::none; };
     virtual boost::optional<std::vector<GenomicRegion>> mapped_regions() const { return boost::none; };
+    virtual boost::optional<std::size_t> count_mapped_reads(const GenomicRegion::ContigName& contig) const { return boost::none; };
+    // The expected number of reads in each bin_size bin of region, estimated from the index only
+    virtual boost::optional<std::vector<double>>
+    estimate_read_counts(const GenomicRegion& region, GenomicRegion::Size bin_size) const { return boost::none; };
 };
 
 } // namespace io
@@ -7,22 +7,37 @@
 #include <iterator>
 #include <utility>
 #include <numeric>
+#include <atomic>
 
 #include "fasta.hpp"
 #include "threadsafe_fasta.hpp"
 #include "caching_fasta.hpp"
+#include "basics/contig_table.hpp"
 
 namespace octopus {
 
+namespace {
+
+ReferenceGenome::Id make_reference_id() noexcept
+{
+    static std::atomic<ReferenceGenome::Id> next_id {0};
+    return next_id++;
+}
+
+} // namespace
+
 ReferenceGenome::ReferenceGenome(std::unique_ptr<io::ReferenceReader> impl)
 : impl_ {std::move(impl)}
 , name_{}
 , contig_sizes_ {}
+, ordered_contigs_ {}
+, id_ {make_reference_id()}
 {
     if (impl_->is_open()) {
         try {
             name_ = impl_->fetch_reference_name();
             ordered_contigs_ = impl_->fetch_contig_names();
+            intern_contigs(ordered_contigs_);
             contig_sizes_.reserve(ordered_contigs_.size());
             for (const auto& contig_name : ordered_contigs_) {
                 contig_sizes_.emplace(contig_name, impl_->fetch_contig_size(contig_name));
@@ -40,6 +55,7 @@ ReferenceGenome::ReferenceGenome(const ReferenceGenome& other)
 , name_ {other.name_}
 , contig_sizes_ {other.contig_sizes_}
 , ordered_contigs_ {other.ordered_contigs_}
+, id_ {make_reference_id()}
 {}
 
 ReferenceGenome& ReferenceGenome::operator=(ReferenceGenome other)
@@ -49,6 +65,7 @@ ReferenceGenome& ReferenceGenome::operator=(ReferenceGenome other)
     swap(name_,            other.name_);
     swap(contig_sizes_,    other.contig_sizes_);
     swap(ordered_contigs_, other.ordered_contigs_);
+    swap(id_,              other.id_);
     return *this;
 }
 
@@ -57,6 +74,11 @@ const std::string& ReferenceGenome::name() const
     return name_;
 }
 
+ReferenceGenome::Id ReferenceGenome::id() const noexcept
+{
+    return id_;
+}
+
 bool ReferenceGenome::has_contig(const ContigName& contig) const noexcept
 {
     return contig_sizes_.count(contig) == 1;
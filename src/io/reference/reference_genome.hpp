@@ -8,6 +8,7 @@
 #include <vector>
 #include <unordered_map>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include <boost/filesystem/path.hpp>
@@ -23,6 +24,7 @@ class ReferenceGenome
 public:
     using ContigName      = io::ReferenceReader::ContigName;
     using GeneticSequence = io::ReferenceReader::GeneticSequence;
+    using Id              = std::uint64_t;
     
     ReferenceGenome() = delete;
     
@@ -37,6 +39,9 @@ public:
     
     const std::string& name() const;
     
+    // Unique to this object, unlike its address which can be reused once it is destroyed
+    Id id() const noexcept;
+    
     bool has_contig(const ContigName& contig) const noexcept;
     std::size_t num_contigs() const noexcept;
     std::vector<ContigName> contig_names() const;
@@ -52,6 +57,7 @@ private:
     std::string name_;
     std::unordered_map<ContigName, ContigRegion::Size> contig_sizes_;
     std::vector<ContigName> ordered_contigs_;
+    Id id_;
 };
 
 // non-member functions
@@ -0,0 +1,267 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "bcf_record_builder.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+auto to_value_type(const int hts_type) noexcept
+{
+    using ValueType = BcfRecordBuilder::ValueType;
+    switch (hts_type) {
+        case BCF_HT_FLAG: return ValueType::flag;
+        case BCF_HT_INT:  return ValueType::integer;
+        case BCF_HT_REAL: return ValueType::real;
+        default:          return ValueType::string;
+    }
+}
+
+BcfRecordBuilder::KeyId get_header_id(const bcf_hdr_t* header, const int line_type, const std::string& key)
+{
+    const auto result = bcf_hdr_id2int(header, BCF_DT_ID, key.c_str());
+    if (!bcf_hdr_idinfo_exists(header, line_type, result)) {
+        throw std::runtime_error {"BcfRecordBuilder: required header line missing for key \"" + key + "\""};
+    }
+    return result;
+}
+
+} // namespace
+
+BcfRecordBuilder::BcfRecordBuilder(std::shared_ptr<const bcf_hdr_t> header)
+: header_ {std::move(header)}
+, record_ {bcf_init(), HtsBcf1Deleter {}}
+, alleles_ {}
+{
+    if (!header_) {
+        throw std::runtime_error {"BcfRecordBuilder: no header"};
+    }
+    if (!record_) {
+        throw std::runtime_error {"BcfRecordBuilder: could not allocate record"};
+    }
+}
+
+BcfRecordBuilder::KeyId BcfRecordBuilder::contig_id(const std::string& contig) const
+{
+    const auto result = bcf_hdr_name2id(header_.get(), contig.c_str());
+    if (result < 0) {
+        throw std::runtime_error {"BcfRecordBuilder: required contig header line missing for contig \"" + contig + "\""};
+    }
+    return result;
+}
+
+BcfRecordBuilder::KeyId BcfRecordBuilder::filter_id(const std::string& key) const
+{
+    return get_header_id(header_.get(), BCF_HL_FLT, key);
+}
+
+BcfRecordBuilder::KeyId BcfRecordBuilder::info_id(const std::string& key) const
+{
+    return get_header_id(header_.get(), BCF_HL_INFO, key);
+}
+
+BcfRecordBuilder::KeyId BcfRecordBuilder::format_id(const std::string& key) const
+{
+    return get_header_id(header_.get(), BCF_HL_FMT, key);
+}
+
+BcfRecordBuilder::ValueType BcfRecordBuilder::info_type(const KeyId key) const noexcept
+{
+    return to_value_type(bcf_hdr_id2type(header_.get(), BCF_HL_INFO, key));
+}
+
+BcfRecordBuilder::ValueType BcfRecordBuilder::format_type(const KeyId key) const noexcept
+{
+    return to_value_type(bcf_hdr_id2type(header_.get(), BCF_HL_FMT, key));
+}
+
+unsigned BcfRecordBuilder::num_samples() const noexcept
+{
+    return static_cast<unsigned>(bcf_hdr_nsamples(header_.get()));
+}
+
+BcfRecordBuilder& BcfRecordBuilder::clear() noexcept
+{
+    bcf_clear(record_.get());
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_chrom(const KeyId contig) noexcept
+{
+    record_->rid = contig;
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_pos(const Position pos) noexcept
+{
+    record_->pos = static_cast<std::int32_t>(pos - 1);
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_id(const char* id)
+{
+    check(bcf_update_id(header_.get(), record_.get(), id), "ID");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_alleles(const std::string& ref, const std::vector<std::string>& alts)
+{
+    alleles_.resize(alts.size() + 1);
+    alleles_.front() = ref.c_str();
+    std::transform(std::cbegin(alts), std::cend(alts), std::next(std::begin(alleles_)),
+                   [] (const auto& allele) { return allele.c_str(); });
+    check(bcf_update_alleles(header_.get(), record_.get(), alleles_.data(), static_cast<int>(alleles_.size())), "REF/ALT");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_qual(const float qual) noexcept
+{
+    record_->qual = (qual == -0) ? 0 : qual;
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::add_filter(const KeyId filter)
+{
+    check(bcf_add_filter(header_.get(), record_.get(), filter), "FILTER");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info(const KeyId key, const std::int32_t value)
+{
+    return set_info(key, &value, 1);
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info(const KeyId key, const std::int32_t* values, const int num_values)
+{
+    assert(info_type(key) == ValueType::integer);
+    check(bcf_update_info_int32(header_.get(), record_.get(), this->key(key), values, num_values), "INFO");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info(const KeyId key, const float value)
+{
+    return set_info(key, &value, 1);
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info(const KeyId key, const float* values, const int num_values)
+{
+    assert(info_type(key) == ValueType::real);
+    check(bcf_update_info_float(header_.get(), record_.get(), this->key(key), values, num_values), "INFO");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info(const KeyId key, const char* value)
+{
+    assert(info_type(key) == ValueType::string);
+    check(bcf_update_info_string(header_.get(), record_.get(), this->key(key), value), "INFO");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_info_flag(const KeyId key)
+{
+    assert(info_type(key) == ValueType::flag);
+    check(bcf_update_info_flag(header_.get(), record_.get(), this->key(key), "", 1), "INFO");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_genotypes(const std::int32_t* alleles, const int max_ploidy)
+{
+    check(bcf_update_genotypes(header_.get(), record_.get(), alleles, max_ploidy * static_cast<int>(num_samples())), "GT");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_format(const KeyId key, const std::int32_t* values, const int values_per_sample)
+{
+    assert(format_type(key) == ValueType::integer);
+    check(bcf_update_format_int32(header_.get(), record_.get(), this->key(key), values,
+                                  values_per_sample * static_cast<int>(num_samples())), "FORMAT");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_format(const KeyId key, const float* values, const int values_per_sample)
+{
+    assert(format_type(key) == ValueType::real);
+    check(bcf_update_format_float(header_.get(), record_.get(), this->key(key), values,
+                                  values_per_sample * static_cast<int>(num_samples())), "FORMAT");
+    return *this;
+}
+
+BcfRecordBuilder& BcfRecordBuilder::set_format(const KeyId key, const char** values)
+{
+    assert(format_type(key) == ValueType::string);
+    check(bcf_update_format_string(header_.get(), record_.get(), this->key(key), values,
+                                   static_cast<int>(num_samples())), "FORMAT");
+    return *this;
+}
+
+std::int32_t BcfRecordBuilder::genotype_allele(const boost::optional<unsigned> allele, const bool phased) noexcept
+{
+    if (allele) {
+        return phased ? bcf_gt_phased(*allele) : bcf_gt_unphased(*allele);
+    } else {
+        return phased ? bcf_gt_missing + 1 : bcf_gt_missing;
+    }
+}
+
+std::int32_t BcfRecordBuilder::int_missing() noexcept
+{
+    return bcf_int32_missing;
+}
+
+std::int32_t BcfRecordBuilder::int_vector_end() noexcept
+{
+    return bcf_int32_vector_end;
+}
+
+float BcfRecordBuilder::float_missing() noexcept
+{
+    float result;
+    bcf_float_set_missing(result);
+    return result;
+}
+
+float BcfRecordBuilder::float_vector_end() noexcept
+{
+    float result;
+    bcf_float_set_vector_end(result);
+    return result;
+}
+
+const bcf_hdr_t* BcfRecordBuilder::header() const noexcept
+{
+    return header_.get();
+}
+
+bcf1_t* BcfRecordBuilder::get() noexcept
+{
+    return record_.get();
+}
+
+const bcf1_t* BcfRecordBuilder::get() const noexcept
+{
+    return record_.get();
+}
+
+// private methods
+
+const char* BcfRecordBuilder::key(const KeyId id) const noexcept
+{
+    // htslib's update functions are keyed by name; this is the header's own copy, so no lookup or allocation
+    return bcf_hdr_int2id(header_.get(), BCF_DT_ID, id);
+}
+
+void BcfRecordBuilder::check(const int result, const char* field) const
+{
+    if (result < 0) {
+        throw std::runtime_error {std::string {"BcfRecordBuilder: failed to set "} + field};
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,111 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef bcf_record_builder_hpp
+#define bcf_record_builder_hpp
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+
+#include "htslib/vcf.h"
+
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/*
+ Builds VCF records with typed values directly into a single, reused htslib bcf1_t.
+
+ Unlike VcfRecord, which stores every INFO and FORMAT value as text, values are passed as
+ integers, floats, flags or C strings and encoded straight into the record, so nothing is
+ formatted and re-parsed on output. Header keys are resolved to ids once (e.g. with info_id)
+ and those ids used for every record. clear() starts a new record but keeps all allocated
+ buffers, so steady state record construction does not allocate.
+
+ A builder is tied to the header it was made from (see VcfWriter::make_record_builder) and
+ only the header's samples, in header order, can be given FORMAT values.
+ */
+class BcfRecordBuilder
+{
+public:
+    using KeyId    = int;
+    using Position = GenomicRegion::Position;
+
+    enum class ValueType { flag, integer, real, string };
+
+    BcfRecordBuilder() = delete;
+
+    BcfRecordBuilder(std::shared_ptr<const bcf_hdr_t> header);
+
+    BcfRecordBuilder(const BcfRecordBuilder&)            = delete;
+    BcfRecordBuilder& operator=(const BcfRecordBuilder&) = delete;
+    BcfRecordBuilder(BcfRecordBuilder&&)                 = default;
+    BcfRecordBuilder& operator=(BcfRecordBuilder&&)      = default;
+
+    ~BcfRecordBuilder() = default;
+
+    // Header lookups throw if the key is not defined in the header
+    KeyId contig_id(const std::string& contig) const;
+    KeyId filter_id(const std::string& key) const;
+    KeyId info_id(const std::string& key) const;
+    KeyId format_id(const std::string& key) const;
+    ValueType info_type(KeyId key) const noexcept;
+    ValueType format_type(KeyId key) const noexcept;
+    unsigned num_samples() const noexcept;
+
+    // Starts a new record
+    BcfRecordBuilder& clear() noexcept;
+
+    BcfRecordBuilder& set_chrom(KeyId contig) noexcept;
+    BcfRecordBuilder& set_pos(Position pos) noexcept; // One based!
+    BcfRecordBuilder& set_id(const char* id);
+    BcfRecordBuilder& set_alleles(const std::string& ref, const std::vector<std::string>& alts);
+    BcfRecordBuilder& set_qual(float qual) noexcept;
+    BcfRecordBuilder& add_filter(KeyId filter);
+
+    BcfRecordBuilder& set_info(KeyId key, std::int32_t value);
+    BcfRecordBuilder& set_info(KeyId key, const std::int32_t* values, int num_values);
+    BcfRecordBuilder& set_info(KeyId key, float value);
+    BcfRecordBuilder& set_info(KeyId key, const float* values, int num_values);
+    BcfRecordBuilder& set_info(KeyId key, const char* value);
+    BcfRecordBuilder& set_info_flag(KeyId key);
+
+    // FORMAT values are given for every sample at once, sample-major in header sample order, with
+    // values_per_sample entries per sample. Samples with fewer values must be padded with
+    // int_vector_end() or float_vector_end().
+    BcfRecordBuilder& set_genotypes(const std::int32_t* alleles, int max_ploidy); // see genotype_allele
+    BcfRecordBuilder& set_format(KeyId key, const std::int32_t* values, int values_per_sample);
+    BcfRecordBuilder& set_format(KeyId key, const float* values, int values_per_sample);
+    BcfRecordBuilder& set_format(KeyId key, const char** values); // one string per sample
+
+    static std::int32_t genotype_allele(boost::optional<unsigned> allele, bool phased) noexcept;
+    static std::int32_t int_missing() noexcept;
+    static std::int32_t int_vector_end() noexcept;
+    static float float_missing() noexcept;
+    static float float_vector_end() noexcept;
+
+    const bcf_hdr_t* header() const noexcept;
+    bcf1_t* get() noexcept;
+    const bcf1_t* get() const noexcept;
+
+private:
+    struct HtsBcf1Deleter
+    {
+        void operator()(bcf1_t* bcf1) const { bcf_destroy(bcf1); }
+    };
+
+    std::shared_ptr<const bcf_hdr_t> header_;
+    std::unique_ptr<bcf1_t, HtsBcf1Deleter> record_;
+    std::vector<const char*> alleles_;
+
+    const char* key(KeyId id) const noexcept;
+    void check(int result, const char* field) const;
+};
+
+} // namespace octopus
+
+#endif
@@ -105,7 +105,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         if (boost::filesystem::exists(file_path_)) {
             file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
             if (file_ == nullptr) return;
-            header_.reset(bcf_hdr_read(file_.get()));
+            header_.reset(bcf_hdr_read(file_.get()), HtsHeaderDeleter {});
             if (header_ == nullptr) {
                 throw std::runtime_error {"HtslibBcfFacade: could not make header for file " + file_path_.string()};
             }
@@ -115,7 +115,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         }
     } else {
         file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
-        header_.reset(bcf_hdr_init(hts_mode.c_str()));
+        header_.reset(bcf_hdr_init(hts_mode.c_str()), HtsHeaderDeleter {});
     }
 }
 
@@ -367,13 +367,14 @@ void HtslibBcfFacade::write(const VcfHeader& header)
     if (bcf_hdr_write(file_.get(), hdr) < 0) {
         throw std::runtime_error {"HtslibBcfFacade: header write failed"};
     }
-    header_.reset(hdr);
+    header_.reset(hdr, HtsHeaderDeleter {});
     samples_ = extract_samples(header_.get());
+    record_.reset(bcf_init());
 }
 
 void set_chrom(const bcf_hdr_t* header, bcf1_t* record, const std::string& chrom);
 void set_pos(bcf1_t* record, GenomicRegion::Position pos);
-void set_id(bcf1_t* record, const std::string& id);
+void set_id(const bcf_hdr_t* header, bcf1_t* record, const std::string& id);
 void set_alleles(const bcf_hdr_t* header, bcf1_t* record, const VcfRecord::NucleotideSequence& ref,
                  const std::vector<VcfRecord::NucleotideSequence>& alts);
 void set_qual(bcf1_t* record, VcfRecord::QualityType qual);
@@ -387,20 +388,15 @@ void HtslibBcfFacade::write(const VcfRecord& record)
     if (file_ == nullptr) {
         throw std::runtime_error {"HtslibBcfFacade: trying to write record to closed file"};
     }
-    if (header_ == nullptr) {
+    if (record_ == nullptr) {
         throw std::runtime_error {"HtslibBcfFacade: trying to write record without a header"};
     }
-    
-    const auto& contig = record.chrom();
-    
-    if (bcf_hdr_get_hrec(header_.get(), BCF_HL_CTG, "ID", contig.c_str(), nullptr) == nullptr) {
-        throw std::runtime_error {"HtslibBcfFacade: required contig header line missing for contig \"" + contig + "\""};
-    }
-    
-    auto hts_record = bcf_init();
-    set_chrom(header_.get(), hts_record, contig);
+    // The record is cleared rather than destroyed so its buffers are reused for the next one
+    auto hts_record = record_.get();
+    bcf_clear(hts_record);
+    set_chrom(header_.get(), hts_record, record.chrom());
     set_pos(hts_record, record.pos() - 1);
-    set_id(hts_record, record.id());
+    set_id(header_.get(), hts_record, record.id());
     set_alleles(header_.get(), hts_record, record.ref(), record.alt());
     if (record.qual()) {
         set_qual(hts_record, *record.qual());
@@ -413,7 +409,27 @@ void HtslibBcfFacade::write(const VcfRecord& record)
     if (bcf_write(file_.get(), header_.get(), hts_record) < 0) {
         throw std::runtime_error {"HtslibBcfFacade: record write failed"};
     }
-    bcf_destroy(hts_record);
+}
+
+BcfRecordBuilder HtslibBcfFacade::make_record_builder() const
+{
+    if (record_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: cannot make record builder as header has not been written"};
+    }
+    return BcfRecordBuilder {header_};
+}
+
+void HtslibBcfFacade::write(BcfRecordBuilder& record)
+{
+    if (file_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record to closed file"};
+    }
+    if (record.header() != header_.get()) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record built for a different header"};
+    }
+    if (bcf_write(file_.get(), header_.get(), record.get()) < 0) {
+        throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+    }
 }
 
 // HtslibBcfFacade::RecordIterator
@@ -495,7 +511,11 @@ void extract_chrom(const bcf_hdr_t* header, const bcf1_t* record, VcfRecord::Bui
 
 void set_chrom(const bcf_hdr_t* header, bcf1_t* record, const std::string& chrom)
 {
-    record->rid = bcf_hdr_name2id(header, chrom.c_str());
+    const auto id = bcf_hdr_name2id(header, chrom.c_str());
+    if (id < 0) {
+        throw std::runtime_error {"HtslibBcfFacade: required contig header line missing for contig \"" + chrom + "\""};
+    }
+    record->rid = id;
 }
 
 void extract_pos(const bcf1_t* record, VcfRecord::Builder& builder)
@@ -513,9 +533,9 @@ void extract_id(const bcf1_t* record, VcfRecord::Builder& builder)
     builder.set_id(record->d.id);
 }
 
-void set_id(bcf1_t* record, const std::string& id)
+void set_id(const bcf_hdr_t* header, bcf1_t* record, const std::string& id)
 {
-    record->d.id = malloc_copy(id);
+    bcf_update_id(header, record, id.c_str());
 }
 
 void extract_ref(const bcf1_t* record, VcfRecord::Builder& builder)
@@ -567,10 +587,19 @@ void extract_filter(const bcf_hdr_t* header, const bcf1_t* record, VcfRecord::Bu
     builder.set_filter(std::move(filter));
 }
 
+int get_header_id(const bcf_hdr_t* header, const int line_type, const std::string& key)
+{
+    const auto result = bcf_hdr_id2int(header, BCF_DT_ID, key.c_str());
+    if (!bcf_hdr_idinfo_exists(header, line_type, result)) {
+        throw std::runtime_error {"HtslibBcfFacade: required header line missing for key \"" + key + "\""};
+    }
+    return result;
+}
+
 void set_filter(const bcf_hdr_t* header, bcf1_t* record, const std::vector<std::string>& filters)
 {
     for (const auto& filter : filters) {
-        bcf_add_filter(header, record, bcf_hdr_id2int(header, BCF_DT_ID, filter.c_str()));
+        bcf_add_filter(header, record, get_header_id(header, BCF_HL_FLT, filter));
     }
 }
 
@@ -647,7 +676,7 @@ void set_info(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source)
         const auto& values    = source.info_value(key);
         const auto num_values = static_cast<int>(values.size());
         static constexpr std::size_t defaultBufferCapacity {100};
-        switch (bcf_hdr_id2type(header, BCF_HL_INFO, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
+        switch (bcf_hdr_id2type(header, BCF_HL_INFO, get_header_id(header, BCF_HL_INFO, key))) {
             case BCF_HT_INT:
             {
                 bc::small_vector<int, defaultBufferCapacity> vals(num_values);
@@ -872,7 +901,7 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
         }
         const auto num_values_per_sample = static_cast<std::size_t>(num_values / num_samples);
         static constexpr std::size_t defaultValueCapacity {1'000};
-        switch (bcf_hdr_id2type(header, BCF_HL_FMT, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
+        switch (bcf_hdr_id2type(header, BCF_HL_FMT, get_header_id(header, BCF_HL_FMT, key))) {
           case BCF_HT_INT:
           {
               static const int pad {bcf_int32_vector_end};
@@ -18,6 +18,7 @@
 
 #include "vcf_reader_impl.hpp"
 #include "vcf_record.hpp"
+#include "bcf_record_builder.hpp"
 
 namespace octopus {
 
@@ -64,6 +65,10 @@ public:
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
     
+    // Requires the header to have been written
+    BcfRecordBuilder make_record_builder() const;
+    void write(BcfRecordBuilder& record);
+    
 private:
     struct HtsFileDeleter
     {
@@ -87,8 +92,9 @@ private:
     
     Path file_path_;
     std::unique_ptr<htsFile, HtsFileDeleter> file_;
-    std::unique_ptr<bcf_hdr_t, HtsHeaderDeleter> header_;
+    std::shared_ptr<bcf_hdr_t> header_; // shared with record builders
     std::vector<std::string> samples_;
+    HtsBcf1Ptr record_; // reused for every record written
     
     std::size_t count_records(HtsBcfSrPtr& sr) const;
     VcfRecord fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const;
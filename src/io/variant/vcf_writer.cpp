@@ -166,6 +166,26 @@ void VcfWriter::write(const VcfRecord& record)
     }
 }
 
+BcfRecordBuilder VcfWriter::make_record_builder() const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (is_header_written_) {
+        return writer_->make_record_builder();
+    } else {
+        throw std::runtime_error {"VcfWriter::make_record_builder: cannot make record builder as header has not been written"};
+    }
+}
+
+void VcfWriter::write(BcfRecordBuilder& record)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (is_header_written_) {
+        writer_->write(record);
+    } else {
+        throw std::runtime_error {"VcfWriter::write: cannot write record as header has not been written"};
+    }
+}
+
 bool VcfWriter::can_write_index() const noexcept
 {
     return file_path_ && is_header_written_
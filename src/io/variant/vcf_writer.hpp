@@ -51,6 +51,10 @@ public:
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
     
+    // Typed record construction for high-volume producers; requires the header to have been written
+    BcfRecordBuilder make_record_builder() const;
+    void write(BcfRecordBuilder& record);
+    
 private:
     boost::optional<Path> file_path_;
     std::unique_ptr<HtslibBcfFacade> writer_;
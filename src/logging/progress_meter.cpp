@@ -66,6 +66,9 @@ ProgressMeter::ProgressMeter(InputRegionMap regions)
 , completed_regions_ {}
 , num_bp_to_search_ {}
 , num_bp_completed_ {0}
+, coverage_estimates_ {}
+, num_reads_to_search_ {0}
+, num_reads_completed_ {0}
 , percent_until_tick_ {max_tick_size_}
 , percent_at_last_tick_ {0}
 , start_ {std::chrono::system_clock::now()}
@@ -101,6 +104,9 @@ ProgressMeter::ProgressMeter(ProgressMeter&& other)
     completed_regions_    = move(other.completed_regions_);
     num_bp_to_search_     = move(other.num_bp_to_search_);
     num_bp_completed_     = move(other.num_bp_completed_);
+    coverage_estimates_   = move(other.coverage_estimates_);
+    num_reads_to_search_  = move(other.num_reads_to_search_);
+    num_reads_completed_  = move(other.num_reads_completed_);
     max_tick_size_        = move(other.max_tick_size_);
     curr_tick_size_       = move(other.curr_tick_size_);
     percent_until_tick_   = move(other.percent_until_tick_);
@@ -124,6 +130,12 @@ ProgressMeter& ProgressMeter::operator=(ProgressMeter&& other)
         completed_regions_    = move(other.completed_regions_);
         num_bp_to_search_     = move(other.num_bp_to_search_);
         num_bp_completed_     = move(other.num_bp_completed_);
+        coverage_estimates_   = move(other.coverage_estimates_);
+        num_reads_to_search_  = move(other.num_reads_to_search_);
+        num_reads_completed_  = move(other.num_reads_completed_);
+    coverage_estimates_   = move(other.coverage_estimates_);
+    num_reads_to_search_  = move(other.num_reads_to_search_);
+    num_reads_completed_  = move(other.num_reads_completed_);
         max_tick_size_        = move(other.max_tick_size_);
         curr_tick_size_       = move(other.curr_tick_size_);
         percent_until_tick_   = move(other.percent_until_tick_);
@@ -146,9 +158,9 @@ double percent_completed(const std::size_t num_bp_completed, const std::size_t n
     return 100 * static_cast<double>(num_bp_completed) / num_bp_to_search;
 }
 
-auto percent_completed_str(const std::size_t num_bp_completed, const std::size_t num_bp_to_search)
+auto percent_completed_str(const double percent_done)
 {
-    return utils::to_string(percent_completed(num_bp_completed, num_bp_to_search), 1) + '%';
+    return utils::to_string(percent_done, 1) + '%';
 }
 
 std::string to_string(const TimeInterval& duration)
@@ -242,6 +254,25 @@ void ProgressMeter::set_max_tick_size(double percent)
     curr_tick_size_ = std::min(max_tick_size_, curr_tick_size_);
 }
 
+void ProgressMeter::set_coverage_estimates(std::unordered_map<ContigName, CoverageEstimate> estimates)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    double num_reads_to_search {0};
+    for (const auto& p : target_regions_) {
+        if (p.second.empty()) continue;
+        const auto estimate_itr = estimates.find(p.first);
+        if (estimate_itr == std::cend(estimates)) return;
+        for (const auto& region : p.second) {
+            num_reads_to_search += estimate_itr->second.count(region);
+        }
+    }
+    if (num_reads_to_search > 0) {
+        coverage_estimates_ = std::move(estimates);
+        num_reads_to_search_ = num_reads_to_search;
+        num_reads_completed_ = 0;
+    }
+}
+
 void ProgressMeter::start()
 {
     if (!target_regions_.empty()) {
@@ -281,6 +312,7 @@ void ProgressMeter::reset()
     completed_regions_.clear();
     num_bp_to_search_ = sum_region_sizes(target_regions_);
     num_bp_completed_ = 0;
+    num_reads_completed_ = 0;
     curr_tick_size_ = max_tick_size_;
     percent_until_tick_ = max_tick_size_;
     percent_at_last_tick_ = 0;
@@ -297,9 +329,12 @@ void ProgressMeter::reset()
 void ProgressMeter::log_completed(const GenomicRegion& region)
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    const auto new_bp_processed = merge(region);
-    const auto new_percent_done = percent_completed(new_bp_processed, num_bp_to_search_);
-    num_bp_completed_ += new_bp_processed;
+    const auto percent_done_before = percent_done();
+    if (!coverage_estimates_.empty()) {
+        num_reads_completed_ += count_new_reads(region);
+    }
+    num_bp_completed_ += merge(region);
+    const auto new_percent_done = percent_done() - percent_done_before;
     percent_until_tick_ -= new_percent_done;
     if (percent_until_tick_ <= 0) output_log(region);
 }
@@ -377,6 +412,35 @@ ProgressMeter::RegionSizeType ProgressMeter::merge(const GenomicRegion& region)
     return result;
 }
 
+double ProgressMeter::count_new_reads(const GenomicRegion& region) const
+{
+    const auto target_itr = target_regions_.find(region.contig_name());
+    const auto estimate_itr = coverage_estimates_.find(region.contig_name());
+    if (target_itr == std::cend(target_regions_) || estimate_itr == std::cend(coverage_estimates_)) return 0;
+    const auto& estimate = estimate_itr->second;
+    const auto completed_itr = completed_regions_.find(region.contig_name());
+    double result {0};
+    for (const auto& target : overlap_range(target_itr->second, region)) {
+        const auto new_region = *overlapped_region(target, region);
+        result += estimate.count(new_region);
+        if (completed_itr != std::cend(completed_regions_)) {
+            for (const auto& completed : completed_itr->second.overlap_range(new_region.contig_region())) {
+                const auto overlap = overlapped_region(completed, new_region.contig_region());
+                if (overlap) result -= estimate.count(GenomicRegion {region.contig_id(), *overlap});
+            }
+        }
+    }
+    return std::max(result, 0.0);
+}
+
+double ProgressMeter::percent_done() const noexcept
+{
+    if (coverage_estimates_.empty()) {
+        return percent_completed(num_bp_completed_, num_bp_to_search_);
+    }
+    return std::min(100 * num_reads_completed_ / num_reads_to_search_, 100.0);
+}
+
 void ProgressMeter::write_header()
 {
     const std::string pos_tab_bar(position_tab_length_, '-');
@@ -397,7 +461,7 @@ void ProgressMeter::write_header()
 
 void ProgressMeter::output_log(const GenomicRegion& region)
 {
-    const auto percent_done = percent_completed(num_bp_completed_, num_bp_to_search_);
+    const auto percent_done = this->percent_done();
     const auto now = std::chrono::system_clock::now();
     const TimeInterval duration {start_, now};
     const auto time_taken = to_string(duration);
@@ -417,7 +481,7 @@ void ProgressMeter::output_log(const GenomicRegion& region)
             ttc = "-";
         }
     }
-    const auto percent_completed = percent_completed_str(num_bp_completed_, num_bp_to_search_);
+    const auto percent_completed = percent_completed_str(percent_done);
     const auto position_tick = region.contig_name() + ":" + std::to_string(region.end());
     const auto position_str = position_pad(region) + position_tick;
     stream(log_) << position_str
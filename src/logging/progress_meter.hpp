@@ -8,12 +8,14 @@
 #include <cstddef>
 #include <chrono>
 #include <deque>
+#include <unordered_map>
 #include <mutex>
 
 #include "config/common.hpp"
 #include "basics/contig_region.hpp"
 #include "basics/genomic_region.hpp"
 #include "containers/mappable_flat_set.hpp"
+#include "utils/coverage_estimate.hpp"
 #include "logging.hpp"
 
 namespace octopus {
@@ -35,6 +37,10 @@ public:
     
     void set_max_tick_size(double percent);
     
+    // Measures progress by the expected number of reads completed rather than by bases, so the
+    // estimated time to completion is not skewed by uneven coverage
+    void set_coverage_estimates(std::unordered_map<ContigName, CoverageEstimate> estimates);
+    
     void start();
     void resume();
     void pause();
@@ -52,6 +58,8 @@ private:
     InputRegionMap target_regions_;
     ContigRegionMap completed_regions_;
     RegionSizeType num_bp_to_search_, num_bp_completed_;
+    std::unordered_map<ContigName, CoverageEstimate> coverage_estimates_;
+    double num_reads_to_search_, num_reads_completed_;
     double min_tick_size_ = 0.1, max_tick_size_ = 1.0, curr_tick_size_ = 1.0;
     double percent_until_tick_;
     double percent_at_last_tick_;
@@ -64,6 +72,8 @@ private:
     logging::InfoLogger log_;
     
     RegionSizeType merge(const GenomicRegion& region);
+    double count_new_reads(const GenomicRegion& region) const;
+    double percent_done() const noexcept;
     
     void write_header();
     void output_log(const GenomicRegion& region);
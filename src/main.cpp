@@ -5,6 +5,9 @@
 #include <cstdlib>
 #include <chrono>
 #include <exception>
+#include <vector>
+#include <cstring>
+#include <thread>
 
 #include "config/config.hpp"
 #include "config/common.hpp"
@@ -13,9 +16,13 @@
 #include "config/option_parser.hpp"
 #include "config/option_collation.hpp"
 #include "core/octopus.hpp"
+#include "core/tools/genome_sharding.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
 #include "utils/timing.hpp"
 #include "utils/system_utils.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/thread_pool.hpp"
 #include "exceptions/error.hpp"
 #include "logging/error_handler.hpp"
 
@@ -45,6 +52,12 @@ void init_common(const OptionMap& options)
     logging::init(get_debug_log_file_name(options), get_trace_log_file_name(options));
     DEBUG_MODE = options::is_debug_mode(options);
     TRACE_MODE = options::is_trace_mode(options);
+    const auto num_threads = options::get_num_threads(options);
+    if (num_threads) {
+        set_shared_thread_pool_size(*num_threads > 1 ? *num_threads : 0);
+    } else {
+        set_shared_thread_pool_size(std::thread::hardware_concurrency());
+    }
 }
 
 std::string to_string(const int argc, const char** argv)
@@ -66,10 +79,62 @@ void sanity_check(const OptionMap& options)
     }
 }
 
+bool is_merge_command(const int argc, const char** argv)
+{
+    return argc > 1 && std::strcmp(argv[1], "merge") == 0;
+}
+
+void run_merge(const OptionMap& options)
+{
+    logging::InfoLogger info_log {};
+    const auto start = std::chrono::system_clock::now();
+    std::vector<VcfReader> shards {};
+    for (const auto& path : get_merge_shard_paths(options)) {
+        shards.emplace_back(path);
+    }
+    const auto output_path = get_output_path(options);
+    auto output = output_path ? VcfWriter {*output_path} : VcfWriter {};
+    merge_shards(shards, output);
+    const auto end = std::chrono::system_clock::now();
+    using utils::TimeInterval;
+    stream(info_log) << "Merged " << shards.size() << " shards in " << TimeInterval {start, end};
+}
+
+int merge_main(const int argc, const char** argv)
+{
+    OptionMap options;
+    try {
+        options = parse_merge_options(argc, argv);
+    } catch (const Error& e) {
+        return log_startup_exception(e);
+    } catch (const std::exception& e) {
+        return log_startup_exception(e);
+    }
+    if (options.count("help") == 1) return EXIT_SUCCESS;
+    try {
+        logging::init();
+        log_program_startup();
+        run_merge(options);
+        log_program_end();
+    } catch (const Error& e) {
+        return log_exception(e);
+    } catch (const std::exception& e) {
+        return log_exception(e);
+    } catch (...) {
+        log_unknown_error();
+        log_program_end();
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
 } // namespace
 
 int main(const int argc, const char** argv)
 {
+    if (is_merge_command(argc, argv)) {
+        return merge_main(argc, argv);
+    }
     OptionMap options;
     try {
         options = parse_options(argc, argv);
@@ -77,7 +77,8 @@ void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
             buffered_region_ = std::move(max_region);
             unchecked_fetch = true;
         } else {
-            buffered_region_ = source_.get().read_manager().find_covered_subregion(max_region, config_.max_buffer_size);
+            const auto& read_manager = source_.get().read_manager();
+            buffered_region_ = read_manager.estimate_covered_subregion(read_manager.samples(), max_region, config_.max_buffer_size);
         }
         buffer_ = source_.get().fetch_reads(expand(*buffered_region_, config_.fetch_expansion));
         if (unchecked_fetch) {
@@ -135,7 +136,7 @@ namespace {
 
 GenomicRegion fully_expand_rhs(const GenomicRegion& region)
 {
-    return GenomicRegion {region.contig_name(), region.begin(), std::numeric_limits<GenomicRegion::Position>::max()};
+    return GenomicRegion {region.contig_id(), region.begin(), std::numeric_limits<GenomicRegion::Position>::max()};
 }
 
 } // namespace
@@ -5,7 +5,6 @@
 
 #include <vector>
 #include <deque>
-#include <functional>
 #include <iterator>
 #include <algorithm>
 #include <numeric>
@@ -13,10 +12,7 @@
 #include <cassert>
 
 #include <boost/random/uniform_int_distribution.hpp>
-#include <boost/random/discrete_distribution.hpp>
 
-#include "basics/mappable_reference_wrapper.hpp"
-#include "concepts/mappable_range.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_algorithms.hpp"
 #include "utils/append.hpp"
@@ -34,145 +30,84 @@ Downsampler::Report::DownsampleRegion::DownsampleRegion(GenomicRegion region, st
 
 namespace {
 
-using ReadWrapper = MappableReferenceWrapper<const AlignedRead>;
-
-using PositionCoverages = std::vector<unsigned>;
-
-bool has_minimum_coverage(const PositionCoverages& required_coverage)
-{
-    return std::all_of(std::cbegin(required_coverage), std::cend(required_coverage),
-                       [] (const auto coverage) noexcept { return coverage == 0; });
-}
-
-template <typename ForwardIt>
-auto calculate_minimum_coverages(const ForwardIt first, const ForwardIt last,
-                                 const GenomicRegion& region, const unsigned min_coverage)
-{
-    auto result = calculate_positional_coverage(first, last, region);
-    std::transform(std::cbegin(result), std::cend(result), std::begin(result),
-                   [min_coverage] (const auto coverage) noexcept {
-                       return std::min(coverage, min_coverage);
-                   });
-    return result;
-}
-
-auto sample(const PositionCoverages& required_coverage)
-{
-    static std::mt19937 generator {42};
-    // TODO: Do we really need to keep regenerating this distribution?
-    boost::random::discrete_distribution<std::size_t> dist {std::cbegin(required_coverage), std::cend(required_coverage)};
-    return dist(generator);
-}
-
-template <typename BidirIt>
-BidirIt random_sample(const BidirIt first, const BidirIt last)
-{
-    static std::mt19937 generator {42};
-    boost::random::uniform_int_distribution<std::size_t> dist(0, std::distance(first, last) - 1);
-    return std::next(first, dist(generator));
-}
-
-template <typename T>
-auto random_sample(const OverlapRange<T>& range)
-{
-    return random_sample(std::begin(range), std::end(range)).base();
-}
-
-template <typename BidirIt>
-auto pick_sample(BidirIt first_unsampled, BidirIt last_unsampled,
-                 const std::vector<GenomicRegion>& positions,
-                 const PositionCoverages& required_coverage,
-                 const AlignedRead::MappingDomain::Size max_read_size)
-{
-    assert(first_unsampled < last_unsampled);
-    const auto candidates = overlap_range(first_unsampled, last_unsampled,
-                                          positions[sample(required_coverage)],
-                                          max_read_size);
-    assert(!candidates.empty());
-    return random_sample(candidates);
-}
-
-void reduce(PositionCoverages& coverages, const ReadWrapper& read, const GenomicRegion& region)
-{
-    assert(!begins_before(read, region));
-    const auto read_offset = begin_distance(region, read);
-    const auto first = std::next(std::begin(coverages), read_offset);
-    auto last = std::next(first, region_size(read));
-    if (last > std::end(coverages)) last = std::end(coverages);
-    std::transform(first, last, first, [] (const auto x) noexcept { return (x > 0) ? x - 1 : 0; });
-}
-
-template <typename ForwardIt>
-ForwardIt shift_left(ForwardIt first, ForwardIt last)
-{
-    return std::rotate(first, std::next(first), last);
-}
-
-template <typename BidirIt>
-BidirIt shift_right(BidirIt first, BidirIt last)
-{
-    const auto rfirst = std::make_reverse_iterator(last);
-    const auto rlast  = std::make_reverse_iterator(first);
-    return std::rotate(rfirst, std::next(rfirst), rlast).base();
-}
-
-template <typename BidirIt>
-void remove_sample(BidirIt& first, BidirIt sample, BidirIt& last)
-{
-    assert(first <= sample && sample < last);
-    // rotating is linear time so it's cheaper to shift the sample into the closer of the
-    // two sampled groups.
-    if (std::distance(first, sample) < std::distance(sample, last)) {
-        if (sample != first) {
-            shift_right(first, std::next(sample));
+using RandomGenerator = std::mt19937;
+
+template <typename RandomIt>
+auto max_mapped_end(RandomIt first_read, RandomIt last_read)
+{
+    return mapped_end(*std::max_element(first_read, last_read, [] (const auto& lhs, const auto& rhs) {
+        return mapped_end(lhs) < mapped_end(rhs);
+    }));
+}
+
+// Selects reads so every position keeps coverage of at least the smaller of its original coverage and
+// target_coverage. The sorted reads are streamed left to right with the total and selected coverage
+// kept as difference arrays, so each position is visited once. Wherever the selected coverage falls short
+// the missing reads are drawn uniformly, without replacement, from the unselected reads covering it.
+template <typename RandomIt>
+std::vector<bool> select_reads(const RandomIt first_read, const RandomIt last_read, const unsigned target_coverage,
+                               RandomGenerator& generator)
+{
+    const auto num_reads = static_cast<std::size_t>(std::distance(first_read, last_read));
+    std::vector<bool> result(num_reads, false);
+    if (num_reads == 0) return result;
+    const auto first_position = mapped_begin(*first_read);
+    const auto num_positions = max_mapped_end(first_read, last_read) - first_position;
+    std::vector<int> total_changes(num_positions + 1, 0), selected_changes(num_positions + 1, 0);
+    std::for_each(first_read, last_read, [&] (const AlignedRead& read) {
+        ++total_changes[mapped_begin(read) - first_position];
+        --total_changes[mapped_end(read) - first_position];
+    });
+    const auto end_offset = [&] (const std::size_t read_idx) {
+        return static_cast<std::size_t>(mapped_end(*std::next(first_read, read_idx)) - first_position);
+    };
+    std::vector<std::size_t> candidates {}; // reads begun but not selected, possibly ended
+    std::size_t next_read_idx {0};
+    unsigned total_coverage {0}, selected_coverage {0};
+    for (std::size_t offset {0}; offset < num_positions; ++offset) {
+        for (; next_read_idx < num_reads; ++next_read_idx) {
+            if (mapped_begin(*std::next(first_read, next_read_idx)) - first_position > offset) break;
+            candidates.push_back(next_read_idx);
+        }
+        total_coverage += total_changes[offset];
+        selected_coverage += selected_changes[offset];
+        const auto required_coverage = std::min(total_coverage, target_coverage);
+        if (selected_coverage >= required_coverage) continue;
+        const auto is_ended = [&] (const std::size_t read_idx) { return end_offset(read_idx) <= offset; };
+        if (candidates.size() > 2 * static_cast<std::size_t>(total_coverage - selected_coverage)) {
+            candidates.erase(std::remove_if(std::begin(candidates), std::end(candidates), is_ended), std::end(candidates));
         }
-        ++first;
-    } else {
-        if (sample != std::prev(last)) {
-            shift_left(sample, last);
+        while (selected_coverage < required_coverage) {
+            assert(!candidates.empty());
+            boost::random::uniform_int_distribution<std::size_t> dist {0, candidates.size() - 1};
+            auto& candidate = candidates[dist(generator)];
+            const auto read_idx = candidate;
+            candidate = candidates.back();
+            candidates.pop_back();
+            if (is_ended(read_idx)) continue;
+            result[read_idx] = true;
+            ++selected_coverage;
+            --selected_changes[end_offset(read_idx)];
         }
-        --last;
     }
+    return result;
 }
 
-auto extract_sampled(std::vector<ReadWrapper>& reads,
-                     std::vector<ReadWrapper>::iterator first_unsampled,
-                     std::vector<ReadWrapper>::iterator last_unsampled)
+template <typename RandomIt>
+auto sample(const RandomIt first_read, const RandomIt last_read, const unsigned target_coverage,
+            RandomGenerator& generator)
 {
-    reads.erase(first_unsampled, last_unsampled);
-    std::sort(std::begin(reads), std::end(reads));
+    const auto selected = select_reads(first_read, last_read, target_coverage, generator);
     std::vector<AlignedRead> result {};
-    result.reserve(reads.size());
-    std::transform(std::begin(reads), std::end(reads), std::back_inserter(result),
-                   [] (const auto& wrapper) -> AlignedRead { return wrapper.get(); });
+    result.reserve(std::count(std::cbegin(selected), std::cend(selected), true));
+    for (std::size_t read_idx {0}; read_idx < selected.size(); ++read_idx) {
+        if (selected[read_idx]) result.push_back(*std::next(first_read, read_idx));
+    }
     return result;
 }
 
 } // namespace
 
-template <typename InputIt>
-auto sample(const InputIt first_read, const InputIt last_read, const GenomicRegion& region,
-            const unsigned target_coverage)
-{
-    if (first_read == last_read) return std::vector<AlignedRead> {};
-    const auto positions = decompose(region);
-    auto required_coverage = calculate_minimum_coverages(first_read, last_read, region, target_coverage);
-    assert(positions.size() == required_coverage.size());
-    std::vector<ReadWrapper> reads {first_read, last_read};
-    const auto max_read_size = size(largest_region(reads)); // for efficient overlap detection
-    // The reads are partitioned into three groups: sampled | unsampled | sampled
-    // which allows a sampled read to be optimally moved out of the unsampled partition
-    auto first_unsampled_itr = std::begin(reads);
-    auto last_unsampled_itr  = std::end(reads);
-    while (!has_minimum_coverage(required_coverage)) {
-        const auto sampled_itr = pick_sample(first_unsampled_itr, last_unsampled_itr,
-                                             positions, required_coverage, max_read_size);
-        reduce(required_coverage, *sampled_itr, region);
-        remove_sample(first_unsampled_itr, sampled_itr, last_unsampled_itr);
-    }
-    return extract_sampled(reads, first_unsampled_itr, last_unsampled_itr);
-}
-
 namespace {
 
 // Look for regions with coverage above max_coverage interconnected by positions
@@ -196,7 +131,8 @@ auto find_target_regions(const ReadContainer& reads, const unsigned max_coverage
 
 } // namespace
 
-Downsampler::Report sample(ReadContainer& reads, const unsigned trigger_coverage, const unsigned target_coverage)
+Downsampler::Report sample(ReadContainer& reads, const unsigned trigger_coverage, const unsigned target_coverage,
+                           RandomGenerator& generator)
 {
     using std::begin; using std::end; using std::make_move_iterator;
     
@@ -223,7 +159,7 @@ Downsampler::Report sample(ReadContainer& reads, const unsigned trigger_coverage
         const auto contained = bases(contained_range(begin(reads), end(reads), region));
         num_reads += std::distance(end(contained), end(reads));
         unsampled_read_blocks.emplace_back(make_move_iterator(end(contained)), make_move_iterator(end(reads)));
-        auto sampled_reads = sample(begin(contained), end(contained), region, target_coverage);
+        auto sampled_reads = sample(begin(contained), end(contained), target_coverage, generator);
         num_reads += sampled_reads.size();
         const auto num_reads_in_target = size(contained);
         assert(num_reads_in_target >= sampled_reads.size());
@@ -251,8 +187,13 @@ Downsampler::Report sample(ReadContainer& reads, const unsigned trigger_coverage
 // Downsampler
 
 Downsampler::Downsampler(const unsigned trigger_coverage, const unsigned target_coverage)
+: Downsampler {trigger_coverage, target_coverage, 42}
+{}
+
+Downsampler::Downsampler(const unsigned trigger_coverage, const unsigned target_coverage, const RandomSeed seed)
 : trigger_coverage_ {trigger_coverage}
 , target_coverage_ {target_coverage}
+, seed_ {seed}
 {
     if (target_coverage > trigger_coverage) {
         target_coverage_ = trigger_coverage;
@@ -261,7 +202,9 @@ Downsampler::Downsampler(const unsigned trigger_coverage, const unsigned target_
 
 Downsampler::Report Downsampler::downsample(ReadContainer& reads) const
 {
-    return sample(reads, trigger_coverage_, target_coverage_);
+    // Each call gets a freshly seeded generator so results don't depend on the order samples are processed
+    RandomGenerator generator {seed_};
+    return sample(reads, trigger_coverage_, target_coverage_, generator);
 }
 
 std::size_t count_downsampled_reads(const DownsamplerReportMap& reports)
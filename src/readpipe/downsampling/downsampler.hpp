@@ -5,6 +5,7 @@
 #define downsampler_hpp
 
 #include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 
 #include "config/common.hpp"
@@ -41,7 +42,11 @@ public:
     
     Downsampler() = default;
     
+    using RandomSeed = std::uint_fast32_t;
+    
     Downsampler(unsigned trigger_coverage, unsigned target_coverage);
+    // Output is deterministic for a given seed
+    Downsampler(unsigned trigger_coverage, unsigned target_coverage, RandomSeed seed);
     
     Downsampler(const Downsampler&)            = default;
     Downsampler& operator=(const Downsampler&) = default;
@@ -56,6 +61,7 @@ public:
 private:
     unsigned trigger_coverage_ = 10'000;
     unsigned target_coverage_  = 10'000;
+    RandomSeed seed_ = 42;
 };
 
 using DownsamplerReportMap = std::unordered_map<SampleName, Downsampler::Report>;
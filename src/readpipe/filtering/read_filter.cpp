@@ -35,6 +35,11 @@ bool IsNotSecondaryAlignment::passes(const AlignedRead& read) const noexcept
     return !read.is_marked_secondary_alignment();
 }
 
+void IsNotSecondaryAlignment::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.skip_secondary = true;
+}
+
 IsNotSupplementaryAlignment::IsNotSupplementaryAlignment()
 : BasicReadFilter {"IsNotSupplementaryAlignment"} {}
 
@@ -46,6 +51,11 @@ bool IsNotSupplementaryAlignment::passes(const AlignedRead& read) const noexcept
     return !read.is_marked_supplementary_alignment();
 }
 
+void IsNotSupplementaryAlignment::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.skip_supplementary = true;
+}
+
 IsGoodMappingQuality::IsGoodMappingQuality(MappingQuality good_mapping_quality)
 :
 BasicReadFilter {"IsGoodMappingQuality"}
@@ -60,6 +70,11 @@ bool IsGoodMappingQuality::passes(const AlignedRead& read) const noexcept
     return read.mapping_quality() >= good_mapping_quality_;
 }
 
+void IsGoodMappingQuality::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.min_mapping_quality = std::max(prefilter.min_mapping_quality, good_mapping_quality_);
+}
+
 HasSufficientGoodBaseFraction::HasSufficientGoodBaseFraction(BaseQuality good_base_quality,
                                                              double min_good_base_fraction)
 : BasicReadFilter {"HasSufficientGoodBaseFraction"}
@@ -114,6 +129,11 @@ bool IsMapped::passes(const AlignedRead& read) const noexcept
     return !read.is_marked_unmapped();
 }
 
+void IsMapped::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.skip_unmapped = true;
+}
+
 IsNotChimeric::IsNotChimeric() : BasicReadFilter {"IsNotChimeric"} {}
 IsNotChimeric::IsNotChimeric(std::string name) :  BasicReadFilter {std::move(name)} {}
 
@@ -138,6 +158,11 @@ bool IsNotMarkedDuplicate::passes(const AlignedRead& read) const noexcept
     return !read.is_marked_duplicate();
 }
 
+void IsNotMarkedDuplicate::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.skip_duplicates = true;
+}
+
 IsShort::IsShort(Length max_length)
 : BasicReadFilter {"IsShort"}
 , max_length_ {max_length} {}
@@ -164,6 +189,12 @@ bool IsLong::passes(const AlignedRead& read) const noexcept
     return sequence_size(read) >= min_length_;
 }
 
+void IsLong::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    // Decoding can only shorten reads (by trimming bases hanging off the contig start), so this is safe
+    prefilter.min_sequence_size = std::max(prefilter.min_sequence_size, min_length_);
+}
+
 IsNotContaminated::IsNotContaminated() : BasicReadFilter {"IsNotContaminated"} {}
 IsNotContaminated::IsNotContaminated(std::string name) :  BasicReadFilter {std::move(name)} {}
 
@@ -184,6 +215,11 @@ bool IsNotMarkedQcFail::passes(const AlignedRead& read) const noexcept
     return !read.is_marked_qc_fail();
 }
 
+void IsNotMarkedQcFail::do_constrain(io::ReadPrefilter& prefilter) const noexcept
+{
+    prefilter.skip_qc_fail = true;
+}
+
 IsProperTemplate::IsProperTemplate() : BasicReadFilter {"IsProperTemplate"} {}
 IsProperTemplate::IsProperTemplate(std::string name) :  BasicReadFilter {std::move(name)} {}
 
@@ -197,7 +233,7 @@ IsLocalTemplate::IsLocalTemplate(std::string name) :  BasicReadFilter {std::move
 
 bool IsLocalTemplate::passes(const AlignedRead& read) const noexcept
 {
-    return !read.has_other_segment() || read.next_segment().contig_name() == contig_name(read);
+    return !read.has_other_segment() || read.next_segment().contig_id() == contig_id(read);
 }
 
 } // namespace readpipe
@@ -12,6 +12,7 @@
 
 #include "basics/cigar_string.hpp"
 #include "basics/aligned_read.hpp"
+#include "io/read/read_prefilter.hpp"
 
 namespace octopus { namespace readpipe
 {
@@ -46,11 +47,19 @@ public:
         return passes(read);
     }
     
+    // Filters that only look at flags, mapping quality, or read length tighten the prefilter so
+    // reads they would fail can be skipped before being decoded
+    void constrain(io::ReadPrefilter& prefilter) const noexcept
+    {
+        do_constrain(prefilter);
+    }
+    
 protected:
     BasicReadFilter(std::string name) : Nameable {std::move(name)} {};
     
 private:
     virtual bool passes(const AlignedRead&) const noexcept = 0;
+    virtual void do_constrain(io::ReadPrefilter&) const noexcept {}
 };
 
 struct HasWellFormedCigar : BasicReadFilter
@@ -75,6 +84,7 @@ struct IsNotSecondaryAlignment : BasicReadFilter
     IsNotSecondaryAlignment(std::string name);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
 };
 
 struct IsNotSupplementaryAlignment : BasicReadFilter
@@ -83,6 +93,7 @@ struct IsNotSupplementaryAlignment : BasicReadFilter
     IsNotSupplementaryAlignment(std::string name);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
 };
 
 struct IsGoodMappingQuality : BasicReadFilter
@@ -96,6 +107,7 @@ struct IsGoodMappingQuality : BasicReadFilter
     IsGoodMappingQuality(std::string name, MappingQuality good_mapping_quality);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
     
 private:
     MappingQuality good_mapping_quality_;
@@ -141,6 +153,7 @@ struct IsMapped : BasicReadFilter
     IsMapped(std::string name);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
 };
 
 struct IsNotChimeric : BasicReadFilter
@@ -165,6 +178,7 @@ struct IsNotMarkedDuplicate : BasicReadFilter
     IsNotMarkedDuplicate(std::string name);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
 };
 
 struct IsShort : BasicReadFilter
@@ -190,6 +204,7 @@ struct IsLong : BasicReadFilter
     IsLong(std::string name, Length min_length);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
     
 private:
     Length min_length_;
@@ -209,6 +224,7 @@ struct IsNotMarkedQcFail : BasicReadFilter
     IsNotMarkedQcFail(std::string name);
     
     bool passes(const AlignedRead& read) const noexcept override;
+    void do_constrain(io::ReadPrefilter& prefilter) const noexcept override;
 };
 
 struct IsProperTemplate : BasicReadFilter
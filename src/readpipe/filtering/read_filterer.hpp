@@ -50,12 +50,22 @@ public:
     
     unsigned num_filters() const noexcept;
     
+    // The part of the basic filters that can be checked before reads are decoded
+    io::ReadPrefilter prefilter() const noexcept;
+    
     void shrink_to_fit() noexcept; // Just removes extra capcity for filters
     
     // Like std::remove
     BidirIt remove(ReadIterator first, ReadIterator last) const;
     BidirIt remove(ReadIterator first, ReadIterator last, FilterCountMap& filter_counts) const;
     
+    // Like remove, but each read is first passed to transform in the same pass as the basic filters
+    template <typename UnaryFunction>
+    BidirIt transform_remove(ReadIterator first, ReadIterator last, UnaryFunction transform) const;
+    template <typename UnaryFunction>
+    BidirIt transform_remove(ReadIterator first, ReadIterator last, UnaryFunction transform,
+                             FilterCountMap& filter_counts) const;
+    
     // Like std::stable_partition
     BidirIt partition(ReadIterator first, ReadIterator last) const;
     BidirIt partition(ReadIterator first, ReadIterator last, FilterCountMap& filter_counts) const;
@@ -66,6 +76,9 @@ private:
     
     bool passes_all_basic_filters(const AlignedRead& read) const noexcept;
     auto find_failing_basic_filter(const AlignedRead& read) const noexcept;
+    template <typename UnaryFunction>
+    BidirIt transform_remove_basic(ReadIterator first, ReadIterator last, UnaryFunction& transform,
+                                   std::vector<std::size_t>* flat_counts) const;
 };
 
 template <typename BidirIt>
@@ -86,6 +99,16 @@ unsigned ReadFilterer<BidirIt>::num_filters() const noexcept
     return static_cast<unsigned>(basic_filters_.size() + context_filters_.size());
 }
 
+template <typename BidirIt>
+io::ReadPrefilter ReadFilterer<BidirIt>::prefilter() const noexcept
+{
+    io::ReadPrefilter result {};
+    for (const auto& filter : basic_filters_) {
+        filter->constrain(result);
+    }
+    return result;
+}
+
 template <typename BidirIt>
 void ReadFilterer<BidirIt>::shrink_to_fit() noexcept
 {
@@ -244,6 +267,40 @@ BidirIt ReadFilterer<BidirIt>::partition(BidirIt first, BidirIt last,
     return last;
 }
 
+template <typename BidirIt>
+template <typename UnaryFunction>
+BidirIt ReadFilterer<BidirIt>::transform_remove(BidirIt first, BidirIt last, UnaryFunction transform) const
+{
+    last = transform_remove_basic(first, last, transform, nullptr);
+    std::for_each(cbegin(context_filters_), cend(context_filters_),
+                  [first, &last] (const auto& filter) {
+                      last = filter->remove(first, last);
+                  });
+    return last;
+}
+
+template <typename BidirIt>
+template <typename UnaryFunction>
+BidirIt ReadFilterer<BidirIt>::transform_remove(BidirIt first, BidirIt last, UnaryFunction transform,
+                                                FilterCountMap& filter_counts) const
+{
+    std::vector<std::size_t> flat_counts(basic_filters_.size(), 0);
+    last = transform_remove_basic(first, last, transform, &flat_counts);
+    filter_counts.reserve(num_filters());
+    std::transform(std::cbegin(basic_filters_), std::cend(basic_filters_), std::cbegin(flat_counts),
+                   std::inserter(filter_counts, std::begin(filter_counts)),
+                   [] (const auto& filter, const auto count) {
+                       return std::make_pair(filter->name(), count);
+                   });
+    std::for_each(cbegin(context_filters_), cend(context_filters_),
+                  [first, &last, &filter_counts] (const auto& filter) {
+                      const auto it = first == last ? last : filter->remove(first, last);
+                      filter_counts.emplace(filter->name(), std::distance(it, last));
+                      last = it;
+                  });
+    return last;
+}
+
 // private member methods
 
 template <typename BidirIt>
@@ -260,6 +317,29 @@ auto ReadFilterer<BidirIt>::find_failing_basic_filter(const AlignedRead& read) c
                             [&read] (const auto& filter) { return (*filter)(read); });
 }
 
+template <typename BidirIt>
+template <typename UnaryFunction>
+BidirIt ReadFilterer<BidirIt>::transform_remove_basic(BidirIt first, BidirIt last, UnaryFunction& transform,
+                                                      std::vector<std::size_t>* flat_counts) const
+{
+    auto result = first;
+    for (; first != last; ++first) {
+        transform(*first);
+        if (flat_counts) {
+            const auto it = find_failing_basic_filter(*first);
+            if (it != std::cend(basic_filters_)) {
+                ++(*flat_counts)[std::distance(std::cbegin(basic_filters_), it)];
+                continue;
+            }
+        } else if (!passes_all_basic_filters(*first)) {
+            continue;
+        }
+        if (result != first) *result = std::move(*first);
+        ++result;
+    }
+    return result;
+}
+
 // non-member methods
 
 template <typename Container>
@@ -6,10 +6,12 @@
 #include <utility>
 #include <iterator>
 #include <algorithm>
+#include <thread>
 #include <cassert>
 
 #include "utils/read_stats.hpp"
 #include "utils/mappable_algorithms.hpp"
+#include "utils/parallel_algorithms.hpp"
 
 namespace octopus {
 
@@ -27,6 +29,7 @@ ReadPipe::ReadPipe(const ReadManager& source, ReadTransformer transformer, ReadF
 , postfilter_transformer_ {}
 , downsampler_ {std::move(downsampler)}
 , samples_ {std::move(samples)}
+, max_threads_ {1}
 , debug_log_ {}
 {
     if (DEBUG_MODE) debug_log_ = logging::DebugLogger {};
@@ -41,6 +44,7 @@ ReadPipe::ReadPipe(const ReadManager& source, ReadTransformer prefilter_transfor
 , postfilter_transformer_ {std::move(postfilter_transformer)}
 , downsampler_ {std::move(downsampler)}
 , samples_ {std::move(samples)}
+, max_threads_ {1}
 , debug_log_ {}
 {
     if (DEBUG_MODE) debug_log_ = logging::DebugLogger {};
@@ -63,6 +67,15 @@ void ReadPipe::set_read_manager(const ReadManager& source) noexcept
     source_ = source;
 }
 
+void ReadPipe::set_max_threads(boost::optional<unsigned> max_threads)
+{
+    if (!max_threads) {
+        const auto num_cores = std::thread::hardware_concurrency();
+        max_threads = num_cores > 0 ? num_cores : 8;
+    }
+    max_threads_ = std::max(*max_threads, 1u);
+}
+
 unsigned ReadPipe::num_samples() const noexcept
 {
     return static_cast<unsigned>(samples_.size());
@@ -75,46 +88,21 @@ const std::vector<SampleName>& ReadPipe::samples() const noexcept
 
 namespace {
 
-template <typename Map>
-void sort_each(Map& reads)
+void insert(ReadContainer&& src, ReadContainer& dst)
 {
-    for (auto& p : reads) {
-        std::sort(std::begin(p.second), std::end(p.second));
+    if (dst.empty()) {
+        dst = std::move(src);
+    } else {
+        dst.insert(std::make_move_iterator(std::begin(src)), std::make_move_iterator(std::end(src)));
     }
+    src.clear();
+    src.shrink_to_fit();
 }
 
-auto fetch_batch(const ReadManager& rm, const std::vector<SampleName>& samples, const GenomicRegion& region)
-{
-    auto result = rm.fetch_reads(samples, region);
-    sort_each(result);
-    return result;
-}
-
-template <typename Container>
-void move_construct(Container&& src, ReadMap::mapped_type& dst)
-{
-    dst.insert(std::make_move_iterator(std::begin(src)), std::make_move_iterator(std::end(src)));
-}
-
-template <>
-void move_construct<ReadMap::mapped_type>(ReadMap::mapped_type&& src, ReadMap::mapped_type& dst)
-{
-    dst = std::move(src);
-}
-
-template <typename Container>
-void insert_each(Container&& src, ReadMap& dst)
+void insert_each(ReadMap&& src, ReadMap& dst)
 {
     for (auto& p : src) {
-        auto& sample_dst = dst.at(p.first);
-        if (sample_dst.empty()) {
-            move_construct(std::move(p.second), sample_dst);
-        } else {
-            sample_dst.insert(std::make_move_iterator(std::begin(p.second)),
-                              std::make_move_iterator(std::end(p.second)));
-        }
-        p.second.clear();
-        p.second.shrink_to_fit();
+        insert(std::move(p.second), dst.at(p.first));
     }
     src.clear();
 }
@@ -135,19 +123,49 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region, boost::optional<Repor
     for (const auto& sample : samples_) {
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
+    // Reads failing flag, mapping quality, or length filters are skipped before being decoded. The
+    // basic filters are still applied after the prefilter transformer, which does not change these.
+    // In debug mode every read is fetched so the per-filter counts are complete.
+    const auto prefilter = debug_log_ ? io::ReadPrefilter {} : filterer_.prefilter();
+    if (report && downsampler_) report->downsample_report.clear();
     for (const auto& batch : batch_samples(samples_)) {
-        auto batch_reads = fetch_batch(source_, batch, region);
+        auto batch_reads = source_.get().fetch_reads(batch, region, prefilter);
         if (debug_log_) {
-            stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " unfiltered reads from " << region;
+            std::size_t num_fetched_reads {0};
+            for (const auto& p : batch_reads) num_fetched_reads += p.second.size();
+            stream(*debug_log_) << "Fetched " << num_fetched_reads << " unfiltered reads from " << region;
         }
-        transform_reads(batch_reads, prefilter_transformer_);
-        if (debug_log_) {
-            SampleFilterCountMap<SampleName, decltype(filterer_)> filter_counts {};
-            filter_counts.reserve(samples_.size());
-            for (const auto& sample : samples_) {
-                filter_counts[sample].reserve(filterer_.num_filters());
+        // Everything written to by sample tasks is created up front so the tasks only touch their own entries
+        SampleFilterCountMap<SampleName, ReadFilterer> filter_counts {};
+        DownsamplerReportMap downsample_reports {};
+        std::vector<std::pair<ReadContainer*, ReadManager::ReadContainer*>> tasks {};
+        tasks.reserve(batch_reads.size());
+        std::vector<boost::optional<FilterCountMap&>> task_filter_counts {};
+        std::vector<boost::optional<DownsampleReport&>> task_downsample_reports {};
+        for (auto& p : batch_reads) {
+            tasks.emplace_back(&result.at(p.first), &p.second);
+            if (debug_log_) {
+                auto& counts = filter_counts[p.first];
+                counts.reserve(filterer_.num_filters());
+                task_filter_counts.emplace_back(counts);
+            } else {
+                task_filter_counts.emplace_back();
+            }
+            if (downsampler_) {
+                task_downsample_reports.emplace_back(downsample_reports[p.first]);
+            } else {
+                task_downsample_reports.emplace_back();
             }
-            erase_filtered_reads(batch_reads, filter(batch_reads, filterer_, filter_counts));
+        }
+        const auto prepare_sample = [&] (const std::size_t task_idx) {
+            insert(prepare(*tasks[task_idx].second, task_filter_counts[task_idx], task_downsample_reports[task_idx]),
+                   *tasks[task_idx].first);
+        };
+        // Each chunk of samples is at least this big so no more than max_threads_ run at once
+        const auto min_samples_per_thread = (tasks.size() + max_threads_ - 1) / max_threads_;
+        parallel_for(std::size_t {0}, tasks.size(), prepare_sample, shared_thread_pool(), min_samples_per_thread);
+        batch_reads.clear();
+        if (debug_log_) {
             if (filterer_.num_filters() > 0) {
                 for (const auto& p : filter_counts) {
                     stream(*debug_log_) << "In sample " << p.first;
@@ -160,28 +178,19 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region, boost::optional<Repor
                     }
                 }
             }
-        } else {
-            erase_filtered_reads(batch_reads, filter(batch_reads, filterer_));
-        }
-        if (postfilter_transformer_) {
-            transform_reads(batch_reads, *postfilter_transformer_);
-        }
-        if (debug_log_) {
-            stream(*debug_log_) << "There are " << count_reads(batch_reads) << " reads in " << region
-                            << " after filtering";
+            if (downsampler_) {
+                stream(*debug_log_) << "Downsampling removed " << count_downsampled_reads(downsample_reports) << " reads from " << region;
+            }
         }
-        if (downsampler_) {
-            auto reads = make_mappable_map(std::move(batch_reads));
-            auto downsample_reports = downsample(reads, *downsampler_);
-            if (debug_log_) stream(*debug_log_) << "Downsampling removed " << count_downsampled_reads(downsample_reports) << " reads from " << region;
-            if (report) {
-                report->downsample_report = std::move(downsample_reports);
+        if (report && downsampler_) {
+            for (auto& p : downsample_reports) {
+                report->downsample_report[p.first] = std::move(p.second);
             }
-            insert_each(std::move(reads), result);
-        } else {
-            insert_each(std::move(batch_reads), result);
         }
     }
+    if (debug_log_) {
+        stream(*debug_log_) << "There are " << count_reads(result) << " reads in " << region << " after filtering";
+    }
     shrink_to_fit(result); // TODO: should we make this conditional on extra capacity?
     return result;
 }
@@ -214,4 +223,42 @@ ReadMap ReadPipe::fetch_reads(const std::vector<GenomicRegion>& regions, boost::
     return result;
 }
 
+// private methods
+
+ReadContainer ReadPipe::prepare(ReadManager::ReadContainer& reads,
+                                boost::optional<FilterCountMap&> filter_counts,
+                                boost::optional<DownsampleReport&> downsample_report) const
+{
+    std::sort(std::begin(reads), std::end(reads));
+    auto filtered_itr = std::end(reads);
+    if (prefilter_transformer_.has_template_transforms()) {
+        prefilter_transformer_.transform_reads(std::begin(reads), std::end(reads));
+        if (filter_counts) {
+            filtered_itr = filterer_.remove(std::begin(reads), std::end(reads), *filter_counts);
+        } else {
+            filtered_itr = filterer_.remove(std::begin(reads), std::end(reads));
+        }
+    } else {
+        // One pass over the reads for the per-read transforms and basic filters
+        const auto transform = [this] (AlignedRead& read) { prefilter_transformer_.transform_read(read); };
+        if (filter_counts) {
+            filtered_itr = filterer_.transform_remove(std::begin(reads), std::end(reads), transform, *filter_counts);
+        } else {
+            filtered_itr = filterer_.transform_remove(std::begin(reads), std::end(reads), transform);
+        }
+    }
+    reads.erase(filtered_itr, std::end(reads));
+    if (postfilter_transformer_) {
+        postfilter_transformer_->transform_reads(std::begin(reads), std::end(reads));
+    }
+    ReadContainer result {std::make_move_iterator(std::begin(reads)), std::make_move_iterator(std::end(reads))};
+    reads.clear();
+    reads.shrink_to_fit();
+    if (downsampler_) {
+        auto sample_report = downsampler_->downsample(result);
+        if (downsample_report) *downsample_report = std::move(sample_report);
+    }
+    return result;
+}
+
 } // namespace octopus
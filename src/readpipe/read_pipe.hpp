@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <cstddef>
 #include <functional>
+#include <memory>
 
 #include <boost/optional.hpp>
 
@@ -66,6 +67,10 @@ public:
     const ReadManager& read_manager() const noexcept;
     void set_read_manager(const ReadManager& source) noexcept;
     
+    // Samples are prepared in parallel on the shared thread pool using up to max_threads threads
+    // (including the calling thread)
+    void set_max_threads(boost::optional<unsigned> max_threads);
+    
     unsigned num_samples() const noexcept;
     const std::vector<SampleName>& samples() const noexcept;
     
@@ -81,7 +86,15 @@ private:
     boost::optional<ReadTransformer> postfilter_transformer_;
     boost::optional<Downsampler> downsampler_;
     std::vector<SampleName> samples_;
+    unsigned max_threads_;
     mutable boost::optional<logging::DebugLogger> debug_log_;
+    
+    using FilterCountMap = readpipe::FilterCountMap<ReadFilterer>;
+    using DownsampleReport = Downsampler::Report;
+    
+    ReadContainer prepare(ReadManager::ReadContainer& reads,
+                          boost::optional<FilterCountMap&> filter_counts,
+                          boost::optional<DownsampleReport&> downsample_report) const;
 };
 
 } // namespace octopus
@@ -30,6 +30,11 @@ void ReadTransformer::shrink_to_fit() noexcept
     template_transforms_.shrink_to_fit();
 }
 
+bool ReadTransformer::has_template_transforms() const noexcept
+{
+    return !template_transforms_.empty();
+}
+
 void ReadTransformer::transform_read(AlignedRead& read) const
 {
     for (const auto& transform : read_transforms_) {
@@ -42,12 +42,15 @@ public:
     
     template <typename ForwardIt>
     void transform_reads(ForwardIt first, ForwardIt last) const;
-        
+    
+    // Template transforms need all reads, so only transformers without them can be applied read by read
+    bool has_template_transforms() const noexcept;
+    void transform_read(AlignedRead& read) const;
+    
 private:
     std::vector<ReadTransform> read_transforms_;
     std::vector<TemplateTransform> template_transforms_;
     
-    void transform_read(AlignedRead& read) const;
     template <typename ForwardIt>
     auto make_references(ForwardIt first, ForwardIt last) const;
     void transform(ReadReferenceVector& reads) const;
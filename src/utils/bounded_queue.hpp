@@ -0,0 +1,115 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef bounded_queue_hpp
+#define bounded_queue_hpp
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+namespace octopus {
+
+// A blocking FIFO queue with fixed capacity for connecting pipeline stages running on different threads.
+// Producers block while the queue is full and consumers block while it is empty. Once closed, pushes are
+// rejected and pops drain the remaining items before returning boost::none.
+template <typename T>
+class BoundedQueue
+{
+public:
+    BoundedQueue() = delete;
+
+    explicit BoundedQueue(std::size_t capacity);
+
+    BoundedQueue(const BoundedQueue&)            = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    BoundedQueue(BoundedQueue&&)                 = delete;
+    BoundedQueue& operator=(BoundedQueue&&)      = delete;
+
+    ~BoundedQueue() = default;
+
+    std::size_t capacity() const noexcept;
+
+    bool push(T item);
+    boost::optional<T> pop();
+
+    void close() noexcept;
+    bool is_closed() const noexcept;
+
+private:
+    const std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(const std::size_t capacity)
+: capacity_ {capacity > 0 ? capacity : 1}
+, items_ {}
+, closed_ {false}
+, mutex_ {}
+, not_full_ {}
+, not_empty_ {}
+{}
+
+template <typename T>
+std::size_t BoundedQueue<T>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template <typename T>
+bool BoundedQueue<T>::push(T item)
+{
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        not_full_.wait(lock, [this] () { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+    }
+    not_empty_.notify_one();
+    return true;
+}
+
+template <typename T>
+boost::optional<T> BoundedQueue<T>::pop()
+{
+    boost::optional<T> result {};
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        not_empty_.wait(lock, [this] () { return closed_ || !items_.empty(); });
+        if (items_.empty()) return result;
+        result = std::move(items_.front());
+        items_.pop_front();
+    }
+    not_full_.notify_one();
+    return result;
+}
+
+template <typename T>
+void BoundedQueue<T>::close() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
+
+template <typename T>
+bool BoundedQueue<T>::is_closed() const noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return closed_;
+}
+
+} // namespace octopus
+
+#endif
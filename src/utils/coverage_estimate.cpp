@@ -0,0 +1,83 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "coverage_estimate.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <cmath>
+
+namespace octopus {
+
+CoverageEstimate::CoverageEstimate(GenomicRegion region, const Size bin_size, const std::vector<double>& bin_counts)
+: region_ {std::move(region)}
+, bin_size_ {bin_size}
+, cumulative_counts_(bin_counts.size() + 1, 0.0)
+{
+    if (bin_size_ == 0) {
+        throw std::invalid_argument {"CoverageEstimate: bin_size must be positive"};
+    }
+    if (bin_counts.size() != (size(region_) + bin_size_ - 1) / bin_size_) {
+        throw std::invalid_argument {"CoverageEstimate: wrong number of bins"};
+    }
+    std::partial_sum(std::cbegin(bin_counts), std::cend(bin_counts), std::next(std::begin(cumulative_counts_)));
+}
+
+const GenomicRegion& CoverageEstimate::mapped_region() const noexcept
+{
+    return region_;
+}
+
+CoverageEstimate::Size CoverageEstimate::bin_size() const noexcept
+{
+    return bin_size_;
+}
+
+double CoverageEstimate::total() const noexcept
+{
+    return cumulative_counts_.empty() ? 0.0 : cumulative_counts_.back();
+}
+
+double CoverageEstimate::count(const GenomicRegion& region) const
+{
+    if (!is_same_contig(region, region_)) return 0;
+    return count_before(region.end()) - count_before(region.begin());
+}
+
+GenomicRegion CoverageEstimate::find_covered_subregion(const GenomicRegion& region, const double max_reads) const
+{
+    if (!is_same_contig(region, region_)) return region;
+    const auto max_count = count_before(region.begin()) + std::max(max_reads, 0.0);
+    if (count_before(region.end()) <= max_count) return region;
+    // The first bin whose cumulative count exceeds max_count contains the end of the subregion
+    const auto bin_itr = std::upper_bound(std::cbegin(cumulative_counts_), std::cend(cumulative_counts_), max_count);
+    const auto bin = static_cast<std::size_t>(std::distance(std::cbegin(cumulative_counts_), bin_itr)) - 1;
+    const auto bin_count = cumulative_counts_[bin + 1] - cumulative_counts_[bin];
+    const auto fraction = (max_count - cumulative_counts_[bin]) / bin_count;
+    const auto bin_begin = region_.begin() + bin * bin_size_;
+    auto end = bin_begin + static_cast<GenomicRegion::Position>(std::floor(fraction * bin_length(bin)));
+    end = std::max(std::min(end, region.end()), region.begin());
+    return GenomicRegion {region.contig_id(), region.begin(), end};
+}
+
+// private methods
+
+double CoverageEstimate::count_before(const GenomicRegion::Position position) const noexcept
+{
+    if (position <= region_.begin()) return 0;
+    if (position >= region_.end()) return total();
+    const auto offset = position - region_.begin();
+    const auto bin = offset / bin_size_;
+    const auto fraction = static_cast<double>(offset - bin * bin_size_) / bin_length(bin);
+    return cumulative_counts_[bin] + fraction * (cumulative_counts_[bin + 1] - cumulative_counts_[bin]);
+}
+
+CoverageEstimate::Size CoverageEstimate::bin_length(const std::size_t bin) const noexcept
+{
+    return std::min(bin_size_, static_cast<Size>(size(region_) - bin * bin_size_));
+}
+
+} // namespace octopus
@@ -0,0 +1,60 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef coverage_estimate_hpp
+#define coverage_estimate_hpp
+
+#include <vector>
+
+#include "concepts/mappable.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/**
+ CoverageEstimate holds the expected number of reads in fixed size bins of a region. Estimates
+ are made from file indices before any reads are read (see ReadManager::estimate_coverage), and
+ reads are assumed to be spread evenly within each bin.
+ */
+class CoverageEstimate : public Mappable<CoverageEstimate>
+{
+public:
+    using Size = GenomicRegion::Size;
+
+    CoverageEstimate() = default;
+
+    // bin_counts must have one count for each bin_size bin of region, the last bin may be partial
+    CoverageEstimate(GenomicRegion region, Size bin_size, const std::vector<double>& bin_counts);
+
+    CoverageEstimate(const CoverageEstimate&)            = default;
+    CoverageEstimate& operator=(const CoverageEstimate&) = default;
+    CoverageEstimate(CoverageEstimate&&)                 = default;
+    CoverageEstimate& operator=(CoverageEstimate&&)      = default;
+
+    ~CoverageEstimate() = default;
+
+    const GenomicRegion& mapped_region() const noexcept;
+
+    Size bin_size() const noexcept;
+
+    double total() const noexcept;
+
+    // The expected number of reads in region. Positions outside of the estimated region count zero.
+    double count(const GenomicRegion& region) const;
+
+    // Returns the largest region starting at region.begin() that is expected to have at most
+    // max_reads reads
+    GenomicRegion find_covered_subregion(const GenomicRegion& region, double max_reads) const;
+
+private:
+    GenomicRegion region_;
+    Size bin_size_ = 1;
+    std::vector<double> cumulative_counts_; // cumulative_counts_[i] is the expected reads in the first i bins
+
+    double count_before(GenomicRegion::Position position) const noexcept;
+    Size bin_length(std::size_t bin) const noexcept;
+};
+
+} // namespace octopus
+
+#endif
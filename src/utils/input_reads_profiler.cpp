@@ -43,15 +43,9 @@ auto estimate_dynamic_size(const AlignedRead& read) noexcept
     + sequence_size(read) * sizeof(char)
     + sequence_size(read) * sizeof(AlignedRead::BaseQuality)
     + read.cigar().size() * sizeof(CigarOperation)
-    + contig_name(read).size() * sizeof(char)
     + (read.has_other_segment() ? sizeof(AlignedRead::Segment) : 0);
 }
 
-auto estimate_read_size(const AlignedRead& read) noexcept
-{
-    return sizeof(AlignedRead) + estimate_dynamic_size(read);
-}
-
 auto get_covered_sample_regions(const std::vector<SampleName>& samples, const InputRegionMap& input_regions,
                                 const ReadManager& read_manager)
 {
@@ -75,7 +69,7 @@ auto choose_sample_region(const GenomicRegion& from, GenomicRegion::Size max_siz
     const auto max_begin = from.end() - max_size;
     static std::default_random_engine gen {};
     std::uniform_int_distribution<GenomicRegion::Position> dist {from.begin(), max_begin};
-    return GenomicRegion {from.contig_name(), dist(gen), from.end()};
+    return GenomicRegion {from.contig_id(), dist(gen), from.end()};
 }
 
 auto draw_sample(const SampleName& sample, const InputRegionMap& regions,
@@ -85,7 +79,7 @@ auto draw_sample(const SampleName& sample, const InputRegionMap& regions,
     assert(!contig_itr->second.empty());
     const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second));
     const auto sample_region = choose_sample_region(*region_itr, config.max_sample_size);
-    auto test_region = source.find_covered_subregion(sample, sample_region, config.max_sample_size);
+    auto test_region = source.estimate_covered_subregion({sample}, sample_region, config.max_sample_size);
     if (is_empty(test_region)) {
         test_region = expand_rhs(test_region, 1);
     }
@@ -98,7 +92,7 @@ auto draw_sample_from_begin(const SampleName& sample, const InputRegionMap& regi
     const auto contig_itr = random_select(std::cbegin(regions), std::cend(regions));
     assert(!contig_itr->second.empty());
     const auto region_itr = random_select(std::cbegin(contig_itr->second), std::cend(contig_itr->second));
-    auto test_region = source.find_covered_subregion(sample, *region_itr, config.max_sample_size);
+    auto test_region = source.estimate_covered_subregion({sample}, *region_itr, config.max_sample_size);
     if (is_empty(test_region)) {
         test_region = expand_rhs(test_region, 1);
     }
@@ -256,7 +250,7 @@ estimate_mean_read_size(const std::vector<SampleName>& samples,
         const auto it = random_select(std::cbegin(sample_regions), std::cend(sample_regions));
         assert(!it->second.empty());
         const auto it2 = random_select(std::cbegin(it->second), std::cend(it->second));
-        auto test_region = read_manager.find_covered_subregion(sample, *it2, num_samples_per_sample);
+        auto test_region = read_manager.estimate_covered_subregion({sample}, *it2, num_samples_per_sample);
         if (is_empty(test_region)) {
             test_region = expand_rhs(test_region, 1);
         }
@@ -268,6 +262,11 @@ estimate_mean_read_size(const std::vector<SampleName>& samples,
     return static_cast<std::size_t>(maths::mean(read_size_samples) + maths::stdev(read_size_samples));
 }
 
+std::size_t estimate_read_size(const AlignedRead& read) noexcept
+{
+    return sizeof(AlignedRead) + estimate_dynamic_size(read);
+}
+
 std::size_t default_read_size_estimate() noexcept
 {
     return sizeof(AlignedRead) + 300;
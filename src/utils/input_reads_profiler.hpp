@@ -44,6 +44,9 @@ estimate_mean_read_size(const std::vector<SampleName>& samples,
                         ReadManager& read_manager,
                         unsigned max_sample_size = 1000);
 
+// The approximate number of bytes used to store the read
+std::size_t estimate_read_size(const AlignedRead& read) noexcept;
+
 std::size_t default_read_size_estimate() noexcept;
 
 } // namespace octopus
@@ -12,6 +12,7 @@
 #include <iterator>
 #include <algorithm>
 #include <numeric>
+#include <limits>
 
 namespace octopus {
 
@@ -20,90 +21,141 @@ constexpr auto num_kmers(const unsigned char k) noexcept
     return 2 << (2 * static_cast<std::size_t>(k) - 1);
 }
 
-template <typename T = short>
+constexpr std::int_fast8_t invalid_base_hash {-1};
+
+// Non-ACGT bases hash to invalid_base_hash
+template <typename T = std::int_fast8_t>
 constexpr auto perfect_hash(const char base) noexcept
 {
+    constexpr T n {invalid_base_hash};
     constexpr std::array<T, 128> hashTable
     {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        n, n, n, n, n, n, n, n, n, n, n, n, n, n, n, n,
+        n, n, n, n, n, n, n, n, n, n, n, n, n, n, n, n,
+        n, n, n, n, n, n, n, n, n, n, n, n, n, n, n, n,
+        n, n, n, n, n, n, n, n, n, n, n, n, n, n, n, n,
+        n, 0, n, 1, n, n, n, 2, n, n, n, n, n, n, n, n,
+        n, n, n, n, 3, n, n, n, n, n, n, n, n, n, n, n,
+        n, 0, n, 1, n, n, n, 2, n, n, n, n, n, n, n, n,
+        n, n, n, n, 3, n, n, n, n, n, n, n, n, n, n, n
     };
-    return hashTable[base];
+    const auto index = static_cast<unsigned char>(base);
+    return index < hashTable.size() ? hashTable[index] : n;
 }
 
 using KmerHashType = std::uint_fast32_t;
 
+// Kmers containing a non-ACGT base are given this hash, which never maps
+template <unsigned char K>
+constexpr KmerHashType invalid_kmer_hash() noexcept
+{
+    return num_kmers(K);
+}
+
+// The first base is the least significant
 template <unsigned char K, typename InputIt>
 constexpr auto perfect_kmer_hash(InputIt first)
 {
-    unsigned k {1};
-    
-    return std::accumulate(first, std::next(first, K), KmerHashType {0},
-                           [&k] (const unsigned curr, const char base) {
-                               const auto result = curr + k * perfect_hash(base);
-                               k *= 4;
-                               return result;
-                           });
+    KmerHashType result {0};
+    for (unsigned i {0}; i < K; ++i, ++first) {
+        const auto base_hash = perfect_hash(*first);
+        if (base_hash == invalid_base_hash) return invalid_kmer_hash<K>();
+        result |= static_cast<KmerHashType>(base_hash) << (2 * i);
+    }
+    return result;
 }
 
 using KmerPerfectHashes = std::vector<KmerHashType>;
 
+// Hashes every kmer of the sequence with a rolling hash, so this is O(n) rather than O(nK)
+template <unsigned char K, typename OutputIt>
+OutputIt compute_kmer_hashes(const std::string& sequence, OutputIt result)
+{
+    static_assert(K > 0 && K <= 15, "K must be in [1, 15]");
+    if (sequence.size() < K) return result;
+    constexpr auto high_shift = 2 * (K - 1);
+    KmerHashType hash {0};
+    unsigned num_valid_bases {0}; // since the last non-ACGT base
+    for (std::size_t i {0}; i < sequence.size(); ++i) {
+        const auto base_hash = perfect_hash(sequence[i]);
+        if (base_hash == invalid_base_hash) {
+            num_valid_bases = 0;
+            hash = 0;
+        } else {
+            ++num_valid_bases;
+            hash = (hash >> 2) | (static_cast<KmerHashType>(base_hash) << high_shift);
+        }
+        if (i + 1 >= K) {
+            *result++ = num_valid_bases >= K ? hash : invalid_kmer_hash<K>();
+        }
+    }
+    return result;
+}
+
+template <unsigned char K>
+void compute_kmer_hashes(const std::string& sequence, KmerPerfectHashes& result)
+{
+    result.resize(sequence.size() >= K ? sequence.size() - K + 1 : 0);
+    compute_kmer_hashes<K>(sequence, std::begin(result));
+}
+
 template <unsigned char K>
 auto compute_kmer_hashes(const std::string& sequence)
 {
-    if (sequence.size() < K) {
-        return KmerPerfectHashes {};
-    }
-    
-    KmerPerfectHashes result(sequence.size() - K + 1);
-    
-    auto result_it = std::begin(result);
-    
-    for (auto it = std::cbegin(sequence); it != std::prev(std::cend(sequence), K - 1); ++it, ++result_it) {
-        *result_it = perfect_kmer_hash<K>(it);
-    }
-    
+    KmerPerfectHashes result {};
+    compute_kmer_hashes<K>(sequence, result);
     return result;
 }
 
-using KmerHashTable = std::pair<std::vector<std::vector<std::size_t>>, std::size_t>;
+/**
+ A flat index of target kmer positions. The positions of kmer h are
+ positions[offsets[h], offsets[h + 1]), in increasing order. Rebuilding the
+ table for a new target reuses the existing storage.
+ */
+struct KmerHashTable
+{
+    using IndexType = std::uint32_t;
+
+    std::vector<IndexType> offsets, positions;
+    std::size_t num_target_kmers;
+    KmerPerfectHashes hashes; // scratch space for target hashes
+};
 
 template <unsigned char K>
 KmerHashTable init_kmer_hash_table()
 {
-    return std::make_pair(std::vector<std::vector<std::size_t>> {num_kmers(K), std::vector<std::size_t> {}}, 0);
+    return KmerHashTable {std::vector<KmerHashTable::IndexType>(num_kmers(K) + 1, 0), {}, 0, {}};
 }
 
-inline void clear_kmer_hash_table(KmerHashTable& table)
+inline void clear_kmer_hash_table(KmerHashTable& table) noexcept
 {
-    for (auto& bin : table.first) bin.clear();
-    table.second = 0;
+    std::fill(std::begin(table.offsets), std::end(table.offsets), 0);
+    table.positions.clear();
+    table.num_target_kmers = 0;
 }
 
 template <unsigned char K>
 void populate_kmer_hash_table(const std::string& sequence, KmerHashTable& result)
 {
-    if (sequence.size() < K) {
-        return;
+    compute_kmer_hashes<K>(sequence, result.hashes);
+    auto& offsets = result.offsets;
+    offsets.assign(num_kmers(K) + 1, 0);
+    // Counting sort of target positions by kmer hash
+    for (const auto hash : result.hashes) {
+        if (hash != invalid_kmer_hash<K>()) ++offsets[hash + 1];
     }
-    
-    const auto last_index = sequence.size() - K;
-    
-    auto it = std::cbegin(sequence);
-    
-    for (std::size_t index {0}; index <= last_index; ++index, ++it) {
-        result.first[perfect_kmer_hash<K>(it)].push_back(index);
+    std::partial_sum(std::cbegin(offsets), std::cend(offsets), std::begin(offsets));
+    result.positions.resize(offsets.back());
+    for (std::size_t index {0}; index < result.hashes.size(); ++index) {
+        const auto hash = result.hashes[index];
+        if (hash != invalid_kmer_hash<K>()) {
+            result.positions[offsets[hash]++] = static_cast<KmerHashTable::IndexType>(index);
+        }
     }
-    
-    for (auto& bin : result.first) bin.shrink_to_fit();
-    
-    result.second = sequence.size() - K + 1;
+    // The fill loop moved each offset to the next bucket's begin
+    std::copy_backward(std::cbegin(offsets), std::prev(std::cend(offsets)), std::end(offsets));
+    offsets.front() = 0;
+    result.num_target_kmers = result.hashes.size();
 }
 
 template <unsigned char K>
@@ -114,55 +166,89 @@ KmerHashTable make_kmer_hash_table(const std::string& sequence)
     return result;
 }
 
-using MappedIndexCounts = std::vector<unsigned>;
+/**
+ Scratch space for map_query_to_target. Each query-target kmer hit votes for the
+ diagonal (mapping position) target_index - query_index. Counts are tagged with the
+ query they were made for, so the buffer never needs resetting between queries.
+ */
+struct MappedIndexCounts
+{
+    std::vector<unsigned> counts, query_ids;
+    unsigned query_id = 0;
+};
 
 inline MappedIndexCounts init_mapping_counts(const KmerHashTable& target)
 {
-    return MappedIndexCounts(target.second, 0);
+    return MappedIndexCounts {std::vector<unsigned>(target.num_target_kmers, 0),
+                              std::vector<unsigned>(target.num_target_kmers, 0), 0};
 }
 
-inline void reset_mapping_counts(MappedIndexCounts& mapping_counts)
+namespace detail {
+
+inline void prepare_mapping_counts(MappedIndexCounts& mapping_counts, const std::size_t num_target_kmers)
 {
-    std::fill(std::begin(mapping_counts), std::end(mapping_counts), 0);
+    if (mapping_counts.counts.size() < num_target_kmers) {
+        mapping_counts.counts.resize(num_target_kmers, 0);
+        mapping_counts.query_ids.resize(num_target_kmers, 0);
+    }
+    if (mapping_counts.query_id == std::numeric_limits<unsigned>::max()) {
+        std::fill(std::begin(mapping_counts.query_ids), std::end(mapping_counts.query_ids), 0);
+        mapping_counts.query_id = 0;
+    }
+    ++mapping_counts.query_id;
 }
 
+} // namespace detail
+
 template <typename OutputIt>
 OutputIt map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target,
                              MappedIndexCounts& mapping_counts, OutputIt result,
                              std::size_t max_mapping_positions = -1)
 {
+    if (target.num_target_kmers == 0 || max_mapping_positions == 0) return result;
+    detail::prepare_mapping_counts(mapping_counts, target.num_target_kmers);
+    const auto query_id = mapping_counts.query_id;
+    auto& counts = mapping_counts.counts;
+    auto& query_ids = mapping_counts.query_ids;
+    const auto num_hashes = target.offsets.size() - 1;
     unsigned max_hit_count {0};
     std::size_t first_max_hit_index {0};
     unsigned num_max_hits {0};
-    
+
     for (std::size_t query_index {0}; query_index < query.size(); ++query_index) {
-        for (const auto target_index : target.first[query[query_index]]) {
-            if (target_index >= query_index) {
-                const auto mapping_begin = target_index - query_index;
-                
-                if (++mapping_counts[mapping_begin] > max_hit_count) {
-                    max_hit_count = mapping_counts[mapping_begin];
+        const auto hash = query[query_index];
+        if (hash >= num_hashes) continue;
+        const auto first_position = std::next(std::cbegin(target.positions), target.offsets[hash]);
+        const auto last_position  = std::next(std::cbegin(target.positions), target.offsets[hash + 1]);
+        // Positions are sorted so skip those that would map before the target
+        const auto first_mappable = std::lower_bound(first_position, last_position, query_index);
+        std::for_each(first_mappable, last_position, [&] (const std::size_t target_index) {
+            const auto mapping_begin = target_index - query_index;
+            if (query_ids[mapping_begin] != query_id) {
+                query_ids[mapping_begin] = query_id;
+                counts[mapping_begin] = 0;
+            }
+            if (++counts[mapping_begin] > max_hit_count) {
+                max_hit_count = counts[mapping_begin];
+                first_max_hit_index = mapping_begin;
+                num_max_hits = 1;
+            } else if (counts[mapping_begin] == max_hit_count) {
+                ++num_max_hits;
+                if (mapping_begin < first_max_hit_index) {
                     first_max_hit_index = mapping_begin;
-                    num_max_hits = 1;
-                } else if (mapping_counts[mapping_begin] == max_hit_count) {
-                    ++num_max_hits;
-                    
-                    if (mapping_begin < first_max_hit_index) {
-                        first_max_hit_index = mapping_begin;
-                    }
                 }
             }
-        }
+        });
     }
-    
+
     if (max_hit_count > 0) {
         *result++ = first_max_hit_index++;
-        
+
         --num_max_hits;
         --max_mapping_positions;
-        
+
         while (max_mapping_positions > 0 && num_max_hits > 0) {
-            if (mapping_counts[first_max_hit_index] == max_hit_count) {
+            if (query_ids[first_max_hit_index] == query_id && counts[first_max_hit_index] == max_hit_count) {
                 *result++ = first_max_hit_index;
                 --num_max_hits;
                 --max_mapping_positions;
@@ -170,7 +256,7 @@ OutputIt map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable
             ++first_max_hit_index;
         }
     }
-    
+
     return result;
 }
 
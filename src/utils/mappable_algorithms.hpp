@@ -1419,7 +1419,7 @@ auto decompose(const MappableTp& mappable, GenomicRegion)
     if (num_elements == 0) return result;
     result.reserve(num_elements);
     GenomicRegion::Position n {0};
-    const auto& contig = contig_name(mappable);
+    const auto contig = contig_id(mappable);
     std::generate_n(std::back_inserter(result), num_elements, [&] () {
         const auto begin = mapped_begin(mappable) + n;
         ++n;
@@ -1454,9 +1454,9 @@ auto decompose(const MappableTp& mappable, const GenomicRegion::Position n)
     const auto num_elements = region_size(mappable) / n;
     if (num_elements == 0) return result;
     result.reserve(num_elements);
-    const auto& contig = contig_name(mappable);
+    const auto contig = contig_id(mappable);
     auto curr = mapped_begin(mappable);
-    std::generate_n(std::back_inserter(result), num_elements, [&contig, &curr, n] () {
+    std::generate_n(std::back_inserter(result), num_elements, [contig, &curr, n] () {
         auto tmp = curr;
         curr += n;
         return GenomicRegion {contig, tmp, tmp + n};
@@ -1476,9 +1476,9 @@ auto decompose(const MappableTp& mappable, const GenomicRegion::Position n, cons
     const auto num_elements = region_size(mappable) / (n - overlap);
     if (num_elements == 0) return result;
     result.reserve(num_elements);
-    const auto& contig = contig_name(mappable);
+    const auto contig = contig_id(mappable);
     auto curr = mapped_begin(mappable);
-    std::generate_n(std::back_inserter(result), num_elements, [&contig, &curr, n, overlap] () {
+    std::generate_n(std::back_inserter(result), num_elements, [contig, &curr, n, overlap] () {
         auto tmp = curr;
         curr += (n - overlap);
         return GenomicRegion {contig, tmp, tmp + n};
@@ -2044,7 +2044,7 @@ inline void append(const ContigRegion& base, ContigRegion::Position begin, Conti
 inline void append(const GenomicRegion& base, GenomicRegion::Position begin, GenomicRegion::Position end,
                    std::vector<GenomicRegion>& result)
 {
-    result.emplace_back(base.contig_name(), begin, end);
+    result.emplace_back(base.contig_id(), begin, end);
 }
 
 } // namespace detail
@@ -0,0 +1,168 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "memory_governor.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <iostream>
+
+namespace octopus {
+
+namespace {
+
+auto index(const MemoryGovernor::Component component) noexcept
+{
+    return static_cast<std::size_t>(component);
+}
+
+} // namespace
+
+MemoryGovernor::MemoryGovernor(MemoryFootprint budget)
+: budget_ {budget}
+{}
+
+boost::optional<MemoryFootprint> MemoryGovernor::budget() const noexcept
+{
+    return budget_;
+}
+
+MemoryGovernor::Reservation MemoryGovernor::reserve(const Component component, const MemoryFootprint footprint)
+{
+    const auto num_bytes = footprint.num_bytes();
+    std::lock_guard<std::mutex> lock {mutex_};
+    auto& usage = usage_[index(component)];
+    usage += num_bytes;
+    peak_usage_[index(component)] = std::max(peak_usage_[index(component)], usage);
+    total_usage_ += num_bytes;
+    peak_total_usage_ = std::max(peak_total_usage_, total_usage_);
+    return Reservation {*this, component, num_bytes};
+}
+
+MemoryFootprint MemoryGovernor::usage() const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return total_usage_;
+}
+
+MemoryFootprint MemoryGovernor::usage(const Component component) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return usage_[index(component)];
+}
+
+MemoryFootprint MemoryGovernor::peak_usage() const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return peak_total_usage_;
+}
+
+MemoryFootprint MemoryGovernor::peak_usage(const Component component) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return peak_usage_[index(component)];
+}
+
+double MemoryGovernor::headroom() const
+{
+    if (!budget_) return 1.0;
+    if (budget_->num_bytes() == 0) return 0.0;
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (total_usage_ >= budget_->num_bytes()) return 0.0;
+    return static_cast<double>(budget_->num_bytes() - total_usage_) / budget_->num_bytes();
+}
+
+void MemoryGovernor::wait_for(const MemoryFootprint footprint) const
+{
+    if (!budget_) return;
+    std::unique_lock<std::mutex> lock {mutex_};
+    released_.wait(lock, [&] () noexcept { return total_usage_ == 0 || can_reserve(footprint.num_bytes()); });
+}
+
+void MemoryGovernor::release(const Component component, const std::size_t num_bytes) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        usage_[index(component)] -= num_bytes;
+        total_usage_ -= num_bytes;
+    }
+    released_.notify_all();
+}
+
+bool MemoryGovernor::can_reserve(const std::size_t num_bytes) const noexcept
+{
+    return !budget_ || (total_usage_ <= budget_->num_bytes() && num_bytes <= budget_->num_bytes() - total_usage_);
+}
+
+// MemoryGovernor::Reservation
+
+MemoryGovernor::Reservation::Reservation(MemoryGovernor& governor, const Component component,
+                                         const std::size_t num_bytes) noexcept
+: governor_ {std::addressof(governor)}
+, component_ {component}
+, num_bytes_ {num_bytes}
+{}
+
+MemoryGovernor::Reservation::Reservation(Reservation&& other) noexcept
+: governor_ {other.governor_}
+, component_ {other.component_}
+, num_bytes_ {other.num_bytes_}
+{
+    other.governor_ = nullptr;
+    other.num_bytes_ = 0;
+}
+
+MemoryGovernor::Reservation& MemoryGovernor::Reservation::operator=(Reservation&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        std::swap(governor_, other.governor_);
+        std::swap(component_, other.component_);
+        std::swap(num_bytes_, other.num_bytes_);
+    }
+    return *this;
+}
+
+MemoryGovernor::Reservation::~Reservation() noexcept
+{
+    release();
+}
+
+MemoryFootprint MemoryGovernor::Reservation::footprint() const noexcept
+{
+    return num_bytes_;
+}
+
+void MemoryGovernor::Reservation::release() noexcept
+{
+    if (governor_) {
+        governor_->release(component_, num_bytes_);
+        governor_ = nullptr;
+        num_bytes_ = 0;
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryGovernor::Component component)
+{
+    using Component = MemoryGovernor::Component;
+    switch (component) {
+        case Component::reads: os << "reads"; break;
+        case Component::haplotypes: os << "haplotypes"; break;
+        case Component::likelihoods: os << "likelihoods"; break;
+    }
+    return os;
+}
+
+void print_peak_usage(std::ostream& os, const MemoryGovernor& governor)
+{
+    using Component = MemoryGovernor::Component;
+    bool first {true};
+    for (const auto component : {Component::reads, Component::haplotypes, Component::likelihoods}) {
+        if (!first) os << ", ";
+        os << component << ' ' << governor.peak_usage(component);
+        first = false;
+    }
+}
+
+} // namespace octopus
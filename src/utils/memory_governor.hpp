@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef memory_governor_hpp
+#define memory_governor_hpp
+
+#include <cstddef>
+#include <array>
+#include <mutex>
+#include <condition_variable>
+#include <iosfwd>
+
+#include <boost/optional.hpp>
+
+#include "memory_footprint.hpp"
+
+namespace octopus {
+
+/**
+ MemoryGovernor keeps account of the working memory held by calling tasks against a global budget.
+ Tasks reserve the estimated footprint of their large data structures (reads, haplotypes,
+ likelihood matrices) for as long as they hold them. Reserving never blocks or fails, as the memory
+ is already in use, but the task scheduler can use the remaining headroom to hold back or shrink
+ new tasks.
+
+ A governor without a budget just records usage.
+ */
+class MemoryGovernor
+{
+public:
+    enum class Component { reads, haplotypes, likelihoods };
+
+    class Reservation;
+
+    MemoryGovernor() = default;
+
+    MemoryGovernor(MemoryFootprint budget);
+
+    MemoryGovernor(const MemoryGovernor&)            = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+    MemoryGovernor(MemoryGovernor&&)                 = delete;
+    MemoryGovernor& operator=(MemoryGovernor&&)      = delete;
+
+    ~MemoryGovernor() = default;
+
+    boost::optional<MemoryFootprint> budget() const noexcept;
+
+    Reservation reserve(Component component, MemoryFootprint footprint);
+
+    MemoryFootprint usage() const;
+    MemoryFootprint usage(Component component) const;
+    MemoryFootprint peak_usage() const;
+    MemoryFootprint peak_usage(Component component) const;
+
+    // The unreserved fraction of the budget; 1 if there is no budget
+    double headroom() const;
+
+    // Blocks until footprint can be reserved without exceeding the budget, or until nothing is
+    // reserved, so a footprint larger than the budget does not wait forever.
+    void wait_for(MemoryFootprint footprint) const;
+
+private:
+    static constexpr std::size_t numComponents {3};
+
+    boost::optional<MemoryFootprint> budget_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable released_;
+    std::array<std::size_t, numComponents> usage_ = {}, peak_usage_ = {};
+    std::size_t total_usage_ = 0, peak_total_usage_ = 0;
+
+    void release(Component component, std::size_t num_bytes) noexcept;
+    bool can_reserve(std::size_t num_bytes) const noexcept;
+};
+
+class MemoryGovernor::Reservation
+{
+public:
+    Reservation() = default;
+
+    Reservation(const Reservation&)            = delete;
+    Reservation& operator=(const Reservation&) = delete;
+    Reservation(Reservation&& other) noexcept;
+    Reservation& operator=(Reservation&& other) noexcept;
+
+    ~Reservation() noexcept;
+
+    MemoryFootprint footprint() const noexcept;
+
+    void release() noexcept;
+
+private:
+    MemoryGovernor* governor_ = nullptr;
+    Component component_ = Component::reads;
+    std::size_t num_bytes_ = 0;
+
+    Reservation(MemoryGovernor& governor, Component component, std::size_t num_bytes) noexcept;
+
+    friend MemoryGovernor;
+};
+
+std::ostream& operator<<(std::ostream& os, MemoryGovernor::Component component);
+
+// Writes the peak usage of each component, e.g. "reads 1.2GB, haplotypes 10MB, likelihoods 300MB"
+void print_peak_usage(std::ostream& os, const MemoryGovernor& governor);
+
+} // namespace octopus
+
+#endif
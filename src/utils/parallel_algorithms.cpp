@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "parallel_algorithms.hpp"
+
+namespace octopus {
+
+TaskGroup::TaskGroup() : TaskGroup {shared_thread_pool()} {}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+: pool_ {pool}
+, num_pending_ {0}
+, cancelled_ {false}
+, mutex_ {}
+, finished_ {}
+, exception_ {}
+, unstarted_ {}
+{}
+
+TaskGroup::~TaskGroup() noexcept
+{
+    cancel();
+    wait_for_tasks();
+}
+
+void TaskGroup::wait()
+{
+    wait_for_tasks();
+    if (exception_) {
+        auto exception = exception_;
+        exception_ = nullptr;
+        cancelled_ = false;
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::cancel() noexcept
+{
+    cancelled_ = true;
+}
+
+bool TaskGroup::is_cancelled() const noexcept
+{
+    return cancelled_;
+}
+
+// private methods
+
+void TaskGroup::execute(Task& task) noexcept
+{
+    if (!cancelled_) {
+        try {
+            task.f();
+        } catch (...) {
+            set_exception(std::current_exception());
+        }
+    }
+    task.f = nullptr;
+    finish_task();
+}
+
+void TaskGroup::finish_task() noexcept
+{
+    // Notify under the lock so the group cannot be destroyed by a waiter before we are done with it
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (--num_pending_ == 0) finished_.notify_all();
+}
+
+void TaskGroup::set_exception(std::exception_ptr exception) noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (!exception_) exception_ = std::move(exception);
+    cancelled_ = true;
+}
+
+void TaskGroup::wait_for_tasks() noexcept
+{
+    std::unique_lock<std::mutex> lock {mutex_};
+    while (num_pending_ > 0) {
+        std::shared_ptr<Task> task {};
+        while (!task && !unstarted_.empty()) {
+            if (!unstarted_.front()->claimed.exchange(true)) task = unstarted_.front();
+            unstarted_.pop_front();
+        }
+        if (task) {
+            lock.unlock();
+            execute(*task);
+            lock.lock();
+        } else {
+            // Every remaining task is running on another thread
+            finished_.wait(lock, [this] () { return num_pending_ == 0; });
+        }
+    }
+    unstarted_.clear();
+}
+
+} // namespace octopus
@@ -0,0 +1,229 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef parallel_algorithms_hpp
+#define parallel_algorithms_hpp
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <boost/optional.hpp>
+
+#include "thread_pool.hpp"
+
+namespace octopus {
+
+/**
+ TaskGroup runs a set of tasks on a ThreadPool and waits for all of them. A waiting thread runs the
+ group's tasks that no worker has started yet itself, so groups can be nested inside pool tasks
+ without deadlock. Only the group's own tasks are run, so a wait never picks up unrelated pool work
+ (e.g. another calling task) on the waiting thread's stack.
+
+ If a task throws, the remaining tasks that have not started are cancelled and wait rethrows the
+ first exception. Tasks can also be cancelled explicitly with cancel.
+ */
+class TaskGroup
+{
+public:
+    TaskGroup();
+    explicit TaskGroup(ThreadPool& pool);
+
+    TaskGroup(const TaskGroup&)            = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&)                 = delete;
+    TaskGroup& operator=(TaskGroup&&)      = delete;
+
+    // Cancels any tasks that have not started and waits for the others
+    ~TaskGroup() noexcept;
+
+    template <typename F>
+    void run(F&& f);
+
+    void wait();
+
+    void cancel() noexcept;
+    bool is_cancelled() const noexcept;
+
+private:
+    // Each task is submitted to the pool and also kept by the group; whichever thread claims it
+    // first runs it, and the other copy is skipped
+    struct Task
+    {
+        std::function<void()> f;
+        std::atomic<bool> claimed {false};
+    };
+
+    ThreadPool& pool_;
+    std::atomic<std::size_t> num_pending_;
+    std::atomic<bool> cancelled_;
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    std::exception_ptr exception_;
+    std::deque<std::shared_ptr<Task>> unstarted_;
+
+    void execute(Task& task) noexcept;
+    void finish_task() noexcept;
+    void set_exception(std::exception_ptr exception) noexcept;
+    void wait_for_tasks() noexcept;
+};
+
+template <typename F>
+void TaskGroup::run(F&& f)
+{
+    ++num_pending_;
+    auto task = std::make_shared<Task>();
+    task->f = std::forward<F>(f);
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        unstarted_.push_back(task);
+    }
+    try {
+        // The group may be gone by the time a worker reaches a task the group already ran, so
+        // nothing but the task is touched until it is claimed
+        pool_.submit([this, task] () { if (!task->claimed.exchange(true)) execute(*task); });
+    } catch (...) {
+        if (!task->claimed.exchange(true)) finish_task();
+        throw;
+    }
+}
+
+namespace detail {
+
+// A few chunks per thread lets idle workers steal from slow chunks
+inline std::size_t count_chunks(const std::size_t n, const ThreadPool& pool, const std::size_t min_chunk_size) noexcept
+{
+    constexpr std::size_t chunksPerThread {4};
+    const auto max_chunks = n / std::max(min_chunk_size, std::size_t {1});
+    if (pool.empty() || max_chunks < 2) return 1;
+    return std::min((pool.size() + 1) * chunksPerThread, max_chunks);
+}
+
+// Calls f(chunk, begin, end) for each of num_chunks contiguous chunks of [0, n). The calling thread
+// runs the first chunk.
+template <typename F>
+void for_each_chunk(const std::size_t n, const std::size_t num_chunks, F&& f, ThreadPool& pool)
+{
+    if (num_chunks < 2) {
+        if (n > 0) f(0, 0, n);
+        return;
+    }
+    const auto chunk_size = (n + num_chunks - 1) / num_chunks;
+    TaskGroup group {pool};
+    for (std::size_t chunk {1}, begin {chunk_size}; begin < n; ++chunk, begin += chunk_size) {
+        const auto end = std::min(begin + chunk_size, n);
+        group.run([&f, chunk, begin, end] () { f(chunk, begin, end); });
+    }
+    f(0, 0, std::min(chunk_size, n));
+    group.wait();
+}
+
+} // namespace detail
+
+// Calls f(i) for each i in [first, last)
+template <typename Integer, typename UnaryFunction>
+void parallel_for(const Integer first, const Integer last, UnaryFunction f,
+                  ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    if (last <= first) return;
+    const auto n = static_cast<std::size_t>(last - first);
+    detail::for_each_chunk(n, detail::count_chunks(n, pool, min_chunk_size),
+                           [&] (std::size_t, std::size_t begin, std::size_t end) {
+                               for (auto i = first + static_cast<Integer>(begin); i < first + static_cast<Integer>(end); ++i) f(i);
+                           }, pool);
+}
+
+template <typename RandomIt, typename UnaryFunction>
+void parallel_for_each(RandomIt first, RandomIt last, UnaryFunction f,
+                       ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    detail::for_each_chunk(n, detail::count_chunks(n, pool, min_chunk_size),
+                           [&] (std::size_t, std::size_t begin, std::size_t end) {
+                               std::for_each(std::next(first, begin), std::next(first, end), f);
+                           }, pool);
+}
+
+// Results are written to result in input order
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(RandomIt first, RandomIt last, OutputIt result, UnaryOp op,
+                            ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    using ResultType = std::decay_t<decltype(op(*first))>;
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const auto num_chunks = detail::count_chunks(n, pool, min_chunk_size);
+    if (num_chunks < 2) return std::transform(first, last, result, std::move(op));
+    std::vector<std::vector<ResultType>> chunk_results(num_chunks);
+    detail::for_each_chunk(n, num_chunks, [&] (std::size_t chunk, std::size_t begin, std::size_t end) {
+        chunk_results[chunk].reserve(end - begin);
+        std::transform(std::next(first, begin), std::next(first, end), std::back_inserter(chunk_results[chunk]), op);
+    }, pool);
+    for (auto& results : chunk_results) {
+        result = std::move(std::begin(results), std::end(results), result);
+    }
+    return result;
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename BinaryOp>
+OutputIt parallel_transform(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, OutputIt result, BinaryOp op,
+                            ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    using ResultType = std::decay_t<decltype(op(*first1, *first2))>;
+    const auto n = static_cast<std::size_t>(std::distance(first1, last1));
+    const auto num_chunks = detail::count_chunks(n, pool, min_chunk_size);
+    if (num_chunks < 2) return std::transform(first1, last1, first2, result, std::move(op));
+    std::vector<std::vector<ResultType>> chunk_results(num_chunks);
+    detail::for_each_chunk(n, num_chunks, [&] (std::size_t chunk, std::size_t begin, std::size_t end) {
+        chunk_results[chunk].reserve(end - begin);
+        std::transform(std::next(first1, begin), std::next(first1, end), std::next(first2, begin),
+                       std::back_inserter(chunk_results[chunk]), op);
+    }, pool);
+    for (auto& results : chunk_results) {
+        result = std::move(std::begin(results), std::end(results), result);
+    }
+    return result;
+}
+
+// reduce must be associative as chunks are reduced independently, but the chunk results are
+// combined in input order, so it need not be commutative
+template <typename RandomIt, typename T, typename BinaryOp, typename UnaryOp>
+T parallel_transform_reduce(RandomIt first, RandomIt last, T init, BinaryOp reduce, UnaryOp transform,
+                            ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const auto num_chunks = detail::count_chunks(n, pool, min_chunk_size);
+    std::vector<boost::optional<T>> partials(num_chunks);
+    detail::for_each_chunk(n, num_chunks, [&] (std::size_t chunk, std::size_t begin, std::size_t end) {
+        T partial = transform(*std::next(first, begin));
+        std::for_each(std::next(first, begin + 1), std::next(first, end), [&] (const auto& value) {
+            partial = reduce(std::move(partial), transform(value));
+        });
+        partials[chunk] = std::move(partial);
+    }, pool);
+    for (auto& partial : partials) {
+        if (partial) init = reduce(std::move(init), std::move(*partial));
+    }
+    return init;
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(RandomIt first, RandomIt last, T init, BinaryOp reduce,
+                  ThreadPool& pool = shared_thread_pool(), const std::size_t min_chunk_size = 1)
+{
+    return parallel_transform_reduce(first, last, std::move(init), std::move(reduce),
+                                     [] (const auto& value) -> T { return value; }, pool, min_chunk_size);
+}
+
+} // namespace octopus
+
+#endif
@@ -284,7 +284,7 @@ template <typename T>
 AlignedRead::NucleotideSequence::size_type mean_read_length(const T& reads, NonMapTag)
 {
     if (reads.empty()) return 0;
-    return maths::mean(std::cbegin(reads), std::cend(reads), [] (const auto& read) { return sequence_size(read); });
+    return maths::mean(std::cbegin(reads), std::cend(reads), [] (const AlignedRead& read) { return sequence_size(read); });
 }
 
 template <typename T>
@@ -292,7 +292,7 @@ AlignedRead::NucleotideSequence::size_type mean_read_length(const T& reads, cons
 {
     const auto overlapped = overlap_range(reads, region);
     if (empty(overlapped)) return 0;
-    return maths::mean(std::cbegin(overlapped), std::cend(overlapped), [] (const auto& read) { return sequence_size(read); });
+    return maths::mean(std::cbegin(overlapped), std::cend(overlapped), [] (const AlignedRead& read) { return sequence_size(read); });
 }
 
 template <typename T>
@@ -300,7 +300,7 @@ AlignedRead::NucleotideSequence::size_type median_read_length(const T& reads, No
 {
     if (reads.empty()) return 0;
     std::vector<AlignedRead::NucleotideSequence::size_type> lengths(reads.size());
-    std::transform(std::cbegin(reads), std::cend(reads), std::begin(lengths), [] (const auto& read) { return sequence_size(read); });
+    std::transform(std::cbegin(reads), std::cend(reads), std::begin(lengths), [] (const AlignedRead& read) { return sequence_size(read); });
     return maths::median(lengths);
 }
 
@@ -310,7 +310,7 @@ AlignedRead::NucleotideSequence::size_type median_read_length(const T& reads, co
     const auto overlapped = overlap_range(reads, region);
     if (empty(overlapped)) return 0;
     std::vector<AlignedRead::NucleotideSequence::size_type> lengths(size(overlapped));
-    std::transform(std::cbegin(overlapped), std::cend(overlapped), std::begin(lengths), [] (const auto& read) { return sequence_size(read); });
+    std::transform(std::cbegin(overlapped), std::cend(overlapped), std::begin(lengths), [] (const AlignedRead& read) { return sequence_size(read); });
     return maths::median(lengths);
 }
 
@@ -440,7 +440,7 @@ double median_mapping_quality(const T& reads, NonMapTag)
     static_assert(is_aligned_read_container<T>, "T must be a container of AlignedReads");
     std::vector<double> qualities(reads.size());
     std::transform(std::cbegin(reads), std::cend(reads), std::begin(qualities),
-                   [] (const auto& read) { return static_cast<double>(read.mapping_quality()); });
+                   [] (const AlignedRead& read) { return static_cast<double>(read.mapping_quality()); });
     return maths::median<double>(qualities);
 }
 
@@ -451,7 +451,7 @@ double median_mapping_quality(const T& reads, const GenomicRegion& region, NonMa
     const auto overlapped = overlap_range(reads, region);
     std::vector<double> qualities(size(overlapped));
     std::transform(std::cbegin(overlapped), std::cend(overlapped), std::begin(qualities),
-                   [] (const auto& read) { return static_cast<double>(read.mapping_quality()); });
+                   [] (const AlignedRead& read) { return static_cast<double>(read.mapping_quality()); });
     return maths::median<double>(qualities);
 }
 
@@ -461,7 +461,7 @@ double rmq_mapping_quality(const T& reads, NonMapTag)
     static_assert(is_aligned_read_container<T>, "T must be a container of AlignedReads");
     std::vector<double> qualities(reads.size());
     std::transform(std::cbegin(reads), std::cend(reads), std::begin(qualities),
-                   [] (const auto& read) { return static_cast<double>(read.mapping_quality()); });
+                   [] (const AlignedRead& read) { return static_cast<double>(read.mapping_quality()); });
     return maths::rmq<double>(qualities);
 }
 
@@ -472,7 +472,7 @@ double rmq_mapping_quality(const T& reads, const GenomicRegion& region, NonMapTa
     const auto overlapped = overlap_range(reads, region);
     std::vector<double> qualities(size(overlapped));
     std::transform(std::cbegin(overlapped), std::cend(overlapped), std::begin(qualities),
-                   [] (const auto& read) { return static_cast<double>(read.mapping_quality()); });
+                   [] (const AlignedRead& read) { return static_cast<double>(read.mapping_quality()); });
     return maths::rmq<double>(qualities);
 }
 
@@ -497,7 +497,7 @@ double median_base_quality(const T& reads, const GenomicRegion& region, NonMapTa
     const auto overlapped = overlap_range(reads, region);
     std::vector<double> qualities {};
     qualities.reserve(count_base_pairs(reads, region, NonMapTag {}));
-    std::for_each(std::cbegin(overlapped), std::cend(overlapped), [&qualities] (const auto& read) {
+    std::for_each(std::cbegin(overlapped), std::cend(overlapped), [&qualities] (const AlignedRead& read) {
         for (const auto quality : read.base_qualities()) {
             qualities.push_back(static_cast<double>(quality));
         }
@@ -526,7 +526,7 @@ double rmq_base_quality(const T& reads, const GenomicRegion& region, NonMapTag)
     const auto overlapped = overlap_range(reads, region);
     std::vector<double> qualities {};
     qualities.reserve(count_base_pairs(reads, region, NonMapTag {}));
-    std::for_each(std::cbegin(overlapped), std::cend(overlapped), [&qualities] (const auto& read) {
+    std::for_each(std::cbegin(overlapped), std::cend(overlapped), [&qualities] (const AlignedRead& read) {
         for (const auto quality : read.base_qualities()) {
             qualities.push_back(static_cast<double>(quality));
         }
@@ -878,7 +878,7 @@ AlignedRead::NucleotideSequence::size_type median_read_length(const T& reads, Ma
     auto length_itr = std::begin(lengths);
     for (const auto& p : reads) {
         length_itr = std::transform(std::cbegin(p.second), std::cend(p.second), length_itr,
-                                    [] (const auto& read) { return sequence_size(read); });
+                                    [] (const AlignedRead& read) { return sequence_size(read); });
     }
     return maths::median(lengths);
 }
@@ -893,7 +893,7 @@ AlignedRead::NucleotideSequence::size_type median_read_length(const T& reads, co
     for (const auto& p : reads) {
         const auto overlapped = overlap_range(p.second, region);
         length_itr = std::transform(std::cbegin(overlapped), std::cend(overlapped), length_itr,
-                                    [] (const auto& read) { return sequence_size(read); });
+                                    [] (const AlignedRead& read) { return sequence_size(read); });
     }
     return maths::median(lengths);
 }
@@ -1017,7 +1017,7 @@ double median_mapping_quality(const T& reads, MapTag)
     qualities.reserve(maths::sum_sizes(reads));
     for (const auto& sample_reads : reads) {
         std::transform(std::cbegin(sample_reads.second), std::cend(sample_reads.second),
-                       std::back_inserter(qualities), [] (const auto& read) {
+                       std::back_inserter(qualities), [] (const AlignedRead& read) {
             return static_cast<double>(read.mapping_quality());
         });
     }
@@ -1032,7 +1032,7 @@ double median_mapping_quality(const T& reads, const GenomicRegion& region, MapTa
     for (const auto& sample_reads : reads) {
         const auto overlapped = overlap_range(sample_reads.second, region);
         std::transform(std::cbegin(overlapped), std::cend(overlapped),
-                       std::back_inserter(qualities), [] (const auto& read) {
+                       std::back_inserter(qualities), [] (const AlignedRead& read) {
             return static_cast<double>(read.mapping_quality());
         });
     }
@@ -1046,7 +1046,7 @@ double rmq_mapping_quality(const T& reads, MapTag)
     qualities.reserve(maths::sum_sizes(reads));
     for (const auto& sample_reads : reads) {
         std::transform(std::cbegin(sample_reads.second), std::cend(sample_reads.second),
-                       std::back_inserter(qualities), [] (const auto& read) {
+                       std::back_inserter(qualities), [] (const AlignedRead& read) {
                            return static_cast<double>(read.mapping_quality());
                        });
     }
@@ -1061,7 +1061,7 @@ double rmq_mapping_quality(const T& reads, const GenomicRegion& region, MapTag)
     for (const auto& sample_reads : reads) {
         const auto overlapped = overlap_range(sample_reads.second, region);
         std::transform(std::cbegin(overlapped), std::cend(overlapped),
-                       std::back_inserter(qualities), [] (const auto& read) {
+                       std::back_inserter(qualities), [] (const AlignedRead& read) {
                            return static_cast<double>(read.mapping_quality());
                        });
     }
@@ -1091,7 +1091,7 @@ double median_base_quality(const T& reads, const GenomicRegion& region, MapTag)
     for (const auto& sample_reads : reads) {
         const auto overlapped = overlap_range(sample_reads.second, region);
         std::for_each(std::cbegin(overlapped), std::cend(overlapped),
-                      [&qualities] (const auto& read) {
+                      [&qualities] (const AlignedRead& read) {
                           for (const auto quality : read.base_qualities()) {
                               qualities.push_back(static_cast<double>(quality));
                           }
@@ -1123,7 +1123,7 @@ double rmq_base_quality(const T& reads, const GenomicRegion& region, MapTag)
     for (const auto& sample_reads : reads) {
         const auto overlapped = overlap_range(sample_reads.second, region);
         std::for_each(std::cbegin(overlapped), std::cend(overlapped),
-                      [&qualities] (const auto& read) {
+                      [&qualities] (const AlignedRead& read) {
                           for (const auto quality : read.base_qualities()) {
                               qualities.push_back(static_cast<double>(quality));
                           }
@@ -0,0 +1,290 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "region_read_summary.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+#include <cmath>
+#include <cassert>
+
+#include "utils/mappable_algorithms.hpp"
+
+namespace octopus {
+
+RegionReadSummary::ReadTotals& RegionReadSummary::ReadTotals::operator+=(const ReadTotals& other) noexcept
+{
+    reads += other.reads;
+    forward += other.forward;
+    supplementary += other.supplementary;
+    mapq_zero += other.mapq_zero;
+    soft_clipped += other.soft_clipped;
+    heavily_clipped += other.heavily_clipped;
+    mapping_quality += other.mapping_quality;
+    squared_mapping_quality += other.squared_mapping_quality;
+    return *this;
+}
+
+RegionReadSummary::ReadTotals& RegionReadSummary::ReadTotals::operator-=(const ReadTotals& other) noexcept
+{
+    reads -= other.reads;
+    forward -= other.forward;
+    supplementary -= other.supplementary;
+    mapq_zero -= other.mapq_zero;
+    soft_clipped -= other.soft_clipped;
+    heavily_clipped -= other.heavily_clipped;
+    mapping_quality -= other.mapping_quality;
+    squared_mapping_quality -= other.squared_mapping_quality;
+    return *this;
+}
+
+RegionReadSummary::RegionReadSummary(GenomicRegion region, const ReadContainer& reads)
+: region_ {std::move(region)}
+{
+    init();
+    std::vector<int> coverage_changes(size(region_) + 1);
+    add(reads, coverage_changes);
+    finalise(coverage_changes);
+}
+
+RegionReadSummary::RegionReadSummary(GenomicRegion region, const ReadMap& reads)
+: region_ {std::move(region)}
+{
+    init();
+    std::vector<int> coverage_changes(size(region_) + 1);
+    for (const auto& p : reads) {
+        add(p.second, coverage_changes);
+    }
+    finalise(coverage_changes);
+}
+
+const GenomicRegion& RegionReadSummary::mapped_region() const noexcept
+{
+    return region_;
+}
+
+RegionReadSummary& RegionReadSummary::operator+=(const RegionReadSummary& other)
+{
+    if (begin_totals_.empty()) return *this = other;
+    assert(region_ == other.region_);
+    const auto add_to = [] (auto& lhs, const auto& rhs) {
+        std::transform(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs), std::begin(lhs),
+                       [] (auto a, const auto& b) { return a += b; });
+    };
+    add_to(begin_totals_, other.begin_totals_);
+    add_to(end_totals_, other.end_totals_);
+    add_to(coverage_sums_, other.coverage_sums_);
+    add_to(squared_coverage_sums_, other.squared_coverage_sums_);
+    std::vector<unsigned> coverages(size(region_));
+    std::adjacent_difference(std::next(std::cbegin(coverage_sums_)), std::cend(coverage_sums_), std::begin(coverages));
+    build_coverage_tables(std::move(coverages));
+    return *this;
+}
+
+bool RegionReadSummary::has_coverage(const GenomicRegion& region) const
+{
+    return max_coverage(region) > 0;
+}
+
+unsigned RegionReadSummary::min_coverage(const GenomicRegion& region) const
+{
+    std::size_t first, last;
+    std::tie(first, last) = offsets(region);
+    if (first == last) return 0;
+    const auto level = static_cast<std::size_t>(std::log2(last - first));
+    const auto& coverages = min_coverages_[level];
+    return std::min(coverages[first], coverages[last - (std::size_t {1} << level)]);
+}
+
+unsigned RegionReadSummary::max_coverage(const GenomicRegion& region) const
+{
+    std::size_t first, last;
+    std::tie(first, last) = offsets(region);
+    if (first == last) return 0;
+    const auto level = static_cast<std::size_t>(std::log2(last - first));
+    const auto& coverages = max_coverages_[level];
+    return std::max(coverages[first], coverages[last - (std::size_t {1} << level)]);
+}
+
+double RegionReadSummary::mean_coverage(const GenomicRegion& region) const
+{
+    std::size_t first, last;
+    std::tie(first, last) = offsets(region);
+    if (first == last) return 0;
+    return static_cast<double>(coverage_sums_[last] - coverage_sums_[first]) / (last - first);
+}
+
+double RegionReadSummary::stdev_coverage(const GenomicRegion& region) const
+{
+    std::size_t first, last;
+    std::tie(first, last) = offsets(region);
+    if (first == last) return 0;
+    const auto n = static_cast<double>(last - first);
+    const auto mean = (coverage_sums_[last] - coverage_sums_[first]) / n;
+    const auto mean_square = (squared_coverage_sums_[last] - squared_coverage_sums_[first]) / n;
+    return std::sqrt(std::max(mean_square - mean * mean, 0.0));
+}
+
+std::size_t RegionReadSummary::count_reads(const GenomicRegion& region) const
+{
+    return totals(region).reads;
+}
+
+std::size_t RegionReadSummary::count_forward(const GenomicRegion& region) const
+{
+    return totals(region).forward;
+}
+
+std::size_t RegionReadSummary::count_reverse(const GenomicRegion& region) const
+{
+    const auto region_totals = totals(region);
+    return region_totals.reads - region_totals.forward;
+}
+
+std::pair<std::size_t, std::size_t> RegionReadSummary::count_directions(const GenomicRegion& region) const
+{
+    const auto region_totals = totals(region);
+    return std::make_pair(region_totals.forward, region_totals.reads - region_totals.forward);
+}
+
+std::size_t RegionReadSummary::count_supplementary(const GenomicRegion& region) const
+{
+    return totals(region).supplementary;
+}
+
+std::size_t RegionReadSummary::count_mapq_zero(const GenomicRegion& region) const
+{
+    return totals(region).mapq_zero;
+}
+
+std::size_t RegionReadSummary::count_soft_clipped(const GenomicRegion& region) const
+{
+    return totals(region).soft_clipped;
+}
+
+std::size_t RegionReadSummary::count_heavily_clipped(const GenomicRegion& region) const
+{
+    return totals(region).heavily_clipped;
+}
+
+double RegionReadSummary::mean_mapping_quality(const GenomicRegion& region) const
+{
+    const auto region_totals = totals(region);
+    if (region_totals.reads == 0) return 0;
+    return static_cast<double>(region_totals.mapping_quality) / region_totals.reads;
+}
+
+double RegionReadSummary::rmq_mapping_quality(const GenomicRegion& region) const
+{
+    const auto region_totals = totals(region);
+    if (region_totals.reads == 0) return 0;
+    return std::sqrt(static_cast<double>(region_totals.squared_mapping_quality) / region_totals.reads);
+}
+
+// private methods
+
+void RegionReadSummary::init()
+{
+    // One extra slot so empty regions at the summary end can be queried
+    const auto num_offsets = static_cast<std::size_t>(size(region_)) + 2;
+    begin_totals_.assign(num_offsets, ReadTotals {});
+    end_totals_.assign(num_offsets, ReadTotals {});
+}
+
+namespace {
+
+bool is_heavily_clipped(const AlignedRead& read) noexcept
+{
+    const auto read_size = sequence_size(read);
+    return is_soft_clipped(read) && read_size > 0 && 4 * total_clip_size(read) > read_size;
+}
+
+} // namespace
+
+void RegionReadSummary::add(const ReadContainer& reads, std::vector<int>& coverage_changes)
+{
+    const auto region_begin = mapped_begin(region_), region_end = mapped_end(region_);
+    for (const AlignedRead& read : overlap_range(reads, region_)) {
+        const std::size_t mapping_quality {read.mapping_quality()};
+        const ReadTotals read_totals {1, is_forward_strand(read), read.is_marked_supplementary_alignment(),
+                                      mapping_quality == 0, is_soft_clipped(read), is_heavily_clipped(read),
+                                      mapping_quality, mapping_quality * mapping_quality};
+        const auto begin_offset = mapped_begin(read) > region_begin ? mapped_begin(read) - region_begin : 0;
+        begin_totals_[begin_offset + 1] += read_totals;
+        // Reads ending after the region overlap every subregion starting after their begin
+        if (mapped_end(read) <= region_end) {
+            end_totals_[mapped_end(read) - region_begin + 1] += read_totals;
+        }
+        ++coverage_changes[begin_offset];
+        --coverage_changes[std::min(mapped_end(read), region_end) - region_begin];
+    }
+}
+
+void RegionReadSummary::finalise(const std::vector<int>& coverage_changes)
+{
+    for (std::size_t i {1}; i < begin_totals_.size(); ++i) {
+        begin_totals_[i] += begin_totals_[i - 1];
+        end_totals_[i] += end_totals_[i - 1];
+    }
+    const auto num_positions = coverage_changes.size() - 1;
+    std::vector<unsigned> coverages(num_positions);
+    coverage_sums_.assign(num_positions + 1, 0);
+    squared_coverage_sums_.assign(num_positions + 1, 0);
+    int coverage {0};
+    for (std::size_t i {0}; i < num_positions; ++i) {
+        coverage += coverage_changes[i];
+        assert(coverage >= 0);
+        coverages[i] = static_cast<unsigned>(coverage);
+        coverage_sums_[i + 1] = coverage_sums_[i] + coverages[i];
+        squared_coverage_sums_[i + 1] = squared_coverage_sums_[i] + static_cast<std::size_t>(coverages[i]) * coverages[i];
+    }
+    build_coverage_tables(std::move(coverages));
+}
+
+void RegionReadSummary::build_coverage_tables(std::vector<unsigned> coverages)
+{
+    min_coverages_.clear();
+    max_coverages_.clear();
+    const auto num_positions = coverages.size();
+    min_coverages_.push_back(coverages);
+    max_coverages_.push_back(std::move(coverages));
+    for (std::size_t width {2}; width <= num_positions; width *= 2) {
+        const auto& prev_min = min_coverages_.back();
+        const auto& prev_max = max_coverages_.back();
+        const auto num_windows = num_positions - width + 1, half_width = width / 2;
+        std::vector<unsigned> mins(num_windows), maxs(num_windows);
+        for (std::size_t i {0}; i < num_windows; ++i) {
+            mins[i] = std::min(prev_min[i], prev_min[i + half_width]);
+            maxs[i] = std::max(prev_max[i], prev_max[i + half_width]);
+        }
+        min_coverages_.push_back(std::move(mins));
+        max_coverages_.push_back(std::move(maxs));
+    }
+}
+
+std::pair<std::size_t, std::size_t> RegionReadSummary::offsets(const GenomicRegion& region) const
+{
+    assert(contains(region_, region));
+    const auto region_begin = mapped_begin(region_);
+    return {mapped_begin(region) - region_begin, mapped_end(region) - region_begin};
+}
+
+RegionReadSummary::ReadTotals RegionReadSummary::totals(const GenomicRegion& region) const
+{
+    std::size_t first, last;
+    std::tie(first, last) = offsets(region);
+    ReadTotals result;
+    if (first == last) {
+        // Empty regions overlap reads touching either side
+        result = begin_totals_[first + 1];
+        result -= end_totals_[first];
+    } else {
+        result = begin_totals_[last];
+        result -= end_totals_[first + 1];
+    }
+    return result;
+}
+
+} // namespace octopus
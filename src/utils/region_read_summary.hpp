@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef region_read_summary_hpp
+#define region_read_summary_hpp
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#include "config/common.hpp"
+#include "concepts/mappable.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+
+namespace octopus {
+
+/**
+ RegionReadSummary answers the read statistics in read_stats.hpp for any subregion of a fixed
+ region without rescanning the reads.
+
+ The summary is filled in a single pass over the reads overlapping the region. Per-read totals
+ (read counts, strand, mapping quality, supplementary and clipping counts) are prefix summed by
+ read begin and end, so the totals for reads overlapping a subregion are one subtraction. Positional
+ coverage is prefix summed for mean and stdev, and min and max coverage use sparse tables, so all
+ queries are O(1).
+
+ Queried regions must be contained by the summary region.
+ */
+class RegionReadSummary : public Mappable<RegionReadSummary>
+{
+public:
+    RegionReadSummary() = default;
+
+    RegionReadSummary(GenomicRegion region, const ReadContainer& reads);
+    // Summarises all samples together
+    RegionReadSummary(GenomicRegion region, const ReadMap& reads);
+
+    RegionReadSummary(const RegionReadSummary&)            = default;
+    RegionReadSummary& operator=(const RegionReadSummary&) = default;
+    RegionReadSummary(RegionReadSummary&&)                 = default;
+    RegionReadSummary& operator=(RegionReadSummary&&)      = default;
+
+    ~RegionReadSummary() = default;
+
+    const GenomicRegion& mapped_region() const noexcept;
+
+    // Combines two summaries of the same region, e.g. to aggregate samples
+    RegionReadSummary& operator+=(const RegionReadSummary& other);
+
+    bool has_coverage(const GenomicRegion& region) const;
+    unsigned min_coverage(const GenomicRegion& region) const;
+    unsigned max_coverage(const GenomicRegion& region) const;
+    double mean_coverage(const GenomicRegion& region) const;
+    double stdev_coverage(const GenomicRegion& region) const;
+
+    std::size_t count_reads(const GenomicRegion& region) const;
+    std::size_t count_forward(const GenomicRegion& region) const;
+    std::size_t count_reverse(const GenomicRegion& region) const;
+    std::pair<std::size_t, std::size_t> count_directions(const GenomicRegion& region) const;
+    std::size_t count_supplementary(const GenomicRegion& region) const;
+    std::size_t count_mapq_zero(const GenomicRegion& region) const;
+    std::size_t count_soft_clipped(const GenomicRegion& region) const;
+    // Reads with more than a quarter of their bases soft clipped
+    std::size_t count_heavily_clipped(const GenomicRegion& region) const;
+
+    double mean_mapping_quality(const GenomicRegion& region) const;
+    double rmq_mapping_quality(const GenomicRegion& region) const;
+
+private:
+    struct ReadTotals
+    {
+        std::size_t reads, forward, supplementary, mapq_zero, soft_clipped, heavily_clipped;
+        std::size_t mapping_quality, squared_mapping_quality;
+
+        ReadTotals& operator+=(const ReadTotals& other) noexcept;
+        ReadTotals& operator-=(const ReadTotals& other) noexcept;
+    };
+
+    GenomicRegion region_;
+    // begin_totals_[i] is the total of reads beginning before offset i, end_totals_[i] of reads ending before i
+    std::vector<ReadTotals> begin_totals_, end_totals_;
+    std::vector<std::size_t> coverage_sums_, squared_coverage_sums_;
+    // Level k holds the min (max) coverage of the 2^k positions from each offset
+    std::vector<std::vector<unsigned>> min_coverages_, max_coverages_;
+
+    void init();
+    void add(const ReadContainer& reads, std::vector<int>& coverage_changes);
+    void finalise(const std::vector<int>& coverage_changes);
+    void build_coverage_tables(std::vector<unsigned> coverages);
+    std::pair<std::size_t, std::size_t> offsets(const GenomicRegion& region) const;
+    ReadTotals totals(const GenomicRegion& region) const;
+};
+
+} // namespace octopus
+
+#endif
@@ -46,7 +46,7 @@ find_exact_tandem_repeats(SequenceType& sequence, const GenomicRegion& region,
     result.reserve(maximal_repetitions.size());
     auto offset = region.begin();
     for (const auto& run : maximal_repetitions) {
-        result.emplace_back(GenomicRegion {region.contig_name(),
+        result.emplace_back(GenomicRegion {region.contig_id(),
                                            static_cast<GenomicRegion::Size>(run.pos + offset),
                                            static_cast<GenomicRegion::Size>(run.pos + run.length + offset)
         }, SequenceType {std::next(std::cbegin(sequence), run.pos), std::next(std::cbegin(sequence), run.pos + run.period)});
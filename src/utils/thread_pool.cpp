@@ -3,41 +3,41 @@
 
 #include "thread_pool.hpp"
 
+#include <stdexcept>
+
 namespace octopus {
 
+namespace {
+
+// The pool and queue of the calling thread, if it is a pool worker
+thread_local const ThreadPool* current_pool {nullptr};
+thread_local std::size_t current_queue {0};
+
+} // namespace
+
 ThreadPool::ThreadPool() : ThreadPool {0} {}
 
 ThreadPool::ThreadPool(const std::size_t n_threads)
-: stop_ {false}
+: queues_(n_threads)
+, next_queue_ {0}
+, n_queued_ {0}
+, n_sleeping_ {0}
+, stop_ {false}
 , n_idle_ {n_threads}
 {
     workers_.reserve(n_threads);
     for (std::size_t i {0}; i < n_threads; ++i) {
-        workers_.emplace_back([this] {
-            std::function<void()> task;
-            while (true) {
-                std::unique_lock<std::mutex> lk {mutex_};
-                cv_.wait(lk, [this] () { return stop_ || !tasks_.empty(); });
-                if (stop_ && tasks_.empty()) return;
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                --n_idle_;
-                lk.unlock();
-                task();
-                lk.lock();
-                ++n_idle_;
-            }
-        });
+        workers_.emplace_back([this, i] { work(i); });
     }
 }
 
 ThreadPool::~ThreadPool() noexcept
 {
     {
-        std::lock_guard<std::mutex> lk {mutex_};
+        std::lock_guard<std::mutex> lk {sleep_mutex_};
         stop_ = true;
     }
-    cv_.notify_all();
+    work_available_.notify_all();
     for (auto& worker : workers_) {
         if (worker.joinable()) worker.join();
     }
@@ -59,9 +59,150 @@ std::size_t ThreadPool::n_idle() const noexcept
 }
 
 void ThreadPool::clear() noexcept
+{
+    for (auto& queue : queues_) {
+        n_queued_ -= queue.clear();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+    const auto n_queues = queues_.size();
+    const auto first = current_pool == this ? current_queue : next_queue_++ % n_queues;
+    ++n_queued_; // before the task is visible so n_queued_ never underflows
+    bool pushed {false};
+    for (std::size_t i {0}; i < n_queues && !pushed; ++i) {
+        pushed = queues_[(first + i) % n_queues].try_push(task);
+    }
+    if (!pushed) queues_[first].push(std::move(task));
+    wake_one();
+}
+
+// private methods
+
+bool ThreadPool::TaskQueue::try_push(std::function<void()>& task)
+{
+    std::unique_lock<std::mutex> lk {mutex_, std::try_to_lock};
+    if (!lk) return false;
+    tasks_.push_back(std::move(task));
+    return true;
+}
+
+void ThreadPool::TaskQueue::push(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lk {mutex_};
+    tasks_.push_back(std::move(task));
+}
+
+bool ThreadPool::TaskQueue::pop_back(std::function<void()>& task)
+{
+    std::lock_guard<std::mutex> lk {mutex_};
+    if (tasks_.empty()) return false;
+    task = std::move(tasks_.back());
+    tasks_.pop_back();
+    return true;
+}
+
+bool ThreadPool::TaskQueue::try_pop_front(std::function<void()>& task)
+{
+    std::unique_lock<std::mutex> lk {mutex_, std::try_to_lock};
+    if (!lk || tasks_.empty()) return false;
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+    return true;
+}
+
+bool ThreadPool::TaskQueue::pop_front(std::function<void()>& task)
 {
     std::lock_guard<std::mutex> lk {mutex_};
-    while (!tasks_.empty()) tasks_.pop();
+    if (tasks_.empty()) return false;
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+    return true;
+}
+
+std::size_t ThreadPool::TaskQueue::clear() noexcept
+{
+    std::lock_guard<std::mutex> lk {mutex_};
+    const auto result = tasks_.size();
+    tasks_.clear();
+    return result;
+}
+
+bool ThreadPool::try_pop(const std::size_t first_queue, std::function<void()>& task)
+{
+    // Workers take their newest task first, as its data is most likely to be in cache, and steal
+    // the oldest tasks of other workers
+    const auto n_queues = queues_.size();
+    if (current_pool == this && queues_[current_queue].pop_back(task)) {
+        --n_queued_;
+        return true;
+    }
+    for (std::size_t i {0}; i < n_queues; ++i) {
+        if (queues_[(first_queue + i) % n_queues].try_pop_front(task)) {
+            --n_queued_;
+            return true;
+        }
+    }
+    for (std::size_t i {0}; i < n_queues; ++i) {
+        if (queues_[(first_queue + i) % n_queues].pop_front(task)) {
+            --n_queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::wake_one()
+{
+    if (n_sleeping_ > 0) {
+        // Taking the lock ensures a worker that is about to sleep sees the new task or the notification
+        { std::lock_guard<std::mutex> lk {sleep_mutex_}; }
+        work_available_.notify_one();
+    }
+}
+
+void ThreadPool::work(const std::size_t index)
+{
+    current_pool = this;
+    current_queue = index;
+    std::function<void()> task {};
+    while (true) {
+        if (try_pop(index, task)) {
+            --n_idle_;
+            task();
+            task = nullptr;
+            ++n_idle_;
+            continue;
+        }
+        std::unique_lock<std::mutex> lk {sleep_mutex_};
+        if (stop_ && n_queued_ == 0) return;
+        ++n_sleeping_;
+        work_available_.wait(lk, [this] () { return stop_ || n_queued_ > 0; });
+        --n_sleeping_;
+    }
+}
+
+namespace {
+
+std::atomic<std::size_t> shared_pool_size {std::thread::hardware_concurrency()};
+
+} // namespace
+
+void set_shared_thread_pool_size(const std::size_t n_threads) noexcept
+{
+    shared_pool_size = n_threads;
+}
+
+ThreadPool& shared_thread_pool()
+{
+    static ThreadPool result {shared_pool_size.load()};
+    return result;
 }
 
 } // namespace octopus
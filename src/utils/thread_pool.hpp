@@ -1,14 +1,14 @@
 // Copyright (c) 2015-2018 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-// This thread pool implementation is mostly derived from https://github.com/progschj/ThreadPool
+// The work-stealing scheme is mostly derived from Sean Parent's "Better Code: Concurrency" task system
 
 #ifndef thread_pool_hpp
 #define thread_pool_hpp
 
 #include <cstddef>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -22,36 +22,65 @@
 
 namespace octopus {
 
+/**
+ ThreadPool runs tasks on a fixed set of worker threads. Each worker owns a task queue; tasks pushed
+ by a worker go to its own queue, other tasks are spread over the queues, and idle workers steal from
+ the other queues. A pool with no workers runs tasks immediately on the pushing thread.
+ */
 class ThreadPool
 {
 public:
     ThreadPool();
     explicit ThreadPool(std::size_t n_threads);
-    
+
     ThreadPool(const ThreadPool&)             = delete;
     ThreadPool& operator=(const ThreadPool&)  = delete;
     ThreadPool(ThreadPool&& other) noexcept   = delete;
     ThreadPool& operator=(ThreadPool&& other) = delete;
-    
+
     ~ThreadPool() noexcept;
-    
+
     std::size_t size() const noexcept;
     bool empty() const noexcept;
     std::size_t n_idle() const noexcept;
-    
+
     void clear() noexcept;
-    
+
     template <typename F, typename... Args>
     auto push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>;
-    
+
+    // Like push but without a future, so task must not throw
+    void submit(std::function<void()> task);
+
 private:
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    class TaskQueue
+    {
+    public:
+        bool try_push(std::function<void()>& task);
+        void push(std::function<void()> task);
+        bool pop_back(std::function<void()>& task);
+        bool try_pop_front(std::function<void()>& task);
+        bool pop_front(std::function<void()>& task);
+        std::size_t clear() noexcept;
+    private:
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+    };
+
+    std::vector<TaskQueue> queues_;
+    std::atomic<std::size_t> next_queue_;
+    std::atomic<std::size_t> n_queued_;
+    std::atomic<std::size_t> n_sleeping_;
+    std::mutex sleep_mutex_;
+    std::condition_variable work_available_;
     std::atomic<bool> stop_;
     std::atomic<std::size_t> n_idle_;
-    
+
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+
+    bool try_pop(std::size_t first_queue, std::function<void()>& task);
+    void wake_one();
+    void work(std::size_t index);
 };
 
 template <typename F, typename... Args>
@@ -60,15 +89,19 @@ auto ThreadPool::push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(A
     using f_result_type = std::result_of_t<F(Args...)>;
     auto task = std::make_shared<std::packaged_task<f_result_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
     auto result = task->get_future();
-    {
-        std::lock_guard<std::mutex> lk {mutex_};
-        if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
-        tasks_.emplace([task] () { (*task)(); });
-    }
-    cv_.notify_one();
+    submit([task] () { (*task)(); });
     return result;
 }
 
+// The pool shared by the calling tasks of a run and by components that parallelise work within a
+// run (filtering, realignment, assembly), so the number of threads is set by the pool size and does
+// not grow with the number of such components. Code running on the pool must not block waiting for
+// other pool tasks it could run itself (see TaskGroup).
+// The size must be set before the pool is first used; later calls have no effect.
+void set_shared_thread_pool_size(std::size_t n_threads) noexcept;
+
+ThreadPool& shared_thread_pool();
+
 } // namespace octopus
 
 #endif
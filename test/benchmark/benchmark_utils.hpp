@@ -5,20 +5,102 @@
 #define Octopus_benchmark_utils_hpp
 
 #include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <ostream>
 
 template <typename D = std::chrono::nanoseconds, typename F>
 D benchmark(F f, unsigned num_tests)
 {
     D total {0};
-    
-    for (; num_tests > 0; --num_tests) {
-        const auto start = std::chrono::system_clock::now();
+
+    for (unsigned i {0}; i < num_tests; ++i) {
+        const auto start = std::chrono::steady_clock::now();
         f();
-        const auto end = std::chrono::system_clock::now();
+        const auto end = std::chrono::steady_clock::now();
         total += std::chrono::duration_cast<D>(end - start);
     }
-    
-    return D {total / num_tests};
+
+    return num_tests > 0 ? D {total / num_tests} : total;
 }
 
+namespace octopus { namespace benchmark {
+
+// Stops the optimiser discarding a computed value
+template <typename T>
+inline void do_not_optimise(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchmarkOptions
+{
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds {250};
+    std::size_t min_iterations = 5, max_iterations = 1'000'000;
+};
+
+struct BenchmarkResult
+{
+    std::string name, parameters;
+    std::size_t iterations, items_per_iteration;
+    std::chrono::nanoseconds min, median, mean;
+};
+
+// Runs setup() then times body(state) until both the minimum time and minimum iterations are reached.
+// Only body is timed, so each iteration can start from fresh state (e.g. a new graph to prune).
+template <typename Setup, typename Body>
+BenchmarkResult run_with_setup(std::string name, std::string parameters, const std::size_t items_per_iteration,
+                               Setup setup, Body body, const BenchmarkOptions& options = {})
+{
+    using Clock = std::chrono::steady_clock;
+    {
+        auto state = setup(); // warm up caches and lazily initialised tables
+        body(state);
+    }
+    std::vector<std::chrono::nanoseconds> times {};
+    std::chrono::nanoseconds total {0};
+    while (times.size() < options.max_iterations
+           && (times.size() < options.min_iterations || total < options.min_time)) {
+        auto state = setup();
+        const auto start = Clock::now();
+        body(state);
+        const auto end = Clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+        total += times.back();
+    }
+    std::sort(std::begin(times), std::end(times));
+    return {std::move(name), std::move(parameters), times.size(), items_per_iteration,
+            times.front(), times[times.size() / 2], total / times.size()};
+}
+
+template <typename Body>
+BenchmarkResult run(std::string name, std::string parameters, const std::size_t items_per_iteration,
+                    Body body, const BenchmarkOptions& options = {})
+{
+    return run_with_setup(std::move(name), std::move(parameters), items_per_iteration,
+                          [] () { return 0; }, [&] (int) { body(); }, options);
+}
+
+// Tab separated, one result per line, so runs from different builds can be joined on (benchmark, parameters)
+inline void write_header(std::ostream& os)
+{
+    os << "benchmark\tparameters\titerations\titems\tmin_ns\tmedian_ns\tmean_ns\titems_per_second\n";
+}
+
+inline void write(const BenchmarkResult& result, std::ostream& os)
+{
+    const auto median_seconds = static_cast<double>(result.median.count()) / 1e9;
+    const auto throughput = median_seconds > 0 ? result.items_per_iteration / median_seconds : 0.0;
+    os << result.name << '\t' << (result.parameters.empty() ? "-" : result.parameters) << '\t'
+       << result.iterations << '\t' << result.items_per_iteration << '\t'
+       << result.min.count() << '\t' << result.median.count() << '\t' << result.mean.count() << '\t'
+       << static_cast<std::size_t>(throughput) << std::endl;
+}
+
+} // namespace benchmark
+} // namespace octopus
+
 #endif
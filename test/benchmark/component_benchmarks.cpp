@@ -0,0 +1,590 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Micro-benchmarks for the hot kernels of octopus. All inputs are derived deterministically from
+// test/data/reference.fa, so results are comparable between builds and releases. Results are
+// written to stdout as tab separated values, one line per (benchmark, parameters).
+//
+// Usage: octopus-benchmarks [--data-dir DIR] [--min-time-ms N] [FILTER...]
+// Only benchmarks whose name contains one of the FILTER strings are run.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <stdexcept>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
+
+#include <htslib/faidx.h>
+#include <htslib/sam.h>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "config/common.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/read/htslib_sam_facade.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/genotype_index_range.hpp"
+#include "core/models/pairhmm/simd_pair_hmm.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/genotype/germline_likelihood_model.hpp"
+#include "core/tools/vargen/utils/assembler.hpp"
+#include "utils/kmer_mapper.hpp"
+
+#include "benchmark_utils.hpp"
+
+#ifndef OCTOPUS_BENCHMARK_DATA_DIR
+#define OCTOPUS_BENCHMARK_DATA_DIR "test/data"
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+// std distributions are implementation defined, so draw directly from the engine to keep inputs
+// identical across standard libraries
+class Random
+{
+public:
+    explicit Random(std::uint64_t seed) : engine_ {seed} {}
+    std::size_t uniform(std::size_t n) { return static_cast<std::size_t>(engine_() % n); }
+    bool bernoulli(double p) { return static_cast<double>(engine_() % 1'000'000) < p * 1'000'000; }
+    char base() { return "ACGT"[engine_() % 4]; }
+    char other_base(char b) { char result; do { result = base(); } while (result == b); return result; }
+private:
+    std::mt19937_64 engine_;
+};
+
+constexpr std::uint64_t seed {42};
+
+struct Environment
+{
+    fs::path working_directory;
+    ReferenceGenome reference;
+    GenomicRegion::ContigName contig;
+    BenchmarkOptions options;
+};
+
+struct WorkingDirectory
+{
+    fs::path path;
+    WorkingDirectory() : path {fs::temp_directory_path() / fs::unique_path("octopus-benchmarks-%%%%-%%%%-%%%%")}
+    {
+        fs::create_directories(path);
+    }
+    ~WorkingDirectory() { boost::system::error_code ec {}; fs::remove_all(path, ec); }
+};
+
+ReferenceGenome load_reference(const fs::path& data_directory, const fs::path& working_directory)
+{
+    // The checked-in reference has no index, so index a private copy
+    const auto fasta = working_directory / "reference.fa";
+    fs::copy_file(data_directory / "reference.fa", fasta, fs::copy_option::overwrite_if_exists);
+    if (fai_build(fasta.c_str()) != 0) {
+        throw std::runtime_error {"could not index " + fasta.string()};
+    }
+    return make_reference(fasta);
+}
+
+std::vector<Allele> make_variant_pool(const ReferenceGenome& reference, const GenomicRegion& region,
+                                      const unsigned num_sites, Random& random)
+{
+    // Evenly spaced sites, mostly SNVs with some small indels, so every haplotype is well defined
+    std::vector<Allele> result {};
+    result.reserve(num_sites);
+    const auto spacing = region_size(region) / (num_sites + 1);
+    for (unsigned i {1}; i <= num_sites; ++i) {
+        const auto pos = region.begin() + i * spacing;
+        const auto type = random.uniform(10);
+        if (type < 7) {
+            const auto ref = reference.fetch_sequence(GenomicRegion {region.contig_name(), pos, pos + 1});
+            result.emplace_back(GenomicRegion {region.contig_name(), pos, pos + 1}, std::string(1, random.other_base(ref.front())));
+        } else if (type < 9) {
+            result.emplace_back(GenomicRegion {region.contig_name(), pos, pos + 3}, "");
+        } else {
+            std::string insertion(3, 'A');
+            std::generate(std::begin(insertion), std::end(insertion), [&] () { return random.base(); });
+            result.emplace_back(GenomicRegion {region.contig_name(), pos, pos}, std::move(insertion));
+        }
+    }
+    return result;
+}
+
+// Haplotype i carries the alt allele at site j iff bit j of i is set, so haplotype 0 is the reference
+std::vector<Haplotype> make_haplotypes(const ReferenceGenome& reference, const GenomicRegion& region,
+                                       const std::vector<Allele>& variants, const unsigned num_haplotypes)
+{
+    std::vector<Haplotype> result {};
+    result.reserve(num_haplotypes);
+    for (unsigned i {0}; i < num_haplotypes; ++i) {
+        Haplotype::Builder builder {region, reference};
+        for (std::size_t j {0}; j < variants.size(); ++j) {
+            if ((i >> j) & 1u) builder.push_back(variants[j]);
+        }
+        result.push_back(builder.build());
+    }
+    return result;
+}
+
+std::string make_read_sequence(const std::string& source, const std::size_t offset, const std::size_t length,
+                               const double error_rate, Random& random)
+{
+    auto result = source.substr(offset, length);
+    for (auto& base : result) {
+        if (random.bernoulli(error_rate)) base = random.other_base(base);
+    }
+    return result;
+}
+
+// Reads are sampled from the given haplotypes with sequencing errors and reported as gapless
+// alignments at the same offset on the reference, much like a naive aligner would report them
+std::vector<AlignedRead> make_reads(const std::vector<Haplotype>& haplotypes, const GenomicRegion& read_region,
+                                    const unsigned num_reads, const unsigned read_length, Random& random)
+{
+    std::vector<AlignedRead> result {};
+    result.reserve(num_reads);
+    const auto max_begin = read_region.end() - read_length;
+    const AlignedRead::BaseQualityVector qualities(read_length, 30);
+    const auto cigar = parse_cigar(std::to_string(read_length) + "M");
+    for (unsigned i {0}; i < num_reads; ++i) {
+        const auto& haplotype = haplotypes[random.uniform(haplotypes.size())];
+        const auto begin = read_region.begin() + static_cast<GenomicRegion::Position>(random.uniform(max_begin - read_region.begin() + 1));
+        const auto offset = std::min<std::size_t>(begin - haplotype.mapped_region().begin(), haplotype.sequence().size() - read_length);
+        result.emplace_back("read" + std::to_string(i), GenomicRegion {read_region.contig_name(), begin, begin + read_length},
+                            make_read_sequence(haplotype.sequence(), offset, read_length, 0.005, random),
+                            qualities, cigar, AlignedRead::MappingQuality {60}, AlignedRead::Flags {}, "RG1");
+    }
+    return result;
+}
+
+ReadMap make_read_map(const SampleName& sample, std::vector<AlignedRead> reads)
+{
+    ReadMap result {};
+    result[sample].insert(std::make_move_iterator(std::begin(reads)), std::make_move_iterator(std::end(reads)));
+    return result;
+}
+
+using Reporter = std::function<void(const BenchmarkResult&)>;
+
+// pair HMM
+
+void benchmark_pair_hmm(const Environment& env, const Reporter& report)
+{
+    // The SIMD kernel has a fixed band of 2 * min_flank_pad() diagonals, so only the read length varies
+    constexpr auto pad = hmm::simd::min_flank_pad();
+    constexpr std::size_t num_reads {500};
+    constexpr short gap_extend {3}, nuc_prior {2};
+    const auto contig_size = env.reference.contig_size(env.contig);
+    for (const int read_length : {50, 100, 150, 250}) {
+        Random random {seed};
+        const auto truth_length = read_length + 2 * pad - 1;
+        std::vector<std::string> truths(num_reads), targets(num_reads);
+        for (std::size_t i {0}; i < num_reads; ++i) {
+            const auto begin = static_cast<GenomicRegion::Position>(random.uniform(contig_size - truth_length));
+            truths[i] = env.reference.fetch_sequence(GenomicRegion {env.contig, begin, begin + static_cast<GenomicRegion::Position>(truth_length)});
+            targets[i] = make_read_sequence(truths[i], pad, read_length, 0.01, random);
+        }
+        const std::vector<std::int8_t> qualities(read_length, 30), gap_open(truth_length, 45);
+        const auto parameters = "read_length=" + std::to_string(read_length);
+        report(run("pairhmm.align.score", parameters, num_reads, [&] () {
+            for (std::size_t i {0}; i < num_reads; ++i) {
+                do_not_optimise(hmm::simd::align(truths[i].data(), targets[i].data(), qualities.data(),
+                                                 truth_length, read_length, gap_open.data(), gap_extend, nuc_prior));
+            }
+        }, env.options));
+        std::vector<char> align1(2 * truth_length + 1), align2(2 * truth_length + 1);
+        report(run("pairhmm.align.traceback", parameters, num_reads, [&] () {
+            int first_pos;
+            for (std::size_t i {0}; i < num_reads; ++i) {
+                do_not_optimise(hmm::simd::align(truths[i].data(), targets[i].data(), qualities.data(),
+                                                 truth_length, read_length, gap_open.data(), gap_extend, nuc_prior,
+                                                 first_pos, align1.data(), align2.data()));
+            }
+        }, env.options));
+    }
+}
+
+// haplotype likelihoods
+
+const SampleName sample {"SAMPLE"};
+const GenomicRegion::Distance likelihood_flank_size {50};
+
+GenomicRegion likelihood_region(const Environment& env)
+{
+    return GenomicRegion {env.contig, 200, 1200};
+}
+
+void benchmark_haplotype_likelihoods(const Environment& env, const Reporter& report)
+{
+    const auto region = likelihood_region(env);
+    for (const unsigned num_haplotypes : {2u, 8u, 32u}) {
+        for (const unsigned num_reads : {100u, 1000u}) {
+            Random random {seed};
+            const auto variants = make_variant_pool(env.reference, region, 12, random);
+            const auto haplotypes = make_haplotypes(env.reference, region, variants, num_haplotypes);
+            const auto reads = make_read_map(sample, make_reads(haplotypes, expand(region, -likelihood_flank_size), num_reads, 150, random));
+            HaplotypeLikelihoodArray likelihoods {num_haplotypes, {sample}};
+            report(run("haplotype_likelihood_array.populate",
+                       "haplotypes=" + std::to_string(num_haplotypes) + ",reads=" + std::to_string(num_reads),
+                       num_haplotypes * num_reads, [&] () {
+                likelihoods.populate(reads, haplotypes);
+                do_not_optimise(likelihoods);
+            }, env.options));
+        }
+    }
+}
+
+// kmer mapper
+
+void benchmark_kmer_mapper(const Environment& env, const Reporter& report)
+{
+    constexpr unsigned char kmer_size {6};
+    constexpr unsigned num_reads {1000}, read_length {150};
+    const auto contig_size = env.reference.contig_size(env.contig);
+    for (const GenomicRegion::Size target_size : {500u, 2000u, 4000u}) {
+        Random random {seed};
+        const GenomicRegion target_region {env.contig, 0, std::min(target_size, contig_size)};
+        const auto target = env.reference.fetch_sequence(target_region);
+        std::vector<std::string> queries(num_reads);
+        for (auto& query : queries) {
+            query = make_read_sequence(target, random.uniform(target.size() - read_length), read_length, 0.01, random);
+        }
+        const auto parameters = "target_size=" + std::to_string(target.size());
+        report(run("kmer_mapper.make_table", parameters, 1, [&] () {
+            do_not_optimise(make_kmer_hash_table<kmer_size>(target));
+        }, env.options));
+        const auto table = make_kmer_hash_table<kmer_size>(target);
+        auto counts = init_mapping_counts(table);
+        std::vector<std::size_t> positions {};
+        report(run("kmer_mapper.map", parameters, num_reads, [&] () {
+            for (const auto& query : queries) {
+                const auto hashes = compute_kmer_hashes<kmer_size>(query);
+                positions.clear();
+                map_query_to_target(hashes, table, counts, std::back_inserter(positions), 10);
+                do_not_optimise(positions);
+            }
+        }, env.options));
+    }
+}
+
+// assembler
+
+void build(coretools::Assembler& assembler, const std::vector<std::string>& reads)
+{
+    bool forward {true};
+    for (const auto& read : reads) {
+        assembler.insert_read(read, forward ? coretools::Assembler::Direction::forward : coretools::Assembler::Direction::reverse);
+        forward = !forward;
+    }
+}
+
+void prune(coretools::Assembler& assembler)
+{
+    assembler.try_recover_dangling_branches();
+    assembler.prune(2);
+    if (!assembler.is_acyclic()) assembler.remove_nonreference_cycles();
+    assembler.cleanup();
+}
+
+void benchmark_assembler(const Environment& env, const Reporter& report)
+{
+    using coretools::Assembler;
+    const GenomicRegion region {env.contig, 1000, 1500};
+    const auto reference = env.reference.fetch_sequence(region);
+    for (const unsigned kmer_size : {10u, 25u}) {
+        for (const unsigned num_reads : {200u, 1000u}) {
+            Random random {seed};
+            const auto variants = make_variant_pool(env.reference, region, 6, random);
+            const auto haplotypes = make_haplotypes(env.reference, region, variants, 4);
+            std::vector<std::string> reads {};
+            reads.reserve(num_reads);
+            for (const auto& read : make_reads(haplotypes, region, num_reads, 100, random)) {
+                reads.push_back(read.sequence());
+            }
+            const Assembler::Parameters params {kmer_size};
+            const auto parameters = "kmer_size=" + std::to_string(kmer_size) + ",reads=" + std::to_string(num_reads);
+            report(run("assembler.build", parameters, num_reads, [&] () {
+                Assembler assembler {params, reference};
+                build(assembler, reads);
+                do_not_optimise(assembler);
+            }, env.options));
+            const auto make_built = [&] () {
+                auto result = std::make_unique<Assembler>(params, reference);
+                build(*result, reads);
+                return result;
+            };
+            report(run_with_setup("assembler.prune", parameters, num_reads, make_built, [] (auto& assembler) {
+                prune(*assembler);
+                do_not_optimise(*assembler);
+            }, env.options));
+            report(run_with_setup("assembler.extract_variants", parameters, num_reads, [&] () {
+                auto result = make_built();
+                prune(*result);
+                return result;
+            }, [] (auto& assembler) {
+                do_not_optimise(assembler->extract_variants(50, 2.0));
+            }, env.options));
+        }
+    }
+}
+
+// genotype likelihoods
+
+void benchmark_germline_likelihood_model(const Environment& env, const Reporter& report)
+{
+    constexpr unsigned num_haplotypes {16}, num_reads {500};
+    const auto region = likelihood_region(env);
+    Random random {seed};
+    const auto variants = make_variant_pool(env.reference, region, 12, random);
+    const auto haplotypes = make_haplotypes(env.reference, region, variants, num_haplotypes);
+    const auto reads = make_read_map(sample, make_reads(haplotypes, expand(region, -likelihood_flank_size), num_reads, 150, random));
+    HaplotypeLikelihoodArray likelihoods {num_haplotypes, {sample}};
+    likelihoods.populate(reads, haplotypes);
+    likelihoods.prime(sample);
+    model::GermlineLikelihoodModel model {likelihoods};
+    model.prime(haplotypes);
+    for (const unsigned ploidy : {1u, 2u, 3u, 4u, 6u}) {
+        const GenotypeIndexRange genotypes {num_haplotypes, ploidy};
+        report(run("germline_likelihood_model.evaluate",
+                   "ploidy=" + std::to_string(ploidy) + ",haplotypes=" + std::to_string(num_haplotypes) + ",reads=" + std::to_string(num_reads),
+                   genotypes.size(), [&] () {
+            double total {0};
+            for (const auto& genotype : genotypes) total += model.evaluate(genotype);
+            do_not_optimise(total);
+        }, env.options));
+    }
+}
+
+// BAM reading
+
+void write_sorted_sam(const fs::path& sam, const Environment& env, const unsigned depth, const unsigned read_length)
+{
+    const auto contig_size = env.reference.contig_size(env.contig);
+    const auto num_reads = static_cast<std::size_t>(depth) * contig_size / read_length;
+    const auto contig_sequence = env.reference.fetch_sequence(env.reference.contig_region(env.contig));
+    Random random {seed};
+    std::vector<GenomicRegion::Position> positions(num_reads);
+    std::generate(std::begin(positions), std::end(positions), [&] () {
+        return static_cast<GenomicRegion::Position>(random.uniform(contig_size - read_length + 1)); });
+    std::sort(std::begin(positions), std::end(positions));
+    std::ofstream out {sam.string()};
+    out << "@HD\tVN:1.4\tSO:coordinate\n" << "@SQ\tSN:" << env.contig << "\tLN:" << contig_size << '\n'
+        << "@RG\tID:RG1\tSM:" << sample << '\n';
+    const std::string qualities(read_length, '?');
+    for (std::size_t i {0}; i < num_reads; ++i) {
+        const auto flag = random.uniform(2) == 0 ? 0 : 16;
+        out << "read" << i << '\t' << flag << '\t' << env.contig << '\t' << positions[i] + 1 << "\t60\t"
+            << read_length << "M\t*\t0\t0\t" << make_read_sequence(contig_sequence, positions[i], read_length, 0.01, random)
+            << '\t' << qualities << "\tRG:Z:RG1\n";
+    }
+}
+
+void convert_to_indexed_bam(const fs::path& sam, const fs::path& bam)
+{
+    htsFile* in {sam_open(sam.c_str(), "r")};
+    htsFile* out {sam_open(bam.c_str(), "wb")};
+    if (!in || !out) throw std::runtime_error {"could not open " + sam.string()};
+    bam_hdr_t* header {sam_hdr_read(in)};
+    if (!header || sam_hdr_write(out, header) < 0) throw std::runtime_error {"bad header in " + sam.string()};
+    bam1_t* record {bam_init1()};
+    while (sam_read1(in, header, record) >= 0) {
+        if (sam_write1(out, header, record) < 0) throw std::runtime_error {"could not write " + bam.string()};
+    }
+    bam_destroy1(record);
+    bam_hdr_destroy(header);
+    sam_close(in);
+    sam_close(out);
+    if (sam_index_build(bam.c_str(), 0) < 0) throw std::runtime_error {"could not index " + bam.string()};
+}
+
+void benchmark_htslib_sam_facade(const Environment& env, const Reporter& report)
+{
+    const auto contig_region = env.reference.contig_region(env.contig);
+    const GenomicRegion window {env.contig, 2000, 3000};
+    for (const unsigned depth : {30u, 300u}) {
+        const auto sam = env.working_directory / ("reads" + std::to_string(depth) + ".sam");
+        const auto bam = fs::path {sam}.replace_extension(".bam");
+        write_sorted_sam(sam, env, depth, 150);
+        convert_to_indexed_bam(sam, bam);
+        io::HtslibSamFacade reader {bam};
+        for (const auto& region : {contig_region, window}) {
+            std::size_t num_reads {0};
+            for (const auto& p : reader.fetch_reads(region, {})) num_reads += p.second.size();
+            report(run("htslib_sam_facade.fetch_reads",
+                       "depth=" + std::to_string(depth) + ",region_size=" + std::to_string(region_size(region)),
+                       num_reads, [&] () {
+                do_not_optimise(reader.fetch_reads(region, {}));
+            }, env.options));
+        }
+    }
+}
+
+// VCF writing
+
+VcfHeader make_vcf_header(const Environment& env, const std::vector<SampleName>& samples)
+{
+    return VcfHeader::Builder {}
+    .set_samples(samples)
+    .add_contig(env.contig, {{"length", std::to_string(env.reference.contig_size(env.contig))}})
+    .add_info("DP", "1", "Integer", "Combined depth across samples")
+    .add_format("GT", "1", "String", "Genotype")
+    .add_format("GQ", "1", "Integer", "Conditional genotype quality (phred-scaled)")
+    .add_format("DP", "1", "Integer", "Read depth")
+    .build_once();
+}
+
+std::vector<VcfRecord> make_vcf_records(const Environment& env, const std::vector<SampleName>& samples, const std::size_t num_records)
+{
+    const auto contig_sequence = env.reference.fetch_sequence(env.reference.contig_region(env.contig));
+    Random random {seed};
+    std::vector<VcfRecord> result {};
+    result.reserve(num_records);
+    for (std::size_t i {0}; i < num_records; ++i) {
+        const auto pos = i % contig_sequence.size();
+        const auto ref = contig_sequence[pos];
+        VcfRecord::Builder builder {};
+        builder.set_chrom(env.contig).set_pos(pos + 1).set_ref(ref).set_alt(random.other_base(ref))
+        .set_qual(static_cast<double>(random.uniform(1000))).set_passed()
+        .set_info("DP", 30 * samples.size()).set_format({"GT", "GQ", "DP"});
+        for (const auto& sample : samples) {
+            const boost::optional<unsigned> allele {static_cast<unsigned>(random.uniform(2))};
+            builder.set_genotype(sample, {boost::optional<unsigned> {0}, allele}, VcfRecord::Builder::Phasing::unphased)
+            .set_format(sample, "GQ", random.uniform(100)).set_format(sample, "DP", 30);
+        }
+        result.push_back(builder.build_once());
+    }
+    return result;
+}
+
+void benchmark_vcf_writer(const Environment& env, const Reporter& report)
+{
+    constexpr std::size_t num_records {4000};
+    for (const unsigned num_samples : {1u, 10u}) {
+        std::vector<SampleName> samples(num_samples);
+        for (unsigned i {0}; i < num_samples; ++i) samples[i] = "SAMPLE" + std::to_string(i);
+        const auto header = make_vcf_header(env, samples);
+        const auto records = make_vcf_records(env, samples, num_records);
+        for (const std::string extension : {".vcf", ".vcf.gz", ".bcf"}) {
+            const auto vcf = env.working_directory / ("calls" + extension);
+            report(run("vcf_writer.write", "format=" + extension.substr(1) + ",samples=" + std::to_string(num_samples),
+                       num_records, [&] () {
+                VcfWriter writer {vcf, header};
+                for (const auto& record : records) writer.write(record);
+            }, env.options));
+        }
+        // The same records, pre-encoded as they would be by a caller using BcfRecordBuilder
+        std::vector<std::int32_t> genotypes(2 * num_samples * num_records), gqs(num_samples * num_records);
+        for (std::size_t r {0}; r < num_records; ++r) {
+            for (unsigned s {0}; s < num_samples; ++s) {
+                const auto& record = records[r];
+                const auto& gt = record.get_sample_value(samples[s], "GT");
+                for (std::size_t p {0}; p < 2; ++p) {
+                    const auto allele = gt[p] == record.ref() ? 0u : 1u;
+                    genotypes[2 * (r * num_samples + s) + p] = BcfRecordBuilder::genotype_allele(allele, false);
+                }
+                gqs[r * num_samples + s] = std::stoi(record.get_sample_value(samples[s], "GQ").front());
+            }
+        }
+        const std::vector<std::int32_t> depths(num_samples, 30);
+        for (const std::string extension : {".vcf", ".vcf.gz", ".bcf"}) {
+            const auto vcf = env.working_directory / ("calls" + extension);
+            report(run("vcf_writer.write_typed", "format=" + extension.substr(1) + ",samples=" + std::to_string(num_samples),
+                       num_records, [&] () {
+                VcfWriter writer {vcf, header};
+                auto builder = writer.make_record_builder();
+                const auto contig = builder.contig_id(env.contig);
+                const auto pass = builder.filter_id("PASS");
+                const auto info_dp = builder.info_id("DP"), gq = builder.format_id("GQ"), format_dp = builder.format_id("DP");
+                for (std::size_t r {0}; r < num_records; ++r) {
+                    const auto& record = records[r];
+                    builder.clear().set_chrom(contig).set_pos(record.pos()).set_id(".")
+                    .set_alleles(record.ref(), record.alt()).set_qual(*record.qual()).add_filter(pass)
+                    .set_info(info_dp, static_cast<std::int32_t>(30 * num_samples))
+                    .set_genotypes(genotypes.data() + 2 * r * num_samples, 2)
+                    .set_format(gq, gqs.data() + r * num_samples, 1)
+                    .set_format(format_dp, depths.data(), 1);
+                    writer.write(builder);
+                }
+            }, env.options));
+        }
+    }
+}
+
+struct Benchmark
+{
+    std::string name;
+    std::function<void(const Environment&, const Reporter&)> run;
+};
+
+const std::vector<Benchmark> benchmarks {
+    {"pairhmm", benchmark_pair_hmm},
+    {"haplotype_likelihood_array", benchmark_haplotype_likelihoods},
+    {"kmer_mapper", benchmark_kmer_mapper},
+    {"assembler", benchmark_assembler},
+    {"germline_likelihood_model", benchmark_germline_likelihood_model},
+    {"htslib_sam_facade", benchmark_htslib_sam_facade},
+    {"vcf_writer", benchmark_vcf_writer}
+};
+
+bool is_selected(const std::string& name, const std::vector<std::string>& filters)
+{
+    return filters.empty() || std::any_of(std::cbegin(filters), std::cend(filters),
+                                          [&] (const auto& filter) { return name.find(filter) != std::string::npos; });
+}
+
+} // namespace
+
+} // namespace benchmark
+} // namespace octopus
+
+int main(int argc, char** argv)
+{
+    using namespace octopus::benchmark;
+    fs::path data_directory {OCTOPUS_BENCHMARK_DATA_DIR};
+    BenchmarkOptions options {};
+    std::vector<std::string> filters {};
+    for (int i {1}; i < argc; ++i) {
+        const std::string arg {argv[i]};
+        if (arg == "--data-dir" && i + 1 < argc) {
+            data_directory = argv[++i];
+        } else if (arg == "--min-time-ms" && i + 1 < argc) {
+            options.min_time = std::chrono::milliseconds {std::atoi(argv[++i])};
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--data-dir DIR] [--min-time-ms N] [FILTER...]" << std::endl;
+            return EXIT_SUCCESS;
+        } else {
+            filters.push_back(arg);
+        }
+    }
+    try {
+        WorkingDirectory working_directory {};
+        auto reference = load_reference(data_directory, working_directory.path);
+        const auto contig = reference.contig_names().front();
+        const Environment env {working_directory.path, std::move(reference), contig, options};
+        write_header(std::cout);
+        const Reporter report {[&] (const BenchmarkResult& result) { write(result, std::cout); }};
+        for (const auto& benchmark : benchmarks) {
+            if (is_selected(benchmark.name, filters)) benchmark.run(env, report);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "octopus-benchmarks: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "basics/contig_table.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(basics)
+BOOST_AUTO_TEST_SUITE(contig_table)
+
+BOOST_AUTO_TEST_CASE(interning_the_same_name_gives_the_same_id)
+{
+    const auto id = intern_contig("contig_table_test_1");
+    BOOST_CHECK_EQUAL(intern_contig("contig_table_test_1"), id);
+    BOOST_CHECK_NE(intern_contig("contig_table_test_2"), id);
+    BOOST_CHECK_EQUAL(lookup_contig_name(id), "contig_table_test_1");
+}
+
+BOOST_AUTO_TEST_CASE(the_empty_name_has_id_zero)
+{
+    BOOST_CHECK_EQUAL(intern_contig(""), 0);
+    BOOST_CHECK_EQUAL(GenomicRegion {}.contig_id(), 0);
+    BOOST_CHECK(GenomicRegion {}.contig_name().empty());
+}
+
+BOOST_AUTO_TEST_CASE(names_stay_valid_as_the_table_grows)
+{
+    const auto& name = lookup_contig_name(intern_contig("contig_table_test_stable"));
+    std::vector<std::string> names {};
+    for (int i {0}; i < 10'000; ++i) names.push_back("contig_table_test_grow_" + std::to_string(i));
+    intern_contigs(names);
+    BOOST_CHECK_EQUAL(name, "contig_table_test_stable");
+    const auto first_id = intern_contig(names.front());
+    for (std::size_t i {0}; i < names.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(lookup_contig_name(first_id + i), names[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_interning_gives_one_id_per_name)
+{
+    constexpr int numThreads {4}, numNames {1000};
+    std::vector<std::vector<ContigId>> ids(numThreads);
+    std::vector<std::thread> threads {};
+    for (int t {0}; t < numThreads; ++t) {
+        threads.emplace_back([&ids, t] () {
+            for (int i {0}; i < numNames; ++i) {
+                ids[t].push_back(intern_contig("contig_table_test_concurrent_" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t {1}; t < numThreads; ++t) {
+        BOOST_CHECK(ids[t] == ids.front());
+    }
+    for (int i {0}; i < numNames; ++i) {
+        BOOST_REQUIRE_EQUAL(lookup_contig_name(ids.front()[i]), "contig_table_test_concurrent_" + std::to_string(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(regions_made_from_names_and_ids_are_equal)
+{
+    const GenomicRegion by_name {"contig_table_test_region", 10, 20};
+    const GenomicRegion by_id {intern_contig("contig_table_test_region"), 10, 20};
+    BOOST_CHECK_EQUAL(by_name, by_id);
+    BOOST_CHECK_EQUAL(by_id.contig_name(), "contig_table_test_region");
+    BOOST_CHECK(is_same_contig(by_name, expand(by_id, 5)));
+    BOOST_CHECK_EQUAL(std::hash<GenomicRegion> {}(by_name), std::hash<GenomicRegion> {}(by_id));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
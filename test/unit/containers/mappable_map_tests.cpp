@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <algorithm>
+#include <iterator>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "containers/mappable_map.hpp"
+#include "utils/read_stats.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(containers)
+BOOST_AUTO_TEST_SUITE(mappable_map)
+
+namespace {
+
+AlignedRead make_read(GenomicRegion::Position begin, const std::string& cigar, AlignedRead::MappingQuality mapping_quality,
+                      bool reverse = false)
+{
+    const auto parsed_cigar = parse_cigar(cigar);
+    const auto read_size = sequence_size(parsed_cigar);
+    AlignedRead::Flags flags {};
+    flags.reverse_mapped = reverse;
+    return AlignedRead {
+        "read", GenomicRegion {"1", begin, begin + reference_size(parsed_cigar)},
+        std::string(read_size, 'A'), AlignedRead::BaseQualityVector(read_size, 30),
+        parsed_cigar, mapping_quality, flags, "RG"
+    };
+}
+
+ReadMap make_reads()
+{
+    ReadMap result {};
+    result["sample"] = ReadContainer {
+        make_read(0, "10M", 60),
+        make_read(3, "4M2D4M", 0, true),
+        make_read(5, "2S8M", 40),
+        make_read(8, "10M", 20, true),
+        make_read(15, "5M", 60),
+        make_read(21, "6M", 10)
+    };
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(overlapped_read_views_reference_the_same_reads_as_copies)
+{
+    const auto reads = make_reads();
+    const GenomicRegion region {"1", 9, 16};
+    const auto copies = copy_overlapped(reads, region);
+    const ReadViewMap views = view_overlapped(reads, region);
+    const auto& sample_copies = copies.at("sample");
+    const auto& sample_views = views.at("sample");
+    BOOST_REQUIRE_EQUAL(sample_views.size(), sample_copies.size());
+    for (std::size_t i {0}; i < sample_views.size(); ++i) {
+        BOOST_CHECK(sample_views[i].get() == sample_copies[i]);
+    }
+    for (const AlignedRead& read : sample_views) {
+        const auto& sample_reads = reads.at("sample");
+        BOOST_CHECK(std::any_of(std::cbegin(sample_reads), std::cend(sample_reads),
+                                [&] (const AlignedRead& other) { return &other == &read; }));
+    }
+    BOOST_CHECK_EQUAL(count_reads(views), count_reads(copies));
+    BOOST_CHECK_EQUAL(max_coverage(views), max_coverage(copies));
+    BOOST_CHECK_EQUAL(count_mapq_zero(views), count_mapq_zero(copies));
+    BOOST_CHECK_CLOSE(rmq_mapping_quality(views), rmq_mapping_quality(copies), 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,4 +1,148 @@
-// Copyright (c) 2017 Daniel Cooke
+// Copyright (c) 2015-2018 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <deque>
+#include <sstream>
+#include <fstream>
+#include <memory>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "htslib/sam.h"
+
+#include "basics/genomic_region.hpp"
+#include "basics/ploidy_map.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/read/read_manager.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "readpipe/read_pipe.hpp"
+#include "core/tools/vargen/cigar_scanner.hpp"
+#include "core/tools/vargen/variant_generator_builder.hpp"
+#include "core/tools/hapgen/haplotype_generator.hpp"
+#include "core/callers/caller_builder.hpp"
+#include "logging/progress_meter.hpp"
+#include "utils/thread_pool.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(caller)
+
+namespace fs = boost::filesystem;
+using coretools::CigarScanner;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+const GenomicRegion callRegion {"1", 100, 400};
+
+char substitute(const char base)
+{
+    return base == 'A' ? 'C' : 'A';
+}
+
+// Reads from two haplotypes of contig 1 with SNVs close enough to be called in several connected
+// active regions, so there is a next active region to speculate on
+std::string make_sam(const ReferenceGenome& reference)
+{
+    const auto contig = reference.fetch_sequence(GenomicRegion {"1", 0, reference.contig_size("1")});
+    std::array<std::string, 2> haplotypes {contig, contig};
+    const std::vector<std::size_t> heterozygous_positions {150, 158, 190, 230, 245, 300, 340};
+    for (std::size_t i {0}; i < heterozygous_positions.size(); ++i) {
+        const auto position = heterozygous_positions[i];
+        haplotypes[i % 2][position] = substitute(contig[position]);
+    }
+    for (const auto position : {200, 320}) {
+        haplotypes[0][position] = haplotypes[1][position] = substitute(contig[position]);
+    }
+    std::ostringstream result {};
+    result << "@HD\tVN:1.6\tSO:coordinate\n";
+    for (const auto& name : reference.contig_names()) {
+        result << "@SQ\tSN:" << name << "\tLN:" << reference.contig_size(name) << '\n';
+    }
+    result << "@RG\tID:RG\tSM:sample\n";
+    constexpr std::size_t readLength {100};
+    for (std::size_t begin {40}, i {0}; begin + readLength <= 460; begin += 2, ++i) {
+        result << 'r' << i << "\t0\t1\t" << begin + 1 << "\t60\t" << readLength << "M\t*\t0\t0\t"
+               << haplotypes[i % 2].substr(begin, readLength) << '\t' << std::string(readLength, 'I') << "\tRG:Z:RG\n";
+    }
+    return result.str();
+}
+
+void write_bam(const std::string& sam, const fs::path& sam_path, const fs::path& bam_path)
+{
+    std::ofstream {sam_path.string()} << sam;
+    samFile* in {sam_open(sam_path.c_str(), "r")};
+    BOOST_REQUIRE(in);
+    bam_hdr_t* header {sam_hdr_read(in)};
+    samFile* out {sam_open(bam_path.c_str(), "wb")};
+    BOOST_REQUIRE(out);
+    BOOST_REQUIRE_EQUAL(sam_hdr_write(out, header), 0);
+    bam1_t* record {bam_init1()};
+    while (sam_read1(in, header, record) >= 0) {
+        BOOST_REQUIRE_GE(sam_write1(out, header, record), 0);
+    }
+    bam_destroy1(record);
+    bam_hdr_destroy(header);
+    sam_close(out);
+    sam_close(in);
+    BOOST_REQUIRE_EQUAL(sam_index_build(bam_path.c_str(), 0), 0);
+}
+
+std::vector<std::string> call(const ReferenceGenome& reference, const ReadPipe& read_pipe, const bool pipeline)
+{
+    VariantGeneratorBuilder candidate_generator_builder {};
+    CigarScanner::Options scanner_options {};
+    scanner_options.include = [] (const CigarScanner::ObservedVariant& variant) { return variant.total_depth >= 5; };
+    candidate_generator_builder.set_cigar_scanner(std::move(scanner_options));
+    CallerBuilder builder {reference, read_pipe, std::move(candidate_generator_builder), HaplotypeGenerator::Builder {}};
+    builder.set_caller("individual");
+    builder.set_ploidies(PloidyMap {2});
+    builder.set_active_region_pipelining(pipeline);
+    const auto caller = builder.build("1");
+    ProgressMeter progress_meter {callRegion};
+    // Run as a calling task does, on a pool worker, so the speculative population has to share the pool
+    const auto calls = shared_thread_pool().push([&] () { return caller->call(callRegion, progress_meter); }).get();
+    std::vector<std::string> result {};
+    for (const auto& call : calls) {
+        std::ostringstream ss {};
+        ss << call;
+        result.push_back(ss.str());
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(pipelined_and_serial_active_regions_give_the_same_calls)
+{
+    TempDirectory directory {};
+    const auto reference = mock::make_reference();
+    const auto bam_path = directory.path / "reads.bam";
+    write_bam(make_sam(reference), directory.path / "reads.sam", bam_path);
+    const ReadManager read_manager {bam_path};
+    const ReadPipe read_pipe {read_manager, read_manager.samples()};
+    const auto serial_calls = call(reference, read_pipe, false);
+    const auto pipelined_calls = call(reference, read_pipe, true);
+    BOOST_CHECK_GE(serial_calls.size(), 5);
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(pipelined_calls), std::cend(pipelined_calls),
+                                  std::cbegin(serial_calls), std::cend(serial_calls));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,105 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "core/checkpoint_journal.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(checkpoint_journal)
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+void touch(const fs::path& file)
+{
+    std::ofstream {file.string()} << "calls\n";
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(committed_journals_can_be_read_back)
+{
+    TempDirectory directory {};
+    CheckpointJournal journal {directory.path};
+    BOOST_CHECK(journal.empty());
+    journal.set_fingerprint("abc");
+    const auto chunk1 = journal.make_unique_file_name("1", "chunk");
+    const auto chunk2 = journal.make_unique_file_name("1", "chunk");
+    const auto boundary = journal.make_unique_file_name("1", "boundary");
+    BOOST_CHECK_NE(chunk1, chunk2);
+    for (const auto& file : {chunk1, chunk2, boundary}) touch(directory.path / file);
+    journal.add_chunk("1", chunk1);
+    journal.add_chunk("1", chunk2);
+    journal.set_completed(GenomicRegion {"1", 0, 1000});
+    journal.set_boundary(GenomicRegion {"1", 1000, 2000}, boundary);
+    journal.commit();
+
+    const CheckpointJournal resumed {directory.path};
+    BOOST_CHECK_EQUAL(resumed.fingerprint(), "abc");
+    BOOST_REQUIRE(resumed.contains("1"));
+    BOOST_CHECK(!resumed.contains("2"));
+    const auto& entry = resumed.at("1");
+    BOOST_CHECK_EQUAL(entry.chunks.size(), 2);
+    BOOST_REQUIRE(entry.completed);
+    BOOST_CHECK_EQUAL(*entry.completed, (GenomicRegion {"1", 0, 1000}));
+    BOOST_REQUIRE(entry.boundary);
+    BOOST_CHECK_EQUAL(entry.boundary->region, (GenomicRegion {"1", 1000, 2000}));
+    BOOST_CHECK_EQUAL(entry.boundary->calls, boundary);
+    BOOST_CHECK_EQUAL(resumed.files().size(), 3);
+
+    auto next = resumed;
+    const auto new_file = next.make_unique_file_name("1", "chunk");
+    BOOST_CHECK(new_file != chunk1 && new_file != chunk2 && new_file != boundary);
+}
+
+BOOST_AUTO_TEST_CASE(journals_referring_to_missing_files_are_not_committed)
+{
+    TempDirectory directory {};
+    CheckpointJournal journal {directory.path};
+    journal.set_fingerprint("abc");
+    const auto chunk = journal.make_unique_file_name("1", "chunk");
+    touch(directory.path / chunk);
+    journal.add_chunk("1", chunk);
+    journal.commit();
+    journal.add_chunk("1", journal.make_unique_file_name("1", "chunk"));
+    BOOST_CHECK_THROW(journal.commit(), UnwritableFileError);
+    // the previous journal is left in place
+    const CheckpointJournal resumed {directory.path};
+    BOOST_REQUIRE(resumed.contains("1"));
+    BOOST_CHECK_EQUAL(resumed.at("1").chunks.size(), 1);
+    BOOST_CHECK(!fs::exists(directory.path / "checkpoint.journal.tmp"));
+}
+
+BOOST_AUTO_TEST_CASE(malformed_journals_are_rejected)
+{
+    TempDirectory directory {};
+    {
+        std::ofstream file {(directory.path / "checkpoint.journal").string()};
+        file << "not a journal\n";
+    }
+    BOOST_CHECK_THROW(CheckpointJournal {directory.path}, MalformedFileError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <random>
+#include <memory>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "ranger/ForestProbability.h"
+#include "ranger/ForestClassification.h"
+
+#include "core/csr/filters/ranger_forest.hpp"
+#include "utils/thread_pool.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(ranger_forest)
+
+namespace fs = boost::filesystem;
+using octopus::csr::RangerForest;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+constexpr std::size_t numFeatures {3};
+
+// Integer valued measures so the text files ranger reads hold exactly the same values as the rows
+std::vector<double> make_rows(const std::size_t num_rows, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::uniform_int_distribution<int> value {-20, 120};
+    std::vector<double> result(num_rows * numFeatures);
+    std::generate(std::begin(result), std::end(result), [&] () { return value(generator); });
+    return result;
+}
+
+std::vector<int> make_labels(const std::vector<double>& rows, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::bernoulli_distribution flip {0.1};
+    std::vector<int> result {};
+    for (std::size_t i {0}; i < rows.size(); i += numFeatures) {
+        const bool tp {rows[i] + rows[i + 1] > 100 && rows[i + 2] < 80};
+        result.push_back(tp != flip(generator));
+    }
+    return result;
+}
+
+void write_data(const fs::path& file, const std::vector<double>& rows, const std::vector<int>& labels)
+{
+    std::ofstream out {file.string()};
+    out << "F1 F2 F3 TP\n";
+    for (std::size_t i {0}; i < labels.size(); ++i) {
+        for (std::size_t j {0}; j < numFeatures; ++j) out << rows[i * numFeatures + j] << ' ';
+        out << labels[i] << '\n';
+    }
+}
+
+template <typename Forest>
+fs::path train(const TempDirectory& directory, const std::string& name)
+{
+    const auto rows = make_rows(500, 1);
+    const auto data_file = directory.path / (name + ".dat");
+    write_data(data_file, rows, make_labels(rows, 2));
+    const auto prefix = directory.path / name;
+    Forest forest {};
+    std::vector<std::string> no_names {};
+    forest.initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, data_file.string(), 0, prefix.string(),
+                   50, nullptr, 42, 1, "", ranger::ImportanceMode::IMP_NONE, 5,
+                   "", no_names, "", true, no_names, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
+                   ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
+                   ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
+    forest.run(false);
+    forest.saveToFile();
+    return prefix.string() + ".forest";
+}
+
+// The probability of the false class as computed by ranger's own prediction pipeline, which is how
+// the random forest filters classified calls before RangerForest
+std::vector<double> ranger_predict(const fs::path& forest_file, const TempDirectory& directory,
+                                   const std::vector<double>& rows)
+{
+    const auto data_file = directory.path / "predict.dat";
+    write_data(data_file, rows, std::vector<int>(rows.size() / numFeatures, 0));
+    ranger::ForestProbability forest {};
+    std::vector<std::string> no_names {};
+    forest.initCpp("TP", ranger::MemoryMode::MEM_DOUBLE, data_file.string(), 0, (directory.path / "predict").string(),
+                   1000, nullptr, 12, 1, forest_file.string(), ranger::ImportanceMode::IMP_GINI, 1,
+                   "", no_names, "", true, no_names, false, ranger::SplitRule::LOGRANK, "", false, 1.0,
+                   ranger::DEFAULT_ALPHA, ranger::DEFAULT_MINPROP, false,
+                   ranger::PredictionType::RESPONSE, ranger::DEFAULT_NUM_RANDOM_SPLITS);
+    forest.run(false);
+    const auto& class_values = forest.getClassValues();
+    const auto false_class = std::distance(std::cbegin(class_values),
+                                           std::find(std::cbegin(class_values), std::cend(class_values), 0.0));
+    std::vector<double> result {};
+    for (const auto& sample : forest.getPredictions().front()) {
+        result.push_back(sample[false_class]);
+    }
+    return result;
+}
+
+void truncate_copy(const fs::path& source, const fs::path& destination, const std::size_t num_bytes)
+{
+    std::ifstream in {source.string(), std::ios::binary};
+    std::vector<char> bytes(num_bytes);
+    in.read(bytes.data(), num_bytes);
+    std::ofstream out {destination.string(), std::ios::binary};
+    out.write(bytes.data(), in.gcount());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(predictions_match_ranger)
+{
+    TempDirectory directory {};
+    const auto forest_file = train<ranger::ForestProbability>(directory, "probability");
+    const RangerForest forest {forest_file, numFeatures};
+    BOOST_CHECK_EQUAL(forest.num_trees(), 50);
+    BOOST_CHECK_EQUAL(forest.num_features(), numFeatures);
+    const auto rows = make_rows(1000, 3);
+    const auto expected = ranger_predict(forest_file, directory, rows);
+    std::vector<double> predictions {};
+    forest.predict(rows, predictions);
+    BOOST_REQUIRE_EQUAL(predictions.size(), expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        BOOST_CHECK_CLOSE(predictions[i], expected[i], 1e-9);
+        BOOST_CHECK_CLOSE(forest.predict(rows.data() + i * numFeatures), expected[i], 1e-9);
+    }
+    ThreadPool workers {2};
+    std::vector<double> parallel_predictions {};
+    forest.predict(rows, parallel_predictions, workers);
+    BOOST_CHECK(parallel_predictions == predictions);
+}
+
+BOOST_AUTO_TEST_CASE(bad_forest_files_are_rejected)
+{
+    TempDirectory directory {};
+    const auto forest_file = train<ranger::ForestProbability>(directory, "probability");
+    BOOST_CHECK_THROW(RangerForest(directory.path / "missing.forest", numFeatures), MissingFileError);
+    const auto empty_file = directory.path / "empty.forest";
+    truncate_copy(forest_file, empty_file, 0);
+    BOOST_CHECK_THROW(RangerForest(empty_file, numFeatures), MalformedFileError);
+    const auto truncated_file = directory.path / "truncated.forest";
+    truncate_copy(forest_file, truncated_file, fs::file_size(forest_file) / 2);
+    BOOST_CHECK_THROW(RangerForest(truncated_file, numFeatures), MalformedFileError);
+    const auto classification_file = train<ranger::ForestClassification>(directory, "classification");
+    BOOST_CHECK_THROW(RangerForest(classification_file, numFeatures), MalformedFileError);
+    BOOST_CHECK_THROW(RangerForest(forest_file, numFeatures, 2), MalformedFileError);
+    BOOST_CHECK_THROW(RangerForest(forest_file, 1), MalformedFileError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,4 +1,96 @@
 // Copyright (c) 2017 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <iterator>
+
+#include "utils/kmer_mapper.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(kmer_mapper)
+
+BOOST_AUTO_TEST_CASE(rolling_kmer_hashes_match_direct_hashes)
+{
+    constexpr unsigned char K {6};
+    const std::string sequence {"ACGTTGCAAGGCTTACGATCGATCGGGATTACCAGT"};
+    const auto hashes = compute_kmer_hashes<K>(sequence);
+    BOOST_REQUIRE_EQUAL(hashes.size(), sequence.size() - K + 1);
+    for (std::size_t i {0}; i < hashes.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], perfect_kmer_hash<K>(std::next(std::cbegin(sequence), i)));
+        BOOST_CHECK(hashes[i] < invalid_kmer_hash<K>());
+    }
+    BOOST_CHECK(compute_kmer_hashes<K>("ACGTA").empty());
+}
+
+BOOST_AUTO_TEST_CASE(kmers_with_non_acgt_bases_are_invalid)
+{
+    constexpr unsigned char K {4};
+    const std::string sequence {"ACGTNACGTA"};
+    const auto hashes = compute_kmer_hashes<K>(sequence);
+    BOOST_REQUIRE_EQUAL(hashes.size(), 7);
+    BOOST_CHECK(hashes[0] != invalid_kmer_hash<K>());
+    for (std::size_t i {1}; i <= 4; ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], invalid_kmer_hash<K>());
+    }
+    BOOST_CHECK_EQUAL(hashes[5], hashes[0]);
+    BOOST_CHECK(compute_kmer_hashes<K>("NNNN").front() != compute_kmer_hashes<K>("AAAA").front());
+}
+
+BOOST_AUTO_TEST_CASE(hash_table_lists_target_positions_by_kmer)
+{
+    constexpr unsigned char K {3};
+    const std::string target {"ACGACGNACG"};
+    const auto table = make_kmer_hash_table<K>(target);
+    BOOST_CHECK_EQUAL(table.num_target_kmers, target.size() - K + 1);
+    const auto hash = perfect_kmer_hash<K>(std::cbegin(target));
+    const std::vector<KmerHashTable::IndexType> positions {
+        std::next(std::cbegin(table.positions), table.offsets[hash]),
+        std::next(std::cbegin(table.positions), table.offsets[hash + 1])
+    };
+    BOOST_CHECK(positions == (std::vector<KmerHashTable::IndexType> {0, 3, 7}));
+    BOOST_CHECK_EQUAL(table.offsets.back(), 5); // 8 kmers, 3 contain N
+}
+
+BOOST_AUTO_TEST_CASE(queries_map_to_their_target_offset)
+{
+    constexpr unsigned char K {4};
+    const std::string target {"TTAGCCGATAGGCTAACCGTTAGACCTGAGGCATCATG"};
+    auto table = make_kmer_hash_table<K>(target);
+    MappedIndexCounts mapping_counts {};
+    for (const std::size_t offset : {0u, 5u, 11u, 20u}) {
+        const auto query = compute_kmer_hashes<K>(target.substr(offset, 15));
+        const auto positions = map_query_to_target(query, table, mapping_counts);
+        BOOST_REQUIRE(!positions.empty());
+        BOOST_CHECK_EQUAL(positions.front(), offset);
+    }
+    // Counts from previous queries must not leak into later ones, even on a smaller target
+    populate_kmer_hash_table<K>(target.substr(10), table);
+    const auto query = compute_kmer_hashes<K>(target.substr(12, 15));
+    const auto positions = map_query_to_target(query, table, mapping_counts);
+    BOOST_REQUIRE_EQUAL(positions.size(), 1);
+    BOOST_CHECK_EQUAL(positions.front(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(equally_good_mappings_are_reported_in_order)
+{
+    constexpr unsigned char K {3};
+    const std::string target {"GATTACAGGGGATTACA"};
+    const auto positions = map_query_to_target<K>("GATTACA", target);
+    BOOST_CHECK(positions == (std::vector<std::size_t> {0, 10}));
+    const auto table = make_kmer_hash_table<K>(target);
+    MappedIndexCounts mapping_counts {};
+    std::vector<std::size_t> first_position {};
+    map_query_to_target(compute_kmer_hashes<K>("GATTACA"), table, mapping_counts, std::back_inserter(first_position), 1);
+    BOOST_CHECK(first_position == (std::vector<std::size_t> {0}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
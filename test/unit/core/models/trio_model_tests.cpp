@@ -0,0 +1,164 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <map>
+#include <tuple>
+#include <random>
+#include <cmath>
+
+#include "basics/genomic_region.hpp"
+#include "basics/trio.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/mutation/denovo_model.hpp"
+#include "core/models/genotype/uniform_population_prior_model.hpp"
+#include "core/models/genotype/trio_model.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+using model::TrioModel;
+
+std::vector<Haplotype> make_haplotypes(const ReferenceGenome& reference)
+{
+    const GenomicRegion region {"1", 100, 200};
+    const std::vector<std::vector<Allele>> alleles {
+        {},
+        {Allele {GenomicRegion {"1", 110, 111}, "A"}},
+        {Allele {GenomicRegion {"1", 130, 131}, "G"}},
+        {Allele {GenomicRegion {"1", 110, 111}, "A"}, Allele {GenomicRegion {"1", 150, 151}, "G"}},
+        {Allele {GenomicRegion {"1", 120, 122}, ""}},
+        {Allele {GenomicRegion {"1", 170, 171}, "A"}, Allele {GenomicRegion {"1", 180, 181}, "G"}}
+    };
+    std::vector<Haplotype> result {};
+    for (const auto& haplotype_alleles : alleles) {
+        Haplotype::Builder builder {region, reference};
+        for (const auto& allele : haplotype_alleles) builder.push_back(allele);
+        result.push_back(builder.build());
+    }
+    return result;
+}
+
+// Reads drawn from the sample's true haplotypes get a high likelihood on those haplotypes and
+// noisy low likelihoods elsewhere, so the posterior has a clear mode and a long tail to prune
+void add_sample(HaplotypeLikelihoodArray& likelihoods, const SampleName& sample,
+                const std::vector<Haplotype>& haplotypes, const std::vector<std::size_t>& true_haplotypes,
+                const std::size_t num_reads, std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> noise {0.0, 1.0};
+    std::vector<std::vector<double>> sample_likelihoods(haplotypes.size(), std::vector<double>(num_reads));
+    for (std::size_t read {0}; read < num_reads; ++read) {
+        const auto source = true_haplotypes[read % true_haplotypes.size()];
+        for (std::size_t h {0}; h < haplotypes.size(); ++h) {
+            sample_likelihoods[h][read] = h == source ? -0.1 * noise(generator) : -3.0 - 10.0 * noise(generator);
+        }
+    }
+    for (std::size_t h {0}; h < haplotypes.size(); ++h) {
+        likelihoods.insert(sample, haplotypes[h], std::move(sample_likelihoods[h]));
+    }
+}
+
+using JointIndex = std::tuple<std::size_t, std::size_t, std::size_t>;
+
+auto index_posteriors(const TrioModel::Latents& posteriors, const std::vector<Genotype<Haplotype>>& genotypes)
+{
+    std::map<JointIndex, double> result {};
+    for (const auto& p : posteriors.joint_genotype_probabilities) {
+        const JointIndex index {std::addressof(p.maternal.get()) - genotypes.data(),
+                                std::addressof(p.paternal.get()) - genotypes.data(),
+                                std::addressof(p.child.get()) - genotypes.data()};
+        result.emplace(index, p.probability);
+    }
+    return result;
+}
+
+void check_equivalent(const TrioModel::InferredLatents& pruned, const TrioModel::InferredLatents& unpruned,
+                      const std::vector<Genotype<Haplotype>>& genotypes)
+{
+    constexpr double tolerance {1e-9};
+    BOOST_CHECK_SMALL(pruned.log_evidence - unpruned.log_evidence, tolerance);
+    // the likelihoods are peaked enough that pruning must skip some combinations
+    BOOST_CHECK_LT(pruned.posteriors.joint_genotype_probabilities.size(),
+                   unpruned.posteriors.joint_genotype_probabilities.size());
+    const auto pruned_posteriors = index_posteriors(pruned.posteriors, genotypes);
+    const auto unpruned_posteriors = index_posteriors(unpruned.posteriors, genotypes);
+    double missing_mass {0};
+    for (const auto& p : unpruned_posteriors) {
+        const auto itr = pruned_posteriors.find(p.first);
+        if (itr != std::cend(pruned_posteriors)) {
+            BOOST_CHECK_SMALL(itr->second - p.second, tolerance);
+        } else {
+            missing_mass += p.second;
+        }
+    }
+    for (const auto& p : pruned_posteriors) {
+        BOOST_CHECK(unpruned_posteriors.count(p.first) == 1);
+    }
+    BOOST_CHECK_SMALL(missing_mass, tolerance);
+    // marginal child posteriors are what the caller reports, so check them directly too
+    std::vector<double> pruned_child(genotypes.size()), unpruned_child(genotypes.size());
+    for (const auto& p : pruned_posteriors) pruned_child[std::get<2>(p.first)] += p.second;
+    for (const auto& p : unpruned_posteriors) unpruned_child[std::get<2>(p.first)] += p.second;
+    for (std::size_t g {0}; g < genotypes.size(); ++g) {
+        BOOST_CHECK_SMALL(pruned_child[g] - unpruned_child[g], tolerance);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(trio_model)
+
+BOOST_AUTO_TEST_CASE(pruned_and_unpruned_joint_search_give_the_same_posteriors)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotypes = make_haplotypes(reference);
+    const Trio trio {Trio::Mother {"mother"}, Trio::Father {"father"}, Trio::Child {"child"}};
+    std::vector<GenotypeIndex> genotype_indices {};
+    const auto genotypes = generate_all_genotypes(haplotypes, 2, genotype_indices);
+    UniformPopulationPriorModel prior_model {};
+    prior_model.prime(haplotypes);
+    DeNovoModel mutation_model {DeNovoModel::Parameters {1e-8, 1e-9}};
+    mutation_model.prime(haplotypes);
+
+    // a consistent trio, and one where the child carries a de novo haplotype
+    const std::vector<std::vector<std::size_t>> child_haplotypes {{0, 2}, {1, 5}};
+    for (const auto& child_truth : child_haplotypes) {
+        std::mt19937 generator {42};
+        HaplotypeLikelihoodArray likelihoods {static_cast<unsigned>(haplotypes.size()), {"mother", "father", "child"}};
+        add_sample(likelihoods, "mother", haplotypes, {0, 1}, 60, generator);
+        add_sample(likelihoods, "father", haplotypes, {2, 3}, 60, generator);
+        add_sample(likelihoods, "child", haplotypes, child_truth, 60, generator);
+
+        TrioModel::Options pruned_options {}, unpruned_options {};
+        pruned_options.max_joint_genotypes = unpruned_options.max_joint_genotypes = 1'000'000;
+        pruned_options.prune_joint_search = true;
+        unpruned_options.prune_joint_search = false;
+        const TrioModel pruned_model {trio, prior_model, mutation_model, pruned_options};
+        const TrioModel unpruned_model {trio, prior_model, mutation_model, unpruned_options};
+
+        const auto pruned = pruned_model.evaluate(genotypes, likelihoods);
+        const auto unpruned = unpruned_model.evaluate(genotypes, likelihoods);
+        check_equivalent(pruned, unpruned, genotypes);
+
+        const auto pruned_indexed = pruned_model.evaluate(genotypes, genotype_indices, likelihoods);
+        const auto unpruned_indexed = unpruned_model.evaluate(genotypes, genotype_indices, likelihoods);
+        check_equivalent(pruned_indexed, unpruned_indexed, genotypes);
+        check_equivalent(pruned_indexed, unpruned, genotypes);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
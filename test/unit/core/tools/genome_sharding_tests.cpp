@@ -0,0 +1,212 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "utils/coverage_estimate.hpp"
+#include "core/tools/genome_sharding.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(genome_sharding)
+
+namespace {
+
+InputRegionMap make_regions(const std::vector<GenomicRegion>& regions)
+{
+    InputRegionMap result {};
+    for (const auto& region : regions) {
+        result[region.contig_name()].insert(region);
+    }
+    return result;
+}
+
+GenomicRegion::Size total_size(const std::vector<GenomeShard>& shards)
+{
+    GenomicRegion::Size result {0};
+    for (const auto& shard : shards) {
+        for (const auto& region : shard.regions) result += size(region);
+    }
+    return result;
+}
+
+namespace fs = boost::filesystem;
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+VcfRecord make_record(const GenomicRegion::Position pos, std::string ref, std::string alt, const double qual)
+{
+    return VcfRecord::Builder().set_chrom("1").set_pos(pos).set_ref(std::move(ref)).set_alt(std::move(alt))
+           .set_qual(qual).set_passed().build_once();
+}
+
+fs::path write_shard(const GenomeShard& shard, const fs::path& directory, const std::vector<VcfRecord>& records)
+{
+    VcfHeader::Builder builder {};
+    builder.set_file_format("VCFv4.3").add_contig("1", {{"length", "1000"}});
+    add_shard_header_fields(shard, builder);
+    const auto result = directory / ("shard" + std::to_string(shard.index + 1) + ".vcf");
+    VcfWriter writer {result, builder.build_once()};
+    for (const auto& record : records) writer << record;
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(shards_partition_regions_in_contig_order)
+{
+    const auto regions = make_regions({GenomicRegion {"1", 0, 1000}, GenomicRegion {"2", 0, 1000}});
+    const std::vector<ContigName> contigs {"1", "2"};
+    const auto shards = make_genome_shards(regions, contigs, 4, {}, 100);
+    BOOST_REQUIRE_EQUAL(shards.size(), 4);
+    BOOST_CHECK_EQUAL(total_size(shards), 2000);
+    for (unsigned i {0}; i < shards.size(); ++i) {
+        BOOST_CHECK_EQUAL(shards[i].index, i);
+        BOOST_CHECK_EQUAL(shards[i].count, 4);
+        BOOST_REQUIRE_EQUAL(shards[i].regions.size(), 1);
+    }
+    BOOST_CHECK_EQUAL(shards[0].regions.front(), (GenomicRegion {"1", 0, 500}));
+    BOOST_CHECK_EQUAL(shards[1].regions.front(), (GenomicRegion {"1", 500, 1000}));
+    BOOST_CHECK_EQUAL(shards[2].regions.front(), (GenomicRegion {"2", 0, 500}));
+    BOOST_CHECK_EQUAL(shards[3].regions.front(), (GenomicRegion {"2", 500, 1000}));
+}
+
+BOOST_AUTO_TEST_CASE(shards_are_balanced_by_read_density)
+{
+    const auto regions = make_regions({GenomicRegion {"1", 0, 1000}, GenomicRegion {"2", 0, 1000}});
+    const std::vector<ContigName> contigs {"1", "2"};
+    const ReadDistributionMap reads {
+        {"1", CoverageEstimate {GenomicRegion {"1", 0, 1000}, 1000, {3000}}},
+        {"2", CoverageEstimate {GenomicRegion {"2", 0, 1000}, 1000, {1000}}}
+    };
+    const auto shards = make_genome_shards(regions, contigs, 2, reads, 100);
+    BOOST_REQUIRE_EQUAL(shards.size(), 2);
+    BOOST_CHECK_EQUAL(total_size(shards), 2000);
+    BOOST_REQUIRE_EQUAL(shards[0].regions.size(), 1);
+    BOOST_CHECK_EQUAL(shards[0].regions.front(), (GenomicRegion {"1", 0, 666}));
+    BOOST_REQUIRE_EQUAL(shards[1].regions.size(), 2);
+    BOOST_CHECK_EQUAL(shards[1].regions.front(), (GenomicRegion {"1", 666, 1000}));
+    BOOST_CHECK_EQUAL(shards[1].regions.back(), (GenomicRegion {"2", 0, 1000}));
+}
+
+BOOST_AUTO_TEST_CASE(shard_boundaries_follow_binned_read_counts_within_a_contig)
+{
+    // contig 1 has as many reads in its first 200 bases as contig 2 has in all of it
+    const auto regions = make_regions({GenomicRegion {"1", 0, 1000}, GenomicRegion {"2", 0, 1000}, GenomicRegion {"3", 0, 1000}});
+    const std::vector<ContigName> contigs {"1", "2", "3"};
+    const ReadDistributionMap reads {
+        {"1", CoverageEstimate {GenomicRegion {"1", 0, 1000}, 100, {600, 600, 0, 0, 0, 0, 0, 0, 0, 0}}},
+        {"2", CoverageEstimate {GenomicRegion {"2", 0, 1000}, 100, std::vector<double>(10, 120)}}
+    };
+    const auto shards = make_genome_shards(regions, contigs, 4, reads, 100);
+    BOOST_REQUIRE_EQUAL(shards.size(), 4);
+    BOOST_CHECK_EQUAL(total_size(shards), 3000);
+    // contig 3 has no estimate, so is costed at the mean density of the others, 1.2 reads per base
+    BOOST_REQUIRE_EQUAL(shards[0].regions.size(), 1);
+    BOOST_CHECK_EQUAL(shards[0].regions.front(), (GenomicRegion {"1", 0, 150}));
+    BOOST_REQUIRE_EQUAL(shards[1].regions.size(), 2);
+    BOOST_CHECK_EQUAL(shards[1].regions.front(), (GenomicRegion {"1", 150, 1000}));
+    BOOST_CHECK_EQUAL(shards[1].regions.back(), (GenomicRegion {"2", 0, 500}));
+    BOOST_REQUIRE_EQUAL(shards[2].regions.size(), 2);
+    BOOST_CHECK_EQUAL(shards[2].regions.front(), (GenomicRegion {"2", 500, 1000}));
+    BOOST_CHECK_EQUAL(shards[2].regions.back(), (GenomicRegion {"3", 0, 250}));
+    BOOST_REQUIRE_EQUAL(shards[3].regions.size(), 1);
+    BOOST_CHECK_EQUAL(shards[3].regions.front(), (GenomicRegion {"3", 250, 1000}));
+}
+
+BOOST_AUTO_TEST_CASE(shard_search_regions_are_expanded_within_search_regions)
+{
+    const auto regions = make_regions({GenomicRegion {"1", 100, 1100}});
+    const auto shards = make_genome_shards(regions, {"1"}, 2, {}, 200);
+    BOOST_REQUIRE_EQUAL(shards.size(), 2);
+    const auto left = get_shard_search_regions(shards[0], regions);
+    BOOST_REQUIRE_EQUAL(left.at("1").size(), 1);
+    BOOST_CHECK_EQUAL(left.at("1").front(), (GenomicRegion {"1", 100, 800}));
+    const auto right = get_shard_search_regions(shards[1], regions);
+    BOOST_REQUIRE_EQUAL(right.at("1").size(), 1);
+    BOOST_CHECK_EQUAL(right.at("1").front(), (GenomicRegion {"1", 400, 1100}));
+}
+
+BOOST_AUTO_TEST_CASE(shards_can_be_read_back_from_vcf_headers)
+{
+    const auto regions = make_regions({GenomicRegion {"1", 0, 1000}, GenomicRegion {"2", 0, 1000}});
+    const auto shards = make_genome_shards(regions, {"1", "2"}, 3, {}, 100);
+    const auto& shard = shards[1];
+    VcfHeader::Builder builder {};
+    builder.set_file_format("VCFv4.3");
+    add_shard_header_fields(shard, builder);
+    const auto header = builder.build_once();
+    const auto read = read_shard(header);
+    BOOST_REQUIRE(read);
+    BOOST_CHECK_EQUAL(read->index, shard.index);
+    BOOST_CHECK_EQUAL(read->count, shard.count);
+    BOOST_CHECK_EQUAL(read->margin, shard.margin);
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(read->regions), std::cend(read->regions),
+                                  std::cbegin(shard.regions), std::cend(shard.regions));
+    BOOST_CHECK(!read_shard(VcfHeader {}));
+}
+
+BOOST_AUTO_TEST_CASE(merge_shards_writes_calls_spanning_a_split_point_once)
+{
+    const auto regions = make_regions({GenomicRegion {"1", 0, 1000}});
+    const auto shards = make_genome_shards(regions, {"1"}, 2, {}, 50);
+    BOOST_REQUIRE_EQUAL(shards.size(), 2);
+    // VCF positions are one-based, so the split point is also the position of the last base of the left core
+    const auto split = shards[0].regions.back().end();
+    BOOST_REQUIRE_EQUAL(shards[1].regions.front().begin(), split);
+    TempDirectory directory {};
+    const std::vector<VcfRecord> left_calls {
+        make_record(100, "A", "C", 50),
+        make_record(split - 1, "ACGTA", "A", 40), // spans the split point
+        make_record(split + 10, "G", "T", 30) // in the right margin
+    };
+    const std::vector<VcfRecord> right_calls {
+        make_record(split - 20, "T", "G", 30), // in the left margin
+        make_record(split - 1, "ACGTA", "A", 45), // the same deletion
+        make_record(split + 2, "G", "A", 20), // inside the deletion, only seen by the right shard
+        make_record(split + 10, "G", "T", 35),
+        make_record(split + 100, "C", "G", 60)
+    };
+    std::vector<VcfReader> readers {};
+    readers.emplace_back(write_shard(shards[1], directory.path, right_calls));
+    readers.emplace_back(write_shard(shards[0], directory.path, left_calls));
+    const auto merged_file = directory.path / "merged.vcf";
+    {
+        VcfWriter merged {merged_file};
+        merge_shards(readers, merged);
+    }
+    VcfReader merged {merged_file};
+    BOOST_CHECK(!read_shard(merged.fetch_header()));
+    const auto records = merged.fetch_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 5);
+    BOOST_CHECK_EQUAL(records[0].pos(), 100);
+    BOOST_CHECK_EQUAL(records[1].pos(), split - 1);
+    BOOST_CHECK_EQUAL(records[1].ref(), "ACGTA");
+    BOOST_CHECK_EQUAL(*records[1].qual(), 40); // from the left shard
+    BOOST_CHECK_EQUAL(records[2].pos(), split + 2);
+    BOOST_CHECK_EQUAL(records[3].pos(), split + 10);
+    BOOST_CHECK_EQUAL(*records[3].qual(), 35); // from the right shard
+    BOOST_CHECK_EQUAL(records[4].pos(), split + 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,121 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "containers/mappable_flat_set.hpp"
+#include "containers/mappable_map.hpp"
+#include "core/types/variant.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_cost_model.hpp"
+#include "core/tools/hapgen/haplotype_generator.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_cost_model)
+
+using Seconds = HaplotypeCostModel::Seconds;
+
+namespace {
+
+MappableFlatSet<Variant> make_snvs(const ReferenceGenome& reference)
+{
+    MappableFlatSet<Variant> result {};
+    for (GenomicRegion::Position position {100}; position < 220; position += 10) {
+        const GenomicRegion region {"1", position, position + 1};
+        const auto ref = reference.fetch_sequence(region);
+        result.emplace(region, ref, ref == "A" ? "C" : "A");
+    }
+    return result;
+}
+
+ReadMap make_reads(const ReferenceGenome& reference)
+{
+    ReadMap result {};
+    auto& reads = result["sample"];
+    for (GenomicRegion::Position begin {50}; begin < 200; begin += 5) {
+        const GenomicRegion region {"1", begin, begin + 100};
+        auto sequence = reference.fetch_sequence(region);
+        AlignedRead::BaseQualityVector qualities(sequence.size(), 30);
+        reads.emplace(std::to_string(begin), region, std::move(sequence), std::move(qualities),
+                      parse_cigar("100M"), 60, AlignedRead::Flags {}, "RG");
+    }
+    return result;
+}
+
+// The largest number of haplotypes in any region the generator produces
+std::size_t max_generated_haplotypes(const HaplotypeGenerator::Builder& builder, const ReferenceGenome& reference,
+                                     const MappableFlatSet<Variant>& candidates, const ReadMap& reads)
+{
+    auto generator = builder.build(reference, candidates, reads);
+    std::size_t result {0};
+    for (int i {0}; i < 100; ++i) {
+        std::vector<Haplotype> haplotypes {};
+        std::tie(haplotypes, std::ignore, std::ignore) = generator.generate();
+        if (haplotypes.empty()) break;
+        result = std::max(result, haplotypes.size());
+        generator.clear_progress();
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(predicted_cost_scales_with_reads_haplotypes_length_and_ploidy)
+{
+    const HaplotypeCostModel model {Seconds {10}, 2, Seconds {1e-6}};
+    BOOST_CHECK_CLOSE(model.predict(100, 10, 500).count(), 1.0, 1e-6);
+    BOOST_CHECK_CLOSE(model.predict(200, 10, 500).count(), 2 * model.predict(100, 10, 500).count(), 1e-6);
+    BOOST_CHECK_CLOSE(model.predict(100, 20, 500).count(), 2 * model.predict(100, 10, 500).count(), 1e-6);
+    const HaplotypeCostModel triploid_model {Seconds {10}, 3, Seconds {1e-6}};
+    BOOST_CHECK_CLOSE(triploid_model.predict(100, 10, 500).count(), 1.5, 1e-6);
+    BOOST_CHECK_EQUAL(model.predict(0, 10, 500).count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(max_haplotypes_fit_the_region_budget)
+{
+    const HaplotypeCostModel model {Seconds {10}, 2, Seconds {1e-6}};
+    BOOST_CHECK_EQUAL(model.max_haplotypes(100, 500), 100);
+    BOOST_CHECK_EQUAL(model.max_haplotypes(1000, 500), 10);
+    BOOST_CHECK(model.predict(1000, model.max_haplotypes(1000, 500), 500) <= model.region_budget());
+    BOOST_CHECK_EQUAL(model.max_haplotypes(0, 500), std::numeric_limits<std::size_t>::max());
+}
+
+BOOST_AUTO_TEST_CASE(calibration_measures_a_positive_unit_cost)
+{
+    const auto model = make_calibrated_cost_model(Seconds {60}, 2);
+    BOOST_CHECK(model.unit_cost().count() > 0);
+    BOOST_CHECK(model.unit_cost() < Seconds {1e-3});
+}
+
+BOOST_AUTO_TEST_CASE(budgeted_generators_walk_regions_within_the_reduced_limits)
+{
+    const auto reference = mock::make_reference();
+    const auto candidates = make_snvs(reference);
+    const auto reads = make_reads(reference);
+    HaplotypeGenerator::Builder builder {};
+    builder.set_lagging_policy(HaplotypeGenerator::Policies::Lagging::none);
+    builder.set_extension_policy(HaplotypeGenerator::Policies::Extension::aggressive);
+    BOOST_REQUIRE_GT(max_generated_haplotypes(builder, reference, candidates, reads), 8);
+    // No region fits this budget, so every region gets the minimum target of two haplotypes, and
+    // the walkers must then include a single candidate per region
+    builder.set_cost_model(HaplotypeCostModel {Seconds {1e-9}, 2, Seconds {1e-6}});
+    BOOST_CHECK_EQUAL(max_generated_haplotypes(builder, reference, candidates, reads), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
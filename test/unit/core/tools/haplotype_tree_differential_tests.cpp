@@ -0,0 +1,161 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <random>
+#include <algorithm>
+
+#include "basics/genomic_region.hpp"
+#include "basics/contig_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "mock/mock_reference.hpp"
+
+#include "baseline_haplotype_tree.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_tree)
+
+namespace {
+
+std::vector<std::string> describe(const std::vector<Haplotype>& haplotypes)
+{
+    std::vector<std::string> result {};
+    result.reserve(haplotypes.size());
+    for (const auto& haplotype : haplotypes) {
+        std::ostringstream ss {};
+        ss << mapped_region(haplotype) << ':' << haplotype.sequence();
+        result.push_back(ss.str());
+    }
+    return result;
+}
+
+template <typename F>
+bool throws(F&& f)
+{
+    try {
+        f();
+        return false;
+    } catch (...) {
+        return true;
+    }
+}
+
+} // namespace
+
+// Runs the same random sequences of tree operations on the arena tree and on the boost::graph tree it
+// replaced, which must then extract the same haplotypes in the same order
+BOOST_AUTO_TEST_CASE(random_operations_give_the_same_haplotypes_as_the_baseline_tree)
+{
+    const auto reference = mock::make_reference();
+    const auto contig = reference.fetch_sequence(GenomicRegion {"1", 0, 400});
+    const std::string bases {"ACGT"};
+    std::mt19937 generator {1};
+    const auto random = [&generator] (const unsigned n) { return static_cast<unsigned>(generator() % n); };
+    for (int trial {0}; trial < 200; ++trial) {
+        coretools::HaplotypeTree tree {"1", reference};
+        baseline::HaplotypeTree baseline_tree {"1", reference};
+        GenomicRegion::Position position {5};
+        std::ostringstream history {};
+        for (int step {0}; step < 40 && position <= 380; ++step) {
+            const auto operation = random(10);
+            if (operation < 5) {
+                position += random(3);
+                const auto ref_size = random(3);
+                std::string alt {};
+                for (auto n = random(3); n > 0; --n) alt += bases[random(4)];
+                if (ref_size == 0 && alt.empty()) alt = "A";
+                const ContigAllele allele {ContigRegion {position, position + ref_size}, alt};
+                if (random(3) == 0) {
+                    tree.splice(allele);
+                    baseline_tree.splice(allele);
+                    history << "splice " << allele << '\n';
+                } else {
+                    tree.extend(allele);
+                    baseline_tree.extend(allele);
+                    history << "extend " << allele << '\n';
+                }
+                if (random(2) == 1) {
+                    const auto size = std::max(1u, ref_size);
+                    const ContigAllele ref_allele {ContigRegion {position, position + size}, contig.substr(position, size)};
+                    tree.extend(ref_allele);
+                    baseline_tree.extend(ref_allele);
+                    history << "extend " << ref_allele << '\n';
+                }
+            } else if (operation < 7 && !tree.is_empty()) {
+                const auto haplotypes = tree.extract_haplotypes();
+                baseline_tree.extract_haplotypes(); // both trees cache the last extracted haplotypes
+                if (!haplotypes.empty()) {
+                    const auto haplotype = haplotypes[random(haplotypes.size())];
+                    history << "prune " << mapped_region(haplotype) << ' ' << haplotype.sequence() << '\n';
+                    if (random(2) == 1) {
+                        tree.prune_all(haplotype);
+                        baseline_tree.prune_all(haplotype);
+                    } else {
+                        const auto tree_threw = throws([&] () { tree.prune_unique(haplotype); });
+                        const auto baseline_threw = throws([&] () { baseline_tree.prune_unique(haplotype); });
+                        BOOST_REQUIRE_MESSAGE(tree_threw == baseline_threw, history.str());
+                    }
+                }
+            } else if (operation < 8 && !tree.is_empty()) {
+                const auto tree_region = tree.encompassing_region();
+                const auto begin = tree_region.begin() + random(size(tree_region) + 1);
+                const GenomicRegion region {"1", begin, begin + random(4)};
+                tree.clear(region);
+                baseline_tree.clear(region);
+                history << "clear " << region << '\n';
+            } else if (operation < 9) {
+                const coretools::HaplotypeTree copy {tree};
+                tree = copy;
+                history << "copy\n";
+            }
+            BOOST_REQUIRE_MESSAGE(tree.num_haplotypes() == baseline_tree.num_haplotypes(), history.str());
+            const auto haplotypes = tree.extract_haplotypes();
+            BOOST_REQUIRE_MESSAGE(describe(haplotypes) == describe(baseline_tree.extract_haplotypes()), history.str());
+            if (!tree.is_empty()) {
+                BOOST_REQUIRE_MESSAGE(tree.extract_haplotype_lengths() == baseline_tree.extract_haplotype_lengths(), history.str());
+                for (const auto& haplotype : haplotypes) {
+                    BOOST_REQUIRE(tree.contains(haplotype));
+                }
+            }
+            if (tree.num_haplotypes() > 300) {
+                tree.clear();
+                baseline_tree.clear();
+                position += 5;
+                history << "reset\n";
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(haplotype_tree_copies_are_independent)
+{
+    const auto reference = mock::make_reference();
+    coretools::HaplotypeTree tree {"1", reference};
+    for (GenomicRegion::Position begin {100}; begin < 120; begin += 2) {
+        tree.extend(Allele {GenomicRegion {"1", begin, begin + 1}, "A"});
+        tree.extend(Allele {GenomicRegion {"1", begin, begin + 1}, "C"});
+    }
+    BOOST_REQUIRE_EQUAL(tree.num_haplotypes(), 1024);
+    const auto copy = tree;
+    tree.clear(GenomicRegion {"1", 100, 102});
+    BOOST_CHECK_EQUAL(copy.num_haplotypes(), 1024);
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 512);
+    const auto haplotypes = copy.extract_haplotypes();
+    BOOST_CHECK_EQUAL(haplotypes.size(), 1024);
+    BOOST_CHECK(std::all_of(std::cbegin(haplotypes), std::cend(haplotypes),
+                            [&] (const auto& haplotype) { return copy.contains(haplotype); }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,94 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "containers/mappable_flat_set.hpp"
+#include "containers/mappable_map.hpp"
+#include "core/types/variant.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/tools/isolated_snv_screener.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(isolated_snv_screener)
+
+namespace {
+
+AlignedRead make_read(GenomicRegion::Position begin, const std::string& cigar, std::string sequence)
+{
+    const auto parsed_cigar = parse_cigar(cigar);
+    const auto read_size = sequence.size();
+    return AlignedRead {
+        "read", GenomicRegion {"2", begin, begin + reference_size(parsed_cigar)},
+        std::move(sequence), AlignedRead::BaseQualityVector(read_size, 30),
+        parsed_cigar, 60, AlignedRead::Flags {}, "RG"
+    };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(only_snvs_far_from_other_candidates_and_outside_repeats_are_isolated)
+{
+    const auto reference = mock::make_reference();
+    const MappableFlatSet<Variant> candidates {
+        Variant {"2", 95, "A", "G"},  // in a poly-A run
+        Variant {"2", 220, "G", "T"},
+        Variant {"2", 225, "A", "C"},
+        Variant {"2", 240, "A", "C"},
+        Variant {"2", 260, "T", "TA"}
+    };
+    const auto snvs = find_isolated_snvs(candidates, reference, 10);
+    BOOST_REQUIRE_EQUAL(snvs.size(), 1);
+    BOOST_CHECK_EQUAL(snvs.front(), (Variant {"2", 240, "A", "C"}));
+    BOOST_CHECK_EQUAL(find_isolated_snvs(candidates, reference, 3).size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(isolated_snv_likelihoods_only_depend_on_the_aligned_base)
+{
+    const auto reference = mock::make_reference();
+    const Variant snv {"2", 240, "A", "C"};
+    ReadMap reads {};
+    reads["sample"] = ReadContainer {
+        make_read(230, "20M", std::string(10, 'A') + "C" + std::string(9, 'A')),
+        make_read(232, "6M3D10M", std::string(16, 'A')),
+        make_read(235, "5S15M", std::string(10, 'A') + "A" + std::string(9, 'A')),
+        make_read(236, "10M", std::string(4, 'A') + "N" + std::string(5, 'A'))
+    };
+    const std::vector<SampleName> samples {"sample"};
+    HaplotypeLikelihoodArray haplotype_likelihoods {2, samples};
+    const auto haplotypes = populate_isolated_snv_likelihoods(snv, view_overlapped(reads, snv), samples,
+                                                              reference, haplotype_likelihoods);
+    BOOST_REQUIRE_EQUAL(haplotypes.size(), 2);
+    BOOST_CHECK(is_reference(haplotypes.front()));
+    BOOST_CHECK(haplotypes.back().contains(snv.alt_allele()));
+    const auto& ref_likelihoods = haplotype_likelihoods("sample", haplotypes.front());
+    const auto& alt_likelihoods = haplotype_likelihoods("sample", haplotypes.back());
+    BOOST_REQUIRE_EQUAL(ref_likelihoods.size(), 4);
+    BOOST_REQUIRE_EQUAL(alt_likelihoods.size(), 4);
+    const auto e = std::pow(10.0, -3.0);
+    BOOST_CHECK_CLOSE(ref_likelihoods[0], std::log(e / 3), 1e-6);
+    BOOST_CHECK_CLOSE(alt_likelihoods[0], std::log(1 - e), 1e-6);
+    BOOST_CHECK_EQUAL(ref_likelihoods[1], 0);
+    BOOST_CHECK_EQUAL(alt_likelihoods[1], 0);
+    BOOST_CHECK_CLOSE(ref_likelihoods[2], std::log(1 - e), 1e-6);
+    BOOST_CHECK_CLOSE(alt_likelihoods[2], std::log(e / 3), 1e-6);
+    BOOST_CHECK_EQUAL(ref_likelihoods[3], 0);
+    BOOST_CHECK_EQUAL(alt_likelihoods[3], 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -3,17 +3,188 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "basics/genomic_region.hpp"
+#include "basics/phred.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/genotype.hpp"
 #include "core/tools/phaser/phaser.hpp"
+#include "mock/mock_reference.hpp"
 
 namespace octopus { namespace test {
 
 BOOST_AUTO_TEST_SUITE(core)
 BOOST_AUTO_TEST_SUITE(phaser)
 
+namespace {
+
+const GenomicRegion phaseRegion {"1", 100, 200};
+
+// Every combination of a bi-allelic site, a tri-allelic site and two more bi-allelic sites
+std::vector<Haplotype> make_haplotypes(const ReferenceGenome& reference)
+{
+    const std::vector<GenomicRegion::Position> sites {110, 130, 150, 170};
+    const std::vector<unsigned> num_alts {1, 2, 1, 1};
+    const std::string bases {"ACGT"};
+    std::vector<std::vector<unsigned>> choices {{}};
+    for (const auto n : num_alts) {
+        std::vector<std::vector<unsigned>> extended {};
+        for (const auto& choice : choices) {
+            for (unsigned a {0}; a <= n; ++a) {
+                extended.push_back(choice);
+                extended.back().push_back(a);
+            }
+        }
+        choices = std::move(extended);
+    }
+    std::vector<Haplotype> result {};
+    for (const auto& choice : choices) {
+        Haplotype::Builder builder {phaseRegion, reference};
+        for (std::size_t s {0}; s < sites.size(); ++s) {
+            if (choice[s] == 0) continue;
+            const GenomicRegion site {"1", sites[s], sites[s] + 1};
+            auto alts = bases;
+            alts.erase(alts.find(reference.fetch_sequence(site).front()), 1);
+            builder.push_back(Allele {site, std::string(1, alts[choice[s] - 1])});
+        }
+        result.push_back(builder.build());
+    }
+    return result;
+}
+
+std::vector<double> make_posteriors(const std::size_t num_genotypes, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::uniform_real_distribution<double> uniform {0.0, 1.0};
+    std::vector<double> result(num_genotypes);
+    std::generate(std::begin(result), std::end(result), [&] () { return std::pow(uniform(generator), 8) + 1e-9; });
+    const auto norm = std::accumulate(std::cbegin(result), std::cend(result), 0.0);
+    for (auto& p : result) p /= norm;
+    return result;
+}
+
+// The phase score with phase complement sets found by copying every genotype into each partition
+double naive_phase_score(const std::vector<Genotype<Haplotype>>& genotypes, const std::vector<double>& posteriors,
+                         const std::vector<GenomicRegion>& partitions)
+{
+    std::vector<std::vector<Genotype<Haplotype>>> keys {};
+    std::vector<std::vector<double>> phase_sets {};
+    for (std::size_t g {0}; g < genotypes.size(); ++g) {
+        std::vector<Genotype<Haplotype>> key {};
+        for (const auto& partition : partitions) key.push_back(copy<Haplotype>(genotypes[g], partition));
+        const auto itr = std::find(std::cbegin(keys), std::cend(keys), key);
+        if (itr == std::cend(keys)) {
+            keys.push_back(std::move(key));
+            phase_sets.push_back({posteriors[g]});
+        } else {
+            phase_sets[std::distance(std::cbegin(keys), itr)].push_back(posteriors[g]);
+        }
+    }
+    double total {0};
+    for (const auto& phase_set : phase_sets) {
+        const auto norm = std::accumulate(std::cbegin(phase_set), std::cend(phase_set), 0.0);
+        double relative_entropy {1};
+        if (phase_set.size() > 1) {
+            double entropy {0};
+            for (const auto p : phase_set) entropy -= (p / norm) * std::log2(p / norm);
+            relative_entropy = 1.0 - std::max(0.0, entropy) / std::log2(phase_set.size());
+        }
+        total += norm * relative_entropy;
+    }
+    return Phred<double> {Phred<double>::Probability {std::max(0.0, 1.0 - total)}}.score();
+}
 
+// Merges genotypes that are the same within region, as the phaser does before scoring a sub-region
+void marginalise(const std::vector<Genotype<Haplotype>>& genotypes, const std::vector<double>& posteriors,
+                 const GenomicRegion& region,
+                 std::vector<Genotype<Haplotype>>& chunks, std::vector<double>& chunk_posteriors)
+{
+    chunks.clear();
+    chunk_posteriors.clear();
+    for (std::size_t g {0}; g < genotypes.size(); ++g) {
+        auto chunk = copy<Haplotype>(genotypes[g], region);
+        const auto itr = std::find(std::cbegin(chunks), std::cend(chunks), chunk);
+        if (itr == std::cend(chunks)) {
+            chunks.push_back(std::move(chunk));
+            chunk_posteriors.push_back(posteriors[g]);
+        } else {
+            chunk_posteriors[std::distance(std::cbegin(chunks), itr)] += posteriors[g];
+        }
+    }
+}
+
+double cap(const double score)
+{
+    return std::min(score, 100.0); // the phaser's default maximum phase score
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(phase_scores_match_phase_complement_sets_of_partition_copies)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotypes = make_haplotypes(reference);
+    const auto genotypes = generate_all_genotypes(haplotypes, 2);
+    const std::vector<SampleName> samples {"first", "second"};
+    Phaser::GenotypePosteriorMap genotype_posteriors {std::cbegin(genotypes), std::cend(genotypes)};
+    std::vector<std::vector<double>> sample_posteriors {};
+    for (std::size_t s {0}; s < samples.size(); ++s) {
+        sample_posteriors.push_back(make_posteriors(genotypes.size(), s + 1));
+        insert_sample(samples[s], sample_posteriors.back(), genotype_posteriors);
+    }
+    // sites are at 110, 130, 150 (tri-allelic) and 170; the last partitioning has a partition with no sites
+    const std::vector<std::vector<GenomicRegion>> partitionings {
+        {GenomicRegion {"1", 105, 120}, GenomicRegion {"1", 125, 140}, GenomicRegion {"1", 145, 160}, GenomicRegion {"1", 165, 180}},
+        {GenomicRegion {"1", 105, 140}, GenomicRegion {"1", 145, 180}},
+        {GenomicRegion {"1", 100, 115}, GenomicRegion {"1", 120, 200}},
+        {GenomicRegion {"1", 105, 120}, GenomicRegion {"1", 140, 145}, GenomicRegion {"1", 160, 175}}
+    };
+    const Phaser unsplit_phaser {Phred<double> {0.0}}, split_phaser {Phred<double> {20.0}};
+    std::vector<Genotype<Haplotype>> chunks {};
+    std::vector<double> chunk_posteriors {};
+    bool any_split {false};
+    for (const auto& partitions : partitionings) {
+        const auto unsplit = unsplit_phaser.force_phase(haplotypes, genotype_posteriors, partitions);
+        const auto split = split_phaser.force_phase(haplotypes, genotype_posteriors, partitions);
+        for (std::size_t s {0}; s < samples.size(); ++s) {
+            const auto& unsplit_regions = unsplit.phase_regions.at(samples[s]);
+            BOOST_REQUIRE_EQUAL(unsplit_regions.size(), 1);
+            BOOST_CHECK_EQUAL(unsplit_regions.front().region, phaseRegion);
+            const auto expected_score = naive_phase_score(genotypes, sample_posteriors[s], partitions);
+            BOOST_CHECK_CLOSE(unsplit_regions.front().score.score(), cap(expected_score), 1e-6);
+            // each split phase region covers a run of partitions, and is scored on the genotypes merged
+            // within it
+            const auto& split_regions = split.phase_regions.at(samples[s]);
+            if (split_regions.size() > 1) any_split = true;
+            auto partition_itr = std::cbegin(partitions);
+            for (const auto& phase : split_regions) {
+                std::vector<GenomicRegion> phase_partitions {};
+                while (partition_itr != std::cend(partitions) && contains(phase.region, *partition_itr)) {
+                    phase_partitions.push_back(*partition_itr++);
+                }
+                BOOST_REQUIRE(!phase_partitions.empty());
+                if (split_regions.size() == 1) {
+                    BOOST_CHECK_CLOSE(phase.score.score(), cap(expected_score), 1e-6);
+                } else {
+                    marginalise(genotypes, sample_posteriors[s], phase.region, chunks, chunk_posteriors);
+                    BOOST_CHECK_CLOSE(phase.score.score(), cap(naive_phase_score(chunks, chunk_posteriors, phase_partitions)), 1e-6);
+                }
+            }
+            BOOST_CHECK(partition_itr == std::cend(partitions));
+        }
+    }
+    BOOST_CHECK(any_split);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
-    
+
 } // namespace test
 } // namespace octopus
@@ -0,0 +1,200 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <iterator>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/phred.hpp"
+#include "containers/mappable_map.hpp"
+#include "core/types/calls/reference_call.hpp"
+#include "core/models/reference/individual_reference_likelihood_model.hpp"
+#include "core/tools/reference_confidence_engine.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(reference_confidence_engine)
+
+namespace {
+
+using model::IndividualReferenceLikelihoodModel;
+
+const GenomicRegion callRegion {"1", 100, 300};
+
+// Reads with random qualities, occasional mismatches and indels, and depth that varies along the
+// region, so the reference qualities move between bands and sometimes drop below the call threshold
+ReadContainer make_reads(const ReferenceGenome& reference, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::uniform_int_distribution<GenomicRegion::Position> begin {90, 290};
+    std::uniform_int_distribution<int> base_quality {5, 40}, event {0, 19};
+    std::discrete_distribution<int> mapping_quality_index {1, 2, 7};
+    const std::vector<AlignedRead::MappingQuality> mapping_qualities {5, 20, 60};
+    const std::vector<std::string> cigars {"20M", "20M", "20M", "8M1I11M", "10M2D10M"};
+    ReadContainer result {};
+    for (int i {0}; i < 150; ++i) {
+        auto read_begin = begin(generator);
+        if (read_begin > 200 && i % 2 == 0) read_begin -= 100; // deeper over the first half
+        const auto cigar = parse_cigar(cigars[i % cigars.size()]);
+        const GenomicRegion read_region {"1", read_begin, read_begin + reference_size(cigar)};
+        const auto ref_sequence = reference.fetch_sequence(read_region);
+        std::string sequence {};
+        std::size_t ref_offset {0};
+        for (const auto& op : cigar) {
+            if (op.flag() == CigarOperation::Flag::insertion) {
+                sequence.append(op.size(), 'A');
+            } else if (op.flag() == CigarOperation::Flag::deletion) {
+                ref_offset += op.size();
+            } else {
+                sequence.append(ref_sequence, ref_offset, op.size());
+                ref_offset += op.size();
+            }
+        }
+        for (auto& base : sequence) {
+            if (event(generator) == 0) base = base == 'C' ? 'G' : 'C';
+        }
+        AlignedRead::BaseQualityVector qualities(sequence.size());
+        std::generate(std::begin(qualities), std::end(qualities), [&] () { return base_quality(generator); });
+        result.emplace(std::to_string(i), read_region, std::move(sequence), std::move(qualities), cigar,
+                       mapping_qualities[mapping_quality_index(generator)], AlignedRead::Flags {}, "RG");
+    }
+    return result;
+}
+
+ReadMap make_reads(const ReferenceGenome& reference, const std::vector<SampleName>& samples)
+{
+    ReadMap result {};
+    unsigned seed {1};
+    for (const auto& sample : samples) {
+        result[sample] = make_reads(reference, seed++);
+    }
+    return result;
+}
+
+ReferenceConfidenceEngine::Parameters make_parameters(const ReferenceConfidenceEngine::Resolution resolution)
+{
+    ReferenceConfidenceEngine::Parameters result {};
+    result.resolution = resolution;
+    result.min_call_posterior = Phred<double> {2.0};
+    return result;
+}
+
+std::size_t band(const std::vector<double>& bands, const double quality)
+{
+    return std::distance(std::cbegin(bands), std::upper_bound(std::cbegin(bands), std::cend(bands), quality));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(positional_calls_match_the_model_qualities)
+{
+    const auto reference = mock::make_reference();
+    const std::vector<SampleName> samples {"sample"};
+    const auto reads = make_reads(reference, samples);
+    const ReferenceConfidenceEngine engine {reference, samples, 2, make_parameters(ReferenceConfidenceEngine::Resolution::positional)};
+    const auto calls = engine.call(callRegion, reads);
+    const IndividualReferenceLikelihoodModel model {2};
+    std::vector<double> qualities {};
+    model.evaluate(callRegion, reference.fetch_sequence(callRegion), reads.at("sample"), qualities);
+    std::size_t num_callable {0};
+    auto call_itr = std::cbegin(calls);
+    for (std::size_t position {0}; position < qualities.size(); ++position) {
+        if (qualities[position] < 2.0) continue;
+        ++num_callable;
+        BOOST_REQUIRE(call_itr != std::cend(calls));
+        const auto& call = **call_itr++;
+        BOOST_CHECK_EQUAL(mapped_begin(call), callRegion.begin() + position);
+        BOOST_CHECK_EQUAL(region_size(call), 1);
+        BOOST_CHECK_CLOSE(call.get_genotype_call("sample").posterior.score(), qualities[position], 1e-9);
+    }
+    BOOST_CHECK(call_itr == std::cend(calls));
+    // the reads must make some positions uncallable for the comparisons below to mean anything
+    BOOST_CHECK_GT(num_callable, 0);
+    BOOST_CHECK_LT(num_callable, qualities.size());
+}
+
+BOOST_AUTO_TEST_CASE(banded_blocks_summarise_the_positional_calls)
+{
+    const auto reference = mock::make_reference();
+    const std::vector<SampleName> samples {"first", "second"};
+    const auto reads = make_reads(reference, samples);
+    const auto blocked_parameters = make_parameters(ReferenceConfidenceEngine::Resolution::blocked);
+    const auto& bands = blocked_parameters.quality_bands;
+    const ReferenceConfidenceEngine positional_engine {reference, samples, 2, make_parameters(ReferenceConfidenceEngine::Resolution::positional)};
+    const ReferenceConfidenceEngine blocked_engine {reference, samples, 2, blocked_parameters};
+    const std::vector<GenomicRegion> regions {GenomicRegion {"1", 100, 180}, GenomicRegion {"1", 190, 300}};
+    const auto positional_calls = positional_engine.call(regions, reads);
+    const auto blocked_calls = blocked_engine.call(regions, reads);
+    BOOST_REQUIRE(!blocked_calls.empty());
+    BOOST_CHECK_LT(blocked_calls.size(), positional_calls.size());
+    auto positional_itr = std::cbegin(positional_calls);
+    const ReferenceCall* prev_block {nullptr};
+    for (const auto& block : blocked_calls) {
+        BOOST_CHECK_EQUAL(block->reference().sequence(), reference.fetch_sequence(mapped_region(*block)));
+        std::map<SampleName, double> min_qualities {};
+        std::map<SampleName, std::size_t> block_bands {};
+        for (auto position = mapped_begin(*block); position < mapped_end(*block); ++position) {
+            // every position in a block has its own positional call, with no gaps
+            BOOST_REQUIRE(positional_itr != std::cend(positional_calls));
+            const auto& call = **positional_itr++;
+            BOOST_REQUIRE_EQUAL(mapped_begin(call), position);
+            for (const auto& sample : samples) {
+                const auto quality = call.get_genotype_call(sample).posterior.score();
+                const auto quality_band = band(bands, quality);
+                if (position == mapped_begin(*block)) {
+                    min_qualities[sample] = quality;
+                    block_bands[sample] = quality_band;
+                } else {
+                    BOOST_CHECK_EQUAL(quality_band, block_bands[sample]);
+                    min_qualities[sample] = std::min(min_qualities[sample], quality);
+                }
+            }
+        }
+        for (const auto& sample : samples) {
+            BOOST_CHECK_CLOSE(block->get_genotype_call(sample).posterior.score(), min_qualities[sample], 1e-9);
+        }
+        const auto block_quality = std::min(min_qualities.at("first"), min_qualities.at("second"));
+        BOOST_CHECK_CLOSE(block->quality().score(), block_quality, 1e-9);
+        // touching blocks are only split where some sample changes band
+        if (prev_block && mapped_end(*prev_block) == mapped_begin(*block)) {
+            BOOST_CHECK(std::any_of(std::cbegin(samples), std::cend(samples), [&] (const auto& sample) {
+                return band(bands, prev_block->get_genotype_call(sample).posterior.score()) != block_bands.at(sample);
+            }));
+        }
+        prev_block = block.get();
+    }
+    BOOST_CHECK(positional_itr == std::cend(positional_calls));
+}
+
+BOOST_AUTO_TEST_CASE(zero_ploidy_samples_get_no_reference_calls)
+{
+    const auto reference = mock::make_reference();
+    const std::vector<SampleName> samples {"sample"};
+    const auto reads = make_reads(reference, samples);
+    const IndividualReferenceLikelihoodModel model {0};
+    std::vector<double> qualities {};
+    model.evaluate(callRegion, reference.fetch_sequence(callRegion), reads.at("sample"), qualities);
+    BOOST_CHECK(qualities == std::vector<double>(size(callRegion), 0.0));
+    for (const auto resolution : {ReferenceConfidenceEngine::Resolution::positional, ReferenceConfidenceEngine::Resolution::blocked}) {
+        const ReferenceConfidenceEngine engine {reference, samples, 0, make_parameters(resolution)};
+        BOOST_CHECK(engine.call(callRegion, reads).empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
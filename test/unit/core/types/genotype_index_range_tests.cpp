@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <algorithm>
+
+#include "core/types/genotype.hpp"
+#include "core/types/genotype_index_range.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(genotype_index_range)
+
+BOOST_AUTO_TEST_CASE(genotype_index_range_size_is_number_of_genotypes)
+{
+    for (unsigned num_elements {1}; num_elements <= 10; ++num_elements) {
+        for (unsigned ploidy {1}; ploidy <= 6; ++ploidy) {
+            const GenotypeIndexRange genotypes {num_elements, ploidy};
+            BOOST_CHECK_EQUAL(genotypes.size(), num_genotypes(num_elements, ploidy));
+            BOOST_CHECK_EQUAL(std::distance(std::cbegin(genotypes), std::cend(genotypes)), genotypes.size());
+        }
+    }
+    BOOST_CHECK(GenotypeIndexRange(0, 2).empty());
+    BOOST_CHECK(GenotypeIndexRange(3, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(genotype_index_range_enumerates_in_generate_all_genotypes_order)
+{
+    const GenotypeIndexRange genotypes {3, 2};
+    const std::vector<GenotypeIndex> expected {{0, 0}, {1, 0}, {2, 0}, {1, 1}, {2, 1}, {2, 2}};
+    BOOST_CHECK(genotypes.materialise() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(genotype_index_range_rank_and_unrank_are_inverse)
+{
+    for (unsigned num_elements {1}; num_elements <= 8; ++num_elements) {
+        for (unsigned ploidy {1}; ploidy <= 5; ++ploidy) {
+            const GenotypeIndexRange genotypes {num_elements, ploidy};
+            for (auto itr = std::cbegin(genotypes); itr != std::cend(genotypes); ++itr) {
+                BOOST_REQUIRE(std::is_sorted(std::crbegin(*itr), std::crend(*itr)));
+                BOOST_CHECK_EQUAL(genotypes.rank(*itr), itr.rank());
+                BOOST_CHECK(genotypes[itr.rank()] == *itr);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(genotype_index_range_iterators_can_jump)
+{
+    const GenotypeIndexRange genotypes {12, 4};
+    const auto all = genotypes.materialise();
+    auto itr = std::cbegin(genotypes);
+    itr += 100;
+    BOOST_CHECK(*itr == all[100]);
+    ++itr;
+    BOOST_CHECK(*itr == all[101]);
+    BOOST_CHECK_EQUAL(genotypes.homozygous_rank(0), 0);
+    BOOST_CHECK_EQUAL(genotypes.homozygous_rank(11), genotypes.size() - 1);
+    BOOST_CHECK(all[genotypes.homozygous_rank(5)] == GenotypeIndex(4, 5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
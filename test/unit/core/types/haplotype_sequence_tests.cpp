@@ -0,0 +1,123 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <new>
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_reader.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_sequence)
+
+namespace {
+
+// A single contig of one repeated base, so references that differ only in that base are easy to tell apart
+class UniformReference : public io::ReferenceReader
+{
+public:
+    UniformReference(char base) : base_ {base} {}
+
+private:
+    char base_;
+
+    std::unique_ptr<ReferenceReader> do_clone() const override { return std::make_unique<UniformReference>(*this); }
+    bool do_is_open() const noexcept override { return true; }
+    std::string do_fetch_reference_name() const override { return std::string {"uniform"} + base_; }
+    std::vector<ContigName> do_fetch_contig_names() const override { return {"1"}; }
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override { return 100; }
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override
+    {
+        return GeneticSequence(size(region), base_);
+    }
+};
+
+Haplotype make_haplotype(const ReferenceGenome& reference, const GenomicRegion& region, const std::vector<Allele>& alleles)
+{
+    Haplotype::Builder builder {region, reference};
+    for (const auto& allele : alleles) builder.push_back(allele);
+    return builder.build();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(haplotype_hash_and_order_agree_with_sequence)
+{
+    const auto reference = mock::make_reference();
+    const GenomicRegion region {"1", 65, 165};
+    // the reference is TGTG at 102, so inserting TG there and deleting 12 bases after the repeat is the
+    // same sequence as deleting 10 bases after it
+    const Allele allele1 {GenomicRegion {"1", 102, 102}, "TG"};
+    const Allele allele2 {GenomicRegion {"1", 104, 116}, ""};
+    const Allele allele3 {GenomicRegion {"1", 106, 116}, ""};
+    const auto hap1 = make_haplotype(reference, region, {allele3});
+    const auto hap2 = make_haplotype(reference, region, {allele1, allele2});
+    BOOST_CHECK_EQUAL(hap1.sequence(), hap2.sequence());
+    BOOST_CHECK_EQUAL(hap1.get_hash(), hap2.get_hash());
+    BOOST_CHECK(hap1 == hap2);
+    BOOST_CHECK_EQUAL(sequence_size(hap1), hap1.sequence().size());
+    const Haplotype ref {region, reference};
+    BOOST_CHECK(is_reference(ref));
+    BOOST_CHECK(!is_reference(hap1));
+    const GenomicRegion ref_region {"1", 102, 104};
+    BOOST_CHECK(is_reference(make_haplotype(reference, region, {Allele {ref_region, reference.fetch_sequence(ref_region)}})));
+    BOOST_CHECK_EQUAL(hap1 < ref, hap1.sequence() < ref.sequence());
+    BOOST_CHECK_EQUAL(ref < hap1, ref.sequence() < hap1.sequence());
+}
+
+BOOST_AUTO_TEST_CASE(copies_share_a_sequence_built_once_across_threads)
+{
+    const auto reference = mock::make_reference();
+    const GenomicRegion region {"1", 100, 200};
+    Haplotype::Builder builder {region, reference};
+    builder.push_back(Allele {GenomicRegion {"1", 120, 121}, "A"});
+    builder.push_back(Allele {GenomicRegion {"1", 150, 153}, ""});
+    const auto haplotype = builder.build();
+    const auto expected = reference.fetch_sequence(GenomicRegion {"1", 100, 120}) + "A"
+                          + reference.fetch_sequence(GenomicRegion {"1", 121, 150})
+                          + reference.fetch_sequence(GenomicRegion {"1", 153, 200});
+    const std::vector<Haplotype> copies(8, haplotype);
+    std::vector<const Haplotype::NucleotideSequence*> sequences(copies.size());
+    std::vector<std::thread> threads {};
+    for (std::size_t i {0}; i < copies.size(); ++i) {
+        threads.emplace_back([&, i] () { sequences[i] = &copies[i].sequence(); });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto sequence : sequences) {
+        BOOST_CHECK_EQUAL(sequence, sequences.front());
+        BOOST_CHECK_EQUAL(*sequence, expected);
+    }
+    BOOST_CHECK_EQUAL(&haplotype.sequence(), sequences.front());
+}
+
+BOOST_AUTO_TEST_CASE(haplotypes_do_not_share_reference_windows_between_references_with_the_same_address)
+{
+    std::aligned_storage_t<sizeof(ReferenceGenome), alignof(ReferenceGenome)> storage;
+    const GenomicRegion region {"1", 10, 20};
+    auto first = new (&storage) ReferenceGenome {std::make_unique<UniformReference>('A')};
+    const Haplotype first_haplotype {region, *first};
+    BOOST_CHECK_EQUAL(first_haplotype.sequence(), std::string(10, 'A'));
+    first->~ReferenceGenome();
+    auto second = new (&storage) ReferenceGenome {std::make_unique<UniformReference>('C')};
+    const Haplotype second_haplotype {region, *second};
+    BOOST_CHECK_EQUAL(second_haplotype.sequence(), std::string(10, 'C'));
+    second->~ReferenceGenome();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
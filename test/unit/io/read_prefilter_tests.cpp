@@ -0,0 +1,125 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "htslib/sam.h"
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/read/read_manager.hpp"
+#include "readpipe/filtering/read_filter.hpp"
+#include "readpipe/filtering/read_filterer.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(read_prefilter)
+
+namespace fs = boost::filesystem;
+using namespace readpipe;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+// Reads of contig 1 with every flag the prefilter looks at, and a spread of mapping qualities and lengths
+std::string make_sam(const ReferenceGenome& reference)
+{
+    const auto contig = reference.fetch_sequence(GenomicRegion {"1", 0, reference.contig_size("1")});
+    const std::vector<unsigned> flags {0, BAM_FUNMAP, BAM_FSECONDARY, BAM_FSUPPLEMENTARY, BAM_FDUP, BAM_FQCFAIL,
+                                       BAM_FREVERSE, BAM_FSECONDARY | BAM_FDUP, 0};
+    std::ostringstream result {};
+    result << "@HD\tVN:1.6\tSO:coordinate\n";
+    for (const auto& name : reference.contig_names()) {
+        result << "@SQ\tSN:" << name << "\tLN:" << reference.contig_size(name) << '\n';
+    }
+    result << "@RG\tID:RG\tSM:sample\n";
+    for (std::size_t i {0}, begin {20}; i < 180; ++i, begin += 2) {
+        const auto length = 20 + (i * 7) % 81;
+        const auto mapping_quality = (i * 13) % 61;
+        result << 'r' << i << '\t' << flags[i % flags.size()] << "\t1\t" << begin + 1 << '\t' << mapping_quality << '\t'
+               << length << "M\t*\t0\t0\t" << contig.substr(begin, length) << '\t' << std::string(length, 'I')
+               << "\tRG:Z:RG\n";
+    }
+    return result.str();
+}
+
+void write_bam(const std::string& sam, const fs::path& sam_path, const fs::path& bam_path)
+{
+    std::ofstream {sam_path.string()} << sam;
+    samFile* in {sam_open(sam_path.c_str(), "r")};
+    BOOST_REQUIRE(in);
+    bam_hdr_t* header {sam_hdr_read(in)};
+    samFile* out {sam_open(bam_path.c_str(), "wb")};
+    BOOST_REQUIRE(out);
+    BOOST_REQUIRE_EQUAL(sam_hdr_write(out, header), 0);
+    bam1_t* record {bam_init1()};
+    while (sam_read1(in, header, record) >= 0) {
+        BOOST_REQUIRE_GE(sam_write1(out, header, record), 0);
+    }
+    bam_destroy1(record);
+    bam_hdr_destroy(header);
+    sam_close(out);
+    sam_close(in);
+    BOOST_REQUIRE_EQUAL(sam_index_build(bam_path.c_str(), 0), 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(prefiltered_reads_are_the_reads_that_pass_the_basic_filters)
+{
+    const auto reference = mock::make_reference();
+    TempDirectory directory {};
+    const auto bam_path = directory.path / "reads.bam";
+    write_bam(make_sam(reference), directory.path / "reads.sam", bam_path);
+    const ReadManager read_manager {bam_path};
+    const GenomicRegion region {"1", 0, reference.contig_size("1")};
+
+    using ReadContainer = ReadManager::ReadContainer;
+    ReadFilterer<ReadContainer::iterator> filterer {};
+    filterer.add(std::make_unique<IsMapped>());
+    filterer.add(std::make_unique<IsNotSecondaryAlignment>());
+    filterer.add(std::make_unique<IsNotSupplementaryAlignment>());
+    filterer.add(std::make_unique<IsNotMarkedDuplicate>());
+    filterer.add(std::make_unique<IsNotMarkedQcFail>());
+    filterer.add(std::make_unique<IsGoodMappingQuality>(20));
+    filterer.add(std::make_unique<IsLong>(50));
+
+    auto all_reads = read_manager.fetch_reads("sample", region);
+    auto postfiltered = all_reads;
+    postfiltered.erase(filterer.remove(std::begin(postfiltered), std::end(postfiltered)), std::end(postfiltered));
+    auto prefiltered = read_manager.fetch_reads("sample", region, filterer.prefilter());
+    // the filters must reject some reads and keep some for the comparison to mean anything
+    BOOST_CHECK_LT(postfiltered.size(), all_reads.size());
+    BOOST_CHECK(!postfiltered.empty());
+    std::sort(std::begin(postfiltered), std::end(postfiltered));
+    std::sort(std::begin(prefiltered), std::end(prefiltered));
+    BOOST_CHECK(prefiltered == postfiltered);
+
+    // a prefilter with no constraints keeps every read
+    const auto unfiltered = read_manager.fetch_reads("sample", region, octopus::io::ReadPrefilter {});
+    BOOST_CHECK_EQUAL(unfiltered.size(), all_reads.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,131 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "io/variant/vcf.hpp"
+#include "io/variant/bcf_record_builder.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(vcf_writer)
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+VcfHeader make_header()
+{
+    return VcfHeader::Builder().add_contig("TEST").set_samples({"SAMPLE"})
+    .add_info("DP", "1", "Integer", "Combined depth across samples")
+    .add_format("GT", "1", "String", "Genotype")
+    .add_format("GQ", "1", "Integer", "Conditional genotype quality (phred-scaled)")
+    .build_once();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(typed_records_are_read_back_with_the_values_they_were_built_with)
+{
+    TempDirectory directory {};
+    const auto bcf = directory.path / "typed.bcf";
+    {
+        VcfWriter writer {bcf};
+        BOOST_REQUIRE(writer.is_open());
+        BOOST_CHECK_THROW(writer.make_record_builder(), std::runtime_error);
+        writer.write(make_header());
+        auto builder = writer.make_record_builder();
+        BOOST_CHECK_THROW(builder.info_id("NOT_IN_HEADER"), std::runtime_error);
+        const auto contig = builder.contig_id("TEST");
+        const auto pass = builder.filter_id("PASS");
+        const auto dp = builder.info_id("DP"), gq = builder.format_id("GQ");
+        const std::int32_t genotype[] {BcfRecordBuilder::genotype_allele(0u, false), BcfRecordBuilder::genotype_allele(1u, true)};
+        const std::int32_t quality {40};
+        for (const unsigned pos : {10u, 20u}) {
+            builder.clear().set_chrom(contig).set_pos(pos).set_id(".").set_alleles("A", {"C"}).set_qual(60)
+            .add_filter(pass).set_info(dp, 30).set_genotypes(genotype, 2).set_format(gq, &quality, 1);
+            writer.write(builder);
+        }
+    }
+    const auto records = VcfReader {bcf}.fetch_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_CHECK_EQUAL(records[0].pos(), 10);
+    BOOST_CHECK_EQUAL(records[1].pos(), 20);
+    for (const auto& record : records) {
+        BOOST_CHECK_EQUAL(record.chrom(), "TEST");
+        BOOST_CHECK_EQUAL(record.ref(), "A");
+        BOOST_REQUIRE_EQUAL(record.alt().size(), 1);
+        BOOST_CHECK_EQUAL(record.alt().front(), "C");
+        BOOST_CHECK(record.has_filter("PASS"));
+        BOOST_CHECK_EQUAL(record.info_value("DP").front(), "30");
+        BOOST_CHECK(record.is_sample_phased("SAMPLE"));
+        const auto& genotype = record.get_sample_value("SAMPLE", "GT");
+        BOOST_REQUIRE_EQUAL(genotype.size(), 2);
+        BOOST_CHECK_EQUAL(genotype[0], "A");
+        BOOST_CHECK_EQUAL(genotype[1], "C");
+        BOOST_CHECK_EQUAL(record.get_sample_value("SAMPLE", "GQ").front(), "40");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(consecutive_records_do_not_share_fields)
+{
+    TempDirectory directory {};
+    const auto bcf = directory.path / "records.bcf";
+    {
+        VcfWriter writer {bcf};
+        BOOST_REQUIRE(writer.is_open());
+        writer.write(make_header());
+        // The writer reuses one htslib record, so the second record must not pick up the first's INFO or ID
+        writer.write(VcfRecord::Builder().set_chrom("TEST").set_pos(10).set_id("rs1").set_ref("A").set_alt("C").set_qual(60)
+                     .set_passed().set_info("DP", 30).set_format({"GT", "GQ"})
+                     .set_genotype("SAMPLE", std::vector<std::string> {"A", "C"}, VcfRecord::Builder::Phasing::phased)
+                     .set_format("SAMPLE", "GQ", 40).build_once());
+        writer.write(VcfRecord::Builder().set_chrom("TEST").set_pos(20).set_ref("AT").set_alt(std::vector<std::string> {"A", "ATT"}).set_qual(10)
+                     .set_format({"GT"})
+                     .set_genotype("SAMPLE", std::vector<std::string> {"A", "ATT"}, VcfRecord::Builder::Phasing::unphased)
+                     .build_once());
+        const auto bad_record = VcfRecord::Builder().set_chrom("TEST").set_pos(30).set_ref("A").set_alt("C")
+                                .set_info("NOT_IN_HEADER", 1).build_once();
+        BOOST_CHECK_THROW(writer.write(bad_record), std::runtime_error);
+    }
+    const auto records = VcfReader {bcf}.fetch_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_CHECK_EQUAL(records[0].pos(), 10);
+    BOOST_CHECK_EQUAL(records[0].id(), "rs1");
+    BOOST_CHECK(records[0].has_filter("PASS"));
+    BOOST_CHECK_EQUAL(records[0].info_value("DP").front(), "30");
+    BOOST_CHECK(records[0].is_sample_phased("SAMPLE"));
+    BOOST_CHECK_EQUAL(records[0].get_sample_value("SAMPLE", "GQ").front(), "40");
+    BOOST_CHECK_EQUAL(records[1].pos(), 20);
+    BOOST_CHECK_EQUAL(records[1].id(), ".");
+    BOOST_CHECK_EQUAL(records[1].ref(), "AT");
+    BOOST_REQUIRE_EQUAL(records[1].alt().size(), 2);
+    BOOST_CHECK(!records[1].has_info("DP"));
+    BOOST_CHECK(records[1].filter().empty());
+    BOOST_CHECK(!records[1].is_sample_phased("SAMPLE"));
+    const auto& genotype = records[1].get_sample_value("SAMPLE", "GT");
+    BOOST_REQUIRE_EQUAL(genotype.size(), 2);
+    BOOST_CHECK_EQUAL(genotype[0], "A");
+    BOOST_CHECK_EQUAL(genotype[1], "ATT");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
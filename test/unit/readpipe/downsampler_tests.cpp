@@ -1,4 +1,94 @@
 // Copyright (c) 2017 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "utils/mappable_algorithms.hpp"
+#include "readpipe/downsampling/downsampler.hpp"
+
+namespace octopus { namespace test {
+
+using octopus::readpipe::Downsampler;
+
+BOOST_AUTO_TEST_SUITE(readpipe)
+BOOST_AUTO_TEST_SUITE(downsampler)
+
+namespace {
+
+AlignedRead make_read(const std::string& name, GenomicRegion::Position begin, unsigned length)
+{
+    return AlignedRead {
+        name, GenomicRegion {"1", begin, begin + length},
+        std::string(length, 'A'), AlignedRead::BaseQualityVector(length, 30),
+        parse_cigar(std::to_string(length) + "M"), 60, AlignedRead::Flags {}, "RG"
+    };
+}
+
+// A pileup that is deep in the middle and shallow on the flanks
+ReadContainer make_pileup()
+{
+    std::vector<AlignedRead> reads {};
+    for (GenomicRegion::Position begin {0}; begin < 100; begin += 10) {
+        reads.push_back(make_read("flank" + std::to_string(begin), begin, 50));
+    }
+    for (unsigned i {0}; i < 500; ++i) {
+        reads.push_back(make_read("deep" + std::to_string(i), 100 + (i * 7) % 50, 30 + i % 20));
+    }
+    return ReadContainer {std::make_move_iterator(std::begin(reads)), std::make_move_iterator(std::end(reads))};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(downsampling_keeps_target_coverage_where_possible)
+{
+    const auto reads = make_pileup();
+    const unsigned trigger_coverage {100}, target_coverage {50};
+    auto downsampled = reads;
+    const auto report = Downsampler {trigger_coverage, target_coverage}.downsample(downsampled);
+    BOOST_REQUIRE(!report.downsampled_regions.empty());
+    BOOST_CHECK(downsampled.size() < reads.size());
+    std::size_t num_removed {0};
+    for (const auto& region : report.downsampled_regions) num_removed += region.num_reads();
+    BOOST_CHECK_EQUAL(reads.size() - downsampled.size(), num_removed);
+    BOOST_CHECK(std::is_sorted(std::cbegin(downsampled), std::cend(downsampled)));
+    const auto region = encompassing_region(reads);
+    const auto original_coverages = calculate_positional_coverage(reads, region);
+    const auto downsampled_coverages = calculate_positional_coverage(downsampled, region);
+    for (std::size_t i {0}; i < original_coverages.size(); ++i) {
+        BOOST_CHECK(downsampled_coverages[i] >= std::min(original_coverages[i], target_coverage));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(downsampling_is_deterministic_for_a_fixed_seed)
+{
+    const auto reads = make_pileup();
+    auto downsampled1 = reads, downsampled2 = reads;
+    Downsampler {100, 50, 7}.downsample(downsampled1);
+    Downsampler {100, 50, 7}.downsample(downsampled2);
+    BOOST_REQUIRE_EQUAL(downsampled1.size(), downsampled2.size());
+    BOOST_CHECK(std::equal(std::cbegin(downsampled1), std::cend(downsampled1), std::cbegin(downsampled2),
+                           [] (const auto& lhs, const auto& rhs) { return lhs.name() == rhs.name(); }));
+}
+
+BOOST_AUTO_TEST_CASE(reads_below_the_trigger_coverage_are_untouched)
+{
+    auto reads = make_pileup();
+    const auto num_reads = reads.size();
+    const auto report = Downsampler {1000, 50}.downsample(reads);
+    BOOST_CHECK(report.downsampled_regions.empty());
+    BOOST_CHECK_EQUAL(reads.size(), num_reads);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,16 +1,141 @@
 // Copyright (c) 2017 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#define BOOST_TEST_DYN_LINK
-
 #include <boost/test/unit_test.hpp>
 
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <memory>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "htslib/sam.h"
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/read/read_manager.hpp"
 #include "readpipe/read_pipe.hpp"
+#include "readpipe/filtering/read_filter.hpp"
+#include "readpipe/transformers/read_transform.hpp"
+#include "utils/thread_pool.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(readpipe)
+BOOST_AUTO_TEST_SUITE(read_pipe)
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+const std::vector<SampleName> samples {"a", "b", "c", "d", "e"};
+
+// Deep enough reads of contig 1 in every sample that the downsampler has work to do, with mapping
+// qualities and base qualities that the filters and transforms change
+std::string make_sam(const ReferenceGenome& reference)
+{
+    const auto contig = reference.fetch_sequence(GenomicRegion {"1", 0, reference.contig_size("1")});
+    std::ostringstream result {};
+    result << "@HD\tVN:1.6\tSO:coordinate\n";
+    for (const auto& name : reference.contig_names()) {
+        result << "@SQ\tSN:" << name << "\tLN:" << reference.contig_size(name) << '\n';
+    }
+    for (const auto& sample : samples) {
+        result << "@RG\tID:" << sample << "\tSM:" << sample << '\n';
+    }
+    constexpr std::size_t readLength {50};
+    for (std::size_t begin {10}, i {0}; begin + readLength <= 450; ++begin) {
+        for (std::size_t s {0}; s < samples.size(); ++s, ++i) {
+            if ((begin + s) % (s + 1) != 0) continue;
+            const auto mapping_quality = (i * 17) % 61;
+            std::string qualities(readLength, 'I');
+            qualities.back() = qualities.front() = static_cast<char>('!' + 2 + i % 10);
+            result << 'r' << i << "\t0\t1\t" << begin + 1 << '\t' << mapping_quality << '\t' << readLength << "M\t*\t0\t0\t"
+                   << contig.substr(begin, readLength) << '\t' << qualities << "\tRG:Z:" << samples[s] << '\n';
+        }
+    }
+    return result.str();
+}
+
+void write_bam(const std::string& sam, const fs::path& sam_path, const fs::path& bam_path)
+{
+    std::ofstream {sam_path.string()} << sam;
+    samFile* in {sam_open(sam_path.c_str(), "r")};
+    BOOST_REQUIRE(in);
+    bam_hdr_t* header {sam_hdr_read(in)};
+    samFile* out {sam_open(bam_path.c_str(), "wb")};
+    BOOST_REQUIRE(out);
+    BOOST_REQUIRE_EQUAL(sam_hdr_write(out, header), 0);
+    bam1_t* record {bam_init1()};
+    while (sam_read1(in, header, record) >= 0) {
+        BOOST_REQUIRE_GE(sam_write1(out, header, record), 0);
+    }
+    bam_destroy1(record);
+    bam_hdr_destroy(header);
+    sam_close(out);
+    sam_close(in);
+    BOOST_REQUIRE_EQUAL(sam_index_build(bam_path.c_str(), 0), 0);
+}
+
+ReadPipe make_read_pipe(const ReadManager& read_manager, const unsigned max_threads)
+{
+    using namespace octopus::readpipe;
+    ReadPipe::ReadTransformer prefilter_transformer {}, postfilter_transformer {};
+    prefilter_transformer.add(CapitaliseBases {});
+    prefilter_transformer.add(MaskLowQualityTails {5});
+    postfilter_transformer.add(CapBaseQualities {30});
+    ReadPipe::ReadFilterer filterer {};
+    filterer.add(std::make_unique<HasValidBaseQualities>());
+    filterer.add(std::make_unique<IsGoodMappingQuality>(10));
+    ReadPipe result {read_manager, std::move(prefilter_transformer), std::move(filterer), std::move(postfilter_transformer),
+                     Downsampler {20, 15}, samples};
+    result.set_max_threads(max_threads);
+    return result;
+}
+
+void check_equal(const ReadMap& lhs, const ReadMap& rhs)
+{
+    BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+    for (const auto& p : lhs) {
+        BOOST_REQUIRE(rhs.count(p.first) == 1);
+        BOOST_CHECK(!p.second.empty());
+        BOOST_CHECK(p.second == rhs.at(p.first));
+    }
+}
+
+} // namespace
 
-BOOST_AUTO_TEST_SUITE(Components)
-BOOST_AUTO_TEST_SUITE(IO)
+BOOST_AUTO_TEST_CASE(samples_prepared_in_parallel_match_samples_prepared_serially)
+{
+    const auto reference = mock::make_reference();
+    TempDirectory directory {};
+    const auto bam_path = directory.path / "reads.bam";
+    write_bam(make_sam(reference), directory.path / "reads.sam", bam_path);
+    const ReadManager read_manager {bam_path};
+    const auto serial_pipe = make_read_pipe(read_manager, 1);
+    const auto parallel_pipe = make_read_pipe(read_manager, 4);
+    const GenomicRegion region {"1", 0, reference.contig_size("1")};
+    check_equal(parallel_pipe.fetch_reads(region), serial_pipe.fetch_reads(region));
+    const std::vector<GenomicRegion> regions {GenomicRegion {"1", 50, 150}, GenomicRegion {"1", 300, 400}};
+    check_equal(parallel_pipe.fetch_reads(regions), serial_pipe.fetch_reads(regions));
+    // as a calling task would, from a pool worker
+    const auto pooled_reads = shared_thread_pool().push([&] () { return parallel_pipe.fetch_reads(region); }).get();
+    check_equal(pooled_reads, serial_pipe.fetch_reads(region));
+}
 
-// TODO
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
 
-BOOST_AUTO_TEST_SUITE_END() // IO
-BOOST_AUTO_TEST_SUITE_END() // Components
+} // namespace test
+} // namespace octopus
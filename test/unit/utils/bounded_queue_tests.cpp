@@ -0,0 +1,67 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <thread>
+#include <numeric>
+
+#include "utils/bounded_queue.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(bounded_queue)
+
+BOOST_AUTO_TEST_CASE(bounded_queue_preserves_order_across_threads)
+{
+    BoundedQueue<int> queue {4};
+    const int num_items {10'000};
+    std::thread producer {[&] () {
+        for (int i {0}; i < num_items; ++i) queue.push(i);
+        queue.close();
+    }};
+    std::vector<int> popped {};
+    while (auto item = queue.pop()) {
+        popped.push_back(*item);
+    }
+    producer.join();
+    std::vector<int> expected(num_items);
+    std::iota(std::begin(expected), std::end(expected), 0);
+    BOOST_CHECK(popped == expected);
+}
+
+BOOST_AUTO_TEST_CASE(closed_bounded_queue_drains_then_rejects)
+{
+    BoundedQueue<int> queue {2};
+    BOOST_CHECK(queue.push(1));
+    BOOST_CHECK(queue.push(2));
+    queue.close();
+    BOOST_CHECK(queue.is_closed());
+    BOOST_CHECK(!queue.push(3));
+    auto item = queue.pop();
+    BOOST_REQUIRE(item);
+    BOOST_CHECK_EQUAL(*item, 1);
+    item = queue.pop();
+    BOOST_REQUIRE(item);
+    BOOST_CHECK_EQUAL(*item, 2);
+    BOOST_CHECK(!queue.pop());
+}
+
+BOOST_AUTO_TEST_CASE(closing_bounded_queue_releases_blocked_producer)
+{
+    BoundedQueue<int> queue {1};
+    queue.push(0);
+    bool pushed {true};
+    std::thread producer {[&] () { pushed = queue.push(1); }};
+    queue.close();
+    producer.join();
+    BOOST_CHECK(!pushed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,47 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "basics/genomic_region.hpp"
+#include "utils/coverage_estimate.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(coverage_estimate)
+
+BOOST_AUTO_TEST_CASE(counts_interpolate_within_bins)
+{
+    // Bins [100, 200), [200, 300), [300, 350)
+    const CoverageEstimate estimate {GenomicRegion {"1", 100, 350}, 100, {10, 30, 5}};
+    BOOST_CHECK_CLOSE(estimate.total(), 45, 1e-6);
+    BOOST_CHECK_CLOSE(estimate.count(GenomicRegion {"1", 100, 350}), 45, 1e-6);
+    BOOST_CHECK_CLOSE(estimate.count(GenomicRegion {"1", 150, 250}), 20, 1e-6);
+    BOOST_CHECK_CLOSE(estimate.count(GenomicRegion {"1", 300, 325}), 2.5, 1e-6);
+    BOOST_CHECK_CLOSE(estimate.count(GenomicRegion {"1", 0, 1000}), 45, 1e-6);
+    BOOST_CHECK_EQUAL(estimate.count(GenomicRegion {"1", 400, 500}), 0);
+    BOOST_CHECK_EQUAL(estimate.count(GenomicRegion {"2", 100, 350}), 0);
+    BOOST_CHECK_THROW((CoverageEstimate {GenomicRegion {"1", 100, 350}, 100, {10, 30}}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(covered_subregions_hold_at_most_the_requested_reads)
+{
+    const CoverageEstimate estimate {GenomicRegion {"1", 0, 300}, 100, {10, 30, 5}};
+    const GenomicRegion region {"1", 0, 300};
+    BOOST_CHECK_EQUAL(estimate.find_covered_subregion(region, 100), region);
+    BOOST_CHECK_EQUAL(estimate.find_covered_subregion(region, 5), (GenomicRegion {"1", 0, 50}));
+    BOOST_CHECK_EQUAL(estimate.find_covered_subregion(region, 25), (GenomicRegion {"1", 0, 150}));
+    BOOST_CHECK_EQUAL(estimate.find_covered_subregion(GenomicRegion {"1", 150, 300}, 15), (GenomicRegion {"1", 150, 200}));
+    BOOST_CHECK_EQUAL(estimate.find_covered_subregion(region, 0), (GenomicRegion {"1", 0, 0}));
+    const auto head = estimate.find_covered_subregion(region, 27);
+    BOOST_CHECK(estimate.count(head) <= 27 + 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,83 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+#include "utils/memory_governor.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(memory_governor)
+
+using Component = MemoryGovernor::Component;
+
+BOOST_AUTO_TEST_CASE(reservations_are_released_when_destroyed)
+{
+    MemoryGovernor governor {1000};
+    {
+        const auto reads = governor.reserve(Component::reads, 300);
+        auto likelihoods = governor.reserve(Component::likelihoods, 200);
+        BOOST_CHECK_EQUAL(governor.usage(), 500);
+        BOOST_CHECK_EQUAL(governor.usage(Component::reads), 300);
+        BOOST_CHECK_CLOSE(governor.headroom(), 0.5, 1e-6);
+        likelihoods = governor.reserve(Component::likelihoods, 100);
+        BOOST_CHECK_EQUAL(governor.usage(Component::likelihoods), 100);
+        auto moved = std::move(likelihoods);
+        BOOST_CHECK_EQUAL(governor.usage(), 400);
+        moved.release();
+        BOOST_CHECK_EQUAL(governor.usage(), 300);
+    }
+    BOOST_CHECK_EQUAL(governor.usage(), 0);
+    BOOST_CHECK_EQUAL(governor.headroom(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(peak_usage_is_recorded_for_each_component)
+{
+    MemoryGovernor governor {};
+    {
+        const auto reads = governor.reserve(Component::reads, 300);
+        const auto haplotypes = governor.reserve(Component::haplotypes, 50);
+    }
+    const auto reads = governor.reserve(Component::reads, 100);
+    BOOST_CHECK_EQUAL(governor.peak_usage(), 350);
+    BOOST_CHECK_EQUAL(governor.peak_usage(Component::reads), 300);
+    BOOST_CHECK_EQUAL(governor.peak_usage(Component::haplotypes), 50);
+    BOOST_CHECK_EQUAL(governor.peak_usage(Component::likelihoods), 0);
+    BOOST_CHECK(!governor.budget());
+    BOOST_CHECK_EQUAL(governor.headroom(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(reservations_can_exceed_the_budget)
+{
+    MemoryGovernor governor {100};
+    const auto reads = governor.reserve(Component::reads, 150);
+    BOOST_CHECK_EQUAL(governor.usage(), 150);
+    BOOST_CHECK_EQUAL(governor.headroom(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(wait_for_blocks_until_memory_is_released)
+{
+    MemoryGovernor governor {100};
+    auto reads = governor.reserve(Component::reads, 80);
+    governor.wait_for(20); // fits
+    std::atomic_bool resumed {false};
+    std::thread waiter {[&] () { governor.wait_for(50); resumed = true; }};
+    std::this_thread::sleep_for(std::chrono::milliseconds {50});
+    BOOST_CHECK(!resumed);
+    reads.release();
+    waiter.join();
+    BOOST_CHECK(resumed);
+    governor.wait_for(1000); // larger than the budget but nothing is reserved
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
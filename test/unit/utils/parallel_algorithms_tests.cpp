@@ -0,0 +1,131 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <numeric>
+#include <iterator>
+#include <atomic>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <future>
+#include <chrono>
+
+#include "utils/thread_pool.hpp"
+#include "utils/parallel_algorithms.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(parallel_algorithms)
+
+BOOST_AUTO_TEST_CASE(parallel_for_visits_each_index_once)
+{
+    ThreadPool pool {4};
+    std::vector<int> visits(1000, 0);
+    parallel_for(0, 1000, [&] (int i) { ++visits[i]; }, pool);
+    BOOST_CHECK(std::all_of(std::cbegin(visits), std::cend(visits), [] (int n) { return n == 1; }));
+    ThreadPool serial_pool {};
+    parallel_for(std::size_t {0}, visits.size(), [&] (std::size_t i) { ++visits[i]; }, serial_pool);
+    BOOST_CHECK(std::all_of(std::cbegin(visits), std::cend(visits), [] (int n) { return n == 2; }));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_transform_preserves_input_order)
+{
+    ThreadPool pool {3};
+    std::vector<int> values(1001);
+    std::iota(std::begin(values), std::end(values), 0);
+    std::vector<std::string> result {};
+    parallel_transform(std::cbegin(values), std::cend(values), std::back_inserter(result),
+                       [] (int value) { return std::to_string(value); }, pool, 10);
+    BOOST_REQUIRE_EQUAL(result.size(), values.size());
+    for (std::size_t i {0}; i < values.size(); ++i) {
+        BOOST_CHECK_EQUAL(result[i], std::to_string(values[i]));
+    }
+    std::vector<int> sums(values.size());
+    parallel_transform(std::cbegin(values), std::cend(values), std::cbegin(values), std::begin(sums),
+                       [] (int a, int b) { return a + b; }, pool);
+    BOOST_CHECK_EQUAL(sums.back(), 2000);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_reduce_combines_chunks_in_order)
+{
+    ThreadPool pool {4};
+    std::vector<int> values(10'000);
+    std::iota(std::begin(values), std::end(values), 1);
+    BOOST_CHECK_EQUAL(parallel_reduce(std::cbegin(values), std::cend(values), 0LL,
+                                      [] (long long a, long long b) { return a + b; }, pool),
+                      50'005'000LL);
+    const std::vector<std::string> letters {"a", "b", "c", "d", "e", "f", "g", "h"};
+    const auto joined = parallel_transform_reduce(std::cbegin(letters), std::cend(letters), std::string {},
+                                                  [] (std::string a, const std::string& b) { return a + b; },
+                                                  [] (const std::string& letter) { return letter; }, pool);
+    BOOST_CHECK_EQUAL(joined, "abcdefgh");
+    BOOST_CHECK_EQUAL(parallel_reduce(std::cbegin(values), std::cbegin(values), 7, std::plus<> {}, pool), 7);
+}
+
+BOOST_AUTO_TEST_CASE(nested_task_groups_do_not_deadlock)
+{
+    ThreadPool pool {2};
+    std::atomic<int> count {0};
+    TaskGroup outer {pool};
+    for (int i {0}; i < 8; ++i) {
+        outer.run([&] () {
+            TaskGroup inner {pool};
+            for (int j {0}; j < 8; ++j) inner.run([&] () { ++count; });
+            inner.wait();
+        });
+    }
+    outer.wait();
+    BOOST_CHECK_EQUAL(count, 64);
+}
+
+BOOST_AUTO_TEST_CASE(waiting_task_groups_only_run_their_own_tasks)
+{
+    ThreadPool pool {1};
+    std::promise<void> started {}, release {};
+    auto blocker = pool.push([&] () { started.set_value(); release.get_future().wait(); });
+    started.get_future().wait();
+    // queued behind the blocked worker, as another calling task would be
+    auto unrelated = pool.push([] () { return std::this_thread::get_id(); });
+    std::thread::id group_thread {};
+    TaskGroup group {pool};
+    group.run([&] () { group_thread = std::this_thread::get_id(); });
+    group.wait();
+    BOOST_CHECK(group_thread == std::this_thread::get_id());
+    BOOST_CHECK(unrelated.wait_for(std::chrono::seconds {0}) != std::future_status::ready);
+    release.set_value();
+    BOOST_CHECK(unrelated.get() != std::this_thread::get_id());
+    blocker.get();
+}
+
+BOOST_AUTO_TEST_CASE(task_group_exceptions_cancel_pending_tasks)
+{
+    ThreadPool pool {1};
+    std::atomic<int> count {0};
+    TaskGroup group {pool};
+    group.run([] () { throw std::runtime_error {"failed"}; });
+    BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+    group.cancel();
+    BOOST_CHECK(group.is_cancelled());
+    group.run([&] () { ++count; });
+    group.wait();
+    BOOST_CHECK_EQUAL(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(pool_futures_return_results)
+{
+    ThreadPool pool {2};
+    auto result = pool.push([] (int a, int b) { return a * b; }, 6, 7);
+    BOOST_CHECK_EQUAL(result.get(), 42);
+    ThreadPool serial_pool {};
+    BOOST_CHECK_EQUAL(serial_pool.push([] () { return 1; }).get(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,115 @@
+// Copyright (c) 2015-2018 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "utils/read_stats.hpp"
+#include "utils/region_read_summary.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(region_read_summary)
+
+namespace {
+
+AlignedRead make_read(GenomicRegion::Position begin, const std::string& cigar, AlignedRead::MappingQuality mapping_quality,
+                      bool reverse = false)
+{
+    const auto parsed_cigar = parse_cigar(cigar);
+    const auto read_size = sequence_size(parsed_cigar);
+    AlignedRead::Flags flags {};
+    flags.reverse_mapped = reverse;
+    return AlignedRead {
+        "read", GenomicRegion {"1", begin, begin + reference_size(parsed_cigar)},
+        std::string(read_size, 'A'), AlignedRead::BaseQualityVector(read_size, 30),
+        parsed_cigar, mapping_quality, flags, "RG"
+    };
+}
+
+ReadMap make_reads()
+{
+    ReadMap result {};
+    result["sample"] = ReadContainer {
+        make_read(0, "10M", 60),
+        make_read(3, "4M2D4M", 0, true),
+        make_read(5, "2S8M", 40),
+        make_read(8, "10M", 20, true),
+        make_read(15, "5M", 60),
+        make_read(21, "6M", 10)
+    };
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(statistics_match_rescanning_reads_for_all_subregions)
+{
+    const auto reads = make_reads();
+    const GenomicRegion region {"1", 2, 24};
+    const RegionReadSummary summary {region, reads};
+    for (auto begin = region.begin(); begin <= region.end(); ++begin) {
+        for (auto end = begin; end <= region.end(); ++end) {
+            const GenomicRegion subregion {"1", begin, end};
+            BOOST_CHECK_EQUAL(summary.count_reads(subregion), count_reads(reads, subregion));
+            BOOST_CHECK_EQUAL(summary.count_forward(subregion), count_forward(reads, subregion));
+            BOOST_CHECK_EQUAL(summary.count_reverse(subregion), count_reverse(reads, subregion));
+            BOOST_CHECK_EQUAL(summary.count_mapq_zero(subregion), count_mapq_zero(reads, subregion));
+            BOOST_CHECK_EQUAL(summary.has_coverage(subregion), has_coverage(reads, subregion));
+            BOOST_CHECK_CLOSE(summary.rmq_mapping_quality(subregion), rmq_mapping_quality(reads, subregion), 1e-6);
+            if (begin < end) {
+                BOOST_CHECK_EQUAL(summary.min_coverage(subregion), min_coverage(reads, subregion));
+                BOOST_CHECK_EQUAL(summary.max_coverage(subregion), max_coverage(reads, subregion));
+                BOOST_CHECK_CLOSE(summary.mean_coverage(subregion), mean_coverage(reads, subregion), 1e-6);
+                BOOST_CHECK_SMALL(summary.stdev_coverage(subregion) - stdev_coverage(reads, subregion), 1e-6);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(summaries_can_be_combined)
+{
+    const auto reads = make_reads();
+    const GenomicRegion region {"1", 0, 30};
+    const auto& sample_reads = reads.at("sample");
+    ReadContainer lhs_reads {}, rhs_reads {};
+    bool to_lhs {true};
+    for (const auto& read : sample_reads) {
+        (to_lhs ? lhs_reads : rhs_reads).insert(read);
+        to_lhs = !to_lhs;
+    }
+    RegionReadSummary combined {region, lhs_reads};
+    combined += RegionReadSummary {region, rhs_reads};
+    const RegionReadSummary expected {region, sample_reads};
+    for (auto begin = region.begin(); begin < region.end(); ++begin) {
+        const GenomicRegion subregion {"1", begin, region.end()};
+        BOOST_CHECK_EQUAL(combined.count_reads(subregion), expected.count_reads(subregion));
+        BOOST_CHECK_EQUAL(combined.min_coverage(subregion), expected.min_coverage(subregion));
+        BOOST_CHECK_EQUAL(combined.max_coverage(subregion), expected.max_coverage(subregion));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(heavily_clipped_reads_have_more_than_a_quarter_of_bases_soft_clipped)
+{
+    ReadMap reads {};
+    reads["sample"] = ReadContainer {make_read(0, "3S7M", 60), make_read(0, "2S8M", 60)};
+    const GenomicRegion region {"1", 0, 10};
+    const RegionReadSummary summary {region, reads};
+    BOOST_CHECK_EQUAL(summary.count_soft_clipped(region), 2);
+    BOOST_CHECK_EQUAL(summary.count_heavily_clipped(region), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus